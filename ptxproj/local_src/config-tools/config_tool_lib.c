@@ -29,6 +29,12 @@
 #include <libudev.h>
 #include <glib.h>
 #include <unistd.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <mntent.h>
+#include <netdb.h>
 
 #include "config_tool_lib.h"
 
@@ -1311,6 +1317,468 @@ int ctlib_IpaddrToInt(char const * szIpAddr,
   return status;
 }
 
+//------------------------------------------------------------------------------
+// Native access to system data
+//------------------------------------------------------------------------------
+
+// content of files that do not change until reboot, by file name
+static GHashTable * procFileCache = NULL;
+G_LOCK_DEFINE_STATIC(procFileCache);
+
+char *ctlib_ReadProcFile(char const * szFilename)
+{
+  size_t size = 0;
+  size_t bufSize = 4096;
+  char * szBuffer;
+  int fd;
+
+  fd = open(szFilename, O_RDONLY | O_CLOEXEC);
+  if(fd < 0)
+  {
+    return NULL;
+  }
+  szBuffer = malloc(bufSize);
+  while(szBuffer != NULL)
+  {
+    ssize_t bytes;
+
+    if((bufSize - size) < 2)
+    {
+      char * szGrown = realloc(szBuffer, bufSize * 2);
+      if(szGrown == NULL)
+      {
+        free(szBuffer);
+        szBuffer = NULL;
+        break;
+      }
+      szBuffer = szGrown;
+      bufSize *= 2;
+    }
+    bytes = read(fd, szBuffer + size, bufSize - size - 1);
+    if(bytes > 0)
+    {
+      size += bytes;
+    }
+    else if((bytes < 0) && (errno == EINTR))
+    {
+      continue;
+    }
+    else
+    {
+      if(bytes < 0)
+      {
+        free(szBuffer);
+        szBuffer = NULL;
+      }
+      break;
+    }
+  }
+  close(fd);
+
+  if(szBuffer != NULL)
+  {
+    szBuffer[size] = '\0';
+  }
+  return szBuffer;
+}
+
+char const *ctlib_ReadProcFileCached(char const * szFilename)
+{
+  char * szContent;
+
+  G_LOCK(procFileCache);
+  if(procFileCache == NULL)
+  {
+    procFileCache = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, free);
+  }
+  szContent = g_hash_table_lookup(procFileCache, szFilename);
+  if(szContent == NULL)
+  {
+    // read errors are not cached, the next call tries again
+    szContent = ctlib_ReadProcFile(szFilename);
+    if(szContent != NULL)
+    {
+      g_hash_table_insert(procFileCache, g_strdup(szFilename), szContent);
+    }
+  }
+  G_UNLOCK(procFileCache);
+
+  return szContent;
+}
+
+int ctlib_GetKernelParameter(char const * szCmdlineFile,
+                             char const * szName,
+                             char       * szValue,
+                             size_t       valueSize)
+{
+  char const * szCmdline = ctlib_ReadProcFileCached(szCmdlineFile);
+  size_t nameLength = strlen(szName);
+  char const * pParam;
+
+  if(szCmdline == NULL)
+  {
+    return FILE_READ_ERROR;
+  }
+  *szValue = '\0';
+
+  pParam = szCmdline;
+  while(*pParam != '\0')
+  {
+    size_t paramLength;
+
+    pParam += strspn(pParam, " \t\n");
+    paramLength = strcspn(pParam, " \t\n");
+
+    if(   (paramLength > nameLength)
+       && (strncmp(pParam, szName, nameLength) == 0)
+       && (pParam[nameLength] == '='))
+    {
+      size_t length = paramLength - nameLength - 1;
+      if(length >= valueSize)
+      {
+        length = valueSize - 1;
+      }
+      memcpy(szValue, pParam + nameLength + 1, length);
+      szValue[length] = '\0';
+      return SUCCESS;
+    }
+    pParam += paramLength;
+  }
+
+  return NOT_FOUND;
+}
+
+int ctlib_GetHostname(char   * szHostname,
+                      size_t   hostnameSize)
+{
+  char acHostname[HOST_NAME_MAX + 1];
+
+  // not cached, the host name may be changed while ctd is running
+  if(gethostname(acHostname, sizeof(acHostname)) != 0)
+  {
+    return SYSTEM_CALL_ERROR;
+  }
+  acHostname[HOST_NAME_MAX] = '\0';
+  safe_strncpy(szHostname, acHostname, hostnameSize);
+
+  return SUCCESS;
+}
+
+int ctlib_GetDnsDomainName(char   * szDomainName,
+                           size_t   domainNameSize)
+{
+  char acHostname[HOST_NAME_MAX + 1];
+  struct addrinfo hints;
+  struct addrinfo * pInfo = NULL;
+
+  *szDomainName = '\0';
+  if(gethostname(acHostname, sizeof(acHostname)) != 0)
+  {
+    return SYSTEM_CALL_ERROR;
+  }
+  acHostname[HOST_NAME_MAX] = '\0';
+
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_flags = AI_CANONNAME;
+  if(getaddrinfo(acHostname, NULL, &hints, &pInfo) == 0)
+  {
+    if((pInfo != NULL) && (pInfo->ai_canonname != NULL))
+    {
+      char const * pDot = strchr(pInfo->ai_canonname, '.');
+      if(pDot != NULL)
+      {
+        safe_strncpy(szDomainName, pDot + 1, domainNameSize);
+      }
+    }
+    freeaddrinfo(pInfo);
+  }
+
+  return SUCCESS;
+}
+
+// true if szPath is szMountDir or located below it
+static bool IsBelowMountDir(char const * szPath,
+                            char const * szMountDir)
+{
+  size_t length = strlen(szMountDir);
+
+  if(strncmp(szPath, szMountDir, length) != 0)
+  {
+    return false;
+  }
+  return    (szPath[length] == '\0')
+         || (szPath[length] == '/')
+         || ((length > 0) && (szMountDir[length - 1] == '/'));
+}
+
+int ctlib_GetMountDevice(char const * szPath,
+                         char       * szDevice,
+                         size_t       deviceSize)
+{
+  char acPath[PATH_MAX];
+  struct mntent * pEntry;
+  size_t bestLength = 0;
+  FILE * fMounts;
+  int status = NOT_FOUND;
+
+  *szDevice = '\0';
+  if(realpath(szPath, acPath) == NULL)
+  {
+    return INVALID_PARAMETER;
+  }
+  fMounts = setmntent("/proc/self/mounts", "r");
+  if(fMounts == NULL)
+  {
+    return FILE_READ_ERROR;
+  }
+  // like df: the longest mount point containing the path, later mounts
+  // hide earlier ones on the same mount point
+  while(NULL != (pEntry = getmntent(fMounts)))
+  {
+    size_t length = strlen(pEntry->mnt_dir);
+    if(IsBelowMountDir(acPath, pEntry->mnt_dir) && (length >= bestLength))
+    {
+      bestLength = length;
+      safe_strncpy(szDevice, pEntry->mnt_fsname, deviceSize);
+      status = SUCCESS;
+    }
+  }
+  endmntent(fMounts);
+
+  return status;
+}
+
+// Resolve the link szDir/szName to a device node
+static int ResolveDeviceLink(char const * szDir,
+                             char const * szName,
+                             char       * szDevice,
+                             size_t       deviceSize)
+{
+  char acLink[PATH_MAX];
+  char acTarget[PATH_MAX];
+
+  snprintf(acLink, sizeof(acLink), "%s/%s", szDir, szName);
+  if(realpath(acLink, acTarget) == NULL)
+  {
+    return NOT_FOUND;
+  }
+  safe_strncpy(szDevice, acTarget, deviceSize);
+  return SUCCESS;
+}
+
+// The link names in /dev/disk/by-label are encoded like "my\x20label"
+static void DecodeUdevString(char const * szEncoded,
+                             char       * szDecoded,
+                             size_t       decodedSize)
+{
+  size_t length = 0;
+
+  while((*szEncoded != '\0') && (length + 1 < decodedSize))
+  {
+    if(   (szEncoded[0] == '\\') && (szEncoded[1] == 'x')
+       && isxdigit((unsigned char)szEncoded[2]) && isxdigit((unsigned char)szEncoded[3]))
+    {
+      szDecoded[length++] = (char)((g_ascii_xdigit_value(szEncoded[2]) << 4) | g_ascii_xdigit_value(szEncoded[3]));
+      szEncoded += 4;
+    }
+    else
+    {
+      szDecoded[length++] = *szEncoded++;
+    }
+  }
+  szDecoded[length] = '\0';
+}
+
+int ctlib_GetDeviceByLabel(char const * szLabel,
+                           char       * szDevice,
+                           size_t       deviceSize)
+{
+  DIR * pDir;
+  struct dirent * pEntry;
+  int status = NOT_FOUND;
+
+  *szDevice = '\0';
+  if(   (strchr(szLabel, '/') == NULL)
+     && (   (SUCCESS == ResolveDeviceLink("/dev/disk/by-label", szLabel, szDevice, deviceSize))
+         || (SUCCESS == ResolveDeviceLink("/dev/disk/by-partlabel", szLabel, szDevice, deviceSize))))
+  {
+    return SUCCESS;
+  }
+
+  // ubi volumes have names instead of labels
+  pDir = opendir("/sys/class/ubi");
+  if(pDir != NULL)
+  {
+    while((status != SUCCESS) && (NULL != (pEntry = readdir(pDir))))
+    {
+      char acNameFile[PATH_MAX];
+      char * szName;
+
+      if(pEntry->d_name[0] == '.')
+      {
+        continue;
+      }
+      snprintf(acNameFile, sizeof(acNameFile), "/sys/class/ubi/%s/name", pEntry->d_name);
+      if(NULL != (szName = ctlib_ReadProcFile(acNameFile)))
+      {
+        g_strchomp(szName);
+        if(strcmp(szName, szLabel) == 0)
+        {
+          snprintf(szDevice, deviceSize, "/dev/%s", pEntry->d_name);
+          status = SUCCESS;
+        }
+        FileContent_Destruct(&szName);
+      }
+    }
+    closedir(pDir);
+  }
+
+  return status;
+}
+
+int ctlib_GetLabelByDevice(char const * szDevice,
+                           char       * szLabel,
+                           size_t       labelSize)
+{
+  char acPureDevice[MAX_LENGTH_OUTPUT_STRING];
+  char acPartition[PATH_MAX];
+  DIR * pDir;
+  struct dirent * pEntry;
+  int status;
+
+  *szLabel = '\0';
+  if(SUCCESS != (status = ctlib_GetPureDeviceName(szDevice, acPureDevice, sizeof(acPureDevice))))
+  {
+    return status;
+  }
+  snprintf(acPartition, sizeof(acPartition), "/sys/class/block/%s", acPureDevice);
+  if(access(acPartition, F_OK) != 0)
+  {
+    return INVALID_PARAMETER;
+  }
+
+  pDir = opendir("/dev/disk/by-label");
+  if(pDir == NULL)
+  {
+    // no labeled file system at all, or no udev rules creating the links
+    return (errno == ENOENT) ? FILE_READ_ERROR : SYSTEM_CALL_ERROR;
+  }
+
+  // the label is taken from the first partition
+  snprintf(acPartition, sizeof(acPartition), "/dev/%s%s1", acPureDevice,
+           (strncmp(acPureDevice, "mmcblk", strlen("mmcblk")) == 0) ? "p" : "");
+  while(NULL != (pEntry = readdir(pDir)))
+  {
+    char acTarget[PATH_MAX];
+
+    if(   (pEntry->d_name[0] != '.')
+       && (SUCCESS == ResolveDeviceLink("/dev/disk/by-label", pEntry->d_name, acTarget, sizeof(acTarget)))
+       && (strcmp(acTarget, acPartition) == 0))
+    {
+      DecodeUdevString(pEntry->d_name, szLabel, labelSize);
+      break;
+    }
+  }
+  closedir(pDir);
+
+  return SUCCESS;
+}
+
+int ctlib_GetPureDeviceName(char const * szDevice,
+                            char       * szPureDevice,
+                            size_t       pureDeviceSize)
+{
+  char acSysPath[PATH_MAX];
+  char acRealPath[PATH_MAX];
+  char const * szName = szDevice;
+
+  *szPureDevice = '\0';
+  if(strncmp(szName, "/dev/", strlen("/dev/")) == 0)
+  {
+    szName += strlen("/dev/");
+  }
+  if((*szName == '\0') || (strchr(szName, '/') != NULL))
+  {
+    return INVALID_PARAMETER;
+  }
+
+  // block devices: disks are returned as they are, partitions as their disk
+  snprintf(acSysPath, sizeof(acSysPath), "/sys/class/block/%s", szName);
+  if(realpath(acSysPath, acRealPath) != NULL)
+  {
+    snprintf(acSysPath, sizeof(acSysPath), "%s/partition", acRealPath);
+    if(access(acSysPath, F_OK) == 0)
+    {
+      *strrchr(acRealPath, '/') = '\0';
+    }
+    safe_strncpy(szPureDevice, strrchr(acRealPath, '/') + 1, pureDeviceSize);
+    return SUCCESS;
+  }
+
+  // ubi volumes: the mtd device the ubi device is attached to
+  snprintf(acSysPath, sizeof(acSysPath), "/sys/class/ubi/%s/name", szName);
+  if(   (access(acSysPath, F_OK) == 0)
+     && (realpath(acSysPath, acRealPath) != NULL))
+  {
+    char * szMtdNum;
+
+    // .../ubi0/ubi0_1/name -> .../ubi0/mtd_num
+    *strrchr(acRealPath, '/') = '\0';
+    *strrchr(acRealPath, '/') = '\0';
+    strncat(acRealPath, "/mtd_num", sizeof(acRealPath) - strlen(acRealPath) - 1);
+    if(NULL != (szMtdNum = ctlib_ReadProcFile(acRealPath)))
+    {
+      g_strchomp(szMtdNum);
+      snprintf(szPureDevice, pureDeviceSize, "mtd%s", szMtdNum);
+      FileContent_Destruct(&szMtdNum);
+      return SUCCESS;
+    }
+    return FILE_READ_ERROR;
+  }
+
+  // mtd devices
+  snprintf(acSysPath, sizeof(acSysPath), "/sys/class/mtd/%s", szName);
+  if(access(acSysPath, F_OK) == 0)
+  {
+    safe_strncpy(szPureDevice, szName, pureDeviceSize);
+    return SUCCESS;
+  }
+
+  return INVALID_PARAMETER;
+}
+
+int ctlib_GetDeviceMedium(char const * szDevice,
+                          char       * szMedium,
+                          size_t       mediumSize)
+{
+  char acPureDevice[MAX_LENGTH_OUTPUT_LINE] = "";
+  char acMediaLine[MAX_LENGTH_OUTPUT_LINE]  = "";
+  int status;
+
+  *szMedium = '\0';
+  if(   (SUCCESS == (status = ctlib_GetPureDeviceName(szDevice, acPureDevice, sizeof(acPureDevice))))
+     && (SUCCESS == (status = SearchLineInDeviceMediumFile(acPureDevice, acMediaLine))))
+  {
+    char const * pMedium = strstr(acMediaLine, acPureDevice);
+
+    status = NOT_FOUND;
+    if(pMedium != NULL)
+    {
+      pMedium += strlen(acPureDevice);
+      if(strncmp(pMedium, SEPARATOR, strlen(SEPARATOR)) == 0)
+      {
+        pMedium += strlen(SEPARATOR);
+        pMedium += strspn(pMedium, " ");
+        safe_strncpy(szMedium, pMedium, mediumSize);
+        status = SUCCESS;
+      }
+    }
+  }
+
+  return status;
+}
+
 /////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////
@@ -220,6 +220,59 @@ int ctlib_IsValidDomainName(char const * szName);
 int  ctlib_IpaddrToInt(char const * szIpAddr,
                        uint32_t   * pResult);
 
+// Native access to system data: answers queries which used to be made by
+// shell commands (hostname, df, blkid, ...) with syscalls and procfs/sysfs
+// reads.
+
+// Read a procfs/sysfs file (st_size is 0 there); free with FileContent_Destruct.
+char *ctlib_ReadProcFile(char const * szFilename);
+
+// Same, but the content is read once per process and must not be freed.
+// Only for files which do not change until reboot (/proc/cpuinfo, /proc/cmdline).
+char const *ctlib_ReadProcFileCached(char const * szFilename);
+
+// Value of a kernel command line parameter ("root" -> "/dev/mmcblk0p2").
+int ctlib_GetKernelParameter(char const * szCmdlineFile,
+                             char const * szName,
+                             char       * szValue,
+                             size_t       valueSize);
+
+int ctlib_GetHostname(char   * szHostname,
+                      size_t   hostnameSize);
+
+// Same result as dnsdomainname: domain part of the canonical host name,
+// empty if the host name cannot be resolved.
+int ctlib_GetDnsDomainName(char   * szDomainName,
+                           size_t   domainNameSize);
+
+// Source of the mount a path is located on (first column of "df <path>").
+int ctlib_GetMountDevice(char const * szPath,
+                         char       * szDevice,
+                         size_t       deviceSize);
+
+// Device node carrying a file system or partition label (blkid), e.g.
+// "home1" -> "/dev/mmcblk0p9"; ubi volumes are matched by volume name.
+int ctlib_GetDeviceByLabel(char const * szLabel,
+                           char       * szDevice,
+                           size_t       deviceSize);
+
+// File system label of the first partition of a device (get_device_data label).
+// FILE_READ_ERROR if udev does not provide labels on this system.
+int ctlib_GetLabelByDevice(char const * szDevice,
+                           char       * szLabel,
+                           size_t       labelSize);
+
+// Device without "/dev/" and partition ("/dev/mmcblk0p2" -> "mmcblk0",
+// "ubi0_1" -> "mtd2"), taken from sysfs.
+int ctlib_GetPureDeviceName(char const * szDevice,
+                            char       * szPureDevice,
+                            size_t       pureDeviceSize);
+
+// Medium of a device according to DEVICE_MEDIA_FILENAME (get_device_data medium).
+int ctlib_GetDeviceMedium(char const * szDevice,
+                          char       * szMedium,
+                          size_t       mediumSize);
+
 // Typelabel field names
 #define TYPELABEL_ORDER_NR        "ORDER"
 #define TYPELABEL_PRODUCT_DESC    "SYSDESC"
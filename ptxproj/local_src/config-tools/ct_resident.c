@@ -0,0 +1,508 @@
+//------------------------------------------------------------------------------
+/// Copyright (c) 2000 - 2022 WAGO GmbH & Co. KG
+///
+/// PROPRIETARY RIGHTS of WAGO GmbH & Co. KG are involved in
+/// the subject matter of this material. All manufacturing, reproduction,
+/// use, and sales rights pertaining to this subject matter are governed
+/// by the license agreement. The recipient of this software implicitly
+/// accepts the terms of the license.
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+///  \file     ct_resident.c
+///
+///  \brief    Client side and protocol of the resident config-tool service
+///            (see ct_resident.h).
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Include files
+//------------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <glib.h>
+
+#include "ct_resident.h"
+
+//------------------------------------------------------------------------------
+// Local typedefs
+//------------------------------------------------------------------------------
+
+// called for every member of a JSON object, has to consume the value
+typedef int (*tFktJsonMember)(char const *  szKey,
+                              char const ** ppCursor,
+                              void        * pContext);
+
+typedef struct
+{
+  char      * szTool;
+  GPtrArray * pArgs;
+} tRequest;
+
+typedef struct
+{
+  int     status;
+  char  * szOutput;
+} tResponse;
+
+//------------------------------------------------------------------------------
+// JSON
+//------------------------------------------------------------------------------
+
+void ctlib_JsonAppendString(GString    * pJson,
+                            char const * szValue)
+{
+  unsigned char const * p = (unsigned char const *)szValue;
+
+  g_string_append_c(pJson, '"');
+  for(; *p != '\0'; ++p)
+  {
+    switch(*p)
+    {
+      case '"':  g_string_append(pJson, "\\\""); break;
+      case '\\': g_string_append(pJson, "\\\\"); break;
+      case '\n': g_string_append(pJson, "\\n");  break;
+      case '\r': g_string_append(pJson, "\\r");  break;
+      case '\t': g_string_append(pJson, "\\t");  break;
+      default:
+        if(*p < 0x20)
+        {
+          g_string_append_printf(pJson, "\\u%04x", *p);
+        }
+        else
+        {
+          // UTF-8 sequences are copied as they are
+          g_string_append_c(pJson, (gchar)*p);
+        }
+        break;
+    }
+  }
+  g_string_append_c(pJson, '"');
+}
+
+static void JsonSkipSpace(char const ** ppCursor)
+{
+  while(g_ascii_isspace(**ppCursor))
+  {
+    ++(*ppCursor);
+  }
+}
+
+static int JsonParseHex4(char const * p,
+                         gunichar   * pValue)
+{
+  int i;
+
+  *pValue = 0;
+  for(i = 0; i < 4; ++i)
+  {
+    int digit = g_ascii_xdigit_value(p[i]);
+    if(digit < 0)
+    {
+      return -1;
+    }
+    *pValue = (*pValue << 4) | (gunichar)digit;
+  }
+  return 0;
+}
+
+static int JsonParseString(char const ** ppCursor,
+                           GString     * pValue)
+{
+  char const * p = *ppCursor;
+
+  if(*p != '"')
+  {
+    return -1;
+  }
+  for(++p; *p != '"'; ++p)
+  {
+    if(*p == '\0')
+    {
+      return -1;
+    }
+    if(*p != '\\')
+    {
+      g_string_append_c(pValue, *p);
+      continue;
+    }
+    ++p;
+    switch(*p)
+    {
+      case '"':  g_string_append_c(pValue, '"');  break;
+      case '\\': g_string_append_c(pValue, '\\'); break;
+      case '/':  g_string_append_c(pValue, '/');  break;
+      case 'b':  g_string_append_c(pValue, '\b'); break;
+      case 'f':  g_string_append_c(pValue, '\f'); break;
+      case 'n':  g_string_append_c(pValue, '\n'); break;
+      case 'r':  g_string_append_c(pValue, '\r'); break;
+      case 't':  g_string_append_c(pValue, '\t'); break;
+      case 'u':
+      {
+        gunichar c;
+        if(JsonParseHex4(p + 1, &c))
+        {
+          return -1;
+        }
+        p += 4;
+        // surrogate pair
+        if((c >= 0xD800) && (c < 0xDC00) && (p[1] == '\\') && (p[2] == 'u'))
+        {
+          gunichar low;
+          if(JsonParseHex4(p + 3, &low) || (low < 0xDC00) || (low > 0xDFFF))
+          {
+            return -1;
+          }
+          c = 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+          p += 6;
+        }
+        g_string_append_unichar(pValue, c);
+        break;
+      }
+      default:
+        return -1;
+    }
+  }
+  *ppCursor = p + 1;
+  return 0;
+}
+
+static int JsonParseInt(char const ** ppCursor,
+                        int         * pValue)
+{
+  char * end;
+  long   value;
+
+  errno = 0;
+  value = strtol(*ppCursor, &end, 10);
+  if((end == *ppCursor) || (errno != 0) || (value < G_MININT) || (value > G_MAXINT))
+  {
+    return -1;
+  }
+  *pValue = (int)value;
+  *ppCursor = end;
+  return 0;
+}
+
+static int JsonParseObject(char const *   szJson,
+                           tFktJsonMember pFktMember,
+                           void         * pContext)
+{
+  char const * p = szJson;
+  GString * pKey = g_string_new(NULL);
+  int status = -1;
+
+  JsonSkipSpace(&p);
+  if(*p++ != '{')
+  {
+    goto out;
+  }
+  JsonSkipSpace(&p);
+  if(*p == '}')
+  {
+    ++p;
+    status = 0;
+    goto out;
+  }
+  for(;;)
+  {
+    g_string_truncate(pKey, 0);
+    JsonSkipSpace(&p);
+    if(JsonParseString(&p, pKey))
+    {
+      goto out;
+    }
+    JsonSkipSpace(&p);
+    if(*p++ != ':')
+    {
+      goto out;
+    }
+    JsonSkipSpace(&p);
+    if(pFktMember(pKey->str, &p, pContext))
+    {
+      goto out;
+    }
+    JsonSkipSpace(&p);
+    if(*p == ',')
+    {
+      ++p;
+      continue;
+    }
+    if(*p == '}')
+    {
+      status = 0;
+    }
+    break;
+  }
+
+out:
+  g_string_free(pKey, TRUE);
+  return status;
+}
+
+static int RequestMember(char const *  szKey,
+                         char const ** ppCursor,
+                         void        * pContext)
+{
+  tRequest * pRequest = pContext;
+  GString  * pValue;
+
+  if(strcmp(szKey, "tool") == 0)
+  {
+    pValue = g_string_new(NULL);
+    if(JsonParseString(ppCursor, pValue))
+    {
+      g_string_free(pValue, TRUE);
+      return -1;
+    }
+    g_free(pRequest->szTool);
+    pRequest->szTool = g_string_free(pValue, FALSE);
+    return 0;
+  }
+  if(strcmp(szKey, "args") == 0)
+  {
+    if(*(*ppCursor)++ != '[')
+    {
+      return -1;
+    }
+    JsonSkipSpace(ppCursor);
+    if(**ppCursor == ']')
+    {
+      ++(*ppCursor);
+      return 0;
+    }
+    for(;;)
+    {
+      JsonSkipSpace(ppCursor);
+      pValue = g_string_new(NULL);
+      if(JsonParseString(ppCursor, pValue))
+      {
+        g_string_free(pValue, TRUE);
+        return -1;
+      }
+      g_ptr_array_add(pRequest->pArgs, g_string_free(pValue, FALSE));
+      JsonSkipSpace(ppCursor);
+      if(**ppCursor == ',')
+      {
+        ++(*ppCursor);
+        continue;
+      }
+      return (*(*ppCursor)++ == ']') ? 0 : -1;
+    }
+  }
+  return -1;
+}
+
+static int ResponseMember(char const *  szKey,
+                          char const ** ppCursor,
+                          void        * pContext)
+{
+  tResponse * pResponse = pContext;
+
+  if(strcmp(szKey, "status") == 0)
+  {
+    return JsonParseInt(ppCursor, &pResponse->status);
+  }
+  if(strcmp(szKey, "output") == 0)
+  {
+    GString * pValue = g_string_new(NULL);
+    if(JsonParseString(ppCursor, pValue))
+    {
+      g_string_free(pValue, TRUE);
+      return -1;
+    }
+    g_free(pResponse->szOutput);
+    pResponse->szOutput = g_string_free(pValue, FALSE);
+    return 0;
+  }
+  return -1;
+}
+
+int ctlib_ResidentParseRequest(char const *  szJson,
+                               char      * * pszTool,
+                               char    * * * pArgv)
+{
+  tRequest request = { NULL, g_ptr_array_new_with_free_func(g_free) };
+
+  if(   JsonParseObject(szJson, RequestMember, &request)
+     || (request.szTool == NULL))
+  {
+    g_free(request.szTool);
+    g_ptr_array_free(request.pArgs, TRUE);
+    return -1;
+  }
+  g_ptr_array_add(request.pArgs, NULL);
+  *pszTool = request.szTool;
+  g_ptr_array_set_free_func(request.pArgs, NULL);
+  *pArgv = (char **)g_ptr_array_free(request.pArgs, FALSE);
+  return 0;
+}
+
+int ctlib_ResidentParseResponse(char const *  szJson,
+                                int         * pStatus,
+                                char      * * pszOutput)
+{
+  tResponse response = { -1, NULL };
+
+  if(JsonParseObject(szJson, ResponseMember, &response))
+  {
+    g_free(response.szOutput);
+    return -1;
+  }
+  *pStatus = response.status;
+  *pszOutput = (response.szOutput != NULL) ? response.szOutput : g_strdup("");
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+// Client
+//------------------------------------------------------------------------------
+
+static int ResidentConnect(void)
+{
+  struct sockaddr_un addr;
+  struct timeval timeout = { CT_RESIDENT_TIMEOUT, 0 };
+  char const * szDisable = getenv(CT_RESIDENT_DISABLE_ENV);
+  int fd;
+
+  if((szDisable != NULL) && (strcmp(szDisable, "1") == 0))
+  {
+    return -1;
+  }
+  fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if(fd < 0)
+  {
+    return -1;
+  }
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, CT_RESIDENT_SOCKET, sizeof(addr.sun_path) - 1);
+  if(   connect(fd, (struct sockaddr *)&addr, sizeof(addr))
+     || setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout))
+     || setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)))
+  {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+static int WriteAll(int          fd,
+                    char const * pData,
+                    size_t       size)
+{
+  while(size > 0)
+  {
+    ssize_t written = send(fd, pData, size, MSG_NOSIGNAL);
+    if(written < 0)
+    {
+      if(errno == EINTR)
+      {
+        continue;
+      }
+      return -1;
+    }
+    pData += written;
+    size -= (size_t)written;
+  }
+  return 0;
+}
+
+static char *ReadAll(int fd)
+{
+  GString * pData = g_string_sized_new(512);
+  char buf[4096];
+
+  for(;;)
+  {
+    ssize_t got = recv(fd, buf, sizeof(buf), 0);
+    if(got < 0)
+    {
+      if(errno == EINTR)
+      {
+        continue;
+      }
+      break;
+    }
+    if(got == 0)
+    {
+      return g_string_free(pData, FALSE);
+    }
+    if(pData->len + (size_t)got > CT_RESIDENT_MAX_MESSAGE)
+    {
+      break;
+    }
+    g_string_append_len(pData, buf, got);
+  }
+  g_string_free(pData, TRUE);
+  return NULL;
+}
+
+int ctlib_ResidentCallGetOutput(char const *  szTool,
+                                int           argc,
+                                char        * argv[],
+                                int         * pStatus,
+                                char      * * pszOutput)
+{
+  GString * pRequest;
+  char * szResponse = NULL;
+  int status = -1;
+  int fd;
+  int i;
+
+  fd = ResidentConnect();
+  if(fd < 0)
+  {
+    return -1;
+  }
+
+  pRequest = g_string_new("{\"tool\":");
+  ctlib_JsonAppendString(pRequest, szTool);
+  g_string_append(pRequest, ",\"args\":[");
+  for(i = 1; i < argc; ++i)
+  {
+    if(i > 1)
+    {
+      g_string_append_c(pRequest, ',');
+    }
+    ctlib_JsonAppendString(pRequest, argv[i]);
+  }
+  g_string_append(pRequest, "]}\n");
+
+  if(   (WriteAll(fd, pRequest->str, pRequest->len) == 0)
+     && (shutdown(fd, SHUT_WR) == 0))
+  {
+    szResponse = ReadAll(fd);
+  }
+  if(szResponse != NULL)
+  {
+    status = ctlib_ResidentParseResponse(szResponse, pStatus, pszOutput);
+  }
+
+  g_free(szResponse);
+  g_string_free(pRequest, TRUE);
+  close(fd);
+  return status;
+}
+
+int ctlib_ResidentCall(char const * szTool,
+                       int          argc,
+                       char       * argv[],
+                       int        * pStatus)
+{
+  char * szOutput = NULL;
+
+  if(ctlib_ResidentCallGetOutput(szTool, argc, argv, pStatus, &szOutput))
+  {
+    return -1;
+  }
+  fputs(szOutput, stdout);
+  g_free(szOutput);
+  return 0;
+}
@@ -0,0 +1,82 @@
+//------------------------------------------------------------------------------
+/// Copyright (c) 2000 - 2022 WAGO GmbH & Co. KG
+///
+/// PROPRIETARY RIGHTS of WAGO GmbH & Co. KG are involved in
+/// the subject matter of this material. All manufacturing, reproduction,
+/// use, and sales rights pertaining to this subject matter are governed
+/// by the license agreement. The recipient of this software implicitly
+/// accepts the terms of the license.
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+///  \file     ct_resident.h
+///
+///  \brief    Client side and protocol of the resident config-tool service
+///            (ctd).
+///
+///            ctd runs the implementations of often used read-only config
+///            tools in one resident process. A tool binary first hands its
+///            command line to ctd and only runs its own implementation if ctd
+///            is not available, so the WBM saves one fork/exec per value.
+///
+///            Protocol: one JSON object per connection and direction.
+///              request:  {"tool":"<name>","args":["<arg1>",...]}
+///              response: {"status":<exit status>,"output":"<stdout>"}
+///            The built-in tool "ctd" with argument "stats" returns the
+///            latency metrics of all tools as JSON in "output".
+//------------------------------------------------------------------------------
+
+#ifndef _ct_resident_h_
+#define _ct_resident_h_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <glib.h>
+
+#define CT_RESIDENT_SOCKET           "/var/run/ctd.sock"
+
+// set to "1" to make the tools skip ctd (benchmarks, debugging)
+#define CT_RESIDENT_DISABLE_ENV      "CT_NO_RESIDENT"
+
+// seconds a client waits for the result of a tool
+#define CT_RESIDENT_TIMEOUT          30
+
+// maximum size of a request or response
+#define CT_RESIDENT_MAX_MESSAGE      (256 * 1024)
+
+// Let ctd execute a tool and print its output to stdout.
+// Returns 0 if ctd executed the tool (*pStatus is its exit status), -1 if the
+// caller has to execute the tool itself.
+int ctlib_ResidentCall(char const * szTool,
+                       int          argc,
+                       char       * argv[],
+                       int        * pStatus);
+
+// Same, but the output is returned in *pszOutput (free with g_free) instead
+// of being printed.
+int ctlib_ResidentCallGetOutput(char const *  szTool,
+                                int           argc,
+                                char        * argv[],
+                                int         * pStatus,
+                                char      * * pszOutput);
+
+// JSON helpers shared by ctd and its clients
+void ctlib_JsonAppendString(GString    * pJson,
+                            char const * szValue);
+
+// Parse a request; *pArgv is a NULL terminated vector (free with g_strfreev).
+int ctlib_ResidentParseRequest(char const *  szJson,
+                               char      * * pszTool,
+                               char    * * * pArgv);
+
+// Parse a response; *pszOutput must be freed with g_free.
+int ctlib_ResidentParseResponse(char const *  szJson,
+                                int         * pStatus,
+                                char      * * pszOutput);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,434 @@
+//------------------------------------------------------------------------------
+/// Copyright (c) 2000 - 2022 WAGO GmbH & Co. KG
+///
+/// PROPRIETARY RIGHTS of WAGO GmbH & Co. KG are involved in
+/// the subject matter of this material. All manufacturing, reproduction,
+/// use, and sales rights pertaining to this subject matter are governed
+/// by the license agreement. The recipient of this software implicitly
+/// accepts the terms of the license.
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+///
+///  \file     ctd.c
+///
+///  \brief    Resident config-tool service.
+///
+///            Executes the implementations of the config tools listed in
+///            astResidentTools in this process. Their sources are compiled a
+///            second time with main renamed to ctd_<tool>_main (see Makefile).
+///            Requests are handled one after another, the output of a tool is
+///            captured by pointing stdout to a memory stream.
+///
+///            Only tools that read state and neither exit() nor keep state
+///            between calls may be added to the list.
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Include files
+//------------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <glib.h>
+
+#include "config_tool_lib.h"
+#include "ct_resident.h"
+
+//------------------------------------------------------------------------------
+// Local macros
+//------------------------------------------------------------------------------
+
+#ifdef  __CPPUTEST__
+#define main ctd_main
+#endif
+
+// seconds a client may take to send its request
+#define CTD_REQUEST_TIMEOUT          5
+
+#define CTD_BACKLOG                  16
+
+//------------------------------------------------------------------------------
+// Local typedefs
+//------------------------------------------------------------------------------
+
+typedef int (*tFktToolMain)(int    argc,
+                            char** argv);
+
+typedef struct
+{
+  char const   * szName;
+  tFktToolMain   pFktMain;
+
+  // latency metrics
+  unsigned long  calls;
+  unsigned long  errors;
+  guint64        totalUs;
+  guint64        maxUs;
+} tResidentTool;
+
+//------------------------------------------------------------------------------
+// External variables
+//------------------------------------------------------------------------------
+
+int ctd_get_coupler_details_main(int argc, char** argv);
+int ctd_get_filesystem_data_main(int argc, char** argv);
+
+//------------------------------------------------------------------------------
+// Local variables
+//------------------------------------------------------------------------------
+
+static tResidentTool astResidentTools[] =
+{
+  { "get_coupler_details",  ctd_get_coupler_details_main, 0, 0, 0, 0 },
+  { "get_filesystem_data",  ctd_get_filesystem_data_main, 0, 0, 0, 0 },
+
+  // end marker
+  { NULL,                   NULL,                         0, 0, 0, 0 },
+};
+
+static volatile sig_atomic_t stop = 0;
+
+static struct timespec startTime;
+
+//------------------------------------------------------------------------------
+// Local functions
+//------------------------------------------------------------------------------
+
+static void OnStop(int sig)
+{
+  (void)sig;
+  stop = 1;
+}
+
+static guint64 ElapsedUs(struct timespec const * pStart)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (guint64)(now.tv_sec - pStart->tv_sec) * 1000000
+         + (now.tv_nsec - pStart->tv_nsec) / 1000;
+}
+
+static tResidentTool *FindTool(char const * szName)
+{
+  tResidentTool * pTool;
+
+  for(pTool = astResidentTools; pTool->szName != NULL; ++pTool)
+  {
+    if(strcmp(pTool->szName, szName) == 0)
+    {
+      return pTool;
+    }
+  }
+  return NULL;
+}
+
+static char *GetStats(void)
+{
+  GString * pJson = g_string_new(NULL);
+  tResidentTool * pTool;
+
+  g_string_append_printf(pJson, "{\"uptime\":%" G_GUINT64_FORMAT ",\"tools\":[",
+                         ElapsedUs(&startTime) / 1000000);
+  for(pTool = astResidentTools; pTool->szName != NULL; ++pTool)
+  {
+    if(pTool != astResidentTools)
+    {
+      g_string_append_c(pJson, ',');
+    }
+    g_string_append(pJson, "{\"name\":");
+    ctlib_JsonAppendString(pJson, pTool->szName);
+    g_string_append_printf(pJson,
+                           ",\"calls\":%lu,\"errors\":%lu,\"avg_us\":%" G_GUINT64_FORMAT
+                           ",\"max_us\":%" G_GUINT64_FORMAT "}",
+                           pTool->calls, pTool->errors,
+                           (pTool->calls > 0) ? pTool->totalUs / pTool->calls : 0,
+                           pTool->maxUs);
+  }
+  g_string_append(pJson, "]}");
+  return g_string_free(pJson, FALSE);
+}
+
+//-- Function: RunTool ---------------------------------------------------------
+///
+///  Execute a tool in this process and capture what it prints to stdout.
+///
+///  \param pTool      the tool
+///  \param argv       arguments without the program name
+///  \param pszOutput  the output of the tool (free with free())
+///
+///  \return the exit status of the tool
+//------------------------------------------------------------------------------
+static int RunTool(tResidentTool  * pTool,
+                   char         * * argv,
+                   char         * * pszOutput)
+{
+  guint argc = g_strv_length(argv) + 1;
+  char ** toolArgv = g_new0(char *, argc + 1);
+  char * pBuffer = NULL;
+  size_t size = 0;
+  FILE * pCapture;
+  FILE * pStdout = stdout;
+  struct timespec start;
+  guint64 elapsed;
+  int status;
+  guint i;
+
+  // the tools may modify their arguments
+  toolArgv[0] = g_strdup(pTool->szName);
+  for(i = 1; i < argc; ++i)
+  {
+    toolArgv[i] = g_strdup(argv[i - 1]);
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  pCapture = open_memstream(&pBuffer, &size);
+  if(pCapture == NULL)
+  {
+    g_strfreev(toolArgv);
+    *pszOutput = NULL;
+    return SYSTEM_CALL_ERROR;
+  }
+  fflush(stdout);
+  stdout = pCapture;
+  optind = 0;  // full getopt reinitialization
+  status = pTool->pFktMain((int)argc, toolArgv);
+  fflush(stdout);
+  stdout = pStdout;
+  fclose(pCapture);
+  elapsed = ElapsedUs(&start);
+
+  pTool->calls++;
+  if(status != SUCCESS)
+  {
+    pTool->errors++;
+  }
+  pTool->totalUs += elapsed;
+  if(elapsed > pTool->maxUs)
+  {
+    pTool->maxUs = elapsed;
+  }
+
+  g_strfreev(toolArgv);
+  *pszOutput = pBuffer;
+  return status;
+}
+
+static char *ReadRequest(int fd)
+{
+  GString * pRequest = g_string_sized_new(256);
+  char buf[1024];
+
+  for(;;)
+  {
+    ssize_t got = recv(fd, buf, sizeof(buf), 0);
+    if(got < 0)
+    {
+      if(errno == EINTR)
+      {
+        continue;
+      }
+      break;
+    }
+    if(got == 0)
+    {
+      return g_string_free(pRequest, FALSE);
+    }
+    g_string_append_len(pRequest, buf, got);
+    if(memchr(buf, '\n', (size_t)got) != NULL)
+    {
+      return g_string_free(pRequest, FALSE);
+    }
+    if(pRequest->len > CT_RESIDENT_MAX_MESSAGE)
+    {
+      break;
+    }
+  }
+  g_string_free(pRequest, TRUE);
+  return NULL;
+}
+
+static void SendResponse(int          fd,
+                         int          status,
+                         char const * szOutput)
+{
+  GString * pResponse = g_string_new(NULL);
+  char const * p;
+  size_t left;
+
+  g_string_append_printf(pResponse, "{\"status\":%d,\"output\":", status);
+  ctlib_JsonAppendString(pResponse, (szOutput != NULL) ? szOutput : "");
+  g_string_append(pResponse, "}\n");
+
+  p = pResponse->str;
+  left = pResponse->len;
+  while(left > 0)
+  {
+    ssize_t written = send(fd, p, left, MSG_NOSIGNAL);
+    if(written < 0)
+    {
+      if(errno == EINTR)
+      {
+        continue;
+      }
+      break;
+    }
+    p += written;
+    left -= (size_t)written;
+  }
+  g_string_free(pResponse, TRUE);
+}
+
+static void HandleConnection(int fd)
+{
+  struct ucred cred;
+  socklen_t credLen = sizeof(cred);
+  struct timeval timeout = { CTD_REQUEST_TIMEOUT, 0 };
+  char * szRequest;
+  char * szTool = NULL;
+  char ** argv = NULL;
+
+  // the tools run with the rights of ctd
+  if(   getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &credLen)
+     || ((cred.uid != 0) && (cred.uid != geteuid())))
+  {
+    return;
+  }
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+  szRequest = ReadRequest(fd);
+  if(   (szRequest != NULL)
+     && (ctlib_ResidentParseRequest(szRequest, &szTool, &argv) == 0))
+  {
+    if(   (strcmp(szTool, "ctd") == 0)
+       && (argv[0] != NULL) && (strcmp(argv[0], "stats") == 0))
+    {
+      char * szStats = GetStats();
+      SendResponse(fd, SUCCESS, szStats);
+      g_free(szStats);
+    }
+    else
+    {
+      tResidentTool * pTool = FindTool(szTool);
+      // unknown tools get no response, the client runs them itself
+      if(pTool != NULL)
+      {
+        char * szOutput = NULL;
+        int status = RunTool(pTool, argv, &szOutput);
+        SendResponse(fd, status, szOutput);
+        free(szOutput);
+      }
+    }
+  }
+
+  g_free(szTool);
+  g_strfreev(argv);
+  g_free(szRequest);
+}
+
+static int CreateSocket(char const * szPath)
+{
+  struct sockaddr_un addr;
+  int fd;
+
+  fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if(fd < 0)
+  {
+    return -1;
+  }
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, szPath, sizeof(addr.sun_path) - 1);
+  unlink(szPath);
+  if(   bind(fd, (struct sockaddr *)&addr, sizeof(addr))
+     || chmod(szPath, 0600)
+     || listen(fd, CTD_BACKLOG))
+  {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+static void ShowHelpText(void)
+{
+  printf("\n* Resident config-tool service *\n\n");
+  printf("Usage: ctd [-s <socket>]\n\n");
+  printf("Executes the following config tools for their binaries:\n");
+  for(tResidentTool * pTool = astResidentTools; pTool->szName != NULL; ++pTool)
+  {
+    printf("  %s\n", pTool->szName);
+  }
+  printf("\nLatency metrics: request tool \"ctd\" with argument \"stats\".\n\n");
+}
+
+int main(int    argc,
+         char** argv)
+{
+  char const * szSocket = CT_RESIDENT_SOCKET;
+  struct sigaction sa;
+  int listenFd;
+  int opt;
+
+  while((opt = getopt(argc, argv, "hs:")) != -1)
+  {
+    switch(opt)
+    {
+      case 's':
+        szSocket = optarg;
+        break;
+      case 'h':
+      default:
+        ShowHelpText();
+        return (opt == 'h') ? SUCCESS : INVALID_PARAMETER;
+    }
+  }
+
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_handler = OnStop;
+  sigaction(SIGTERM, &sa, NULL);
+  sigaction(SIGINT, &sa, NULL);
+  signal(SIGPIPE, SIG_IGN);
+
+  // ctd itself must never hand a request to ctd
+  setenv(CT_RESIDENT_DISABLE_ENV, "1", 1);
+
+  listenFd = CreateSocket(szSocket);
+  if(listenFd < 0)
+  {
+    fprintf(stderr, "ctd: cannot listen on %s: %s\n", szSocket, strerror(errno));
+    return SYSTEM_CALL_ERROR;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &startTime);
+
+  while(!stop)
+  {
+    int fd = accept4(listenFd, NULL, NULL, SOCK_CLOEXEC);
+    if(fd < 0)
+    {
+      if((errno == EINTR) || (errno == ECONNABORTED))
+      {
+        continue;
+      }
+      fprintf(stderr, "ctd: accept: %s\n", strerror(errno));
+      break;
+    }
+    HandleConnection(fd);
+    close(fd);
+  }
+
+  close(listenFd);
+  unlink(szSocket);
+  return SUCCESS;
+}
@@ -0,0 +1,282 @@
+//------------------------------------------------------------------------------
+/// Copyright (c) 2000 - 2022 WAGO GmbH & Co. KG
+///
+/// PROPRIETARY RIGHTS of WAGO GmbH & Co. KG are involved in
+/// the subject matter of this material. All manufacturing, reproduction,
+/// use, and sales rights pertaining to this subject matter are governed
+/// by the license agreement. The recipient of this software implicitly
+/// accepts the terms of the license.
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+///
+///  \file     ctd_bench.c
+///
+///  \brief    Replays the config-tool calls of a WBM page load with and
+///            without the resident config-tool service (ctd).
+///
+///            usage: ctd_bench [-n <page loads>] [-f <file>]
+///
+///            The file holds one config-tool command line per line, e.g.
+///            "get_coupler_details order-number"; by default the calls of the
+///            WBM status page are replayed. Every page load is run
+///              exec:   each tool started with ctd disabled (as before ctd)
+///              client: each tool started, the binaries hand over to ctd
+///              direct: the requests sent to ctd without starting a tool
+///            Tools not handled by ctd are started in all modes.
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Include files
+//------------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <glib.h>
+
+#include "config_tool_lib.h"
+#include "ct_resident.h"
+
+//------------------------------------------------------------------------------
+// Local macros
+//------------------------------------------------------------------------------
+
+#ifdef  __CPPUTEST__
+#define main ctd_bench_main
+#endif
+
+#define CONFIG_TOOLS_DIR             "/etc/config-tools/"
+
+//------------------------------------------------------------------------------
+// Local typedefs
+//------------------------------------------------------------------------------
+
+typedef enum
+{
+  MODE_EXEC,
+  MODE_CLIENT,
+  MODE_DIRECT
+} tBenchMode;
+
+//------------------------------------------------------------------------------
+// Local variables
+//------------------------------------------------------------------------------
+
+// config-tool calls of the WBM status page
+static char const * const aszStatusPage[] =
+{
+  "get_coupler_details product-description",
+  "get_coupler_details order-number",
+  "get_coupler_details firmware-revision",
+  "get_coupler_details license-information",
+  "get_coupler_details html-pages-revision",
+  "get_coupler_details actual-hostname",
+  "get_coupler_details actual-domain-name",
+  "get_coupler_details serial-number",
+  "get_coupler_details bootloader-version",
+  "get_coupler_details codesys-webserver-version",
+  "get_coupler_details default-webserver",
+  "get_coupler_details webserver-port",
+  "get_filesystem_data active-partition-medium",
+  "get_filesystem_data active-partition-medium-text",
+  "get_filesystem_data medium-list-json",
+  "get_filesystem_data device-data-list-json",
+  "get_clock_data date-local",
+  "get_clock_data time-local",
+  "get_typelabel_value SYSDESC",
+  NULL
+};
+
+extern char **environ;
+
+//------------------------------------------------------------------------------
+// Local functions
+//------------------------------------------------------------------------------
+
+static int Spawn(char * * argv,
+                 int      disableResident)
+{
+  posix_spawn_file_actions_t actions;
+  GPtrArray * pEnv = g_ptr_array_new();
+  char * szPath = g_strconcat(CONFIG_TOOLS_DIR, argv[0], NULL);
+  pid_t pid;
+  int status = -1;
+  char ** env;
+
+  for(env = environ; *env != NULL; ++env)
+  {
+    if(!g_str_has_prefix(*env, CT_RESIDENT_DISABLE_ENV "="))
+    {
+      g_ptr_array_add(pEnv, *env);
+    }
+  }
+  if(disableResident)
+  {
+    g_ptr_array_add(pEnv, CT_RESIDENT_DISABLE_ENV "=1");
+  }
+  g_ptr_array_add(pEnv, NULL);
+
+  posix_spawn_file_actions_init(&actions);
+  posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+  if(posix_spawn(&pid, szPath, &actions, NULL, argv, (char **)pEnv->pdata) == 0)
+  {
+    waitpid(pid, &status, 0);
+  }
+  posix_spawn_file_actions_destroy(&actions);
+  g_ptr_array_free(pEnv, TRUE);
+  g_free(szPath);
+  return status;
+}
+
+static void RunCall(char * * argv,
+                    tBenchMode mode)
+{
+  if(mode == MODE_DIRECT)
+  {
+    char * szOutput = NULL;
+    int status;
+
+    if(ctlib_ResidentCallGetOutput(argv[0], (int)g_strv_length(argv), argv,
+                                   &status, &szOutput) == 0)
+    {
+      g_free(szOutput);
+      return;
+    }
+  }
+  (void)Spawn(argv, mode == MODE_EXEC);
+}
+
+static double RunPage(char * * * calls,
+                      tBenchMode mode)
+{
+  struct timespec start, end;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for(; *calls != NULL; ++calls)
+  {
+    RunCall(*calls, mode);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  return (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+static GPtrArray *LoadCalls(char const * szFile)
+{
+  GPtrArray * pCalls = g_ptr_array_new();
+
+  if(szFile == NULL)
+  {
+    char const * const * pLine;
+    for(pLine = aszStatusPage; *pLine != NULL; ++pLine)
+    {
+      g_ptr_array_add(pCalls, g_strsplit(*pLine, " ", -1));
+    }
+  }
+  else
+  {
+    char * szContent = NULL;
+    char ** lines;
+    char ** pLine;
+
+    if(!g_file_get_contents(szFile, &szContent, NULL, NULL))
+    {
+      g_ptr_array_free(pCalls, TRUE);
+      return NULL;
+    }
+    lines = g_strsplit(szContent, "\n", -1);
+    for(pLine = lines; *pLine != NULL; ++pLine)
+    {
+      g_strstrip(*pLine);
+      if((**pLine != '\0') && (**pLine != COMMENT_CHAR))
+      {
+        g_ptr_array_add(pCalls, g_strsplit_set(*pLine, " \t", -1));
+      }
+    }
+    g_strfreev(lines);
+    g_free(szContent);
+  }
+  g_ptr_array_add(pCalls, NULL);
+  return pCalls;
+}
+
+int main(int    argc,
+         char** argv)
+{
+  static char const * const aszMode[] = { "exec", "client", "direct" };
+  char const * szFile = NULL;
+  GPtrArray * pCalls;
+  int pages = 20;
+  int opt;
+  int mode;
+
+  while((opt = getopt(argc, argv, "n:f:h")) != -1)
+  {
+    switch(opt)
+    {
+      case 'n':
+        pages = atoi(optarg);
+        break;
+      case 'f':
+        szFile = optarg;
+        break;
+      default:
+        printf("usage: %s [-n <page loads>] [-f <file>]\n", argv[0]);
+        return (opt == 'h') ? SUCCESS : INVALID_PARAMETER;
+    }
+  }
+  if(pages <= 0)
+  {
+    return INVALID_PARAMETER;
+  }
+  pCalls = LoadCalls(szFile);
+  if(pCalls == NULL)
+  {
+    fprintf(stderr, "cannot read %s\n", szFile);
+    return FILE_READ_ERROR;
+  }
+
+  printf("%u calls per page, %d page loads\n", pCalls->len - 1, pages);
+  for(mode = MODE_EXEC; mode <= MODE_DIRECT; ++mode)
+  {
+    double total = 0;
+    double max = 0;
+    int i;
+
+    // warm up caches so that the first mode is not penalized
+    (void)RunPage((char ***)pCalls->pdata, (tBenchMode)mode);
+    for(i = 0; i < pages; ++i)
+    {
+      double ms = RunPage((char ***)pCalls->pdata, (tBenchMode)mode);
+      total += ms;
+      if(ms > max)
+      {
+        max = ms;
+      }
+    }
+    printf("%-6s: %8.1f ms per page (max %.1f ms)\n", aszMode[mode], total / pages, max);
+  }
+
+  {
+    char * stats[] = { "ctd", "stats", NULL };
+    char * szOutput = NULL;
+    int status;
+    if(ctlib_ResidentCallGetOutput("ctd", 2, stats, &status, &szOutput) == 0)
+    {
+      printf("ctd: %s\n", szOutput);
+      g_free(szOutput);
+    }
+    else
+    {
+      printf("ctd is not running\n");
+    }
+  }
+
+  g_ptr_array_set_free_func(pCalls, (GDestroyNotify)g_strfreev);
+  g_ptr_array_free(pCalls, TRUE);
+  return SUCCESS;
+}
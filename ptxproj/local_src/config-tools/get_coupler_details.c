@@ -36,6 +36,7 @@
 #include <libgen.h>               // for basename()
 
 #include "config_tool_lib.h"
+#include "ct_resident.h"
 #include "libnet/ct_libnet.h"
 
 //------------------------------------------------------------------------------
@@ -44,6 +45,8 @@
 
 #ifdef  __CPPUTEST__
 #define main get_filesystem_data_main
+#elif defined(__CT_RESIDENT__)
+#define main ctd_get_coupler_details_main
 #endif
 
 #define SHOW_ERRORS                         0
@@ -367,7 +370,7 @@ int GetProcessorType(char* pProcessorTypeString)
 //
 {
   int   status          = SUCCESS;
-  char* pCpuinfoContent = NULL;
+  char const * pCpuinfoContent = NULL;
 
   if(pProcessorTypeString == NULL)
   {
@@ -377,13 +380,8 @@ int GetProcessorType(char* pProcessorTypeString)
   // initialise output-string
   *pProcessorTypeString = '\0';
 
-  char pCmdTemplate[] = "cat %s";
-  char cmd[strlen(pCmdTemplate) + strlen(g_proc_cpuinfo) + 1];
-
-  snprintf(cmd, sizeof(cmd), pCmdTemplate, g_proc_cpuinfo);
-
-  // get content of cpuinfo-file (it is not possible to read the file directly to buffer, because its size is ostensible always 0)
-  pCpuinfoContent = SystemCall_GetOutput(cmd);
+  // get content of cpuinfo-file (its size is ostensible always 0, so it is read until EOF; it does not change until reboot)
+  pCpuinfoContent = ctlib_ReadProcFileCached(g_proc_cpuinfo);
 
   if(pCpuinfoContent == NULL)
   {
@@ -396,7 +394,7 @@ int GetProcessorType(char* pProcessorTypeString)
     char* pFoundProcessorTypeString           = NULL;
 
     // loop over the lines of cpuinfo to find the line with the model-name-string (x86-specific)
-    while((SUCCESS == SystemCall_GetLineByNr(pCpuinfoContent, lineNr, cpuinfoLine)) && (pFoundProcessorTypeString == NULL))
+    while((SUCCESS == FileContent_GetLineByNr((char *)pCpuinfoContent, lineNr, cpuinfoLine)) && (pFoundProcessorTypeString == NULL))
     {
       // if the line with the model-name-string was found (x86)
       if(strstr(cpuinfoLine, "model name") != NULL)
@@ -426,8 +424,6 @@ int GetProcessorType(char* pProcessorTypeString)
 
       ++lineNr;
     }
-
-    SystemCall_Destruct(&pCpuinfoContent);
   }
 
   return(status);
@@ -798,7 +794,6 @@ int GetActualHostname(char* pHostnameString)
 //
 {
   int   status                = SUCCESS;
-  char* pEnvironmentHostname  = NULL;
 
   if(pHostnameString == NULL)
   {
@@ -808,19 +803,10 @@ int GetActualHostname(char* pHostnameString)
   // initialise output-string
   *pHostnameString = '\0';
 
-  pEnvironmentHostname = SystemCall_GetOutput("hostname");
-
-  if(pEnvironmentHostname == NULL)
+  if(SUCCESS != ctlib_GetHostname(pHostnameString, MAX_LENGTH_COUPLER_DETAIL_STRING))
   {
     status = FILE_READ_ERROR;
   }
-  else
-  {
-    // cut line feed and copy hostname string to output variable
-    (void)CutLine(pEnvironmentHostname, strlen(pEnvironmentHostname));
-    strncpy(pHostnameString, pEnvironmentHostname, MAX_LENGTH_COUPLER_DETAIL_STRING);
-    SystemCall_Destruct(&pEnvironmentHostname);
-  }
 
   return status;
 }
@@ -837,7 +823,6 @@ int GetActualDomainName(char *pDomainNameString)
 //
 {
   int   status = SUCCESS;
-  char* pDomainname = NULL;
 
   if(pDomainNameString == NULL)
   {
@@ -847,19 +832,11 @@ int GetActualDomainName(char *pDomainNameString)
   // initialise output-string
   *pDomainNameString = '\0';
 
-  pDomainname = SystemCall_GetOutput("dnsdomainname");
-
-  if(pDomainname == NULL)
+  // what dnsdomainname prints: domain part of the resolved host name
+  if(SUCCESS != ctlib_GetDnsDomainName(pDomainNameString, MAX_LENGTH_COUPLER_DETAIL_STRING))
   {
     status = FILE_READ_ERROR;
   }
-  else
-  {
-    // cut line feed and copy domainname string to output variable
-    (void)CutLine(pDomainname, strlen(pDomainname));
-    strncpy(pDomainNameString, pDomainname, MAX_LENGTH_COUPLER_DETAIL_STRING);
-    SystemCall_Destruct(&pDomainname);
-  }
 
   return status;
 }
@@ -1705,6 +1682,14 @@ int main(int    argc,
 {
   int   status            = SUCCESS;
 
+#if !defined(__CPPUTEST__) && !defined(__CT_RESIDENT__)
+  // let the resident service do the work if it is running
+  if(ctlib_ResidentCall("get_coupler_details", argc, argv, &status) == 0)
+  {
+    return(status);
+  }
+#endif
+
   // help-text requested?
   if((argc == 2) && ((strcmp(argv[1], "--help") == 0) || strcmp(argv[1], "-h") == 0))
   {
@@ -31,6 +31,7 @@
 #include <assert.h>
 
 #include "config_tool_lib.h"
+#include "ct_resident.h"
 
 const char * g_proc_cmdline    = "/proc/cmdline";
 const char * g_proc_partitions = "/proc/partitions";
@@ -41,6 +42,8 @@ const char * g_proc_partitions = "/proc/partitions";
 
 #ifdef  __CPPUTEST__
 #define main get_coupler_details_main
+#elif defined(__CT_RESIDENT__)
+#define main ctd_get_filesystem_data_main
 #endif
 
 #define SHOW_ERRORS                         0
@@ -202,16 +205,9 @@ static int GetActivePartition(char* pOutputString,
 //
 {
   int   status              = SUCCESS;
-  char* pacActivePartition  = NULL;
 
   UNUSED_PARAMETER(additionalParam);
 
-  // construct command line: get root=... and print 2nd part using '=' as delimiter
-  char pCmdTemplate[] = "cat %s | grep -o 'root=[^[:space:]]\\+' | cut -d = -f 2";
-  char cmd[strlen(pCmdTemplate) + strlen(g_proc_cmdline) + 1];
-
-  snprintf(cmd, sizeof(cmd), pCmdTemplate, g_proc_cmdline);
-
   if(pOutputString == NULL)
   {
     return(INVALID_PARAMETER);
@@ -220,21 +216,14 @@ static int GetActivePartition(char* pOutputString,
   // initialise output-string
   *pOutputString = '\0';
 
-  pacActivePartition = SystemCall_GetOutput(cmd);
-
-  if(pacActivePartition == NULL)
+  // CAUTION if strlen(pOutputString) < MAX_LENGTH_OUTPUT_STRING
+  // TODO: remove constants from calls like this!
+  if(FILE_READ_ERROR == ctlib_GetKernelParameter(g_proc_cmdline, "root", pOutputString, MAX_LENGTH_OUTPUT_STRING))
   {
     status = FILE_READ_ERROR;
   }
-  else // copy string to output
+  else
   {
-
-    // CAUTION if strlen(pOutputString) < MAX_LENGTH_OUTPUT_STRING
-    // TODO: remove constants from calls like this!
-    strncpy(pOutputString, pacActivePartition, MAX_LENGTH_OUTPUT_STRING);
-    CutWord(pOutputString, MAX_LENGTH_OUTPUT_STRING);
-    SystemCall_Destruct(&pacActivePartition);
-
     if(pOutputString == strstr(pOutputString, "ubi"))
     {
       // /proc/cmdline accepts 2 ways to define a ubi root partition:
@@ -619,8 +608,8 @@ static int GetHomeDevice(char* pOutputString,
 // what is referred to as 'device' by other functions (/dev/hda or /dev/mtd)
 //
 {
-  int   status                  = SUCCESS;
-  char* pDfContent              = NULL;
+  int   status                                = SUCCESS;
+  char  mountDevice[MAX_LENGTH_OUTPUT_STRING]   = "";
 
   UNUSED_PARAMETER(additionalParam);
 
@@ -632,49 +621,51 @@ static int GetHomeDevice(char* pOutputString,
   // initialise output-string
   *pOutputString = '\0';
 
-  // get output of df-system-call
-  pDfContent = SystemCall_GetOutput("df /home");
+  // same device df /home shows in its first column
+  status = ctlib_GetMountDevice("/home", mountDevice, sizeof(mountDevice));
 
-  if(pDfContent == NULL)
+  if(status == NOT_FOUND)
+  {
+    status = SUCCESS;
+  }
+  else if(status != SUCCESS)
   {
     status = FILE_READ_ERROR;
   }
   else
   {
-    char  dfLineString[MAX_LENGTH_OUTPUT_LINE]  = "";
-
-    // We have to look at the 2nd line (GetLineByNr starts to count with 1)
-    //
-    // df output looks like this:
-    //
-    // Filesystem           1K-blocks      Used Available Use% Mounted on
-    // /dev/root                81249     48380     28773  63% /
-
-    if(SUCCESS == SystemCall_GetLineByNr(pDfContent, 2, dfLineString))
+    // if /home is located within the rootfs, the mount table shows "/dev/root" instead of the real device
+    if(0 == strcmp(mountDevice, "/dev/root"))
     {
-
-      // device is directly the first string in line, so we just must cut the rest
-      CutWord(dfLineString, MAX_LENGTH_OUTPUT_LINE);
-
-      // if /home is located within the rootfs, df returns "/dev/root" instead of the real device
-      if(0 == strcmp(dfLineString, "/dev/root"))
-      {
-         status = GetActivePartition(dfLineString, 0);
-      }
-
-      strncpy(pOutputString, dfLineString, MAX_LENGTH_OUTPUT_STRING);
+      status = GetActivePartition(mountDevice, 0);
     }
 
+    strncpy(pOutputString, mountDevice, MAX_LENGTH_OUTPUT_STRING);
   }
 
-  SystemCall_Destruct(&pDfContent);
-
   return status;
 }
 
 static int GetIndexOfActiveRootfs(void)
 {
   int result = -1;
+  char bootTarget[MAX_LENGTH_OUTPUT_STRING] = "";
+
+  // the bootchooser of barebox passes the booted target ("rootfs.1") to the
+  // kernel; get_systeminfo is only needed if it is missing (e.g. SD card boot)
+  if(   (SUCCESS == ctlib_GetKernelParameter(g_proc_cmdline, "bootchooser.active", bootTarget, sizeof(bootTarget)))
+     || (SUCCESS == ctlib_GetKernelParameter(g_proc_cmdline, "rauc.slot", bootTarget, sizeof(bootTarget))))
+  {
+    if(strcmp(bootTarget, "rootfs.1") == 0)
+    {
+      return 1;
+    }
+    else if(strcmp(bootTarget, "rootfs.2") == 0)
+    {
+      return 2;
+    }
+  }
+
   char* strSystem1Active = SystemCall_GetOutput("/etc/config-tools/get_systeminfo 1 active");
   if(NULL != strSystem1Active)
   {
@@ -699,6 +690,14 @@ static int GetHomePartitionFromIndex(char* pOutputString, int homeNameIndex)
 {
   int status = NOT_FOUND;
   char cmd[MAX_LENGTH_OUTPUT_STRING];
+
+  snprintf(cmd, sizeof cmd, "home%d", homeNameIndex);
+  if(SUCCESS == ctlib_GetDeviceByLabel(cmd, pOutputString, MAX_LENGTH_OUTPUT_STRING))
+  {
+    return SUCCESS;
+  }
+
+  // label not known to udev, ask blkid
   snprintf(cmd, sizeof cmd, "/sbin/blkid | grep -E 'home%d' | cut -d: -f1 | tr '\\n' '\\0'", homeNameIndex);
   char* strHomePartition = SystemCall_GetOutput(cmd);
   if(NULL != strHomePartition)
@@ -753,8 +752,6 @@ static int GetActivePartitionMedium(char* pOutputString,
   int   status                                              = SUCCESS;
   char  completeHomeDeviceString[MAX_LENGTH_OUTPUT_STRING]  = "";
   char* pHomeDeviceString                                   = NULL;
-  char* pHomeDeviceMedium                                   = NULL;
-  char  systemCall[MAX_LENGTH_SYSTEM_CALL]                   = "";
 
   UNUSED_PARAMETER(additionalParam);
 
@@ -776,19 +773,8 @@ static int GetActivePartitionMedium(char* pOutputString,
     pHomeDeviceString += strlen("/dev/");
   }
 
-  // get medium of home device
-  (void)snprintf(systemCall, sizeof(systemCall), "/etc/config-tools/get_device_data medium %s", pHomeDeviceString);
-  pHomeDeviceMedium = SystemCall_GetOutput(systemCall);
-
-  if(pHomeDeviceMedium == NULL)
-  {
-    status = FILE_READ_ERROR;
-  }
-  else
-  {
-    strncpy(pOutputString, pHomeDeviceMedium, MAX_LENGTH_OUTPUT_STRING);
-    SystemCall_Destruct(&pHomeDeviceMedium);
-  }
+  // get medium of home device, stays empty if it is unknown
+  (void)ctlib_GetDeviceMedium(pHomeDeviceString, pOutputString, MAX_LENGTH_OUTPUT_STRING);
 
   return status;
 }
@@ -861,23 +847,13 @@ static int GetMediumByIndex(char* pOutputString,
   }
   else
   {
-    char* pacMedium                         = NULL;
-    char  systemCall[MAX_LENGTH_SYSTEM_CALL] = "";
     //printf("acDevice:%s\n", acDevice);
 
     // get medium of device
-    (void)snprintf(systemCall, sizeof(systemCall), "/etc/config-tools/get_device_data medium %s", acDevice);
-    pacMedium = SystemCall_GetOutput(systemCall);
-
-    if((pacMedium == NULL) || (!strlen(pacMedium)))
+    if(   (SUCCESS != ctlib_GetDeviceMedium(acDevice, pOutputString, MAX_LENGTH_OUTPUT_STRING))
+       || (!strlen(pOutputString)))
     {
       status = NOT_FOUND;
-      //strncpy(pOutputString, acDevice, MAX_LENGTH_OUTPUT_STRING);
-    }
-    else
-    {
-      strncpy(pOutputString, pacMedium, MAX_LENGTH_OUTPUT_STRING);
-      SystemCall_Destruct(&pacMedium);
     }
   }
 
@@ -991,35 +967,30 @@ static int ShowDeviceDataListJson(char* pOutputString,
   {
     char  mediumString[MAX_LENGTH_OUTPUT_STRING]  = "";
     char  labelString[MAX_LENGTH_OUTPUT_STRING]   = "";
-    char* pacMedium                               = NULL;
-    char* pacLabel                                = NULL;
-    char  systemCall[MAX_LENGTH_SYSTEM_CALL]      = "";
-    int   resultlen;
 
     // get medium of device
-    (void)snprintf(systemCall, sizeof(systemCall), "/etc/config-tools/get_device_data medium %s", deviceString);
-    pacMedium = SystemCall_GetOutput(systemCall);
-    if(NULL == pacMedium)
-    {
-      continue;
-    }
-    strncpy(mediumString, pacMedium, MAX_LENGTH_OUTPUT_STRING);
-    resultlen = strlen(pacMedium);
-    SystemCall_Destruct(&pacMedium);
-    if(0 == resultlen)
+    (void)ctlib_GetDeviceMedium(deviceString, mediumString, sizeof(mediumString));
+    if(0 == strlen(mediumString))
     {
       continue;
     }
 
     // get label of device
-    (void)snprintf(systemCall, sizeof(systemCall), "/etc/config-tools/get_device_data label %s", deviceString);
-    pacLabel = SystemCall_GetOutput(systemCall);
-    if(NULL == pacLabel)
+    if(FILE_READ_ERROR == ctlib_GetLabelByDevice(deviceString, labelString, sizeof(labelString)))
     {
-      continue;
+      // no label links from udev, ask blkid
+      char  systemCall[MAX_LENGTH_SYSTEM_CALL]  = "";
+      char* pacLabel                            = NULL;
+
+      (void)snprintf(systemCall, sizeof(systemCall), "/etc/config-tools/get_device_data label %s", deviceString);
+      pacLabel = SystemCall_GetOutput(systemCall);
+      if(NULL == pacLabel)
+      {
+        continue;
+      }
+      strncpy(labelString, pacLabel, MAX_LENGTH_OUTPUT_STRING);
+      SystemCall_Destruct(&pacLabel);
     }
-    strncpy(labelString, pacLabel, MAX_LENGTH_OUTPUT_STRING);
-    SystemCall_Destruct(&pacLabel);
 
     if(firstPrint != 1) printf(", ");
     else firstPrint = 0;
@@ -1039,6 +1010,14 @@ int main(int    argc,
 {
   int   status            = SUCCESS;
 
+#if !defined(__CPPUTEST__) && !defined(__CT_RESIDENT__)
+  // let the resident service do the work if it is running
+  if(ctlib_ResidentCall("get_filesystem_data", argc, argv, &status) == 0)
+  {
+    return(status);
+  }
+#endif
+
   // help-text requested?
   if((argc == 2) && ((strcmp(argv[1], "--help") == 0) || strcmp(argv[1], "-h") == 0))
   {
@@ -32,11 +32,13 @@ void DynamicIPEventHandler::SetConfig() {
 
   ::std::string interface;
   netconf::DynamicIPEventAction action;
+  ::std::string lease;
+  pid_t client_pid = 0;
 
-  auto status = napi::MakeDynamicIPAction(GetValueOfSet(vm_), interface, action);
+  auto status = napi::MakeDynamicIPAction(GetValueOfSet(vm_), interface, action, lease, client_pid);
 
   if (status.IsOk()) {
-    status = napi::NotifyDynamicIPAction(interface, action);
+    status = napi::NotifyDynamicIPAction(interface, action, lease, client_pid);
   }
 
   if (status.IsNotOk()) {
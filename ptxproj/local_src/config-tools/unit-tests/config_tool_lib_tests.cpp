@@ -157,3 +157,42 @@ TEST(config_tool_lib, run_udev_query)
 #endif
 }
 
+
+TEST(config_tool_lib, get_kernel_parameter)
+{
+  char buf[16];
+
+  LONGS_EQUAL(SUCCESS, ctlib_GetKernelParameter("./data_stubs/cmdline_hda1", "root", buf, sizeof(buf)));
+  STRCMP_EQUAL("/dev/hda1", buf);
+
+  LONGS_EQUAL(SUCCESS, ctlib_GetKernelParameter("./data_stubs/cmdline_hda1", "def", buf, sizeof(buf)));
+  STRCMP_EQUAL("klmn", buf);
+
+  // parameters without value and prefixes do not match
+  LONGS_EQUAL(NOT_FOUND, ctlib_GetKernelParameter("./data_stubs/cmdline_hda1", "abc", buf, sizeof(buf)));
+  LONGS_EQUAL(NOT_FOUND, ctlib_GetKernelParameter("./data_stubs/cmdline_hda1", "de", buf, sizeof(buf)));
+  STRCMP_EQUAL("", buf);
+
+  // value is truncated to the buffer
+  LONGS_EQUAL(SUCCESS, ctlib_GetKernelParameter("./data_stubs/cmdline_mmc", "root", buf, 8));
+  STRCMP_EQUAL("/dev/mm", buf);
+
+  LONGS_EQUAL(FILE_READ_ERROR, ctlib_GetKernelParameter("./data_stubs/no_such_file", "root", buf, sizeof(buf)));
+}
+
+TEST(config_tool_lib, read_proc_file)
+{
+  char * szContent = ctlib_ReadProcFile("/proc/self/status");
+  char const * szCached;
+
+  CHECK(NULL != szContent);
+  CHECK(NULL != strstr(szContent, "Name:"));
+  FileContent_Destruct(&szContent);
+
+  szCached = ctlib_ReadProcFileCached("./data_stubs/cpuinfo_pac200");
+  CHECK(NULL != szCached);
+  POINTERS_EQUAL(szCached, ctlib_ReadProcFileCached("./data_stubs/cpuinfo_pac200"));
+  CHECK(NULL != strstr(szCached, "ARMv7"));
+
+  POINTERS_EQUAL(NULL, ctlib_ReadProcFile("./data_stubs/no_such_file"));
+}
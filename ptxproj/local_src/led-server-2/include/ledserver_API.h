@@ -60,6 +60,9 @@ typedef int tLedNr;
 //typedef for the ledhandler funktion-pointer
 typedef int(*tLedHandler)(tLedNr, void*,void*);
 
+//typedef for the handler called when blink-sequences ended
+typedef void(*tLedSequenceEndHandler)(void);
+
 /*
  * this struct is used for setting the handler for crrating a new blink-sequence
  */
@@ -284,6 +287,19 @@ tLedNr ledserver_LEDCTRL_GetLedCount(void);
 //------------------------------------------------------------------------------
 tLedReturnCode ledserver_LEDCTRL_SetResetUserDataHandler(tLedStateClass status,tLedHandler resetUserDataHandler);
 
+/*
+ * set Handler for being notified about LEDs changing their state by themselves.
+ */
+//------------------------------------------------------------------------------
+///  ledserver_LEDCTRL_SetSequenceEndHandler()
+///  Set a Handler which is called when blink-sequences ended and their LEDs
+///  went into the static state. It is called by the blink-thread without any
+///  lock of the library held, so it may get and set LEDs.
+///
+///  \param sequenceEndHandler functionpointer to the handler, NULL for none
+//------------------------------------------------------------------------------
+void ledserver_LEDCTRL_SetSequenceEndHandler(tLedSequenceEndHandler sequenceEndHandler);
+
 //this function to be used only from a ledHandler
 //------------------------------------------------------------------------------
 ///  ledserver_LEDCTRL_SetLedStateData()
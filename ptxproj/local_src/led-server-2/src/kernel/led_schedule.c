@@ -64,6 +64,7 @@ tLedColors              LedColors[]={LED_OFF,//0
                                      };
 tLED                  * SCHEDULE_led = NULL;
 int                     ledScheduleRun = 0;
+static tLedSequenceEndHandler sequenceEndHandler = NULL;
 
 //-- Function: TimespecToTimeMS -----------------------------------------------------
 ///
@@ -115,6 +116,7 @@ void *LedSchedule(void)
   while(ledScheduleRun > 0)
   {
     int             led_i;             //Iterator for LEDs
+    int             ended = 0;         //sequences ended in this round
     struct timespec nextChange;
     tTimeMS        nextChangeMSec;
 
@@ -135,6 +137,10 @@ void *LedSchedule(void)
       if(SCHEDULE_led[led_i].nextChange <= actMSec)
       {
         SEQUENTIAL_LedBlinkSequential( (uint16_t)led_i, &actMSec);
+        if(!SCHEDULE_led[led_i].active)
+        {
+          ended++;
+        }
       }
       //set next time to wake up for the thread
       if(SCHEDULE_led[led_i].nextChange < nextChangeMSec)
@@ -143,6 +149,19 @@ void *LedSchedule(void)
       }
       pthread_mutex_unlock(&SCHEDULE_led[led_i].mutexBlinkSeq);
     }//for
+
+    //the handler may set LEDs itself, so it is called without the lock and
+    //all LEDs are checked again afterwards
+    if(ended && sequenceEndHandler != NULL)
+    {
+      tLedSequenceEndHandler handler = sequenceEndHandler;
+      pthread_mutex_unlock(&mutexLedSchedule);
+      handler();
+      pthread_mutex_lock(&mutexLedSchedule);
+      clock_gettime(LED_SCHED_TIMER_BASE, &aktTime);
+      TimespecToTimeMS(&actMSec,(const struct timespec*) &aktTime);
+      continue;
+    }
     
     //if nothing changed. no LED is blining and the thread can stop
     if(nextChangeMSec == END_OF_MSECONDS_64)
@@ -511,6 +530,13 @@ tLedReturnCode ledserver_LEDCTRL_GetLedNumber(const char * ledName,tLedNr * pLed
   return ret;
 }
 
+void ledserver_LEDCTRL_SetSequenceEndHandler(tLedSequenceEndHandler handler)
+{
+  pthread_mutex_lock(&mutexLedSchedule);
+  sequenceEndHandler = handler;
+  pthread_mutex_unlock(&mutexLedSchedule);
+}
+
 tLedNr ledserver_LEDCTRL_GetLedCount(void)
 {
   return (tLedNr) GetNoOfLeds();
@@ -36,12 +36,48 @@
 // defines; structure, enumeration and type definitions
 //------------------------------------------------------------------------------
 #define NSEC_PER_SEC        ((uint64_t)(1000 * 1000 * 1000))
+#define NSEC_PER_USEC       ((uint64_t)1000)
 #define TIMESPEC_TO_U64(ts) ((uint64_t)(ts).tv_nsec+(uint64_t)(ts).tv_sec*NSEC_PER_SEC)
 #define DIV_ROUND_UP(n,d)   ((((n) + (d)) - 1U)/ (d))
 
 #define SINGLECORE_THRESHOLD2 75U  // show value of most loaded core instead of average of all cores
 #define SINGLECORE_THRESHOLD1 50U  // show mix of most loaded core and average of all cores
 
+#define CGROUP_V1_USAGE_PATH "/sys/fs/cgroup/cpuacct/%s/cpuacct.usage_percpu"
+#define CGROUP_V2_USAGE_PATH "/sys/fs/cgroup/%s/cpu.stat"
+#define CGROUP_V2_PSI_PATH   "/sys/fs/cgroup/%s/cpu.pressure"
+#define PROC_STAT_PATH       "/proc/stat"
+
+#define SAMPLER_BUFFER_SIZE  4096U
+
+struct cgroupcpuload_group
+{
+  int      usage_fd;
+  int      pressure_fd;
+  uint16_t counters;        // v1: one counter per core, v2: one total counter
+  uint64_t * runtime;
+  uint64_t * runtime_old;
+  uint32_t * load_core;
+  uint32_t load;
+  uint64_t some_total;
+  uint64_t full_total;
+  struct cgroupcpuload_pressure pressure;
+};
+
+struct cgroupcpuload_sampler
+{
+  int      version;
+  size_t   count;
+  struct cgroupcpuload_group * groups;
+  int      stat_fd;
+  uint16_t cores;
+  uint64_t * core_busy;
+  uint64_t * core_total;
+  uint32_t * core_load;
+  uint64_t timestamp;
+  char     * buffer;
+};
+
 //------------------------------------------------------------------------------
 // function prototypes
 //------------------------------------------------------------------------------
@@ -60,26 +96,199 @@ static void cgroupcpuload_read_runtime(struct cgroupcpuload * cgroupcpuload);
 // function implementation
 //------------------------------------------------------------------------------
 
+//------------------------------------------------------------------------------
+static int cgroupcpuload_open(char const * const format, char const * const cgroup_path)
+{
+  char path[256];
+
+  snprintf(path, sizeof(path), format, cgroup_path);
+  return open(path, O_RDONLY | O_NOATIME);
+}
+
+//------------------------------------------------------------------------------
+static uint16_t cgroupcpuload_count_counters(char const * const buffer, ssize_t const length)
+{
+  uint16_t counters = 1;
+
+  for (ssize_t i = 0; i < (length - 1); i++)
+  {
+    if ((buffer[i] == ' ') && (buffer[i+1] > ' '))
+    {
+      counters++;
+    }
+  }
+
+  return counters;
+}
+
+//------------------------------------------------------------------------------
+// Parses the space separated nanosecond counters of cpuacct.usage_percpu.
+static void cgroupcpuload_parse_percpu(char * const buffer,
+                                       ssize_t const length,
+                                       uint64_t * const runtime,
+                                       uint64_t * const runtime_old,
+                                       uint16_t const counters)
+{
+  int  core   = 0;
+  int  oldpos = 0;
+  uint64_t result = 0;
+  const char * const uint64_format = "%" PRIu64 "\n";
+
+  for (int pos = 0; pos < length; pos++)
+  {
+    if (((buffer[pos] == ' ') && (buffer[pos+1] > ' ')) || (pos == (length -1)))
+    {
+      DBG("core %i runtime buffer %s", core + 1, &buffer[oldpos]);
+      buffer[pos] = '\n';
+
+      if (sscanf(&buffer[oldpos], uint64_format, &result) > 0)
+      {
+        if (core < counters)
+        {
+          runtime_old[core] = runtime[core];
+          runtime[core]     = result;
+          DBG("core %i runtime %" PRIu64, core + 1, runtime[core]);
+          core++;
+        }
+      }
+      oldpos = pos + 1;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Parses the usage_usec line of cpu.stat and returns the usage in nanoseconds.
+static int cgroupcpuload_parse_cpustat(char const * const buffer, uint64_t * const usage)
+{
+  char const * const key = strstr(buffer, "usage_usec ");
+
+  if (key == NULL)
+  {
+    return -1;
+  }
+
+  *usage = strtoull(key + sizeof("usage_usec ") - 1U, NULL, 10) * NSEC_PER_USEC;
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+// Parses a fixed point value "12.34" into hundredths.
+static uint32_t cgroupcpuload_parse_centi(char const * const value)
+{
+  char * end = NULL;
+  uint32_t result = (uint32_t)strtoul(value, &end, 10) * 100U;
+
+  if ((end != NULL) && (*end == '.') && (end[1] >= '0') && (end[1] <= '9'))
+  {
+    result += (uint32_t)(end[1] - '0') * 10U;
+    if ((end[2] >= '0') && (end[2] <= '9'))
+    {
+      result += (uint32_t)(end[2] - '0');
+    }
+  }
+
+  return result;
+}
+
+//------------------------------------------------------------------------------
+// Parses one line ("some ..." or "full ...") of a PSI file.
+static int cgroupcpuload_parse_psi_line(char const * const buffer,
+                                        char const * const kind,
+                                        uint32_t avg[3],
+                                        uint64_t * const total)
+{
+  char const * line = strstr(buffer, kind);
+  char const * field;
+
+  if (line == NULL)
+  {
+    return -1;
+  }
+
+  field = strstr(line, "avg10=");
+  avg[0] = (field != NULL) ? cgroupcpuload_parse_centi(field + sizeof("avg10=") - 1U) : 0U;
+  field = strstr(line, "avg60=");
+  avg[1] = (field != NULL) ? cgroupcpuload_parse_centi(field + sizeof("avg60=") - 1U) : 0U;
+  field = strstr(line, "avg300=");
+  avg[2] = (field != NULL) ? cgroupcpuload_parse_centi(field + sizeof("avg300=") - 1U) : 0U;
+  field = strstr(line, "total=");
+  *total = (field != NULL) ? strtoull(field + sizeof("total=") - 1U, NULL, 10) : 0U;
+
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+// Legacy weighting of per-core loads, see cgroupcpuload.h.
+static uint32_t cgroupcpuload_weight(uint32_t const * const load_core, uint16_t const cores)
+{
+  uint32_t load    = 0U;
+  uint32_t maxload = 0U;
+
+  for (int core = 0; core < cores; core++)
+  {
+    load += load_core[core];
+    if (load_core[core] > maxload)
+    {
+      maxload = load_core[core];
+    }
+  }
+
+  load = load / cores;
+
+  if (maxload > SINGLECORE_THRESHOLD2)
+  {
+    load = maxload;
+  }
+  else
+  {
+    if (maxload > SINGLECORE_THRESHOLD1)
+    {
+      load = (load + maxload) / 2;
+    }
+  }
+
+  if (load > 100U)
+  {
+    load = 100U;
+  }
+
+  return load;
+}
+
+//------------------------------------------------------------------------------
+static uint16_t cgroupcpuload_online_cores(void)
+{
+  long const cores = sysconf(_SC_NPROCESSORS_ONLN);
+
+  return (cores > 0) ? (uint16_t)cores : 1U;
+}
+
 //------------------------------------------------------------------------------
 DLL_DECL struct cgroupcpuload * cgroupcpuload_init(char const * const cgroup_path)
 {
-  char   path[256];
   char   buffer[256];
   struct timespec timespec;
   struct cgroupcpuload *cgroupcpuload = calloc(1, sizeof(*cgroupcpuload));
+  int    version = 1;
   int    fd;
 
-  snprintf(path, sizeof(path), "/sys/fs/cgroup/cpuacct/%s/cpuacct.usage_percpu", cgroup_path);
-  fd = open(path, O_RDONLY | O_NOATIME);
+  fd = cgroupcpuload_open(CGROUP_V1_USAGE_PATH, cgroup_path);
+  if (fd == -1)
+  {
+    version = 2;
+    fd = cgroupcpuload_open(CGROUP_V2_USAGE_PATH, cgroup_path);
+  }
 
   if (fd == -1)
   {
-    ERROR("open (%s, ..) failed: %s", path, strerror(errno));
+    ERROR("open usage file of cgroup %s failed: %s", cgroup_path, strerror(errno));
     return NULL;
   }
 
   cgroupcpuload->cpuacct_usage_fd = fd;
+  cgroupcpuload->cgroup_version   = version;
   cgroupcpuload->cpu_cores        = 1;
+  cgroupcpuload->online_cores     = 1;
   cgroupcpuload->runtime_core     = NULL;
   cgroupcpuload->runtime_core_old = NULL;
   cgroupcpuload->load_core        = NULL;
@@ -89,14 +298,16 @@ DLL_DECL struct cgroupcpuload * cgroupcpuload_init(char const * const cgroup_pat
 
   if (length > 0)
   {
-	  buffer[length-1] = '\0';
+    buffer[length-1] = '\0';
 
-	  for (int i = 0; i < length; i++)
-	  {
-	    if ((buffer[i] == ' ') && (buffer[i+1] > ' '))
-	    {
-	      cgroupcpuload->cpu_cores++;
-	    }
+    if (version == 1)
+    {
+      cgroupcpuload->cpu_cores = cgroupcpuload_count_counters(buffer, length);
+    }
+    else
+    {
+      // cpu.stat only has the total usage of the group
+      cgroupcpuload->online_cores = cgroupcpuload_online_cores();
     }
 
     cgroupcpuload->runtime_core     = calloc(1, cgroupcpuload->cpu_cores * sizeof(uint64_t));
@@ -151,7 +362,6 @@ DLL_DECL uint32_t cgroupcpuload_get_load(struct cgroupcpuload * cgroupcpuload)
 {
   struct timespec timespec;
   uint32_t load       = 0U;
-  uint32_t maxload    = 0U;
   uint64_t timestamp;
   uint64_t delta_time;
   uint64_t delta_runtime;
@@ -181,78 +391,384 @@ DLL_DECL uint32_t cgroupcpuload_get_load(struct cgroupcpuload * cgroupcpuload)
     for (int core = 0; core < cgroupcpuload->cpu_cores; core++)
     {
       delta_runtime = (cgroupcpuload->runtime_core[core] - cgroupcpuload->runtime_core_old[core]);
-      cgroupcpuload->load_core[core] = (uint32_t) DIV_ROUND_UP(100U * delta_runtime, delta_time);
-      load += cgroupcpuload->load_core[core];
+      cgroupcpuload->load_core[core] = (uint32_t) DIV_ROUND_UP(100U * delta_runtime, delta_time * cgroupcpuload->online_cores);
       DBG("core %i delta_runtime %" PRIu64 " load: %" PRIu32 "%%", core + 1, delta_runtime, cgroupcpuload->load_core[core]);
-      if (cgroupcpuload->load_core[core] > maxload)
+    }
+
+    load = cgroupcpuload_weight(cgroupcpuload->load_core, cgroupcpuload->cpu_cores);
+  }
+
+  INFO("cpu load: %" PRIu32 "%%", load);
+
+  return load;
+}
+
+
+//------------------------------------------------------------------------------
+static void cgroupcpuload_read_runtime(struct cgroupcpuload * cgroupcpuload)
+{
+  char buffer[256];
+  uint64_t usage;
+
+  lseek(cgroupcpuload->cpuacct_usage_fd, 0, SEEK_SET);
+  ssize_t const length = read(cgroupcpuload->cpuacct_usage_fd, buffer, sizeof(buffer) - 1U);
+  if (length > 0)
+  {
+    buffer[length] = '\0';
+    DBG("buffer %s", buffer);
+
+    if (cgroupcpuload->cgroup_version == 2)
+    {
+      if (cgroupcpuload_parse_cpustat(buffer, &usage) == 0)
       {
-        maxload = cgroupcpuload->load_core[core];
+        cgroupcpuload->runtime_core_old[0] = cgroupcpuload->runtime_core[0];
+        cgroupcpuload->runtime_core[0]     = usage;
       }
     }
+    else
+    {
+      cgroupcpuload_parse_percpu(buffer, length, cgroupcpuload->runtime_core,
+                                 cgroupcpuload->runtime_core_old, cgroupcpuload->cpu_cores);
+    }
   }
+}
 
-  load = load / cgroupcpuload->cpu_cores;
 
-  if (maxload > SINGLECORE_THRESHOLD2)
+//------------------------------------------------------------------------------
+static ssize_t cgroupcpuload_sampler_read(struct cgroupcpuload_sampler * const sampler, int const fd)
+{
+  ssize_t const length = pread(fd, sampler->buffer, SAMPLER_BUFFER_SIZE - 1U, 0);
+
+  sampler->buffer[(length > 0) ? length : 0] = '\0';
+  return length;
+}
+
+//------------------------------------------------------------------------------
+// Reads the per-core counters of /proc/stat. With store == 0 only the cores are counted.
+static uint16_t cgroupcpuload_sampler_read_stat(struct cgroupcpuload_sampler * const sampler,
+                                                int const store)
+{
+  uint16_t cores = 0U;
+  char * line = sampler->buffer;
+
+  if (cgroupcpuload_sampler_read(sampler, sampler->stat_fd) <= 0)
   {
-    load = maxload;
+    return 0U;
   }
-  else
+
+  while ((line != NULL) && (strncmp(line, "cpu", 3) == 0))
   {
-    if (maxload > SINGLECORE_THRESHOLD1)
+    if ((line[3] >= '0') && (line[3] <= '9'))
     {
-      load = (load + maxload) / 2;
+      char * field = line + 3;
+      unsigned long const core = strtoul(field, &field, 10);
+      uint64_t values[8] = { 0 };
+      uint64_t total = 0U;
+
+      for (size_t i = 0U; i < (sizeof(values) / sizeof(values[0])); i++)
+      {
+        values[i] = strtoull(field, &field, 10);
+        total += values[i];
+      }
+
+      if (store && (core < sampler->cores))
+      {
+        uint64_t const busy       = total - values[3] - values[4];  // idle, iowait
+        uint64_t const delta_busy = busy - sampler->core_busy[core];
+        uint64_t const delta_all  = total - sampler->core_total[core];
+
+        sampler->core_load[core]  = (delta_all != 0U) ? (uint32_t)((100U * delta_busy) / delta_all) : 0U;
+        sampler->core_busy[core]  = busy;
+        sampler->core_total[core] = total;
+      }
+      cores++;
+    }
+
+    line = strchr(line, '\n');
+    if (line != NULL)
+    {
+      line++;
     }
   }
 
-  if (load > 100U)
+  return cores;
+}
+
+//------------------------------------------------------------------------------
+static int cgroupcpuload_sampler_open_group(struct cgroupcpuload_sampler * const sampler,
+                                            struct cgroupcpuload_group * const group,
+                                            char const * const cgroup_path)
+{
+  ssize_t length;
+
+  group->usage_fd    = -1;
+  group->pressure_fd = -1;
+  group->counters    = 1U;
+
+  if (sampler->version != 2)
   {
-    load = 100U;
+    group->usage_fd = cgroupcpuload_open(CGROUP_V1_USAGE_PATH, cgroup_path);
+    if (group->usage_fd != -1)
+    {
+      sampler->version = 1;
+    }
+  }
+  if ((group->usage_fd == -1) && (sampler->version != 1))
+  {
+    group->usage_fd = cgroupcpuload_open(CGROUP_V2_USAGE_PATH, cgroup_path);
+    if (group->usage_fd != -1)
+    {
+      sampler->version    = 2;
+      group->pressure_fd  = cgroupcpuload_open(CGROUP_V2_PSI_PATH, cgroup_path);
+    }
   }
 
-  INFO("cpu load: %" PRIu32 "%%", load);
+  if (group->usage_fd == -1)
+  {
+    ERROR("open usage file of cgroup %s failed: %s", cgroup_path, strerror(errno));
+    return -1;
+  }
 
-  return load;
-}
+  if (sampler->version == 1)
+  {
+    length = cgroupcpuload_sampler_read(sampler, group->usage_fd);
+    if (length > 0)
+    {
+      group->counters = cgroupcpuload_count_counters(sampler->buffer, length - 1);
+    }
+  }
 
+  group->runtime     = calloc(group->counters, sizeof(uint64_t));
+  group->runtime_old = calloc(group->counters, sizeof(uint64_t));
+  group->load_core   = calloc(group->counters, sizeof(uint32_t));
+
+  return ((group->runtime != NULL) && (group->runtime_old != NULL) && (group->load_core != NULL)) ? 0 : -1;
+}
 
 //------------------------------------------------------------------------------
-static void cgroupcpuload_read_runtime(struct cgroupcpuload * cgroupcpuload)
+DLL_DECL struct cgroupcpuload_sampler * cgroupcpuload_sampler_init(char const * const cgroup_paths[], size_t count)
 {
-  char buffer[256];
-  int  core   = 0;
-  int  oldpos = 0;
-  uint64_t result = 0;
-  const char * const uint64_format = "%" PRIu64 "\n";
+  struct cgroupcpuload_sampler * sampler = calloc(1, sizeof(*sampler));
 
-  lseek(cgroupcpuload->cpuacct_usage_fd, 0, SEEK_SET);
-  ssize_t const length = read(cgroupcpuload->cpuacct_usage_fd, buffer, sizeof(buffer) - 1U);
-  if (length > 0)
+  if (sampler == NULL)
   {
-    buffer[length] = '\0';
-    DBG("buffer %s", buffer);
+    return NULL;
+  }
 
-    for (int pos = 0; pos < length; pos++)
+  sampler->count   = count;
+  sampler->stat_fd = -1;
+  sampler->groups  = calloc(count, sizeof(*sampler->groups));
+  sampler->buffer  = malloc(SAMPLER_BUFFER_SIZE);
+  if ((sampler->groups == NULL) || (sampler->buffer == NULL))
+  {
+    cgroupcpuload_sampler_destroy(sampler);
+    return NULL;
+  }
+
+  for (size_t i = 0U; i < count; i++)
+  {
+    // groups which can't be opened report no load
+    (void)cgroupcpuload_sampler_open_group(sampler, &sampler->groups[i], cgroup_paths[i]);
+  }
+
+  sampler->stat_fd = open(PROC_STAT_PATH, O_RDONLY);
+  if (sampler->stat_fd != -1)
+  {
+    sampler->cores = cgroupcpuload_sampler_read_stat(sampler, 0);
+  }
+  if (sampler->cores != 0U)
+  {
+    sampler->core_busy  = calloc(sampler->cores, sizeof(uint64_t));
+    sampler->core_total = calloc(sampler->cores, sizeof(uint64_t));
+    sampler->core_load  = calloc(sampler->cores, sizeof(uint32_t));
+    if ((sampler->core_busy == NULL) || (sampler->core_total == NULL) || (sampler->core_load == NULL))
     {
-      if (((buffer[pos] == ' ') && (buffer[pos+1] > ' ')) || (pos == (length -1)))
+      cgroupcpuload_sampler_destroy(sampler);
+      return NULL;
+    }
+  }
+
+  // first update initializes the counters, loads become meaningful with the next one
+  (void)cgroupcpuload_sampler_update(sampler);
+
+  return sampler;
+}
+
+//------------------------------------------------------------------------------
+DLL_DECL void cgroupcpuload_sampler_destroy(struct cgroupcpuload_sampler * sampler)
+{
+  if (sampler == NULL)
+  {
+    return;
+  }
+
+  if (sampler->groups != NULL)
+  {
+    for (size_t i = 0U; i < sampler->count; i++)
+    {
+      struct cgroupcpuload_group * const group = &sampler->groups[i];
+      if (group->usage_fd != -1)
       {
-        DBG("core %i runtime buffer %s", core + 1, &buffer[oldpos]);
-        buffer[pos] = '\n';
+        close(group->usage_fd);
+      }
+      if (group->pressure_fd != -1)
+      {
+        close(group->pressure_fd);
+      }
+      free(group->runtime);
+      free(group->runtime_old);
+      free(group->load_core);
+    }
+    free(sampler->groups);
+  }
+  if (sampler->stat_fd != -1)
+  {
+    close(sampler->stat_fd);
+  }
+  free(sampler->core_busy);
+  free(sampler->core_total);
+  free(sampler->core_load);
+  free(sampler->buffer);
+  free(sampler);
+}
 
-        if (sscanf(&buffer[oldpos], uint64_format, &result) > 0)
-        {
-          if (core < cgroupcpuload->cpu_cores)
-          {
-            cgroupcpuload->runtime_core_old[core] = cgroupcpuload->runtime_core[core];
-            cgroupcpuload->runtime_core[core]     = result;
-            DBG("core %i runtime %" PRIu64, core + 1, cgroupcpuload->runtime_core[core]);
-            core++;
-          }
-        }
-        oldpos = pos + 1;
+//------------------------------------------------------------------------------
+static void cgroupcpuload_sampler_update_group(struct cgroupcpuload_sampler * const sampler,
+                                               struct cgroupcpuload_group * const group,
+                                               uint64_t const delta_time)
+{
+  ssize_t length;
+  uint64_t usage;
+  uint32_t avg[3];
+  uint64_t total;
+
+  if (group->usage_fd == -1)
+  {
+    return;
+  }
+
+  length = cgroupcpuload_sampler_read(sampler, group->usage_fd);
+  if (length > 0)
+  {
+    if (sampler->version == 2)
+    {
+      if (cgroupcpuload_parse_cpustat(sampler->buffer, &usage) == 0)
+      {
+        group->runtime_old[0] = group->runtime[0];
+        group->runtime[0]     = usage;
       }
     }
+    else
+    {
+      cgroupcpuload_parse_percpu(sampler->buffer, length, group->runtime, group->runtime_old, group->counters);
+    }
+  }
+
+  if (delta_time != 0U)
+  {
+    uint64_t const divisor = (sampler->version == 2) ? (delta_time * ((sampler->cores != 0U) ? sampler->cores : 1U))
+                                                     : delta_time;
+    for (uint16_t i = 0U; i < group->counters; i++)
+    {
+      group->load_core[i] = (uint32_t)DIV_ROUND_UP(100U * (group->runtime[i] - group->runtime_old[i]), divisor);
+    }
+    group->load = cgroupcpuload_weight(group->load_core, group->counters);
+  }
+
+  if ((group->pressure_fd != -1) && (cgroupcpuload_sampler_read(sampler, group->pressure_fd) > 0))
+  {
+    uint64_t const delta_us = delta_time / NSEC_PER_USEC;
+
+    if (cgroupcpuload_parse_psi_line(sampler->buffer, "some", avg, &total) == 0)
+    {
+      group->pressure.some_avg10    = avg[0];
+      group->pressure.some_avg60    = avg[1];
+      group->pressure.some_avg300   = avg[2];
+      group->pressure.some_interval = (delta_us != 0U) ? (uint32_t)(((total - group->some_total) * 10000U) / delta_us) : 0U;
+      group->some_total             = total;
+    }
+    if (cgroupcpuload_parse_psi_line(sampler->buffer, "full", avg, &total) == 0)
+    {
+      group->pressure.full_avg10    = avg[0];
+      group->pressure.full_avg60    = avg[1];
+      group->pressure.full_avg300   = avg[2];
+      group->pressure.full_interval = (delta_us != 0U) ? (uint32_t)(((total - group->full_total) * 10000U) / delta_us) : 0U;
+      group->full_total             = total;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+DLL_DECL int cgroupcpuload_sampler_update(struct cgroupcpuload_sampler * sampler)
+{
+  struct timespec timespec;
+  uint64_t timestamp;
+  uint64_t delta_time;
+
+  if (sampler == NULL)
+  {
+    return -1;
+  }
+
+  // one timestamp for all groups, the reads follow back-to-back
+  if (clock_gettime(CLOCK_MONOTONIC, &timespec) != 0)
+  {
+    return -1;
+  }
+  timestamp  = TIMESPEC_TO_U64(timespec);
+  delta_time = (sampler->timestamp != 0U) ? (timestamp - sampler->timestamp) : 0U;
+  sampler->timestamp = timestamp;
+
+  for (size_t i = 0U; i < sampler->count; i++)
+  {
+    cgroupcpuload_sampler_update_group(sampler, &sampler->groups[i], delta_time);
   }
+
+  if (sampler->cores != 0U)
+  {
+    (void)cgroupcpuload_sampler_read_stat(sampler, 1);
+  }
+
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+DLL_DECL int cgroupcpuload_sampler_get_version(struct cgroupcpuload_sampler const * sampler)
+{
+  return (sampler != NULL) ? sampler->version : 0;
+}
+
+//------------------------------------------------------------------------------
+DLL_DECL uint32_t cgroupcpuload_sampler_get_load(struct cgroupcpuload_sampler const * sampler, size_t group)
+{
+  return ((sampler != NULL) && (group < sampler->count)) ? sampler->groups[group].load : 0U;
+}
+
+//------------------------------------------------------------------------------
+DLL_DECL uint16_t cgroupcpuload_sampler_get_cores(struct cgroupcpuload_sampler const * sampler)
+{
+  return (sampler != NULL) ? sampler->cores : 0U;
+}
+
+//------------------------------------------------------------------------------
+DLL_DECL uint32_t cgroupcpuload_sampler_get_core_load(struct cgroupcpuload_sampler const * sampler, uint16_t core)
+{
+  return ((sampler != NULL) && (core < sampler->cores)) ? sampler->core_load[core] : 0U;
+}
+
+//------------------------------------------------------------------------------
+DLL_DECL int cgroupcpuload_sampler_get_pressure(struct cgroupcpuload_sampler const * sampler,
+                                                size_t group,
+                                                struct cgroupcpuload_pressure * pressure)
+{
+  if ((sampler == NULL) || (pressure == NULL) || (group >= sampler->count) ||
+      (sampler->groups[group].pressure_fd == -1))
+  {
+    return -1;
+  }
+
+  *pressure = sampler->groups[group].pressure;
+  return 0;
 }
 
 
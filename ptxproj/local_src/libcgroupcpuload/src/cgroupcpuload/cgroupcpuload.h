@@ -20,6 +20,7 @@
 // include files
 //------------------------------------------------------------------------------
 #include <inttypes.h>
+#include <stddef.h>
 
 //------------------------------------------------------------------------------
 // defines; structure, enumeration and type definitions
@@ -33,8 +34,27 @@ struct cgroupcpuload
   uint32_t * load_core;
   uint16_t   cpu_cores;
   int        cpuacct_usage_fd;
+  int        cgroup_version;    // 1: cpuacct.usage_percpu, 2: cpu.stat (unified hierarchy)
+  uint16_t   online_cores;
 };
 
+// Pressure stall information of a cgroup (cgroup v2 only).
+// All values are in hundredths of a percent (10000 == 100%).
+struct cgroupcpuload_pressure
+{
+  uint32_t some_avg10;     // kernel running averages: at least one task stalled
+  uint32_t some_avg60;
+  uint32_t some_avg300;
+  uint32_t full_avg10;     // kernel running averages: all non-idle tasks stalled
+  uint32_t full_avg60;
+  uint32_t full_avg300;
+  uint32_t some_interval;  // share of the last sampling interval with some tasks stalled
+  uint32_t full_interval;  // share of the last sampling interval with all tasks stalled
+};
+
+// Samples several cgroups and the per-core system load with one timestamp.
+struct cgroupcpuload_sampler;
+
 //------------------------------------------------------------------------------
 // function prototypes
 //------------------------------------------------------------------------------
@@ -64,6 +84,42 @@ extern "C"
 
   uint32_t cgroupcpuload_get_load(struct cgroupcpuload * cgroupcpuload);
 
+  //
+  //  Multi-group sampler
+  //
+  //  All files (cpuacct.usage_percpu on cgroup v1, cpu.stat and cpu.pressure on
+  //  cgroup v2, /proc/stat for the per-core breakdown) are opened once and read
+  //  with pread by cgroupcpuload_sampler_update, right after taking a single
+  //  timestamp. The results of the last update are returned by the getters.
+  //
+  //  On cgroup v2 the kernel only reports the total usage of a group, so the load
+  //  of a group is its average over all cores there. The per-core load returned by
+  //  cgroupcpuload_sampler_get_core_load is the busy time of the whole system.
+  //
+
+  struct cgroupcpuload_sampler * cgroupcpuload_sampler_init(char const * const cgroup_paths[], size_t count);
+
+  void cgroupcpuload_sampler_destroy(struct cgroupcpuload_sampler * sampler);
+
+  // Returns 0 on success, -1 on error.
+  int cgroupcpuload_sampler_update(struct cgroupcpuload_sampler * sampler);
+
+  // Returns 1 or 2, 0 if no group could be opened.
+  int cgroupcpuload_sampler_get_version(struct cgroupcpuload_sampler const * sampler);
+
+  // Load of a group in percent, weighted like cgroupcpuload_get_load.
+  uint32_t cgroupcpuload_sampler_get_load(struct cgroupcpuload_sampler const * sampler, size_t group);
+
+  uint16_t cgroupcpuload_sampler_get_cores(struct cgroupcpuload_sampler const * sampler);
+
+  // System load of a core in percent, from /proc/stat.
+  uint32_t cgroupcpuload_sampler_get_core_load(struct cgroupcpuload_sampler const * sampler, uint16_t core);
+
+  // Returns 0 on success, -1 if no pressure information is available (e.g. cgroup v1).
+  int cgroupcpuload_sampler_get_pressure(struct cgroupcpuload_sampler const * sampler,
+                                         size_t group,
+                                         struct cgroupcpuload_pressure * pressure);
+
 
   #ifdef __cplusplus
 } // extern "C"
@@ -48,7 +48,7 @@
 // variables' and constants' definitions
 //------------------------------------------------------------------------------
 
-static char const szCommandlineOptions[] = "hl:o:I:n:";
+static char const szCommandlineOptions[] = "hl:o:I:n:p";
 
 static struct option arstCommandlineOptions[] =
 {
@@ -57,6 +57,7 @@ static struct option arstCommandlineOptions[] =
   { "output-file",                 optional_argument, NULL, 'o' },
   { "interval",                    optional_argument, NULL, 'I' },
   { "count",                       optional_argument, NULL, 'n' },
+  { "pressure",                    no_argument,       NULL, 'p' },
   { NULL,                          no_argument,       NULL,  0  } // End marker, don't remove
 };
 
@@ -68,6 +69,7 @@ static char const * const arszCommandlineOptionTexts[] =
   "Store results to file.",
   "Interval between subsequent readings. (ms)",
   "Count of samples. Measurement ends when the count is reached.",
+  "Add CPU pressure stall columns (some/full, 1/100 %) per group (cgroup v2 only).",
   NULL // End marker, don't remove
 };
 
@@ -78,8 +80,9 @@ static struct Parameters{
     char * groups[50];
     __useconds_t interval_ms;
     uint32_t samples;
+    bool pressure;
     bool running;
-} Options = {STDOUT_FILENO, 0U, {NULL}, 2000U, 200U, true};
+} Options = {STDOUT_FILENO, 0U, {NULL}, 2000U, 200U, false, true};
 
 //------------------------------------------------------------------------------
 // function implementation
@@ -250,6 +253,9 @@ static statusCode_t EvaluateOptions(int const argc,
         }
         break;
 
+      case 'p':
+        Options.pressure = true;
+        break;
 
       case '0':
         if(arstCommandlineOptions[(unsigned int)optionIndex].flag != NULL)
@@ -272,20 +278,7 @@ static statusCode_t EvaluateOptions(int const argc,
 }
 
 
-static void InitializeCGroups(
-    struct cgroupcpuload * cgroups[],
-    char * const groups[],
-    size_t count)
-{
-  assert(NULL != cgroups);
-  for(size_t i = 0U; i < count; ++i)
-  {
-    cgroups[i] = cgroupcpuload_init(groups[i]);
-  }
-}
-
-
-static statusCode_t WriteCsvHeader(char * const groups[], size_t const count)
+static statusCode_t WriteCsvHeader(char * const groups[], size_t const count, bool const pressure)
 {
   bool fOK = false;
   for(size_t i = 0U; i < count; ++i)
@@ -293,6 +286,14 @@ static statusCode_t WriteCsvHeader(char * const groups[], size_t const count)
     fOK = (   (CPULOADMONITOR_SUCCESS == WriteCString(groups[i]))
            && (CPULOADMONITOR_SUCCESS == WriteCString(",")) );
 
+    if(fOK && pressure)
+    {
+      fOK = (   (CPULOADMONITOR_SUCCESS == WriteCString(groups[i]))
+             && (CPULOADMONITOR_SUCCESS == WriteCString(".some,"))
+             && (CPULOADMONITOR_SUCCESS == WriteCString(groups[i]))
+             && (CPULOADMONITOR_SUCCESS == WriteCString(".full,")) );
+    }
+
     if(!fOK)
     {
       break;
@@ -308,61 +309,53 @@ static statusCode_t WriteCsvHeader(char * const groups[], size_t const count)
 }
 
 
-static void DestroyCGroups(struct cgroupcpuload * cgroups[], size_t count)
-{
-  assert(NULL != cgroups);
-  for(size_t i = 0U; i < count; ++i)
-  {
-    cgroupcpuload_destroy(cgroups[i]);
-  }
-}
-
-
 static statusCode_t EvaluateCGroups(
-    struct cgroupcpuload * cgroups[],
+    struct cgroupcpuload_sampler * sampler,
     size_t const count,
     __useconds_t const interval_us,
     uint32_t samples,
+    bool const pressure,
     bool *run_flag)
 {
-  assert(NULL != cgroups);
-  bool fOK = false;
-  uint32_t * const load = calloc(count, sizeof( uint32_t));
+  assert(NULL != sampler);
+  bool fOK = true;
+  char buffer[sizeof("4294967295,4294967295,4294967295,")];
 
-  if(NULL != load)
+  while(   (fOK)
+        && (samples-- != 0U)
+        && ((bool) __atomic_load_n(run_flag, __ATOMIC_RELAXED) ))
   {
-    char buffer[sizeof("100%;")];
-    fOK = true;
-    while(   (fOK)
-          && (samples-- != 0U)
-          && ((bool) __atomic_load_n(run_flag, __ATOMIC_RELAXED) ))
-    {
-      //lint -e(534) Ignoring return value
-      usleep(interval_us);
+    //lint -e(534) Ignoring return value
+    usleep(interval_us);
 
-      for(size_t i = 0U; i < count; ++i)
+    // all groups are sampled with one timestamp
+    (void)cgroupcpuload_sampler_update(sampler);
+
+    for(size_t i = 0U; i < count; ++i)
+    {
+      struct cgroupcpuload_pressure psi = { 0 };
+      if (pressure)
       {
-        load[i] = cgroupcpuload_get_load(cgroups[i]);
+        (void)cgroupcpuload_sampler_get_pressure(sampler, i, &psi);
+        sprintf(buffer, "%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",",
+                cgroupcpuload_sampler_get_load(sampler, i), psi.some_interval, psi.full_interval);
       }
-
-      for(size_t i = 0U; i < count; ++i)
+      else
       {
-        sprintf(buffer, "%" PRIu32 ",", load[i]);
-        fOK = (CPULOADMONITOR_SUCCESS == WriteCString(buffer));
-        if(!fOK)
-        {
-          break;
-        }
+        sprintf(buffer, "%" PRIu32 ",", cgroupcpuload_sampler_get_load(sampler, i));
       }
-      if(fOK)
+      fOK = (CPULOADMONITOR_SUCCESS == WriteCString(buffer));
+      if(!fOK)
       {
-        fOK = (CPULOADMONITOR_SUCCESS == WriteCString("\n"));
+        break;
       }
     }
+    if(fOK)
+    {
+      fOK = (CPULOADMONITOR_SUCCESS == WriteCString("\n"));
+    }
   }
 
-  free(load);
-
   return (fOK) ? CPULOADMONITOR_SUCCESS : CPULOADMONITOR_FILE_WRITE_ERROR;
 }
 
@@ -372,21 +365,22 @@ static statusCode_t MonitorCGroups(
     size_t const count,
     __useconds_t const interval_ms,
     uint32_t samples,
+    bool const pressure,
     bool *run_flag)
 {
 
   bool fOK;
-  struct cgroupcpuload ** cgroups = calloc(count, sizeof(struct cgroupcpuload *));
+  struct cgroupcpuload_sampler * sampler = cgroupcpuload_sampler_init((char const * const *)groups, count);
 
-  InitializeCGroups(cgroups,
-                    groups,
-                    count);
+  if (NULL == sampler)
+  {
+    return CPULOADMONITOR_FAILED;
+  }
 
-  fOK = (   (CPULOADMONITOR_SUCCESS == WriteCsvHeader(groups, count))
-         && (CPULOADMONITOR_SUCCESS == EvaluateCGroups(cgroups, count, interval_ms * 1000U, samples, run_flag)) );
+  fOK = (   (CPULOADMONITOR_SUCCESS == WriteCsvHeader(groups, count, pressure))
+         && (CPULOADMONITOR_SUCCESS == EvaluateCGroups(sampler, count, interval_ms * 1000U, samples, pressure, run_flag)) );
 
-  DestroyCGroups(cgroups, count);
-  free(cgroups);
+  cgroupcpuload_sampler_destroy(sampler);
 
   return (fOK) ? CPULOADMONITOR_SUCCESS : CPULOADMONITOR_FILE_WRITE_ERROR;
 }
@@ -456,6 +450,7 @@ int main (int argc, char * argv[])
                             Options.group_count,
                             Options.interval_ms,
                             Options.samples,
+                            Options.pressure,
                             &Options.running);
   }
 
@@ -22,6 +22,7 @@
 DEFINE_FAKE_VALUE_FUNC1(int, close, int);
 DEFINE_FAKE_VALUE_FUNC3(long int, lseek, int, long int, int);
 DEFINE_FAKE_VALUE_FUNC3(ssize_t, read, int, void *,size_t);
+DEFINE_FAKE_VALUE_FUNC4(ssize_t, pread, int, void *,size_t, off_t);
 
 
 #pragma GCC diagnostic pop
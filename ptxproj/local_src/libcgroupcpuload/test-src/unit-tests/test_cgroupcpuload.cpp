@@ -58,6 +58,7 @@ DEFINE_FFF_GLOBALS;
     FAKE(close) \
     FAKE(lseek) \
     FAKE(read)  \
+    FAKE(pread) \
     FAKE(free)  \
     FAKE(clock_gettime)
 
@@ -103,6 +104,64 @@ static int clock_gettime_custom_fake(clockid_t clockid, timespec * timerval)
 }
 
 
+// cgroup v2 sampler: fds handed out by open_v2_custom_fake
+static const int fd_cpu_stat  = 10;
+static const int fd_pressure  = 11;
+static const int fd_proc_stat = 12;
+static int       sample_phase = 0;
+
+static int open_v2_custom_fake(const char * path, int flags, va_list mode)
+{
+  if (strstr(path, "cpuacct") != nullptr)
+  {
+    return -1;
+  }
+  if (strstr(path, "cpu.stat") != nullptr)
+  {
+    return fd_cpu_stat;
+  }
+  if (strstr(path, "cpu.pressure") != nullptr)
+  {
+    return fd_pressure;
+  }
+  return fd_proc_stat;
+}
+
+static ssize_t pread_v2_custom_fake(int file, void * buffer, size_t maxsize, off_t offset)
+{
+  char * const text = static_cast<char *>(buffer);
+
+  if (file == fd_cpu_stat)
+  {
+    snprintf(text, maxsize, "usage_usec %d\nuser_usec 0\nsystem_usec 0\n", sample_phase * 1000000);
+  }
+  else if (file == fd_pressure)
+  {
+    snprintf(text, maxsize, "some avg10=12.34 avg60=5.60 avg300=0.07 total=%d\n"
+                            "full avg10=1.00 avg60=0.00 avg300=0.00 total=%d\n",
+                            sample_phase * 250000, sample_phase * 100000);
+  }
+  else
+  {
+    snprintf(text, maxsize, "cpu  %d 0 0 %d 0 0 0 0 0 0\n"
+                            "cpu0 %d 0 0 %d 0 0 0 0 0 0\n"
+                            "cpu1 %d 0 0 %d 0 0 0 0 0 0\n"
+                            "intr 0\n",
+                            sample_phase * 100, sample_phase * 100,
+                            sample_phase * 75, sample_phase * 25,
+                            sample_phase * 25, sample_phase * 75);
+  }
+  return static_cast<ssize_t>(strlen(text));
+}
+
+static int clock_gettime_phase_custom_fake(clockid_t clockid, timespec * timerval)
+{
+  timerval->tv_sec  = sample_phase + 1;
+  timerval->tv_nsec = 0;
+  return 0;
+}
+
+
 //------------------------------------------------------------------------------
 // test implementation
 //------------------------------------------------------------------------------
@@ -155,3 +214,59 @@ TEST_F(test_cgroupcpuload, dummy_test)
     ASSERT_EQ(fff.call_history[6], (void *)free);
     */
 }
+
+TEST_F(test_cgroupcpuload, sampler_cgroup_v2)
+{
+    char const * groups[] = { cgrouprts };
+    cgroupcpuload_pressure pressure;
+
+    open_fake.custom_fake          = open_v2_custom_fake;
+    pread_fake.custom_fake         = pread_v2_custom_fake;
+    clock_gettime_fake.custom_fake = clock_gettime_phase_custom_fake;
+    sample_phase = 0;
+
+    cgroupcpuload_sampler * sampler = cgroupcpuload_sampler_init(groups, 1);
+    ASSERT_NE(sampler, nullptr);
+    EXPECT_EQ(cgroupcpuload_sampler_get_version(sampler), 2);
+    EXPECT_EQ(cgroupcpuload_sampler_get_cores(sampler), 2);
+
+    sample_phase = 1;
+    EXPECT_EQ(cgroupcpuload_sampler_update(sampler), 0);
+
+    // 1 s of usage within 1 s on 2 cores
+    EXPECT_EQ(cgroupcpuload_sampler_get_load(sampler, 0), 50);
+    EXPECT_EQ(cgroupcpuload_sampler_get_core_load(sampler, 0), 75);
+    EXPECT_EQ(cgroupcpuload_sampler_get_core_load(sampler, 1), 25);
+
+    ASSERT_EQ(cgroupcpuload_sampler_get_pressure(sampler, 0, &pressure), 0);
+    EXPECT_EQ(pressure.some_avg10, 1234);
+    EXPECT_EQ(pressure.some_avg60, 560);
+    EXPECT_EQ(pressure.some_avg300, 7);
+    EXPECT_EQ(pressure.full_avg10, 100);
+    EXPECT_EQ(pressure.some_interval, 2500);
+    EXPECT_EQ(pressure.full_interval, 1000);
+
+    cgroupcpuload_sampler_destroy(sampler);
+
+    // files are opened once and never read with read()
+    EXPECT_EQ(read_fake.call_count, 0);
+    EXPECT_EQ(close_fake.call_count, 3);
+}
+
+TEST_F(test_cgroupcpuload, sampler_without_pressure_on_cgroup_v1)
+{
+    char const * groups[] = { cgrouprts };
+    cgroupcpuload_pressure pressure;
+
+    open_fake.custom_fake          = open_custom_fake;
+    pread_fake.custom_fake         = pread_v2_custom_fake;
+    clock_gettime_fake.custom_fake = clock_gettime_phase_custom_fake;
+    sample_phase = 0;
+
+    cgroupcpuload_sampler * sampler = cgroupcpuload_sampler_init(groups, 1);
+    ASSERT_NE(sampler, nullptr);
+    EXPECT_EQ(cgroupcpuload_sampler_get_version(sampler), 1);
+    EXPECT_EQ(cgroupcpuload_sampler_get_pressure(sampler, 0, &pressure), -1);
+
+    cgroupcpuload_sampler_destroy(sampler);
+}
@@ -0,0 +1,67 @@
+// Copyright (c) 2022 WAGO GmbH & Co. KG
+// SPDX-License-Identifier: MPL-2.0
+
+// Refresh of a 4 port bridge: one control socket session of mstpd_client
+// compared with the two mstpctl processes (showbridge, showportdetail) the
+// fallback starts. The fallback is measured by process starts of /bin/true
+// only, its lower bound; mstpctl does the same requests on top.
+//
+// usage: refresh_latency.elf [refreshes]
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <string>
+
+#include "fake_mstpd.hpp"
+#include "mstpd_client.hpp"
+#include "program.hpp"
+#include "stp.hpp"
+
+using namespace wago::stp::lib;  // NOLINT(google-build-using-namespace)
+
+int main(int argc, char* argv[]) {
+  int refreshes = (argc > 1) ? ::std::atoi(argv[1]) : 200;
+  if (refreshes <= 0) {
+    ::std::fprintf(stderr, "usage: %s [refreshes]\n", argv[0]);
+    return 1;
+  }
+
+  try {
+    using clock = ::std::chrono::steady_clock;
+
+    ::std::string server_name = ".mstp_server_bench_" + ::std::to_string(::getpid());
+    fake_net_class sysfs;
+    fake_mstpd mstpd{server_name};
+
+    auto start = clock::now();
+    for (int i = 0; i < refreshes; ++i) {
+      mstpd_client client{server_name, sysfs.path()};
+      stp_info info;
+      if (!client.get_info("br0", info).ok() || info.ports.size() != 4) {
+        ::std::fprintf(stderr, "refresh %d failed\n", i);
+        return 1;
+      }
+    }
+    auto native = ::std::chrono::duration<double, ::std::micro>(clock::now() - start).count() / refreshes;
+
+    start = clock::now();
+    for (int i = 0; i < refreshes; ++i) {
+      if (program::execute("/bin/true").get_result() != 0 || program::execute("/bin/true").get_result() != 0) {
+        ::std::fprintf(stderr, "cannot start /bin/true\n");
+        return 1;
+      }
+    }
+    auto exec = ::std::chrono::duration<double, ::std::micro>(clock::now() - start).count() / refreshes;
+
+    ::std::printf("refresh of 4 port bridge (%d runs): control socket %.1f us, 2 process starts %.1f us\n", refreshes,
+                  native, exec);
+  } catch (const ::std::exception& e) {
+    ::std::fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+  return 0;
+}
@@ -7,6 +7,7 @@
 
 #include "config_parser.hpp"
 #include "file.hpp"
+#include "mstpd_client.hpp"
 #include "program.hpp"
 #include "stp.hpp"
 
@@ -31,6 +32,14 @@ status configure_mstp_deamon(::std::string &&path) {
 }  // namespace
 
 status configure_stp(const stp_config &config) {
+  mstpd_client client;
+  if (client.is_connected()) {
+    status s = client.configure(config);
+    if (!client.has_transport_error()) {
+      return s;
+    }
+  }
+
   ::std::stringstream ss = to_stream(config, true);
   status s               = write(ss, MSTPD_BATCH_FILE_CONFIG_PATH);
   if (s.ok()) {
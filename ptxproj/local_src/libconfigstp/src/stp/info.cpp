@@ -7,6 +7,7 @@
 
 #include "configure.hpp"
 #include "info_parser.hpp"
+#include "mstpd_client.hpp"
 #include "program.hpp"
 #include "setup.hpp"
 
@@ -40,9 +41,7 @@ bool mstp_deamon_running() {
   return get_pid_of("/usr/sbin/mstpd") > 0;
 }
 
-}  // namespace
-
-status get_stp_info(stp_info& info) {
+status get_stp_info_by_mstpctl(stp_info& info) {
   info = stp_info{};
   status s{};
   if (mstp_deamon_running()) {
@@ -68,4 +67,26 @@ status get_stp_info(stp_info& info) {
 
   return s;
 }
+
+}  // namespace
+
+status get_stp_info(stp_info& info) {
+  info = stp_info{};
+  mstpd_client client;
+  if (client.is_daemon_absent()) {
+    return status{};
+  }
+  if (client.is_connected()) {
+    info.enabled = true;
+
+    stp_config config{};
+    read_persistence(config);
+
+    status s = client.get_info(config.bridge, info);
+    if (!client.has_transport_error()) {
+      return s;
+    }
+  }
+  return get_stp_info_by_mstpctl(info);
+}
 }  // namespace wago::stp::lib
\ No newline at end of file
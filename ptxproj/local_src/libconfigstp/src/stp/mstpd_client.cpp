@@ -0,0 +1,367 @@
+// Copyright (c) 2022 WAGO GmbH & Co. KG
+// SPDX-License-Identifier: MPL-2.0
+
+#include "mstpd_client.hpp"
+
+#include <arpa/inet.h>
+#include <dirent.h>
+#include <linux/if_bridge.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "mstpd_ctl.hpp"
+
+namespace wago::stp::lib {
+
+namespace {
+
+::std::atomic<unsigned int> client_counter{0};
+
+void set_socket_address(sockaddr_un& sa, const ::std::string& name) {
+  ::std::memset(&sa, 0, sizeof(sa));
+  sa.sun_family = AF_UNIX;
+  // abstract name, the whole sun_path is part of the address (as in mstpd)
+  name.copy(&sa.sun_path[1], sizeof(sa.sun_path) - 2);
+}
+
+// Formats of mstpctl: BR_ID_FMT and PRT_ID_FMT
+::std::string bridge_id_to_string(const ctl::bridge_identifier& id) {
+  auto priority = ntohs(id.s.priority);
+  char buffer[32];
+  ::std::snprintf(buffer, sizeof(buffer), "%01X.%03X.%02X:%02X:%02X:%02X:%02X:%02X", (priority >> 12U) & 0x0FU,
+                  priority & 0x0FFFU, id.s.mac_address[0], id.s.mac_address[1], id.s.mac_address[2],
+                  id.s.mac_address[3], id.s.mac_address[4], id.s.mac_address[5]);
+  return buffer;
+}
+
+::std::string port_id_to_string(ctl::port_identifier id) {
+  auto priority = ntohs(id);
+  char buffer[16];
+  ::std::snprintf(buffer, sizeof(buffer), "%01X.%03X", (priority >> 12U) & 0x0FU, priority & 0x0FFFU);
+  return buffer;
+}
+
+::std::string state_to_string(int state) {
+  switch (state) {
+    case BR_STATE_DISABLED:
+    case BR_STATE_BLOCKING:
+    case BR_STATE_LISTENING:
+      return "discarding";
+    case BR_STATE_LEARNING:
+      return "learning";
+    case BR_STATE_FORWARDING:
+      return "forwarding";
+    default:
+      return "unknown";
+  }
+}
+
+::std::string role_to_string(int role) {
+  switch (role) {
+    case ctl::ROOT:
+      return "Root";
+    case ctl::DESIGNATED:
+      return "Designated";
+    case ctl::ALTERNATE:
+      return "Alternate";
+    case ctl::BACKUP:
+      return "Backup";
+    case ctl::MASTER:
+      return "Master";
+    case ctl::DISABLED:
+      return "Disabled";
+    default:
+      return "Unknown";
+  }
+}
+
+protocol_version to_protocol_version(int protocol) {
+  if (protocol == ctl::RSTP) {
+    return protocol_version::RSTP;
+  }
+  return protocol >= ctl::MSTP ? protocol_version::MSTP : protocol_version::STP;
+}
+
+int to_ctl_protocol(protocol_version protocol) {
+  switch (protocol) {
+    case protocol_version::RSTP:
+      return ctl::RSTP;
+    case protocol_version::MSTP:
+      return ctl::MSTP;
+    default:
+      return ctl::STP;
+  }
+}
+
+::std::uint8_t limit_priority(::std::uint16_t priority) {
+  return static_cast<::std::uint8_t>(::std::min<::std::uint16_t>(priority, 255));
+}
+
+int not_dot_dotdot(const dirent* entry) {
+  return static_cast<int>(::std::strcmp(entry->d_name, ".") != 0 && ::std::strcmp(entry->d_name, "..") != 0);
+}
+
+status invalid_interface(const ::std::string& doc, const ::std::string& ifname) {
+  return status{status_code::SYSTEM_CALL_ERROR,
+                "Can't find index for " + doc + " " + ifname + ". Not a valid interface.\n"};
+}
+
+}  // namespace
+
+mstpd_client::mstpd_client(::std::string server_name, ::std::string net_class_path)
+    : net_class_path_{::std::move(net_class_path)} {
+  int s = ::socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+  if (s < 0) {
+    return;
+  }
+
+  // mstpd needs a named client socket to send the response to
+  sockaddr_un client_address{};
+  set_socket_address(client_address, "CONFIGSTP_" + ::std::to_string(::getpid()) + "_" +
+                                         ::std::to_string(client_counter.fetch_add(1)));
+  sockaddr_un server_address{};
+  set_socket_address(server_address, server_name);
+
+  if (::bind(s, reinterpret_cast<sockaddr*>(&client_address), sizeof(client_address)) != 0) {
+    ::close(s);
+    return;
+  }
+  if (::connect(s, reinterpret_cast<sockaddr*>(&server_address), sizeof(server_address)) != 0) {
+    // abstract sockets vanish with their owner
+    daemon_absent_ = errno == ECONNREFUSED;
+    ::close(s);
+    return;
+  }
+  fd_ = s;
+}
+
+mstpd_client::~mstpd_client() {
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+}
+
+bool mstpd_client::is_connected() const {
+  return fd_ >= 0;
+}
+
+bool mstpd_client::is_daemon_absent() const {
+  return daemon_absent_;
+}
+
+bool mstpd_client::has_transport_error() const {
+  return transport_error_;
+}
+
+int mstpd_client::send_request(int cmd, const void* in, size_t in_size, void* out, size_t out_size,
+                               ::std::string& log) {
+  ctl::msg_hdr hdr{cmd, static_cast<int>(in_size), static_cast<int>(out_size),
+                   static_cast<int>(ctl::LOG_STRING_LEN - 1), 0};
+  char log_buffer[ctl::LOG_STRING_LEN];
+
+  iovec iov[3] = {{&hdr, sizeof(hdr)}, {const_cast<void*>(in), in_size}, {log_buffer, 0}};
+  msghdr msg{};
+  msg.msg_iov    = iov;
+  msg.msg_iovlen = 3;
+
+  transport_error_ = true;
+  if (fd_ < 0 || ::sendmsg(fd_, &msg, MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(hdr) + in_size)) {
+    return -1;
+  }
+
+  pollfd pfd{fd_, POLLIN, 0};
+  int r;
+  do {
+    r = ::poll(&pfd, 1, ctl::RESPONSE_TIMEOUT_MS);
+  } while (r < 0 && errno == EINTR);
+  if (r <= 0) {
+    return -1;
+  }
+
+  iov[1]    = {out, out_size};
+  iov[2]    = {log_buffer, sizeof(log_buffer)};
+  ssize_t l = ::recvmsg(fd_, &msg, 0);
+  if (l < static_cast<ssize_t>(sizeof(hdr)) || l != static_cast<ssize_t>(sizeof(hdr)) + hdr.lout + hdr.llog ||
+      hdr.cmd != cmd || hdr.lout != static_cast<int>(out_size) || hdr.llog < 0 ||
+      hdr.llog >= static_cast<int>(sizeof(log_buffer))) {
+    return -1;
+  }
+  transport_error_ = false;
+  log.assign(log_buffer, static_cast<size_t>(hdr.llog));
+  return hdr.res;
+}
+
+int mstpd_client::get_interface_index(const ::std::string& ifname) const {
+  int index = 0;
+  ::std::ifstream ifindex(net_class_path_ + "/" + ifname + "/ifindex");
+  if (ifname.find('/') != ::std::string::npos || !(ifindex >> index)) {
+    return 0;
+  }
+  return index;
+}
+
+status mstpd_client::get_port_list(const ::std::string& bridge, ::std::vector<::std::string>& ports) const {
+  dirent** namelist = nullptr;
+  ::std::string brif = net_class_path_ + "/" + bridge + "/brif";
+  int count          = ::scandir(brif.c_str(), &namelist, not_dot_dotdot, ::versionsort);
+  if (count < 0) {
+    return status{status_code::SYSTEM_CALL_ERROR, "Error getting list of all ports of bridge " + bridge + "\n"};
+  }
+  for (int i = 0; i < count; ++i) {
+    ports.emplace_back(namelist[i]->d_name);
+    ::free(namelist[i]);  // NOLINT(cppcoreguidelines-no-malloc): allocated by scandir
+  }
+  ::free(namelist);  // NOLINT(cppcoreguidelines-no-malloc)
+  return status{};
+}
+
+status mstpd_client::get_info(const ::std::string& bridge, stp_info& info) {
+  transport_error_ = false;
+  int br_index     = get_interface_index(bridge);
+  if (br_index <= 0) {
+    return invalid_interface("bridge", bridge);
+  }
+
+  ::std::string log;
+  ctl::get_cist_bridge_status_in bridge_in{br_index};
+  ctl::get_cist_bridge_status_out bridge_out{};
+  if (send_request(ctl::GET_CIST_BRIDGE_STATUS, &bridge_in, sizeof(bridge_in), &bridge_out, sizeof(bridge_out),
+                   log) != 0) {
+    return status{status_code::SYSTEM_CALL_ERROR, ::std::move(log)};
+  }
+
+  const auto& b      = bridge_out.status;
+  info.bridge        = bridge;
+  info.priority      = bridge_id_to_string(b.bridge_id);
+  info.protocol      = to_protocol_version(b.protocol_version);
+  info.forward_delay = b.root_forward_delay;
+  info.hello_time    = b.bridge_hello_time;
+  info.max_age       = b.root_max_age;
+  info.max_hops      = b.max_hops;
+  info.path_cost     = b.root_path_cost;
+
+  ::std::vector<::std::string> ports;
+  status s = get_port_list(bridge, ports);
+  for (const auto& port : ports) {
+    if (!s.ok()) {
+      break;
+    }
+    int port_index = get_interface_index(port);
+    if (port_index <= 0) {
+      s = invalid_interface("port", port);
+      break;
+    }
+    ctl::get_cist_port_status_in port_in{br_index, port_index};
+    ctl::get_cist_port_status_out port_out{};
+    if (send_request(ctl::GET_CIST_PORT_STATUS, &port_in, sizeof(port_in), &port_out, sizeof(port_out), log) != 0) {
+      s = status{status_code::SYSTEM_CALL_ERROR, ::std::move(log)};
+      break;
+    }
+
+    const auto& p = port_out.status;
+    stp_port_info pi;
+    pi.port        = port;
+    pi.role        = role_to_string(p.role);
+    pi.status      = state_to_string(p.state);
+    pi.priority    = port_id_to_string(p.port_id);
+    pi.edge_port   = p.admin_edge_port;
+    pi.bpdu_filter = p.bpdu_filter_port;
+    pi.bpdu_guard  = p.bpdu_guard_port;
+    pi.root_guard  = p.restricted_role;
+    pi.path_cost   = p.external_port_path_cost;
+    info.ports.emplace_back(pi);
+  }
+  return s;
+}
+
+status mstpd_client::configure(const stp_config& config) {
+  transport_error_ = false;
+  int br_index     = get_interface_index(config.bridge);
+  if (br_index <= 0) {
+    return invalid_interface("bridge", config.bridge);
+  }
+
+  // mstpctl reports failed bridge and port settings on stdout, everything else on stderr
+  ::std::string log;
+  auto request = [&](int cmd, const auto& in, const char* failed_setting) {
+    if (send_request(cmd, &in, sizeof(in), nullptr, 0, log) == 0) {
+      return status{};
+    }
+    if (transport_error_ || failed_setting == nullptr) {
+      return status{status_code::SYSTEM_CALL_ERROR, ::std::move(log)};
+    }
+    return status{status_code::WRONG_PARAMETER_PATTERN, ::std::string("Couldn't change ") + failed_setting + "\n"};
+  };
+  auto set_bridge = [&](auto&& set, const char* field) {
+    ctl::set_cist_bridge_config_in in{};
+    in.br_index = br_index;
+    set(in.cfg);
+    return request(ctl::SET_CIST_BRIDGE_CONFIG, in, field);
+  };
+  auto set_port = [&](int port_index, auto&& set, const char* field) {
+    ctl::set_cist_port_config_in in{};
+    in.br_index   = br_index;
+    in.port_index = port_index;
+    set(in.cfg);
+    return request(ctl::SET_CIST_PORT_CONFIG, in, field);
+  };
+
+  // same order as the batch file: max age is lowered first to keep it consistent with forward delay
+  ctl::set_msti_bridge_config_in priority_in{br_index, ctl::CIST_MSTID, limit_priority(config.priority)};
+  // clang-format off
+  status s = set_bridge([&](auto& c) { c.protocol_version = to_ctl_protocol(config.protocol);
+                                       c.set_protocol_version = true; }, "bridge protocol_version");
+  if (s.ok()) { s = request(ctl::SET_MSTI_BRIDGE_CONFIG, priority_in, nullptr); }
+  if (s.ok()) { s = set_bridge([&](auto& c) { c.bridge_max_age = 6; c.set_bridge_max_age = true; }, "bridge bridge_max_age"); }
+  if (s.ok()) { s = set_bridge([&](auto& c) { c.bridge_forward_delay = config.forward_delay; c.set_bridge_forward_delay = true; },
+                               "bridge bridge_forward_delay"); }
+  if (s.ok()) { s = set_bridge([&](auto& c) { c.bridge_max_age = config.max_age; c.set_bridge_max_age = true; }, "bridge bridge_max_age"); }
+  if (s.ok()) { s = set_bridge([&](auto& c) { c.max_hops = config.max_hops; c.set_max_hops = true; }, "bridge max_hops"); }
+  if (s.ok()) { s = set_bridge([&](auto& c) { c.bridge_hello_time = config.hello_time; c.set_bridge_hello_time = true; },
+                               "bridge bridge_hello_time"); }
+
+  for (const auto& port : config.port_configs) {
+    if (!s.ok()) {
+      break;
+    }
+    int port_index = get_interface_index(port.port);
+    if (port_index <= 0) {
+      s = invalid_interface("port", port.port);
+      break;
+    }
+    ctl::set_msti_port_config_in prio_in{};
+    prio_in.br_index              = br_index;
+    prio_in.port_index            = port_index;
+    prio_in.mstid                 = ctl::CIST_MSTID;
+    prio_in.cfg.port_priority     = limit_priority(port.priority);
+    prio_in.cfg.set_port_priority = true;
+
+    s = request(ctl::SET_MSTI_PORT_CONFIG, prio_in, "per-tree port port_priority");
+    if (s.ok()) { s = set_port(port_index, [&](auto& c) { c.admin_external_port_path_cost = port.path_cost;
+                                                          c.set_admin_external_port_path_cost = true; },
+                               "port admin_external_port_path_cost"); }
+    if (s.ok()) { s = set_port(port_index, [&](auto& c) { c.bpdu_guard_port = port.bpdu_guard; c.set_bpdu_guard_port = true; },
+                               "port bpdu_guard_port"); }
+    if (s.ok()) { s = set_port(port_index, [&](auto& c) { c.bpdu_filter_port = port.bpdu_filter; c.set_bpdu_filter_port = true; },
+                               "port bpdu_filter_port"); }
+    if (s.ok()) { s = set_port(port_index, [&](auto& c) { c.admin_edge_port = port.edge_port; c.set_admin_edge_port = true; },
+                               "port admin_edge_port"); }
+    if (s.ok()) { s = set_port(port_index, [&](auto& c) { c.restricted_role = port.root_guard; c.set_restricted_role = true; },
+                               "port restricted_role"); }
+  }
+  // clang-format on
+  return s;
+}
+
+}  // namespace wago::stp::lib
@@ -0,0 +1,56 @@
+// Copyright (c) 2022 WAGO GmbH & Co. KG
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "stp.hpp"
+
+namespace wago::stp::lib {
+
+constexpr auto MSTPD_SERVER_SOCKET_NAME = ".mstp_server";
+constexpr auto SYSFS_CLASS_NET_PATH     = "/sys/class/net";
+
+// Client for the control socket of mstpd (the protocol mstpctl speaks).
+// Reads all bridge and port details within one session and applies a configuration
+// without starting mstpctl for every request.
+class mstpd_client {
+ public:
+  explicit mstpd_client(::std::string server_name = MSTPD_SERVER_SOCKET_NAME,
+                        ::std::string net_class_path = SYSFS_CLASS_NET_PATH);
+  ~mstpd_client();
+  mstpd_client(const mstpd_client&)            = delete;
+  mstpd_client& operator=(const mstpd_client&) = delete;
+  mstpd_client(mstpd_client&&)                 = delete;
+  mstpd_client& operator=(mstpd_client&&)      = delete;
+
+  bool is_connected() const;
+
+  // Nobody listens on the control socket: mstpd is not running.
+  bool is_daemon_absent() const;
+
+  // The last call failed because of the control socket, not because of mstpd.
+  // The caller may retry with mstpctl.
+  bool has_transport_error() const;
+
+  // Same content as parse_stp_info of "mstpctl showbridge/showportdetail -f json <bridge>".
+  status get_info(const ::std::string& bridge, stp_info& info);
+
+  // Same requests as "mstpctl --batch" with to_stream(config, true).
+  status configure(const stp_config& config);
+
+ private:
+  int fd_               = -1;
+  bool daemon_absent_   = false;
+  bool transport_error_ = false;
+  ::std::string net_class_path_;
+
+  int send_request(int cmd, const void* in, size_t in_size, void* out, size_t out_size, ::std::string& log);
+  int get_interface_index(const ::std::string& ifname) const;
+  status get_port_list(const ::std::string& bridge, ::std::vector<::std::string>& ports) const;
+};
+
+}  // namespace wago::stp::lib
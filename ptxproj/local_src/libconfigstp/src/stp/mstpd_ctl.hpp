@@ -0,0 +1,217 @@
+// Copyright (c) 2022 WAGO GmbH & Co. KG
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <net/if.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace wago::stp::lib {
+
+// Control protocol of mstpd 0.1.0 (ctl_functions.h, mstp.h). The structures are
+// exchanged in host byte order and layout, so they have to match the daemon exactly.
+namespace ctl {
+
+constexpr int GET_CIST_BRIDGE_STATUS = 101;
+constexpr int SET_CIST_BRIDGE_CONFIG = 103;
+constexpr int SET_MSTI_BRIDGE_CONFIG = 104;
+constexpr int GET_CIST_PORT_STATUS   = 105;
+constexpr int SET_CIST_PORT_CONFIG   = 107;
+constexpr int SET_MSTI_PORT_CONFIG   = 108;
+
+constexpr ::std::size_t LOG_STRING_LEN   = 256;
+constexpr int RESPONSE_TIMEOUT_MS = 5000;
+
+constexpr ::std::uint16_t CIST_MSTID = 0;
+
+enum protocol : int { STP = 0, RSTP = 2, MSTP = 3 };
+
+enum role : int { DISABLED, ROOT, DESIGNATED, ALTERNATE, BACKUP, MASTER };
+
+struct msg_hdr {
+  int cmd;
+  int lin;
+  int lout;
+  int llog;
+  int res;
+};
+
+union bridge_identifier {
+  ::std::uint64_t u;
+  struct {
+    ::std::uint16_t priority;  // big endian
+    ::std::uint8_t mac_address[6];
+  } __attribute__((packed)) s;
+};
+
+using port_identifier = ::std::uint16_t;  // big endian
+
+struct cist_bridge_status {
+  bridge_identifier bridge_id;
+  unsigned int time_since_topology_change;
+  unsigned int topology_change_count;
+  bool topology_change;
+  char topology_change_port[IFNAMSIZ];
+  char last_topology_change_port[IFNAMSIZ];
+  bridge_identifier designated_root;
+  unsigned int root_path_cost;
+  port_identifier root_port_id;
+  ::std::uint8_t root_max_age;
+  ::std::uint8_t root_forward_delay;
+  ::std::uint8_t bridge_max_age;
+  ::std::uint8_t bridge_forward_delay;
+  unsigned int tx_hold_count;
+  int protocol_version;
+  bridge_identifier regional_root;
+  unsigned int internal_path_cost;
+  bool enabled;
+  unsigned int ageing_time;
+  ::std::uint8_t max_hops;
+  ::std::uint8_t bridge_hello_time;
+};
+
+struct cist_bridge_config {
+  ::std::uint8_t bridge_max_age;
+  bool set_bridge_max_age;
+  ::std::uint8_t bridge_forward_delay;
+  bool set_bridge_forward_delay;
+  int protocol_version;
+  bool set_protocol_version;
+  unsigned int tx_hold_count;
+  bool set_tx_hold_count;
+  ::std::uint8_t max_hops;
+  bool set_max_hops;
+  ::std::uint8_t bridge_hello_time;
+  bool set_bridge_hello_time;
+  unsigned int bridge_ageing_time;
+  bool set_bridge_ageing_time;
+};
+
+struct cist_port_status {
+  unsigned int uptime;
+  int state;
+  port_identifier port_id;
+  ::std::uint32_t admin_external_port_path_cost;
+  ::std::uint32_t external_port_path_cost;
+  bridge_identifier designated_root;
+  ::std::uint32_t designated_external_cost;
+  bridge_identifier designated_bridge;
+  port_identifier designated_port;
+  bool tc_ack;
+  ::std::uint8_t port_hello_time;
+  bool admin_edge_port;
+  bool auto_edge_port;
+  bool oper_edge_port;
+  bool enabled;
+  int admin_p2p;
+  bool oper_p2p;
+  bool restricted_role;
+  bool restricted_tcn;
+  int role;
+  bool disputed;
+  bridge_identifier designated_regional_root;
+  ::std::uint32_t designated_internal_cost;
+  ::std::uint32_t admin_internal_port_path_cost;
+  ::std::uint32_t internal_port_path_cost;
+  bool bpdu_guard_port;
+  bool bpdu_guard_error;
+  bool bpdu_filter_port;
+  bool network_port;
+  bool ba_inconsistent;
+  unsigned int num_rx_bpdu_filtered;
+  unsigned int num_rx_bpdu;
+  unsigned int num_rx_tcn;
+  unsigned int num_tx_bpdu;
+  unsigned int num_tx_tcn;
+  unsigned int num_trans_fwd;
+  unsigned int num_trans_blk;
+  bool rcvd_bpdu;
+  bool rcvd_rstp;
+  bool rcvd_stp;
+  bool rcvd_tc_ack;
+  bool rcvd_tcn;
+  bool send_rstp;
+};
+
+struct cist_port_config {
+  ::std::uint32_t admin_external_port_path_cost;
+  bool set_admin_external_port_path_cost;
+  bool admin_edge_port;
+  bool set_admin_edge_port;
+  bool auto_edge_port;
+  bool set_auto_edge_port;
+  int admin_p2p;
+  bool set_admin_p2p;
+  bool restricted_role;
+  bool set_restricted_role;
+  bool restricted_tcn;
+  bool set_restricted_tcn;
+  bool bpdu_guard_port;
+  bool set_bpdu_guard_port;
+  bool network_port;
+  bool set_network_port;
+  bool dont_txmt;
+  bool set_dont_txmt;
+  bool bpdu_filter_port;
+  bool set_bpdu_filter_port;
+};
+
+struct msti_port_config {
+  ::std::uint32_t admin_internal_port_path_cost;
+  bool set_admin_internal_port_path_cost;
+  ::std::uint8_t port_priority;
+  bool set_port_priority;
+};
+
+struct get_cist_bridge_status_in {
+  int br_index;
+};
+struct get_cist_bridge_status_out {
+  cist_bridge_status status;
+  char root_port_name[IFNAMSIZ];
+};
+struct set_cist_bridge_config_in {
+  int br_index;
+  cist_bridge_config cfg;
+};
+struct set_msti_bridge_config_in {
+  int br_index;
+  ::std::uint16_t mstid;
+  ::std::uint8_t bridge_priority;
+};
+struct get_cist_port_status_in {
+  int br_index;
+  int port_index;
+};
+struct get_cist_port_status_out {
+  cist_port_status status;
+};
+struct set_cist_port_config_in {
+  int br_index;
+  int port_index;
+  cist_port_config cfg;
+};
+struct set_msti_port_config_in {
+  int br_index;
+  int port_index;
+  ::std::uint16_t mstid;
+  msti_port_config cfg;
+};
+
+// mstpd rejects messages whose sizes differ from its own structures
+static_assert(sizeof(cist_bridge_status) == 112, "CIST_BridgeStatus layout");
+static_assert(sizeof(cist_bridge_config) == 32, "CIST_BridgeConfig layout");
+static_assert(sizeof(cist_port_status) == 136, "CIST_PortStatus layout");
+static_assert(sizeof(cist_port_config) == 32, "CIST_PortConfig layout");
+static_assert(sizeof(msti_port_config) == 8, "MSTI_PortConfig layout");
+static_assert(sizeof(get_cist_bridge_status_out) == 128, "get_cist_bridge_status_OUT layout");
+static_assert(sizeof(set_cist_bridge_config_in) == 36, "set_cist_bridge_config_IN layout");
+static_assert(sizeof(set_msti_bridge_config_in) == 8, "set_msti_bridge_config_IN layout");
+static_assert(sizeof(set_cist_port_config_in) == 40, "set_cist_port_config_IN layout");
+static_assert(sizeof(set_msti_port_config_in) == 20, "set_msti_port_config_IN layout");
+
+}  // namespace ctl
+
+}  // namespace wago::stp::lib
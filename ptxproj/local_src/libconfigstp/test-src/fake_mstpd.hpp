@@ -0,0 +1,211 @@
+// Copyright (c) 2022 WAGO GmbH & Co. KG
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <arpa/inet.h>
+#include <linux/if_bridge.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "mstpd_ctl.hpp"
+
+// Stand-ins for mstpd and /sys/class/net shared by the unit tests and the
+// refresh benchmark.
+
+namespace wago::stp::lib {
+
+constexpr int BRIDGE_INDEX = 10;
+
+inline void set_abstract_address(sockaddr_un& sa, const ::std::string& name) {
+  ::std::memset(&sa, 0, sizeof(sa));
+  sa.sun_family = AF_UNIX;
+  name.copy(&sa.sun_path[1], sizeof(sa.sun_path) - 2);
+}
+
+inline ctl::bridge_identifier make_bridge_id(::std::uint16_t priority) {
+  ctl::bridge_identifier id{};
+  const ::std::uint8_t mac[] = {0x00, 0x30, 0xDE, 0x42, 0x5D, 0xE4};
+  id.s.priority              = htons(priority);
+  ::std::memcpy(id.s.mac_address, mac, sizeof(mac));
+  return id;
+}
+
+// Answers the control requests like mstpd does for a bridge br0 (index 10) with the
+// ports ethX1..ethX4 (index 1..4).
+class fake_mstpd {
+ public:
+  struct request {
+    int cmd;
+    ::std::vector<char> in;
+  };
+
+  explicit fake_mstpd(::std::string name) {
+    fd_ = ::socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    sockaddr_un sa{};
+    set_abstract_address(sa, name);
+    if (::bind(fd_, reinterpret_cast<sockaddr*>(&sa), sizeof(sa)) != 0) {
+      auto error = errno;
+      ::close(fd_);
+      throw ::std::system_error(error, ::std::generic_category(), "fake_mstpd bind");
+    }
+    thread_ = ::std::thread([this]() { serve(); });
+  }
+
+  ~fake_mstpd() {
+    stop_ = true;
+    thread_.join();
+    ::close(fd_);
+  }
+
+  fake_mstpd(const fake_mstpd&)            = delete;
+  fake_mstpd& operator=(const fake_mstpd&) = delete;
+
+  ::std::vector<request> get_requests() {
+    ::std::lock_guard<::std::mutex> lock(mutex_);
+    return requests_;
+  }
+
+  ::std::atomic<int> failing_cmd{0};
+  ::std::atomic<int> failing_request{-1};
+
+ private:
+  int fd_ = -1;
+  ::std::atomic<bool> stop_{false};
+  ::std::thread thread_;
+  ::std::mutex mutex_;
+  ::std::vector<request> requests_;
+
+  void serve() {
+    while (!stop_) {
+      pollfd pfd{fd_, POLLIN, 0};
+      if (::poll(&pfd, 1, 10) <= 0) {
+        continue;
+      }
+      ctl::msg_hdr hdr{};
+      char in[512];
+      sockaddr_un sa{};
+      iovec iov[2] = {{&hdr, sizeof(hdr)}, {in, sizeof(in)}};
+      msghdr msg{};
+      msg.msg_name    = &sa;
+      msg.msg_namelen = sizeof(sa);
+      msg.msg_iov     = iov;
+      msg.msg_iovlen  = 2;
+      ssize_t l       = ::recvmsg(fd_, &msg, 0);
+      if (l < static_cast<ssize_t>(sizeof(hdr))) {
+        continue;
+      }
+
+      ::std::vector<char> out(static_cast<size_t>(hdr.lout));
+      int number;
+      {
+        ::std::lock_guard<::std::mutex> lock(mutex_);
+        number = static_cast<int>(requests_.size());
+        requests_.push_back(request{hdr.cmd, ::std::vector<char>(in, in + hdr.lin)});
+      }
+      hdr.res = answer(hdr.cmd, in, out);
+      if (hdr.cmd == failing_cmd || number == failing_request) {
+        hdr.res = -1;
+      }
+      ::std::string log = hdr.res != 0 ? "CTL: request failed\n" : "";
+      hdr.llog          = static_cast<int>(log.size());
+
+      iovec out_iov[3] = {{&hdr, sizeof(hdr)}, {out.data(), out.size()}, {log.data(), log.size()}};
+      msg.msg_iov      = out_iov;
+      msg.msg_iovlen   = 3;
+      ::sendmsg(fd_, &msg, MSG_NOSIGNAL);
+    }
+  }
+
+  static int answer(int cmd, const char* in, ::std::vector<char>& out) {
+    if (cmd == ctl::GET_CIST_BRIDGE_STATUS && out.size() == sizeof(ctl::get_cist_bridge_status_out)) {
+      ctl::get_cist_bridge_status_in br_in{};
+      ::std::memcpy(&br_in, in, sizeof(br_in));
+      if (br_in.br_index != BRIDGE_INDEX) {
+        return -1;
+      }
+      ctl::get_cist_bridge_status_out o{};
+      o.status.bridge_id          = make_bridge_id(0x8000);
+      o.status.root_path_cost     = 10;
+      o.status.root_max_age       = 12;
+      o.status.root_forward_delay = 14;
+      o.status.max_hops           = 17;
+      o.status.bridge_hello_time  = 18;
+      o.status.protocol_version   = ctl::RSTP;
+      ::std::memcpy(out.data(), &o, sizeof(o));
+      return 0;
+    }
+    if (cmd == ctl::GET_CIST_PORT_STATUS && out.size() == sizeof(ctl::get_cist_port_status_out)) {
+      ctl::get_cist_port_status_in port_in{};
+      ::std::memcpy(&port_in, in, sizeof(port_in));
+      ctl::get_cist_port_status_out o{};
+      bool odd                         = (port_in.port_index % 2) != 0;
+      o.status.port_id                 = htons(static_cast<::std::uint16_t>(0x8000 + port_in.port_index));
+      o.status.state                   = odd ? BR_STATE_FORWARDING : BR_STATE_BLOCKING;
+      o.status.role                    = odd ? ctl::DESIGNATED : ctl::DISABLED;
+      o.status.external_port_path_cost = 200000 + static_cast<::std::uint32_t>(port_in.port_index);
+      o.status.admin_edge_port         = !odd;
+      o.status.bpdu_guard_port         = !odd;
+      o.status.bpdu_filter_port        = !odd;
+      o.status.restricted_role         = !odd;
+      ::std::memcpy(out.data(), &o, sizeof(o));
+      return 0;
+    }
+    return 0;
+  }
+};
+
+// Temporary /sys/class/net tree with the bridge br0 (index 10) and its ports
+// ethX1..ethX4 (index 1..4), removed on destruction.
+class fake_net_class {
+ public:
+  fake_net_class() {
+    char dir[] = "/tmp/mstpd_client_test_XXXXXX";
+    if (::mkdtemp(dir) == nullptr) {
+      throw ::std::system_error(errno, ::std::generic_category(), "fake_net_class mkdtemp");
+    }
+    path_ = dir;
+    add_interface("br0", BRIDGE_INDEX);
+    for (int i = 1; i <= 4; ++i) {
+      auto port = "ethX" + ::std::to_string(i);
+      add_interface(port, i);
+      ::std::ofstream(path_ / "br0" / "brif" / port).flush();
+    }
+  }
+
+  ~fake_net_class() {
+    ::std::error_code ec;
+    ::std::filesystem::remove_all(path_, ec);
+  }
+
+  fake_net_class(const fake_net_class&)            = delete;
+  fake_net_class& operator=(const fake_net_class&) = delete;
+
+  const ::std::filesystem::path& path() const {
+    return path_;
+  }
+
+  void add_interface(const ::std::string& name, int index) {
+    ::std::filesystem::create_directories(path_ / name / "brif");
+    ::std::ofstream(path_ / name / "ifindex") << index << "\n";
+  }
+
+ private:
+  ::std::filesystem::path path_;
+};
+
+}  // namespace wago::stp::lib
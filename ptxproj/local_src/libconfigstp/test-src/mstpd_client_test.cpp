@@ -0,0 +1,218 @@
+// Copyright (c) 2022 WAGO GmbH & Co. KG
+// SPDX-License-Identifier: MPL-2.0
+
+#include "mstpd_client.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include "fake_mstpd.hpp"
+#include "mstpd_ctl.hpp"
+#include "stp.hpp"
+
+namespace wago::stp::lib {
+
+namespace {
+
+class mstpd_client_test : public testing::Test {
+ public:
+  ::std::string server_name = ".mstp_server_test_" + ::std::to_string(::getpid());
+  ::std::unique_ptr<fake_net_class> sysfs;
+  ::std::filesystem::path net_class;
+
+  void SetUp() override {
+    sysfs     = ::std::make_unique<fake_net_class>();
+    net_class = sysfs->path();
+  }
+
+  void TearDown() override {
+    sysfs.reset();
+  }
+
+  template <typename T>
+  static T request_as(const fake_mstpd::request& r) {
+    T t{};
+    EXPECT_EQ(sizeof(T), r.in.size());
+    ::std::memcpy(&t, r.in.data(), ::std::min(sizeof(T), r.in.size()));
+    return t;
+  }
+};
+
+}  // namespace
+
+TEST_F(mstpd_client_test, ReportsAbsentDaemon) {
+  mstpd_client client{server_name, net_class};
+
+  EXPECT_FALSE(client.is_connected());
+  EXPECT_TRUE(client.is_daemon_absent());
+}
+
+TEST_F(mstpd_client_test, GetInfoMatchesMstpctlOutput) {
+  fake_mstpd mstpd{server_name};
+  mstpd_client client{server_name, net_class};
+  ASSERT_TRUE(client.is_connected());
+
+  stp_info info;
+  status s = client.get_info("br0", info);
+
+  ASSERT_TRUE(s.ok()) << s.to_string();
+  EXPECT_FALSE(client.has_transport_error());
+  EXPECT_EQ("br0", info.bridge);
+  EXPECT_EQ("8.000.00:30:DE:42:5D:E4", info.priority);
+  EXPECT_EQ(protocol_version::RSTP, info.protocol);
+  EXPECT_EQ(14, info.forward_delay);
+  EXPECT_EQ(18, info.hello_time);
+  EXPECT_EQ(12, info.max_age);
+  EXPECT_EQ(17, info.max_hops);
+  EXPECT_EQ(10, info.path_cost);
+
+  ASSERT_EQ(4, info.ports.size());
+  EXPECT_EQ("ethX1", info.ports[0].port);
+  EXPECT_EQ("8.001", info.ports[0].priority);
+  EXPECT_EQ("Designated", info.ports[0].role);
+  EXPECT_EQ("forwarding", info.ports[0].status);
+  EXPECT_EQ(200001, info.ports[0].path_cost);
+  EXPECT_FALSE(info.ports[0].edge_port);
+  EXPECT_FALSE(info.ports[0].root_guard);
+
+  EXPECT_EQ("ethX2", info.ports[1].port);
+  EXPECT_EQ("8.002", info.ports[1].priority);
+  EXPECT_EQ("Disabled", info.ports[1].role);
+  EXPECT_EQ("discarding", info.ports[1].status);
+  EXPECT_TRUE(info.ports[1].edge_port);
+  EXPECT_TRUE(info.ports[1].bpdu_guard);
+  EXPECT_TRUE(info.ports[1].bpdu_filter);
+  EXPECT_TRUE(info.ports[1].root_guard);
+
+  EXPECT_EQ(5, mstpd.get_requests().size());
+}
+
+TEST_F(mstpd_client_test, GetInfoFailsForUnknownBridge) {
+  fake_mstpd mstpd{server_name};
+  mstpd_client client{server_name, net_class};
+
+  stp_info info;
+  status s = client.get_info("br1", info);
+
+  EXPECT_EQ(status_code::SYSTEM_CALL_ERROR, s.get_code());
+  EXPECT_FALSE(client.has_transport_error());
+  EXPECT_TRUE(mstpd.get_requests().empty());
+}
+
+TEST_F(mstpd_client_test, ConfigureSendsBatchRequests) {
+  fake_mstpd mstpd{server_name};
+  mstpd_client client{server_name, net_class};
+
+  stp_config config;
+  config.bridge        = "br0";
+  config.protocol      = protocol_version::RSTP;
+  config.priority      = 4;
+  config.forward_delay = 21;
+  config.max_age       = 30;
+  config.hello_time    = 3;
+  config.max_hops      = 25;
+  stp_port_config port{"ethX3"};
+  port.priority   = 300;
+  port.path_cost  = 1234;
+  port.edge_port  = true;
+  port.root_guard = true;
+  config.port_configs.push_back(port);
+
+  status s = client.configure(config);
+  ASSERT_TRUE(s.ok()) << s.to_string();
+
+  auto requests = mstpd.get_requests();
+  ASSERT_EQ(13, requests.size());
+
+  auto protocol = request_as<ctl::set_cist_bridge_config_in>(requests[0]);
+  EXPECT_EQ(ctl::SET_CIST_BRIDGE_CONFIG, requests[0].cmd);
+  EXPECT_EQ(BRIDGE_INDEX, protocol.br_index);
+  EXPECT_TRUE(protocol.cfg.set_protocol_version);
+  EXPECT_FALSE(protocol.cfg.set_bridge_max_age);
+  EXPECT_EQ(ctl::RSTP, protocol.cfg.protocol_version);
+
+  auto priority = request_as<ctl::set_msti_bridge_config_in>(requests[1]);
+  EXPECT_EQ(ctl::SET_MSTI_BRIDGE_CONFIG, requests[1].cmd);
+  EXPECT_EQ(0, priority.mstid);
+  EXPECT_EQ(4, priority.bridge_priority);
+
+  EXPECT_EQ(6, request_as<ctl::set_cist_bridge_config_in>(requests[2]).cfg.bridge_max_age);
+  EXPECT_EQ(21, request_as<ctl::set_cist_bridge_config_in>(requests[3]).cfg.bridge_forward_delay);
+  EXPECT_EQ(30, request_as<ctl::set_cist_bridge_config_in>(requests[4]).cfg.bridge_max_age);
+  EXPECT_EQ(25, request_as<ctl::set_cist_bridge_config_in>(requests[5]).cfg.max_hops);
+  EXPECT_EQ(3, request_as<ctl::set_cist_bridge_config_in>(requests[6]).cfg.bridge_hello_time);
+
+  auto port_priority = request_as<ctl::set_msti_port_config_in>(requests[7]);
+  EXPECT_EQ(ctl::SET_MSTI_PORT_CONFIG, requests[7].cmd);
+  EXPECT_EQ(3, port_priority.port_index);
+  EXPECT_TRUE(port_priority.cfg.set_port_priority);
+  EXPECT_EQ(255, port_priority.cfg.port_priority);
+
+  auto path_cost = request_as<ctl::set_cist_port_config_in>(requests[8]);
+  EXPECT_EQ(ctl::SET_CIST_PORT_CONFIG, requests[8].cmd);
+  EXPECT_TRUE(path_cost.cfg.set_admin_external_port_path_cost);
+  EXPECT_EQ(1234, path_cost.cfg.admin_external_port_path_cost);
+
+  EXPECT_TRUE(request_as<ctl::set_cist_port_config_in>(requests[9]).cfg.set_bpdu_guard_port);
+  EXPECT_FALSE(request_as<ctl::set_cist_port_config_in>(requests[9]).cfg.bpdu_guard_port);
+  EXPECT_TRUE(request_as<ctl::set_cist_port_config_in>(requests[10]).cfg.set_bpdu_filter_port);
+  EXPECT_TRUE(request_as<ctl::set_cist_port_config_in>(requests[11]).cfg.admin_edge_port);
+  EXPECT_TRUE(request_as<ctl::set_cist_port_config_in>(requests[12]).cfg.restricted_role);
+}
+
+TEST_F(mstpd_client_test, ConfigureStopsAtRejectedSetting) {
+  fake_mstpd mstpd{server_name};
+  mstpd.failing_request = 3;
+  mstpd_client client{server_name, net_class};
+
+  stp_config config;
+  config.bridge = "br0";
+  config.port_configs.push_back(stp_port_config{"ethX1"});
+
+  status s = client.configure(config);
+
+  EXPECT_EQ(status_code::WRONG_PARAMETER_PATTERN, s.get_code());
+  EXPECT_EQ("Couldn't change bridge bridge_forward_delay\n", s.to_string());
+  EXPECT_FALSE(client.has_transport_error());
+  EXPECT_EQ(4, mstpd.get_requests().size());
+}
+
+TEST_F(mstpd_client_test, ConfigureFailsForUnknownPort) {
+  fake_mstpd mstpd{server_name};
+  mstpd_client client{server_name, net_class};
+
+  stp_config config;
+  config.bridge = "br0";
+  config.port_configs.push_back(stp_port_config{"ethX9"});
+
+  status s = client.configure(config);
+
+  EXPECT_EQ(status_code::SYSTEM_CALL_ERROR, s.get_code());
+  EXPECT_EQ(7, mstpd.get_requests().size());
+}
+
+TEST_F(mstpd_client_test, RefreshFourPortBridgeRepeatedly) {
+  fake_mstpd mstpd{server_name};
+  constexpr int refreshes = 3;
+
+  for (int i = 0; i < refreshes; ++i) {
+    mstpd_client client{server_name, net_class};
+    stp_info info;
+    ASSERT_TRUE(client.get_info("br0", info).ok());
+    ASSERT_EQ(4, info.ports.size());
+    EXPECT_EQ("ethX4", info.ports[3].port);
+  }
+
+  // one bridge and four port requests per refresh, no other traffic
+  EXPECT_EQ(refreshes * 5, mstpd.get_requests().size());
+}
+
+}  // namespace wago::stp::lib
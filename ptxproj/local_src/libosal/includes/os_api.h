@@ -745,6 +745,9 @@ void os_critical_section_unlock (handle_t section);
  * Routines:
  *  - @ref os_memory_alloc Allocate memory
  *  - @ref os_memory_dealloc Deallocate memory
+ *  - @ref os_memory_pool_init Enable the pool allocator
+ *  - @ref os_memory_pool_get_stats Query the pool allocator statistics
+ *  - @ref os_memory_pool_reset_stats Reset the pool allocator statistics
  */
 
 /**
@@ -798,6 +801,80 @@ void* os_memory_alloc (uint_t size);
  */
 void os_memory_dealloc (void* mem);
 
+/**
+ * @}
+ * @defgroup os_memory_pool os_memory_pool
+ * @ingroup os_memory
+ * @{
+ */
+
+#define OS_MEMORY_POOL_CLASSES    9   /**< size classes of 16, 32, ... 4096 bytes */
+
+/**
+ * Statistics of one size class of the pool allocator.
+ */
+typedef struct
+{
+  uint_t block_size;                  /**< size of the blocks of this class */
+  uint_t blocks;                      /**< blocks reserved for this class */
+  uint_t in_use;                      /**< blocks currently allocated */
+  uint_t high_water;                  /**< maximum of @e in_use since init or reset */
+  uint_t fallbacks;                   /**< requests served by malloc, class exhausted */
+} os_memory_pool_class_stats_t;
+
+/**
+ * Statistics of the pool allocator, see @ref os_memory_pool_get_stats.
+ */
+typedef struct
+{
+  os_memory_pool_class_stats_t classes[OS_MEMORY_POOL_CLASSES];
+  uint_t oversize_fallbacks;          /**< requests larger than the biggest class */
+  bool_t active;                      /**< pool allocator is enabled */
+  bool_t locked;                      /**< pool memory is locked into RAM */
+} os_memory_pool_stats_t;
+
+/**
+ * Calling @ref os_memory_pool_init enables the pool allocator behind
+ * @ref os_memory_alloc and @ref os_memory_dealloc. For each size class the given number
+ * of blocks is reserved, pre-faulted and locked into RAM. Afterwards requests fitting
+ * into a class are served from a per-thread cache or a lock-free free list, so cyclic
+ * and real-time paths don't enter malloc. Requests which don't fit or find their class
+ * exhausted fall back to malloc and are counted.
+ *
+ * The routine has to be called once at startup, before memory is allocated on
+ * real-time paths. The pool can't be disabled again.
+ *
+ * @param blocks   Array of @ref OS_MEMORY_POOL_CLASSES block counts, one per class.
+ *
+ * @return
+ * 0 indicates success, -1 indicates failure or an already enabled pool.
+ *
+ * @sa
+ * os_memory_pool_get_stats
+ */
+int_t os_memory_pool_init (const uint_t* blocks);
+
+/**
+ * The @ref os_memory_pool_get_stats routine returns a snapshot of the per class usage,
+ * high-water marks and malloc fallbacks. Use it to size the pools.
+ *
+ * @param stats    Points to the structure to fill.
+ *
+ * @sa
+ * os_memory_pool_init os_memory_pool_reset_stats
+ */
+void os_memory_pool_get_stats (os_memory_pool_stats_t* stats);
+
+/**
+ * The @ref os_memory_pool_reset_stats routine sets the high-water marks to the current
+ * usage and clears the fallback counters. Called after startup, fallbacks counted later
+ * show allocations on cyclic paths which the pool could not serve.
+ *
+ * @sa
+ * os_memory_pool_get_stats
+ */
+void os_memory_pool_reset_stats (void);
+
 /**
  * @}
  */
@@ -1265,10 +1342,17 @@ void os_thread_exit (uint_t exit_code);
  * specific routines, constants, types and function prototypes of the abstraction layer
  * interface has to be use.
  *
+ * All time-out routines of a process are called one after another by a single dispatcher
+ * thread. A routine which takes long delays the notification of every other timer, so
+ * routines should return quickly and hand longer work over to a thread of their own.
+ *
  * Routines:
  *  - @ref os_timer_activate_periodical Activate timer
  *  - @ref os_timer_activate_onetime Activate timer
  *  - @ref os_timer_deactivate Deactivate timer
+ *  - @ref os_timer_deactivate_nowait Deactivate timer without waiting for its routine
+ *  - @ref os_timer_get_overrun Query missed periods of a timer
+ *  - @ref os_timer_configure Configure the timer dispatcher thread
  *
  *  Prototypes:
  *  - @ref os_timeout_routine_t Time-out event routine
@@ -1285,6 +1369,9 @@ void os_thread_exit (uint_t exit_code);
  * user-defined callback routine, which is called once on expiration of a single event or
  * periodically on expiration of periodic events.
  *
+ * The routine is called by the timer dispatcher thread, which calls the routines of all
+ * timers one after another. While it runs, no other timer is notified.
+ *
  * @param user    Specifies a reference to user specific data passed to the function
  *                using the @e user parameter of @ref os_timer_activate_periodical.
  *
@@ -1377,15 +1464,43 @@ handle_t os_timer_activate_onetime (handle_t user, uint_t timeout, os_timeout_ro
  * interval immediately. After the routine returns a time-out event will not be notified
  * anymore. The timer can't be reactivated after calling this function.
  *
+ * If the time-out routine of the timer is running, @ref os_timer_deactivate blocks until
+ * it has returned, so the user data can be released right afterwards. The caller must
+ * therefore not hold a lock which the time-out routine takes, otherwise both wait for
+ * each other. Such callers use @ref os_timer_deactivate_nowait. A time-out routine may
+ * deactivate its own timer, this does not block.
+ *
  * @param timer_h      Specifies the timer related reference of the timer.
  *
  * @return
  *
  * @see
- * os_timer_activate_periodical os_timer_activate_onetime
+ * os_timer_activate_periodical os_timer_activate_onetime os_timer_deactivate_nowait
  */
 void os_timer_deactivate (handle_t timer_h);
 
+/**
+ * @}
+ * @defgroup os_timer_deactivate_nowait os_timer_deactivate_nowait
+ * @ingroup os_timer
+ * @{
+ */
+
+/**
+ * A call to the @ref os_timer_deactivate_nowait deactivates a timer like
+ * @ref os_timer_deactivate, but does not wait for a time-out routine of the timer which
+ * is running. Such a routine still completes after the function has returned, so the
+ * user data must stay valid until then. The timer is released when the routine returns.
+ *
+ * @param timer_h      Specifies the timer related reference of the timer.
+ *
+ * @return
+ *
+ * @see
+ * os_timer_deactivate
+ */
+void os_timer_deactivate_nowait (handle_t timer_h);
+
 /**
  * @}
  * @defgroup os_timer_stop os_timer_stop
@@ -1463,6 +1578,54 @@ handle_t os_timer_restart_periodical (handle_t timer_h, uint_t timeout);
  */
 handle_t os_timer_restart_onetime (handle_t timer_h, uint_t timeout);
 
+/**
+ * @}
+ * @defgroup os_timer_get_overrun os_timer_get_overrun
+ * @ingroup os_timer
+ * @{
+ */
+
+/**
+ * Calling @ref os_timer_get_overrun returns the number of periods a periodical timer
+ * missed because its previous time-out routine (or the routine of another timer) was
+ * still running. Missed periods are not notified later; the timer continues with the
+ * next period in its original phase. The counter is reset whenever the timer is
+ * (re)started.
+ *
+ * @param timer_h  Specifies the timer related reference of the timer.
+ *
+ * @return
+ * Number of missed periods. 0 for an invalid reference.
+ *
+ * @sa
+ * os_timer_activate_periodical os_timer_restart_periodical
+ */
+uint_t os_timer_get_overrun (handle_t timer_h);
+
+/**
+ * @}
+ * @defgroup os_timer_configure os_timer_configure
+ * @ingroup os_timer
+ * @{
+ */
+
+/**
+ * All time-out routines are called by one dispatcher thread which waits on a monotonic
+ * clock, so the timers are not affected by changes of the system time. Calling
+ * @ref os_timer_configure sets the scheduling of this thread. The settings are applied
+ * immediately and also to timers already running.
+ *
+ * @param prio     Priority of the dispatcher thread. 0 selects SCHED_OTHER, any other
+ *                 value SCHED_FIFO with the given priority.
+ * @param cpu      Index of the CPU the dispatcher thread is bound to. A negative value
+ *                 restores the affinity the thread was started with.
+ *
+ * @return
+ * 0 indicates success, -1 indicates failure, e.g. if the dispatcher thread is not
+ * running or the priority or CPU affinity could not be set.
+ */
+int_t os_timer_configure (uint_t prio, int_t cpu);
+
 /**
  * @}
  */
@@ -22,16 +22,353 @@
 
 #include "os_api.h"                         /* operating system */
 
+#include <pthread.h>
+#include <sys/mman.h>
+
+
+/****************************************************************************************/
+/* static declaration */
+
+#define OS_MEMORY_POOL_MIN_SHIFT      4
+#define OS_MEMORY_POOL_CACHE_SIZE     16
+#define OS_MEMORY_POOL_BLOCK_SIZE(c)  (((size_t)1) << ((c) + OS_MEMORY_POOL_MIN_SHIFT))
+
+typedef struct pool_class_tag   pool_class_t;
+typedef struct pool_cache_tag   pool_cache_t;
+
+/*
+ * Free blocks of a class form a stack linked by block index, stored in the first bytes
+ * of each free block. The head holds index+1 in the low and an ABA tag in the high
+ * 32 bits, so push and pop are a single 64 bit compare and swap.
+ */
+struct pool_class_tag
+{
+  uint8_t* base;
+  uint8_t* end;
+  uint_t blocks;
+  uint64_t free_head;
+  uint_t in_use;
+  uint_t high_water;
+  uint_t fallbacks;
+};
+
+struct pool_cache_tag
+{
+  void* blocks[OS_MEMORY_POOL_CLASSES][OS_MEMORY_POOL_CACHE_SIZE];
+  uint_t count[OS_MEMORY_POOL_CLASSES];
+  bool_t registered;
+};
+
+static pool_class_t pool_classes[OS_MEMORY_POOL_CLASSES];
+static uint8_t* pool_base;
+static uint8_t* pool_end;
+static bool_t pool_active;
+static bool_t pool_locked;
+static uint_t pool_oversize;
+static pthread_key_t pool_cache_key;
+static __thread pool_cache_t pool_cache;
+
+
 
 /****************************************************************************************/
 /* functionality */
 
+static inline bool_t
+os_memory_pool_is_active (void)
+{
+  return __atomic_load_n(&pool_active, __ATOMIC_ACQUIRE);
+}
+
+static inline int_t
+os_memory_pool_class_of (size_t size)
+{
+  if (size <= OS_MEMORY_POOL_BLOCK_SIZE(0))
+  {
+    return 0;
+  }
+  if (size > OS_MEMORY_POOL_BLOCK_SIZE(OS_MEMORY_POOL_CLASSES - 1))
+  {
+    return -1;
+  }
+
+  return (int_t)(sizeof(unsigned long) * 8) - __builtin_clzl((unsigned long)(size - 1))
+         - OS_MEMORY_POOL_MIN_SHIFT;
+}
+
+static inline int_t
+os_memory_pool_class_of_block (const void* mem)
+{
+  int_t cls;
+
+  for (cls = 0; cls < OS_MEMORY_POOL_CLASSES; cls++)
+  {
+    if ((const uint8_t*)mem < pool_classes[cls].end)
+    {
+      break;
+    }
+  }
+
+  return cls;
+}
+
+static void*
+os_memory_pool_pop (pool_class_t* pc, int_t cls)
+{
+  uint64_t head;
+  uint64_t next;
+  uint8_t* block;
+  uint32_t index;
+
+  head = __atomic_load_n(&pc->free_head, __ATOMIC_ACQUIRE);
+  do
+  {
+    index = (uint32_t)head;
+    if (0 == index)
+    {
+      return NULL;
+    }
+    block = pc->base + ((size_t)(index - 1) << (cls + OS_MEMORY_POOL_MIN_SHIFT));
+    next = (((head >> 32) + 1) << 32) | __atomic_load_n((uint32_t*)block, __ATOMIC_RELAXED);
+  } while (!__atomic_compare_exchange_n(&pc->free_head, &head, next, true,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+
+  return block;
+}
+
+static void
+os_memory_pool_push (pool_class_t* pc, int_t cls, void* block)
+{
+  uint64_t head;
+  uint64_t next;
+  uint32_t index;
+
+  index = (uint32_t)(((uint8_t*)block - pc->base) >> (cls + OS_MEMORY_POOL_MIN_SHIFT)) + 1;
+  head = __atomic_load_n(&pc->free_head, __ATOMIC_RELAXED);
+  do
+  {
+    __atomic_store_n((uint32_t*)block, (uint32_t)head, __ATOMIC_RELAXED);
+    next = (((head >> 32) + 1) << 32) | index;
+  } while (!__atomic_compare_exchange_n(&pc->free_head, &head, next, true,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+/**
+ * The @ref os_memory_pool_flush routine returns the blocks cached by an exiting thread
+ * to the shared free lists.
+ *
+ * @param arg Cache of the exiting thread.
+ */
+static void
+os_memory_pool_flush (void* arg)
+{
+  pool_cache_t* cache = (pool_cache_t*) arg;
+  int_t cls;
+
+  for (cls = 0; cls < OS_MEMORY_POOL_CLASSES; cls++)
+  {
+    while (0 < cache->count[cls])
+    {
+      os_memory_pool_push(&pool_classes[cls], cls, cache->blocks[cls][--cache->count[cls]]);
+    }
+  }
+  cache->registered = false;
+}
+
+static void*
+os_memory_pool_alloc (size_t size)
+{
+  pool_cache_t* cache = &pool_cache;
+  pool_class_t* pc;
+  void* block;
+  uint_t in_use;
+  uint_t high_water;
+  int_t cls;
+
+  cls = os_memory_pool_class_of(size);
+  if (0 > cls)
+  {
+    __atomic_add_fetch(&pool_oversize, 1, __ATOMIC_RELAXED);
+    return malloc(size);
+  }
+
+  pc = &pool_classes[cls];
+  if (0 < cache->count[cls])
+  {
+    block = cache->blocks[cls][--cache->count[cls]];
+  }
+  else
+  {
+    block = os_memory_pool_pop(pc, cls);
+    if (NULL == block)
+    {
+      __atomic_add_fetch(&pc->fallbacks, 1, __ATOMIC_RELAXED);
+      return malloc(size);
+    }
+  }
+
+  in_use = __atomic_add_fetch(&pc->in_use, 1, __ATOMIC_RELAXED);
+  high_water = __atomic_load_n(&pc->high_water, __ATOMIC_RELAXED);
+  while ((in_use > high_water) &&
+         !__atomic_compare_exchange_n(&pc->high_water, &high_water, in_use, true,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+  {
+  }
+
+  return block;
+}
+
+static void
+os_memory_pool_dealloc (void* mem)
+{
+  pool_cache_t* cache = &pool_cache;
+  pool_class_t* pc;
+  int_t cls;
+
+  cls = os_memory_pool_class_of_block(mem);
+  pc = &pool_classes[cls];
+
+  __atomic_sub_fetch(&pc->in_use, 1, __ATOMIC_RELAXED);
+  if (OS_MEMORY_POOL_CACHE_SIZE > cache->count[cls])
+  {
+    if (!cache->registered)
+    {
+      cache->registered = true;
+      (void) pthread_setspecific(pool_cache_key, cache);
+    }
+    cache->blocks[cls][cache->count[cls]++] = mem;
+  }
+  else
+  {
+    os_memory_pool_push(pc, cls, mem);
+  }
+}
+
+/*
+ * The @ref os_memory_pool_init routine is described in header file os_api.h.
+ */
+int_t
+os_memory_pool_init (const uint_t* blocks)
+{
+  static pthread_mutex_t init_lock = PTHREAD_MUTEX_INITIALIZER;
+  pool_class_t* pc;
+  uint8_t* region;
+  size_t total = 0;
+  int_t cls;
+  uint_t i;
+
+  if (NULL == blocks)
+  {
+    return -1;
+  }
+
+  for (cls = 0; cls < OS_MEMORY_POOL_CLASSES; cls++)
+  {
+    total += (size_t)blocks[cls] * OS_MEMORY_POOL_BLOCK_SIZE(cls);
+  }
+
+  pthread_mutex_lock(&init_lock);
+  if (os_memory_pool_is_active() || (0 == total))
+  {
+    pthread_mutex_unlock(&init_lock);
+    return -1;
+  }
+
+  region = mmap(NULL, total, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+  if ((MAP_FAILED == region) || (0 != pthread_key_create(&pool_cache_key, os_memory_pool_flush)))
+  {
+    if (MAP_FAILED != region)
+    {
+      munmap(region, total);
+    }
+    pthread_mutex_unlock(&init_lock);
+    return -1;
+  }
+
+  /* touch every page, MAP_POPULATE is only a hint */
+  memset(region, 0, total);
+  pool_locked = (0 == mlock(region, total));
+
+  pool_base = region;
+  for (cls = 0; cls < OS_MEMORY_POOL_CLASSES; cls++)
+  {
+    pc = &pool_classes[cls];
+    pc->base = region;
+    pc->blocks = blocks[cls];
+    region += (size_t)pc->blocks * OS_MEMORY_POOL_BLOCK_SIZE(cls);
+    pc->end = region;
+    for (i = 0; i < pc->blocks; i++)
+    {
+      *(uint32_t*)(pc->base + (i * OS_MEMORY_POOL_BLOCK_SIZE(cls))) = ((i + 1) < pc->blocks) ? (i + 2) : 0;
+    }
+    pc->free_head = (0 < pc->blocks) ? 1 : 0;
+  }
+  pool_end = region;
+
+  __atomic_store_n(&pool_active, true, __ATOMIC_RELEASE);
+  pthread_mutex_unlock(&init_lock);
+
+  return 0;
+}
+
+/*
+ * The @ref os_memory_pool_get_stats routine is described in header file os_api.h.
+ */
+void
+os_memory_pool_get_stats (os_memory_pool_stats_t* stats)
+{
+  pool_class_t* pc;
+  int_t cls;
+
+  if (NULL == stats)
+  {
+    return;
+  }
+
+  memset(stats, 0, sizeof(*stats));
+  stats->active = os_memory_pool_is_active();
+  stats->locked = pool_locked;
+  stats->oversize_fallbacks = __atomic_load_n(&pool_oversize, __ATOMIC_RELAXED);
+  for (cls = 0; cls < OS_MEMORY_POOL_CLASSES; cls++)
+  {
+    pc = &pool_classes[cls];
+    stats->classes[cls].block_size = (uint_t)OS_MEMORY_POOL_BLOCK_SIZE(cls);
+    stats->classes[cls].blocks = pc->blocks;
+    stats->classes[cls].in_use = __atomic_load_n(&pc->in_use, __ATOMIC_RELAXED);
+    stats->classes[cls].high_water = __atomic_load_n(&pc->high_water, __ATOMIC_RELAXED);
+    stats->classes[cls].fallbacks = __atomic_load_n(&pc->fallbacks, __ATOMIC_RELAXED);
+  }
+}
+
+/*
+ * The @ref os_memory_pool_reset_stats routine is described in header file os_api.h.
+ */
+void
+os_memory_pool_reset_stats (void)
+{
+  pool_class_t* pc;
+  int_t cls;
+
+  __atomic_store_n(&pool_oversize, 0, __ATOMIC_RELAXED);
+  for (cls = 0; cls < OS_MEMORY_POOL_CLASSES; cls++)
+  {
+    pc = &pool_classes[cls];
+    __atomic_store_n(&pc->high_water, __atomic_load_n(&pc->in_use, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+    __atomic_store_n(&pc->fallbacks, 0, __ATOMIC_RELAXED);
+  }
+}
+
 /*
  * The @ref os_memory_alloc routine is described in header file os_api.h.
  */
 handle_t
 os_memory_alloc (uint_t size)
 {
+  if (os_memory_pool_is_active())
+  {
+    return os_memory_pool_alloc(size);
+  }
+
   return malloc(size);
 }
 
@@ -41,6 +378,13 @@ os_memory_alloc (uint_t size)
 void
 os_memory_dealloc (void* mem)
 {
+  if ((NULL != mem) && os_memory_pool_is_active() &&
+      ((uint8_t*)mem >= pool_base) && ((uint8_t*)mem < pool_end))
+  {
+    os_memory_pool_dealloc(mem);
+    return;
+  }
+
   free(mem);
 }
 
@@ -16,29 +16,68 @@
  *  $Revision$
  */
 
-
 /****************************************************************************************/
 /* includes */
 
 #include "os_api.h"                         /* operating system */
 
 #include <pthread.h>
-#include <sys/signal.h>
-#include <sys/time.h>
+#include <sched.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
 #include <errno.h>
 
 
 /****************************************************************************************/
 /* static declaration */
 
+#define OS_TIMER_NSEC_PER_MSEC    1000000ULL
+#define OS_TIMER_NSEC_PER_SEC     1000000000ULL
+#define OS_TIMER_HEAP_CHUNK       16
+#define OS_TIMER_NOT_QUEUED       ((uint_t)-1)
+
 typedef struct timer_ref_tag    timer_ref_t;
 
 struct timer_ref_tag
 {
-  timer_t id;
   handle_t user;
   uint_t timeout;
   os_timeout_routine_t routine;
+  uint64_t deadline;                        /* next expiration, CLOCK_MONOTONIC in ns */
+  uint64_t period;                          /* 0 for one-shot timers */
+  uint_t overrun;                           /* missed periods since last (re)start */
+  uint_t index;                             /* position in the heap */
+};
+
+/*
+ * All timers of the process are served by a single dispatcher thread. It waits on one
+ * timerfd (CLOCK_MONOTONIC) which is always armed to the earliest deadline of the heap,
+ * so neither helper threads per expiration nor wall clock changes affect the timers.
+ */
+static struct
+{
+  pthread_once_t once;
+  pthread_mutex_t lock;
+  pthread_cond_t idle;
+  pthread_t thread;
+  int_t started;
+  int fd;
+  timer_ref_t** heap;
+  uint_t count;
+  uint_t size;
+  timer_ref_t* running;                     /* timer whose routine is being called */
+  bool_t release_running;                   /* free the running timer after its routine */
+  uint_t prio;
+  int_t cpu;
+  cpu_set_t default_cpus;                   /* affinity the dispatcher was started with */
+} os_timer_service =
+{
+  .once = PTHREAD_ONCE_INIT,
+  .lock = PTHREAD_MUTEX_INITIALIZER,
+  .idle = PTHREAD_COND_INITIALIZER,
+  .fd = -1,
+  .cpu = -1,
 };
 
 
@@ -46,124 +85,423 @@ struct timer_ref_tag
 /****************************************************************************************/
 /* functionality */
 
+static uint64_t
+os_timer_now (void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return ((uint64_t)ts.tv_sec * OS_TIMER_NSEC_PER_SEC) + (uint64_t)ts.tv_nsec;
+}
+
+static void
+os_timer_heap_swap (uint_t a, uint_t b)
+{
+  timer_ref_t** heap = os_timer_service.heap;
+  timer_ref_t* tmp;
+
+  tmp = heap[a];
+  heap[a] = heap[b];
+  heap[b] = tmp;
+  heap[a]->index = a;
+  heap[b]->index = b;
+}
+
+static void
+os_timer_heap_up (uint_t pos)
+{
+  timer_ref_t** heap = os_timer_service.heap;
+  uint_t parent;
+
+  while (0 < pos)
+  {
+    parent = (pos - 1) / 2;
+    if (heap[parent]->deadline <= heap[pos]->deadline)
+    {
+      break;
+    }
+    os_timer_heap_swap(parent, pos);
+    pos = parent;
+  }
+}
+
+static void
+os_timer_heap_down (uint_t pos)
+{
+  timer_ref_t** heap = os_timer_service.heap;
+  uint_t count = os_timer_service.count;
+  uint_t child;
+
+  for (;;)
+  {
+    child = (2 * pos) + 1;
+    if (child >= count)
+    {
+      break;
+    }
+    if (((child + 1) < count) && (heap[child + 1]->deadline < heap[child]->deadline))
+    {
+      child++;
+    }
+    if (heap[pos]->deadline <= heap[child]->deadline)
+    {
+      break;
+    }
+    os_timer_heap_swap(pos, child);
+    pos = child;
+  }
+}
+
+static int_t
+os_timer_heap_insert (timer_ref_t* timer)
+{
+  timer_ref_t** heap;
+
+  if (os_timer_service.count == os_timer_service.size)
+  {
+    heap = realloc(os_timer_service.heap,
+                   (os_timer_service.size + OS_TIMER_HEAP_CHUNK) * sizeof(*heap));
+    if (NULL == heap)
+    {
+      return -1;
+    }
+    os_timer_service.heap = heap;
+    os_timer_service.size += OS_TIMER_HEAP_CHUNK;
+  }
+
+  timer->index = os_timer_service.count++;
+  os_timer_service.heap[timer->index] = timer;
+  os_timer_heap_up(timer->index);
+
+  return 0;
+}
+
+static void
+os_timer_heap_remove (timer_ref_t* timer)
+{
+  uint_t pos = timer->index;
+  uint_t last;
+
+  if (OS_TIMER_NOT_QUEUED == pos)
+  {
+    return;
+  }
+
+  last = --os_timer_service.count;
+  if (pos != last)
+  {
+    os_timer_heap_swap(pos, last);
+    os_timer_heap_down(pos);
+    os_timer_heap_up(pos);
+  }
+  timer->index = OS_TIMER_NOT_QUEUED;
+}
+
 /**
- * The @ref os_timer_notify_handler routine handles the timeout of the timer referenced
- * by the signal event of the operating system. The application specific callback routine
- * will be called to notify the event.
- *
- * @param sigval Specifies the signal event of the timeout.
+ * The @ref os_timer_arm routine programs the timerfd of the dispatcher to the earliest
+ * deadline of the heap or disarms it if no timer is queued. The caller holds the lock.
  */
 static void
-os_timer_notify_handler (sigval_t sigval)
+os_timer_arm (void)
 {
-  timer_ref_t* timer;
+  struct itimerspec ts;
+  uint64_t deadline;
+
+  memset(&ts, 0, sizeof(ts));
+  if (0 < os_timer_service.count)
+  {
+    deadline = os_timer_service.heap[0]->deadline;
+    ts.it_value.tv_sec = (time_t)(deadline / OS_TIMER_NSEC_PER_SEC);
+    ts.it_value.tv_nsec = (long)(deadline % OS_TIMER_NSEC_PER_SEC);
+    if ((0 == ts.it_value.tv_sec) && (0 == ts.it_value.tv_nsec))
+    {
+      ts.it_value.tv_nsec = 1;
+    }
+  }
 
-  timer = (timer_ref_t*) sigval.sival_ptr;
-  timer->routine(timer->user);
+  (void) timerfd_settime(os_timer_service.fd, TFD_TIMER_ABSTIME, &ts, NULL);
 }
 
-/*
- * The @ref os_timer_activate_periodical routine is described in header file os_api.h.
+/**
+ * The @ref os_timer_apply_sched routine sets priority and affinity of the dispatcher
+ * thread. The caller holds the lock.
+ *
+ * @return 0 on success, -1 if the priority or the affinity could not be set.
  */
-handle_t
-os_timer_activate_periodical (handle_t user, uint_t timeout, os_timeout_routine_t routine)
+static int_t
+os_timer_apply_sched (void)
 {
-  struct itimerspec ts;
-  struct sigevent se;
+  struct sched_param sched;
+  cpu_set_t cpus;
+
+  memset(&sched, 0, sizeof(sched));
+  sched.sched_priority = (int)os_timer_service.prio;
+  if (0 != pthread_setschedparam(os_timer_service.thread,
+                                 (0 < os_timer_service.prio) ? SCHED_FIFO : SCHED_OTHER,
+                                 &sched))
+  {
+    return -1;
+  }
+
+  if (0 <= os_timer_service.cpu)
+  {
+    if (os_timer_service.cpu >= CPU_SETSIZE)
+    {
+      return -1;
+    }
+    CPU_ZERO(&cpus);
+    CPU_SET(os_timer_service.cpu, &cpus);
+  }
+  else
+  {
+    /* undo the binding of an earlier call */
+    cpus = os_timer_service.default_cpus;
+  }
+  if (0 != pthread_setaffinity_np(os_timer_service.thread, sizeof(cpus), &cpus))
+  {
+    return -1;
+  }
+
+  return 0;
+}
+
+/**
+ * The @ref os_timer_dispatcher routine is the only thread calling the timeout routines.
+ * Periods are advanced from the previous deadline, not from the time of notification,
+ * so the timers don't drift. Periods which were missed completely are skipped and
+ * counted as overrun.
+ *
+ * @param arg Not used.
+ */
+static void*
+os_timer_dispatcher (void* arg)
+{
+  os_timeout_routine_t routine;
   timer_ref_t* timer;
-  int_t status;
+  handle_t user;
+  uint64_t expirations;
+  uint64_t missed;
+  uint64_t now;
 
-  timer = malloc(sizeof(*timer));
-  if (NULL != timer)
+  OS_ARGUMENT_USED(arg);
+
+  for (;;)
   {
-    ts.it_value.tv_sec = (__time_t)(timeout / 1000);
-    ts.it_value.tv_nsec = (__suseconds_t)(timeout % 1000) * 1000000;
-    ts.it_interval.tv_sec = (__time_t)ts.it_value.tv_sec;
-    ts.it_interval.tv_nsec = (__suseconds_t)ts.it_value.tv_nsec;
-
-    memset(&se, 0, sizeof(struct sigevent));
-    se.sigev_notify = SIGEV_THREAD;
-    se.sigev_value.sival_ptr = timer;
-    se._sigev_un._sigev_thread._function = os_timer_notify_handler;
-    se._sigev_un._sigev_thread._attribute = NULL;
-
-    status = timer_create(CLOCK_REALTIME, &se, &timer->id);
-    if (0 == status)
+    if (0 > read(os_timer_service.fd, &expirations, sizeof(expirations)))
     {
-      status = timer_settime(timer->id, 0, &ts, NULL);
-      if (0 != status)
+      if ((EINTR == errno) || (EAGAIN == errno))
       {
-        timer_delete(timer->id);
+        continue;
       }
+      break;
     }
 
-    if (0 == status)
+    pthread_mutex_lock(&os_timer_service.lock);
+
+    now = os_timer_now();
+    while ((0 < os_timer_service.count) && (os_timer_service.heap[0]->deadline <= now))
     {
-      timer->user = user;
-      timer->timeout = timeout;
-      timer->routine = routine;
+      timer = os_timer_service.heap[0];
+      os_timer_heap_remove(timer);
+
+      if (0 != timer->period)
+      {
+        missed = (now - timer->deadline) / timer->period;
+        timer->overrun += (uint_t)missed;
+        timer->deadline += (missed + 1) * timer->period;
+        (void) os_timer_heap_insert(timer);
+      }
+
+      routine = timer->routine;
+      user = timer->user;
+      os_timer_service.running = timer;
+      pthread_mutex_unlock(&os_timer_service.lock);
+
+      routine(user);
+
+      pthread_mutex_lock(&os_timer_service.lock);
+      if (os_timer_service.release_running)
+      {
+        /* deactivated by os_timer_deactivate_nowait while its routine was running */
+        free(timer);
+        os_timer_service.release_running = false;
+      }
+      os_timer_service.running = NULL;
+      pthread_cond_broadcast(&os_timer_service.idle);
+      now = os_timer_now();
     }
-    else
+
+    os_timer_arm();
+
+    pthread_mutex_unlock(&os_timer_service.lock);
+  }
+
+  return NULL;
+}
+
+static void
+os_timer_service_init (void)
+{
+  pthread_attr_t attr;
+
+  os_timer_service.fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+  if (0 > os_timer_service.fd)
+  {
+    return;
+  }
+
+  if (0 == pthread_attr_init(&attr))
+  {
+    if (0 == pthread_create(&os_timer_service.thread, &attr, os_timer_dispatcher, NULL))
     {
-      free(timer);
-      timer = NULL;
+      (void) pthread_setname_np(os_timer_service.thread, "os_timer");
+      if (0 != pthread_getaffinity_np(os_timer_service.thread,
+                                      sizeof(os_timer_service.default_cpus),
+                                      &os_timer_service.default_cpus))
+      {
+        (void) sched_getaffinity(0, sizeof(os_timer_service.default_cpus),
+                                 &os_timer_service.default_cpus);
+      }
+      os_timer_service.started = true;
     }
+    pthread_attr_destroy(&attr);
   }
 
-  return timer;
+  if (!os_timer_service.started)
+  {
+    close(os_timer_service.fd);
+    os_timer_service.fd = -1;
+  }
 }
 
-/*
- * The @ref os_timer_activate_onetime routine is described in header file os_api.h.
+/**
+ * The @ref os_timer_start routine (re)queues a timer with the given timeout. A timeout
+ * of 0 leaves the timer stopped. The caller holds the lock.
+ *
+ * @return 0 on success, -1 on failure.
  */
-handle_t
-os_timer_activate_onetime (handle_t user, uint_t timeout, os_timeout_routine_t routine)
+static int_t
+os_timer_start (timer_ref_t* timer, uint_t timeout, bool_t periodical)
+{
+  int_t status = 0;
+
+  os_timer_heap_remove(timer);
+
+  timer->timeout = timeout;
+  timer->overrun = 0;
+  timer->period = periodical ? ((uint64_t)timeout * OS_TIMER_NSEC_PER_MSEC) : 0;
+
+  if (0 != timeout)
+  {
+    timer->deadline = os_timer_now() + ((uint64_t)timeout * OS_TIMER_NSEC_PER_MSEC);
+    status = os_timer_heap_insert(timer);
+  }
+  os_timer_arm();
+
+  return status;
+}
+
+static handle_t
+os_timer_create (handle_t user, uint_t timeout, os_timeout_routine_t routine, bool_t periodical)
 {
-  struct itimerspec ts;
-  struct sigevent se;
   timer_ref_t* timer;
-  int_t status;
+
+  (void) pthread_once(&os_timer_service.once, os_timer_service_init);
+  if (!os_timer_service.started)
+  {
+    return NULL;
+  }
 
   timer = malloc(sizeof(*timer));
   if (NULL != timer)
   {
-    ts.it_value.tv_sec = (__time_t)(timeout / 1000);
-    ts.it_value.tv_nsec = (__suseconds_t)(timeout % 1000) * 1000000;
-    ts.it_interval.tv_sec = (__time_t)0;
-    ts.it_interval.tv_nsec = (__suseconds_t)0;
-
-    memset(&se, 0, sizeof(struct sigevent));
-    se.sigev_notify = SIGEV_THREAD;
-    se.sigev_value.sival_ptr = timer;
-    se._sigev_un._sigev_thread._function = os_timer_notify_handler;
-    se._sigev_un._sigev_thread._attribute = NULL;
-
-    status = timer_create(CLOCK_REALTIME, &se, &timer->id);
-    if (0 == status)
-    {
-      status = timer_settime(timer->id, 0, &ts, NULL);
-      if (0 != status)
-      {
-        timer_delete(timer->id);
-      }
-    }
+    memset(timer, 0, sizeof(*timer));
+    timer->user = user;
+    timer->routine = routine;
+    timer->index = OS_TIMER_NOT_QUEUED;
 
-    if (0 == status)
+    pthread_mutex_lock(&os_timer_service.lock);
+    if (0 != os_timer_start(timer, timeout, periodical))
     {
-      timer->user = user;
-      timer->timeout = timeout;
-      timer->routine = routine;
+      free(timer);
+      timer = NULL;
     }
-    else
+    pthread_mutex_unlock(&os_timer_service.lock);
+  }
+
+  return timer;
+}
+
+static handle_t
+os_timer_restart (handle_t ref, uint_t timeout, bool_t periodical)
+{
+  timer_ref_t* timer;
+
+  timer = (timer_ref_t*) ref;
+  if (NULL != timer)
+  {
+    pthread_mutex_lock(&os_timer_service.lock);
+    if (0 != os_timer_start(timer, timeout, periodical))
     {
-      free(timer);
       timer = NULL;
     }
+    pthread_mutex_unlock(&os_timer_service.lock);
   }
 
   return timer;
 }
 
+/*
+ * The @ref os_timer_configure routine is described in header file os_api.h.
+ */
+int_t
+os_timer_configure (uint_t prio, int_t cpu)
+{
+  int_t status = 0;
+
+  if ((0 < prio) && (((int)prio < sched_get_priority_min(SCHED_FIFO)) ||
+                     ((int)prio > sched_get_priority_max(SCHED_FIFO))))
+  {
+    return -1;
+  }
+
+  (void) pthread_once(&os_timer_service.once, os_timer_service_init);
+
+  pthread_mutex_lock(&os_timer_service.lock);
+  os_timer_service.prio = prio;
+  os_timer_service.cpu = cpu;
+  if (os_timer_service.started)
+  {
+    status = os_timer_apply_sched();
+  }
+  else
+  {
+    status = -1;
+  }
+  pthread_mutex_unlock(&os_timer_service.lock);
+
+  return status;
+}
+
+/*
+ * The @ref os_timer_activate_periodical routine is described in header file os_api.h.
+ */
+handle_t
+os_timer_activate_periodical (handle_t user, uint_t timeout, os_timeout_routine_t routine)
+{
+  return os_timer_create(user, timeout, routine, true);
+}
+
+/*
+ * The @ref os_timer_activate_onetime routine is described in header file os_api.h.
+ */
+handle_t
+os_timer_activate_onetime (handle_t user, uint_t timeout, os_timeout_routine_t routine)
+{
+  return os_timer_create(user, timeout, routine, false);
+}
+
 /*
  * The @ref os_timer_deactivate routine is described in header file os_api.h.
  */
@@ -175,62 +513,76 @@ os_timer_deactivate (handle_t ref)
   timer = (timer_ref_t*) ref;
   if (NULL != timer)
   {
-    timer_delete(timer->id);
+    pthread_mutex_lock(&os_timer_service.lock);
+    os_timer_heap_remove(timer);
+    os_timer_arm();
+
+    /* a timer may deactivate itself from its own routine */
+    if (!pthread_equal(pthread_self(), os_timer_service.thread))
+    {
+      while (timer == os_timer_service.running)
+      {
+        pthread_cond_wait(&os_timer_service.idle, &os_timer_service.lock);
+      }
+    }
+    pthread_mutex_unlock(&os_timer_service.lock);
+
     free(timer);
   }
 }
 
 /*
- * The @ref os_timer_stop routine is described in header file os_api.h.
+ * The @ref os_timer_deactivate_nowait routine is described in header file os_api.h.
  */
 void
-os_timer_stop (handle_t ref)
+os_timer_deactivate_nowait (handle_t ref)
 {
-  struct itimerspec ts;
   timer_ref_t* timer;
 
   timer = (timer_ref_t*) ref;
   if (NULL != timer)
   {
-    timer->timeout = 0;
+    pthread_mutex_lock(&os_timer_service.lock);
+    os_timer_heap_remove(timer);
+    os_timer_arm();
 
-    ts.it_value.tv_sec = (__time_t)0;
-    ts.it_value.tv_nsec = (__suseconds_t)0;
-    ts.it_interval.tv_sec = (__time_t)0;
-    ts.it_interval.tv_nsec = (__suseconds_t)0;
+    /* the dispatcher frees a timer whose routine is still running once it returns */
+    if ((timer == os_timer_service.running) &&
+        !pthread_equal(pthread_self(), os_timer_service.thread))
+    {
+      os_timer_service.release_running = true;
+      timer = NULL;
+    }
+    pthread_mutex_unlock(&os_timer_service.lock);
 
-    timer_settime(timer->id, 0, &ts, NULL);
+    free(timer);
   }
 }
 
 /*
- * The @ref os_timer_restart_onetime routine is described in header file os_api.h.
+ * The @ref os_timer_stop routine is described in header file os_api.h.
  */
-handle_t
-os_timer_restart_periodical (handle_t ref, uint_t timeout)
+void
+os_timer_stop (handle_t ref)
 {
-  struct itimerspec ts;
   timer_ref_t* timer;
-  int_t status;
 
   timer = (timer_ref_t*) ref;
   if (NULL != timer)
   {
-    timer->timeout = timeout;
-
-    ts.it_value.tv_sec = (__time_t)(timeout / 1000);
-    ts.it_value.tv_nsec = (__suseconds_t)(timeout % 1000) * 1000000;
-    ts.it_interval.tv_sec = (__time_t)ts.it_value.tv_sec;
-    ts.it_interval.tv_nsec = (__suseconds_t)ts.it_value.tv_nsec;
-
-    status = timer_settime(timer->id, 0, &ts, NULL);
-    if (0 != status)
-    {
-      timer = NULL;
-    }
+    pthread_mutex_lock(&os_timer_service.lock);
+    (void) os_timer_start(timer, 0, false);
+    pthread_mutex_unlock(&os_timer_service.lock);
   }
+}
 
-  return timer;
+/*
+ * The @ref os_timer_restart_onetime routine is described in header file os_api.h.
+ */
+handle_t
+os_timer_restart_periodical (handle_t ref, uint_t timeout)
+{
+  return os_timer_restart(ref, timeout, true);
 }
 
 /*
@@ -239,28 +591,27 @@ os_timer_restart_periodical (handle_t ref, uint_t timeout)
 handle_t
 os_timer_restart_onetime (handle_t ref, uint_t timeout)
 {
-  struct itimerspec ts;
+  return os_timer_restart(ref, timeout, false);
+}
+
+/*
+ * The @ref os_timer_get_overrun routine is described in header file os_api.h.
+ */
+uint_t
+os_timer_get_overrun (handle_t ref)
+{
   timer_ref_t* timer;
-  int_t status;
+  uint_t overrun = 0;
 
   timer = (timer_ref_t*) ref;
   if (NULL != timer)
   {
-    timer->timeout = timeout;
-
-    ts.it_value.tv_sec = (__time_t)(timeout / 1000);
-    ts.it_value.tv_nsec = (__suseconds_t)(timeout % 1000) * 1000000;
-    ts.it_interval.tv_sec = (__time_t)0;
-    ts.it_interval.tv_nsec = (__suseconds_t)0;
-
-    status = timer_settime(timer->id, 0, &ts, NULL);
-    if (0 != status)
-    {
-      timer = NULL;
-    }
+    pthread_mutex_lock(&os_timer_service.lock);
+    overrun = timer->overrun;
+    pthread_mutex_unlock(&os_timer_service.lock);
   }
 
-  return timer;
+  return overrun;
 }
 
 
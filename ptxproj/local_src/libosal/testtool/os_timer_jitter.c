@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2000 - 2022 WAGO GmbH & Co. KG
+ *
+ * PROPRIETARY RIGHTS of WAGO GmbH & Co. KG are involved in
+ * the subject matter of this material. All manufacturing, reproduction,
+ * use, and sales rights pertaining to this subject matter are governed
+ * by the license agreement. The recipient of this software implicitly
+ * accepts the terms of the license.
+ *
+ * Filename:
+ *  $Workfile: os_timer_jitter.c $
+ *
+ * Measures the notification jitter of the os_timer_* routines.
+ *
+ * usage: os_timer_jitter [timers] [period ms] [seconds] [prio] [cpu]
+ *
+ * Starts a number of periodical timers with the same period and records, for every
+ * notification, how late it was against the ideal deadline start + n * period. The
+ * minimum, mean and maximum lateness and the overruns of all timers are printed at
+ * the end. Priority and CPU are passed to os_timer_configure.
+ */
+
+/****************************************************************************************/
+/* includes */
+
+#include "os_api.h"                         /* operating system */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+
+
+/****************************************************************************************/
+/* static declaration */
+
+#define JITTER_NSEC_PER_MSEC      1000000ULL
+#define JITTER_NSEC_PER_SEC       1000000000ULL
+
+typedef struct
+{
+  handle_t timer;
+  uint64_t start;                           /* activation, CLOCK_MONOTONIC in ns */
+  uint64_t period;
+  uint64_t notifications;
+  uint64_t late_min;
+  uint64_t late_max;
+  uint64_t late_sum;
+} jitter_timer_t;
+
+
+/****************************************************************************************/
+/* functionality */
+
+static uint64_t
+jitter_now (void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return ((uint64_t)ts.tv_sec * JITTER_NSEC_PER_SEC) + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * The @ref jitter_routine is the time-out routine of all timers. All routines are called
+ * by the same dispatcher thread, so the counters need no lock.
+ */
+static void
+jitter_routine (handle_t user)
+{
+  jitter_timer_t* t = (jitter_timer_t*) user;
+  uint64_t now = jitter_now();
+  uint64_t elapsed = now - t->start;
+  uint64_t late = elapsed % t->period;
+
+  if (late < t->late_min)
+  {
+    t->late_min = late;
+  }
+  if (late > t->late_max)
+  {
+    t->late_max = late;
+  }
+  t->late_sum += late;
+  t->notifications++;
+}
+
+int
+main (int argc, char* argv[])
+{
+  uint_t count = (1 < argc) ? (uint_t)atoi(argv[1]) : 8;
+  uint_t period = (2 < argc) ? (uint_t)atoi(argv[2]) : 1;
+  uint_t seconds = (3 < argc) ? (uint_t)atoi(argv[3]) : 10;
+  uint_t prio = (4 < argc) ? (uint_t)atoi(argv[4]) : 0;
+  int_t cpu = (5 < argc) ? atoi(argv[5]) : -1;
+  jitter_timer_t* timers;
+  uint64_t notifications = 0;
+  uint64_t late_min = UINT64_MAX;
+  uint64_t late_max = 0;
+  uint64_t late_sum = 0;
+  uint_t overrun = 0;
+  uint_t i;
+
+  if ((0 == count) || (0 == period))
+  {
+    fprintf(stderr, "usage: %s [timers] [period ms] [seconds] [prio] [cpu]\n", argv[0]);
+    return 1;
+  }
+
+  timers = calloc(count, sizeof(*timers));
+  if (NULL == timers)
+  {
+    return 1;
+  }
+
+  if (0 != os_timer_configure(prio, cpu))
+  {
+    fprintf(stderr, "cannot set priority %u and cpu %d of the timer thread\n", prio, cpu);
+  }
+
+  for (i = 0; i < count; i++)
+  {
+    timers[i].period = (uint64_t)period * JITTER_NSEC_PER_MSEC;
+    timers[i].late_min = UINT64_MAX;
+    timers[i].start = jitter_now();
+    timers[i].timer = os_timer_activate_periodical(&timers[i], period, jitter_routine);
+    if (NULL == timers[i].timer)
+    {
+      fprintf(stderr, "cannot activate timer %u\n", i);
+      return 1;
+    }
+  }
+
+  sleep(seconds);
+
+  for (i = 0; i < count; i++)
+  {
+    overrun += os_timer_get_overrun(timers[i].timer);
+    os_timer_deactivate(timers[i].timer);
+    notifications += timers[i].notifications;
+    late_sum += timers[i].late_sum;
+    if (timers[i].late_min < late_min)
+    {
+      late_min = timers[i].late_min;
+    }
+    if (timers[i].late_max > late_max)
+    {
+      late_max = timers[i].late_max;
+    }
+  }
+
+  printf("timers %u, period %u ms, %u s, prio %u, cpu %d\n", count, period, seconds, prio, cpu);
+  printf("notifications %llu, overruns %u\n", (unsigned long long)notifications, overrun);
+  if (0 < notifications)
+  {
+    printf("lateness min %llu us, mean %llu us, max %llu us\n",
+           (unsigned long long)(late_min / 1000),
+           (unsigned long long)(late_sum / notifications / 1000),
+           (unsigned long long)(late_max / 1000));
+  }
+
+  free(timers);
+
+  return 0;
+}
+
+
+/****************************************************************************************/
+/* end of source */
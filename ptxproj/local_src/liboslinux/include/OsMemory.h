@@ -13,6 +13,7 @@
 // Include files
 //------------------------------------------------------------------------------
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -22,6 +23,9 @@
 // Defines
 //------------------------------------------------------------------------------
 
+/// Number of size classes of the optional pool allocator.
+/// Class n serves requests of up to (16 << n) bytes, i.e. 16 .. 4096 bytes.
+#define OS_MEMORY_POOL_CLASSES   9
 
 //------------------------------------------------------------------------------
 // Macros
@@ -32,6 +36,23 @@
 // Typedefs
 //------------------------------------------------------------------------------
 
+typedef struct OsMemoryPoolClassStats
+{
+   size_t BlockSize;   ///< size of the blocks of this class
+   u32 Blocks;         ///< blocks reserved for this class
+   u32 InUse;          ///< blocks currently handed out
+   u32 HighWater;      ///< maximum of InUse since init or last reset
+   u32 Fallbacks;      ///< requests of this class served by malloc (pool exhausted)
+}tOsMemoryPoolClassStats;
+
+typedef struct OsMemoryPoolStats
+{
+   tOsMemoryPoolClassStats Classes[OS_MEMORY_POOL_CLASSES];
+   u32 OversizeFallbacks;  ///< requests larger than the biggest class
+   bool Active;            ///< pool has been initialized
+   bool Locked;            ///< pool memory is locked into RAM
+}tOsMemoryPoolStats;
+
 //------------------------------------------------------------------------------
 // Global variables
 //------------------------------------------------------------------------------
@@ -52,4 +73,26 @@ i32 OsMemory_Compare( const void* lhs, const void *rhs, size_t count);
 
 void OsMemory_Set(void *ptr, u8 value, size_t size);
 
+/// Enables the pool allocator behind OsMemory_Alloc/Calloc/Realloc/Free.
+///
+/// For each size class blocksPerClass[n] blocks are reserved, pre-faulted and
+/// locked into RAM. Afterwards requests which fit into a class are served from
+/// a per-thread cache or a lock-free free list without calling malloc. Requests
+/// which don't fit or find their class exhausted fall back to malloc and are
+/// counted, see OsMemory_PoolGetStats.
+///
+/// Has to be called once at startup before any real-time path allocates.
+///
+/// \param blocksPerClass number of blocks for each of the OS_MEMORY_POOL_CLASSES classes
+/// \return 0 on success, -1 if the pool is already active or can't be reserved
+i32 OsMemory_PoolInit(const u32 blocksPerClass[OS_MEMORY_POOL_CLASSES]);
+
+/// Returns a snapshot of the pool allocator statistics.
+void OsMemory_PoolGetStats(tOsMemoryPoolStats *stats) OS_ARG_NONNULL((1));
+
+/// Resets the high-water marks to the current usage and clears the fallback counters.
+/// Call it after startup; fallbacks counted afterwards show allocations on the
+/// cyclic paths that the pool could not serve.
+void OsMemory_PoolResetStats(void);
+
 #endif  // D_OsMemory_H
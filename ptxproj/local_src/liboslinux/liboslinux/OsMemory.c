@@ -16,22 +16,49 @@
 #include <stdlib.h>
 #include <memory.h>
 
+#include <pthread.h>
+#include <sys/mman.h>
+
 #include "OsTrace.h"
 
 //------------------------------------------------------------------------------
 // Defines
 //------------------------------------------------------------------------------
 
+#define POOL_MIN_SHIFT   4
+#define POOL_CACHE_SIZE  16
 
 //------------------------------------------------------------------------------
 // Macros
 //------------------------------------------------------------------------------
 
+#define POOL_BLOCK_SIZE(cls) (((size_t)1) << ((cls) + POOL_MIN_SHIFT))
 
 //------------------------------------------------------------------------------
 // Typedefs
 //------------------------------------------------------------------------------
 
+/// Free blocks of a class form a stack linked by block index (stored in the
+/// first bytes of each free block). The head holds index+1 in the low and an
+/// ABA tag in the high 32 bits, so push and pop are a single 64 bit CAS.
+typedef struct stOsMemoryPoolClass
+{
+   u8 *Base;
+   u8 *End;
+   u32 Blocks;
+   u64 FreeHead;
+   u32 InUse;
+   u32 HighWater;
+   u32 Fallbacks;
+}_OsMemoryPoolClass;
+
+typedef struct stOsMemoryPoolCache
+{
+   void *Blocks[OS_MEMORY_POOL_CLASSES][POOL_CACHE_SIZE];
+   u32 Count[OS_MEMORY_POOL_CLASSES];
+   bool Registered;
+}_OsMemoryPoolCache;
+
 //------------------------------------------------------------------------------
 // Global variables
 //------------------------------------------------------------------------------
@@ -41,12 +68,269 @@
 // Local variables
 //------------------------------------------------------------------------------
 
+static _OsMemoryPoolClass s_PoolClasses[OS_MEMORY_POOL_CLASSES];
+static u8 *s_PoolBase;
+static u8 *s_PoolEnd;
+static bool s_PoolActive;
+static bool s_PoolLocked;
+static u32 s_PoolOversize;
+static pthread_key_t s_PoolCacheKey;
+static __thread _OsMemoryPoolCache s_PoolCache;
+
+static inline bool PoolIsActive(void)
+{
+   return __atomic_load_n(&s_PoolActive, __ATOMIC_ACQUIRE);
+}
+
+static inline int PoolClassOf(size_t size)
+{
+   if (size <= POOL_BLOCK_SIZE(0))
+   {
+      return 0;
+   }
+   if (size > POOL_BLOCK_SIZE(OS_MEMORY_POOL_CLASSES - 1))
+   {
+      return -1;
+   }
+   return (int)(sizeof(unsigned long) * 8) - __builtin_clzl((unsigned long)(size - 1)) - POOL_MIN_SHIFT;
+}
+
+static inline bool PoolOwns(const void *ptr)
+{
+   return ((const u8 *)ptr >= s_PoolBase) && ((const u8 *)ptr < s_PoolEnd);
+}
+
+static inline int PoolClassOfBlock(const void *ptr)
+{
+   int cls;
+   for (cls = 0; cls < OS_MEMORY_POOL_CLASSES; cls++)
+   {
+      if ((const u8 *)ptr < s_PoolClasses[cls].End)
+      {
+         break;
+      }
+   }
+   return cls;
+}
+
+static void *PoolPop(_OsMemoryPoolClass *pc, int cls)
+{
+   u64 head = __atomic_load_n(&pc->FreeHead, __ATOMIC_ACQUIRE);
+   u64 next;
+   u8 *block;
+
+   do
+   {
+      u32 index = (u32)head;
+      if (index == 0)
+      {
+         return NULL;
+      }
+      block = pc->Base + ((size_t)(index - 1) << (cls + POOL_MIN_SHIFT));
+      next = (((head >> 32) + 1) << 32) | __atomic_load_n((u32 *)block, __ATOMIC_RELAXED);
+   } while (!__atomic_compare_exchange_n(&pc->FreeHead, &head, next, true,
+                                         __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+   return block;
+}
+
+static void PoolPush(_OsMemoryPoolClass *pc, int cls, void *block)
+{
+   u32 index = (u32)(((u8 *)block - pc->Base) >> (cls + POOL_MIN_SHIFT)) + 1;
+   u64 head = __atomic_load_n(&pc->FreeHead, __ATOMIC_RELAXED);
+   u64 next;
+
+   do
+   {
+      __atomic_store_n((u32 *)block, (u32)head, __ATOMIC_RELAXED);
+      next = (((head >> 32) + 1) << 32) | index;
+   } while (!__atomic_compare_exchange_n(&pc->FreeHead, &head, next, true,
+                                         __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+/// Returns the blocks cached by an exiting thread to the shared free lists.
+static void PoolCacheFlush(void *arg)
+{
+   _OsMemoryPoolCache *cache = arg;
+   int cls;
+
+   for (cls = 0; cls < OS_MEMORY_POOL_CLASSES; cls++)
+   {
+      while (cache->Count[cls] > 0)
+      {
+         PoolPush(&s_PoolClasses[cls], cls, cache->Blocks[cls][--cache->Count[cls]]);
+      }
+   }
+   cache->Registered = false;
+}
+
+static inline void PoolCacheRegister(_OsMemoryPoolCache *cache)
+{
+   if (unlikely(!cache->Registered))
+   {
+      cache->Registered = true;
+      (void)pthread_setspecific(s_PoolCacheKey, cache);
+   }
+}
+
+static void *PoolAlloc(size_t size)
+{
+   _OsMemoryPoolCache *cache = &s_PoolCache;
+   int cls = PoolClassOf(size);
+   _OsMemoryPoolClass *pc;
+   void *block;
+   u32 inUse;
+   u32 highWater;
+
+   if (cls < 0)
+   {
+      __atomic_add_fetch(&s_PoolOversize, 1, __ATOMIC_RELAXED);
+      return malloc(size);
+   }
+
+   pc = &s_PoolClasses[cls];
+   if (cache->Count[cls] > 0)
+   {
+      block = cache->Blocks[cls][--cache->Count[cls]];
+   }
+   else
+   {
+      block = PoolPop(pc, cls);
+      if (block == NULL)
+      {
+         __atomic_add_fetch(&pc->Fallbacks, 1, __ATOMIC_RELAXED);
+         return malloc(size);
+      }
+   }
+
+   inUse = __atomic_add_fetch(&pc->InUse, 1, __ATOMIC_RELAXED);
+   highWater = __atomic_load_n(&pc->HighWater, __ATOMIC_RELAXED);
+   while (inUse > highWater &&
+          !__atomic_compare_exchange_n(&pc->HighWater, &highWater, inUse, true,
+                                       __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+   {
+   }
+   return block;
+}
+
+static void PoolFree(void *ptr)
+{
+   _OsMemoryPoolCache *cache = &s_PoolCache;
+   int cls = PoolClassOfBlock(ptr);
+   _OsMemoryPoolClass *pc = &s_PoolClasses[cls];
+
+   __atomic_sub_fetch(&pc->InUse, 1, __ATOMIC_RELAXED);
+   if (cache->Count[cls] < POOL_CACHE_SIZE)
+   {
+      PoolCacheRegister(cache);
+      cache->Blocks[cls][cache->Count[cls]++] = ptr;
+   }
+   else
+   {
+      PoolPush(pc, cls, ptr);
+   }
+}
+
+i32 OsMemory_PoolInit(const u32 blocksPerClass[OS_MEMORY_POOL_CLASSES])
+{
+   static pthread_mutex_t initLock = PTHREAD_MUTEX_INITIALIZER;
+   size_t total = 0;
+   u8 *region;
+   int cls;
+   u32 i;
+
+   assert(blocksPerClass != NULL);
+
+   for (cls = 0; cls < OS_MEMORY_POOL_CLASSES; cls++)
+   {
+      total += (size_t)blocksPerClass[cls] * POOL_BLOCK_SIZE(cls);
+   }
+
+   pthread_mutex_lock(&initLock);
+   if (PoolIsActive() || total == 0)
+   {
+      pthread_mutex_unlock(&initLock);
+      return -1;
+   }
+
+   region = mmap(NULL, total, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+   if (region == MAP_FAILED || pthread_key_create(&s_PoolCacheKey, PoolCacheFlush) != 0)
+   {
+      if (region != MAP_FAILED)
+      {
+         munmap(region, total);
+      }
+      pthread_mutex_unlock(&initLock);
+      OsTraceError("%s", "Can't reserve memory pool");
+      return -1;
+   }
+
+   // touch every page, MAP_POPULATE is only a hint
+   memset(region, 0, total);
+   s_PoolLocked = (mlock(region, total) == 0);
+   if (!s_PoolLocked)
+   {
+      OsTraceWarning("%s", "Memory pool is not locked into RAM\n");
+   }
+
+   s_PoolBase = region;
+   for (cls = 0; cls < OS_MEMORY_POOL_CLASSES; cls++)
+   {
+      _OsMemoryPoolClass *pc = &s_PoolClasses[cls];
+      pc->Base = region;
+      pc->Blocks = blocksPerClass[cls];
+      region += (size_t)pc->Blocks * POOL_BLOCK_SIZE(cls);
+      pc->End = region;
+      for (i = 0; i < pc->Blocks; i++)
+      {
+         *(u32 *)(pc->Base + i * POOL_BLOCK_SIZE(cls)) = (i + 1 < pc->Blocks) ? i + 2 : 0;
+      }
+      pc->FreeHead = (pc->Blocks > 0) ? 1 : 0;
+   }
+   s_PoolEnd = region;
+
+   __atomic_store_n(&s_PoolActive, true, __ATOMIC_RELEASE);
+   pthread_mutex_unlock(&initLock);
+   return 0;
+}
+
+void OsMemory_PoolGetStats(tOsMemoryPoolStats *stats)
+{
+   int cls;
+
+   memset(stats, 0, sizeof(*stats));
+   stats->Active = PoolIsActive();
+   stats->Locked = s_PoolLocked;
+   stats->OversizeFallbacks = __atomic_load_n(&s_PoolOversize, __ATOMIC_RELAXED);
+   for (cls = 0; cls < OS_MEMORY_POOL_CLASSES; cls++)
+   {
+      _OsMemoryPoolClass *pc = &s_PoolClasses[cls];
+      stats->Classes[cls].BlockSize = POOL_BLOCK_SIZE(cls);
+      stats->Classes[cls].Blocks = pc->Blocks;
+      stats->Classes[cls].InUse = __atomic_load_n(&pc->InUse, __ATOMIC_RELAXED);
+      stats->Classes[cls].HighWater = __atomic_load_n(&pc->HighWater, __ATOMIC_RELAXED);
+      stats->Classes[cls].Fallbacks = __atomic_load_n(&pc->Fallbacks, __ATOMIC_RELAXED);
+   }
+}
+
+void OsMemory_PoolResetStats(void)
+{
+   int cls;
+
+   __atomic_store_n(&s_PoolOversize, 0, __ATOMIC_RELAXED);
+   for (cls = 0; cls < OS_MEMORY_POOL_CLASSES; cls++)
+   {
+      _OsMemoryPoolClass *pc = &s_PoolClasses[cls];
+      __atomic_store_n(&pc->HighWater, __atomic_load_n(&pc->InUse, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+      __atomic_store_n(&pc->Fallbacks, 0, __ATOMIC_RELAXED);
+   }
+}
 
 void *OsMemory_Alloc(size_t size)
 {
    assert(size != 0);
 
-   void *res = malloc(size);
+   void *res = PoolIsActive() ? PoolAlloc(size) : malloc(size);
    if (res == NULL)
    {
       OsTraceError("%s", "Out of memory, shutting down program");
@@ -60,7 +344,19 @@ void *OsMemory_Calloc(size_t numberOfElements, size_t elementSize)
    assert(numberOfElements != 0);
    assert(elementSize != 0);
 
-   void *res = calloc(numberOfElements, elementSize);
+   void *res;
+   if (PoolIsActive() && (elementSize <= SIZE_MAX / numberOfElements))
+   {
+      res = PoolAlloc(numberOfElements * elementSize);
+      if (res != NULL)
+      {
+         memset(res, 0, numberOfElements * elementSize);
+      }
+   }
+   else
+   {
+      res = calloc(numberOfElements, elementSize);
+   }
    if (res == NULL)
    {
       OsTraceError("%s", "Out of memory, shutting down program");
@@ -74,7 +370,25 @@ void *OsMemory_Realloc(void *ptr, size_t size)
    assert(ptr != NULL);
    assert(size != 0);
 
-   void *res = realloc(ptr, size);
+   void *res;
+   if (PoolIsActive() && PoolOwns(ptr))
+   {
+      size_t blockSize = POOL_BLOCK_SIZE(PoolClassOfBlock(ptr));
+      if (size <= blockSize && PoolClassOf(size) == PoolClassOfBlock(ptr))
+      {
+         return ptr;
+      }
+      res = PoolAlloc(size);
+      if (res != NULL)
+      {
+         memcpy(res, ptr, (size < blockSize) ? size : blockSize);
+         PoolFree(ptr);
+      }
+   }
+   else
+   {
+      res = realloc(ptr, size);
+   }
    if (res == NULL)
    {
       OsTraceError("%s", "Out of memory, shutting down program");
@@ -101,5 +415,10 @@ i32 OsMemory_Compare( const void* lhs, const void *rhs, size_t count)
 
 void OsMemory_Free(void * ptr)
 {
+   if (ptr != NULL && PoolIsActive() && PoolOwns(ptr))
+   {
+      PoolFree(ptr);
+      return;
+   }
    free(ptr);
 }
@@ -8,19 +8,190 @@
 #include "cgrules.h"
 
 #include <libcgroup.h>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <grp.h>
+#include <pthread.h>
+#include <pwd.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
+#include "cgrules_conf.h"
 #include "pthread_wrapper.h"
 #include "log.h"
 
 #define CGRULES_CONF_FILE "/etc/cgrules.conf"
 #define CGCONFIG_CONF_FILE "/etc/cgconfig.conf"
+#define CGROUP_V2_ROOT "/sys/fs/cgroup"
+#define CGROUP_V2_CONTROLLERS CGROUP_V2_ROOT "/cgroup.controllers"
+#define DEFAULT_GROUP "rts/def"
+
+#define CGRULES_MAX_TARGETS 16
+
+/* credentials the rule engine is asked to match, see cgrules_apply_rule_by_name() */
+#define CGRULES_RULE_UID ((uid_t)0)
+#define CGRULES_RULE_GID ((gid_t)0)
+
+/*
+ * The destination of every cdsvX_polNNprioNNN rule is resolved once from
+ * cgrules.conf, see cgrules_conf.h for the supported syntax. Threads are
+ * attached to the resolved group directly, the libcgroup rule engine is only
+ * used for rules which can't be resolved that way.
+ */
+struct cgrules_target
+{
+	char path[128];
+	struct cgroup *group;   /* cgroup v1 */
+	int threads_fd;         /* cgroup v2: <path>/cgroup.threads */
+};
 
 static struct cgroup *default_group;
 static char proc_name[4096];
 static bool isRuntimeSystem = false;
 static bool isCodesysV2 = false;
 static bool isCodesysV3= false;
+static bool isUnified = false;
+
+static struct cgrules_target targets[CGRULES_MAX_TARGETS];
+static int target_count;
+static int default_target = CGRULES_TARGET_NONE;
+static cgrules_prio_cache prio_cache;
+
+static int cgrules_open_threads_file(const char *path)
+{
+	char buffer[256];
+	char type[32] = "";
+	int fd;
+
+	/* threads can only be moved individually into threaded cgroups, which are set up by cgroupsconfig */
+	snprintf(buffer, sizeof(buffer), "%s/%s/cgroup.type", CGROUP_V2_ROOT, path);
+	fd = open(buffer, O_RDONLY | O_CLOEXEC);
+	if (fd >= 0)
+	{
+		ssize_t len = read(fd, type, sizeof(type) - 1);
+		if (len > 0 && strncmp(type, "threaded", 8) != 0)
+			WARN("%s is not threaded, threads can't be moved into it", path);
+		close(fd);
+	}
+
+	snprintf(buffer, sizeof(buffer), "%s/%s/cgroup.threads", CGROUP_V2_ROOT, path);
+	fd = open(buffer, O_WRONLY | O_CLOEXEC);
+	if (fd < 0)
+		ERROR("can't open %s: %s", buffer, strerror(errno));
+	return fd;
+}
+
+static int cgrules_get_target(const char *path, const char *controllers)
+{
+	int i;
+
+	while (*path == '/')
+		path++;
+
+	for (i = 0; i < target_count; i++)
+	{
+		if (strcmp(targets[i].path, path) == 0)
+			return i;
+	}
+	if (target_count == CGRULES_MAX_TARGETS)
+		return CGRULES_TARGET_NONE;
+
+	struct cgrules_target *target = &targets[target_count];
+	snprintf(target->path, sizeof(target->path), "%s", path);
+	target->threads_fd = -1;
+
+	if (isUnified)
+	{
+		target->threads_fd = cgrules_open_threads_file(target->path);
+		if (target->threads_fd < 0)
+			return CGRULES_TARGET_NONE;
+	}
+	else
+	{
+		target->group = cgroup_new_cgroup(target->path);
+		if (target->group == NULL)
+			return CGRULES_TARGET_NONE;
+
+		if (controllers == NULL || strcmp(controllers, "*") == 0)
+		{
+			int ret = cgroup_get_cgroup(target->group);
+			if (ret != 0)
+			{
+				ERROR("failed to get group %s: %s", target->path, cgroup_strerror(ret));
+				cgroup_free(&target->group);
+				return CGRULES_TARGET_NONE;
+			}
+		}
+		else
+		{
+			char list[128];
+			char *saveptr = NULL;
+			snprintf(list, sizeof(list), "%s", controllers);
+			for (char *c = strtok_r(list, ",", &saveptr); c != NULL; c = strtok_r(NULL, ",", &saveptr))
+				cgroup_add_controller(target->group, c);
+		}
+	}
+
+	return target_count++;
+}
+
+/*
+ * Checks the user part of a rule ("*", "name" or "@group") against the
+ * credentials the rule engine matches with.
+ */
+static bool cgrules_user_matches(const char *user, size_t len)
+{
+	char name[128];
+
+	if (len == 0 || len >= sizeof(name))
+		return false;
+	memcpy(name, user, len);
+	name[len] = '\0';
+
+	if (strcmp(name, "*") == 0)
+		return true;
+
+	if (name[0] == '@')
+	{
+		struct group *grp = getgrnam(name + 1);
+		if (grp == NULL)
+			return false;
+		if (grp->gr_gid == CGRULES_RULE_GID)
+			return true;
+
+		struct passwd *pwd = getpwuid(CGRULES_RULE_UID);
+		if (pwd == NULL)
+			return false;
+		for (char **member = grp->gr_mem; *member != NULL; member++)
+		{
+			if (strcmp(*member, pwd->pw_name) == 0)
+				return true;
+		}
+		return false;
+	}
+
+	struct passwd *pwd = getpwnam(name);
+	return pwd != NULL && pwd->pw_uid == CGRULES_RULE_UID;
+}
+
+static void cgrules_load_prio_rules(void)
+{
+	const char *prefix = isCodesysV2 ? "cdsv2_pol" : "cdsv3_pol";
+	FILE *f;
+
+	memset(prio_cache, CGRULES_TARGET_NONE, sizeof(prio_cache));
+
+	f = fopen(CGRULES_CONF_FILE, "r");
+	if (f == NULL)
+		return;
+
+	if (!cgrules_conf_load_prio_rules(f, prefix, cgrules_user_matches, cgrules_get_target, prio_cache))
+		DBG("%s", "priority rules are left to the rule engine");
+	fclose(f);
+}
 
 void cgrules_init()
 {
@@ -37,11 +208,19 @@ void cgrules_init()
 
 	isCodesysV2 = strcmp("plclinux_rt", proc_name) == 0;
 	isCodesysV3 = strcmp("codesys3", proc_name) == 0;
-
 	isRuntimeSystem = isCodesysV2 || isCodesysV3;
 
 	if(!isRuntimeSystem) goto finished;
 
+	isUnified = access(CGROUP_V2_CONTROLLERS, F_OK) == 0;
+	if (isUnified)
+	{
+		/* libcgroup doesn't know the unified hierarchy, threads are moved via cgroup.threads */
+		cgrules_load_prio_rules();
+		default_target = cgrules_get_target(DEFAULT_GROUP, NULL);
+		goto finished;
+	}
+
     int ret;
     if ((ret = cgroup_init()) != 0)
     {
@@ -77,7 +256,7 @@ void cgrules_init()
         WARN("cgroup_change_all_cgroups() failed: %s", cgroup_strerror(ret));
     }
 
-    default_group = cgroup_new_cgroup("/rts/def");
+    default_group = cgroup_new_cgroup("/" DEFAULT_GROUP);
     ret = cgroup_get_cgroup(default_group);
     if (ret != 0)
     {
@@ -87,6 +266,8 @@ void cgrules_init()
         goto finished;
     }
 
+    cgrules_load_prio_rules();
+
 finished:
     return;
 }
@@ -97,27 +278,54 @@ static void cgrules_get_task_name_by_prio(char *buffer, size_t buffer_size, int
     {
 	    snprintf(buffer, buffer_size,"cdsv2_pol%02dprio%03d", policy, prio);
     }
+
     if (isCodesysV3)
     {
 	    snprintf(buffer, buffer_size,"cdsv3_pol%02dprio%03d", policy, prio);
     }
 }
 
+static int cgrules_attach(int target, pid_t tpid)
+{
+	char buffer[16];
+	int len;
+
+	if (isUnified)
+	{
+		len = snprintf(buffer, sizeof(buffer), "%d", (int)tpid);
+		if (write(targets[target].threads_fd, buffer, (size_t)len) != len)
+		{
+			DBG("can't move %d to %s: %s", (int)tpid, targets[target].path, strerror(errno));
+			return CGRULES_TARGET_NONE;
+		}
+	}
+	else if (cgroup_attach_task_pid(targets[target].group, tpid) != 0)
+	{
+		return CGRULES_TARGET_NONE;
+	}
+	return target;
+}
+
 bool cgrules_is_rts_proc(void)
 {
 	return isRuntimeSystem;
 }
 
-void cgrules_move_to_default(pid_t pid)
+int cgrules_move_to_default(pid_t pid)
 {
-	if (!isRuntimeSystem) return;
+	if (!isRuntimeSystem) return CGRULES_TARGET_NONE;
 	DBG("%s", __func__);
-	cgroup_attach_task_pid(default_group, pid);
+	if (default_target != CGRULES_TARGET_NONE)
+		return cgrules_attach(default_target, pid);
+	if (!isUnified)
+		cgroup_attach_task_pid(default_group, pid);
+	return CGRULES_TARGET_NONE;
 }
 
 void cgrules_apply_rule_by_name(const char *name, pid_t tpid)
 {
-	if (!isRuntimeSystem) return;
+	if (!isRuntimeSystem || isUnified) return;
+
     if (strcmp(name, proc_name))
     {
     	DBG("cgrules_apply_rule_by_name: %s", name);
@@ -125,10 +333,21 @@ void cgrules_apply_rule_by_name(const char *name, pid_t tpid)
     }
 }
 
-void cgrules_apply_rule_by_prio(pid_t tpid, int prio, int policy)
+int cgrules_apply_rule_by_prio(pid_t tpid, int prio, int policy, int current_target)
 {
+	if (!isRuntimeSystem) return CGRULES_TARGET_NONE;
+
+	int target = cgrules_conf_lookup(prio_cache, policy, prio);
+	if (target != CGRULES_TARGET_NONE)
+	{
+		/* thread is already in the group of this priority */
+		if (target == current_target)
+			return target;
+		return cgrules_attach(target, tpid);
+	}
+
 	char prio_name[sizeof("rtsVx::pol00prio000")];
 	cgrules_get_task_name_by_prio(prio_name, sizeof(prio_name), prio, policy);
 	cgrules_apply_rule_by_name(prio_name, tpid);
+	return CGRULES_TARGET_NONE;
 }
-
@@ -11,11 +11,17 @@
 #include <sys/types.h>
 #include <stdbool.h>
 
+/* Target ids identify a resolved destination group of a thread.
+ * CGRULES_TARGET_NONE means unknown, e.g. when the rule engine was used. */
+#define CGRULES_TARGET_NONE (-1)
+
 void cgrules_init();
 
 bool cgrules_is_rts_proc(void);
-void cgrules_move_to_default(pid_t pid);
+int cgrules_move_to_default(pid_t pid);
 void cgrules_apply_rule_by_name(const char* name, pid_t tpid);
-void cgrules_apply_rule_by_prio(pid_t tpid, int prio, int policy);
+/* Returns the target id the thread is in afterwards. If current_target already
+ * matches the priority's destination, nothing is done. */
+int cgrules_apply_rule_by_prio(pid_t tpid, int prio, int policy, int current_target);
 
 #endif
@@ -0,0 +1,90 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2018-2022 WAGO GmbH & Co. KG
+
+
+#include "cgrules_conf.h"
+
+#include <string.h>
+
+#include "cgrules.h"
+
+bool cgrules_conf_load_prio_rules(FILE *conf, const char *prefix,
+                                  cgrules_user_matcher user_matches,
+                                  cgrules_target_resolver get_target,
+                                  cgrules_prio_cache cache)
+{
+	size_t prefix_len = strlen(prefix);
+	char line[512];
+	bool last_matched = false;
+	bool resolved = true;
+
+	memset(cache, CGRULES_TARGET_NONE, sizeof(cgrules_prio_cache));
+
+	while (fgets(line, sizeof(line), conf) != NULL)
+	{
+		char user[128], controllers[128], destination[128];
+		int policy, prio;
+
+		if (sscanf(line, "%127s %127s %127s", user, controllers, destination) != 3 || user[0] == '#')
+		{
+			last_matched = false;
+			continue;
+		}
+		if (user[0] == '%')
+		{
+			if (last_matched)
+				resolved = false;
+			continue;
+		}
+
+		const char *name = strchr(user, ':');
+		last_matched = false;
+		if (!user_matches(user, (name != NULL) ? (size_t)(name - user) : strlen(user)))
+			continue;
+
+		if (name == NULL || strcmp(name + 1, "*") == 0)
+		{
+			/* matches all of our threads, nothing after this line is used */
+			if (strchr(destination, '%') != NULL)
+			{
+				resolved = false;
+				break;
+			}
+			int target = get_target(destination, controllers);
+			for (policy = 0; policy < CGRULES_MAX_POLICY; policy++)
+				for (prio = 0; prio < CGRULES_MAX_PRIO; prio++)
+					if (cache[policy][prio] == CGRULES_TARGET_NONE)
+						cache[policy][prio] = (signed char)target;
+			break;
+		}
+
+		name++;
+		if (strncmp(name, prefix, prefix_len) != 0 ||
+		    sscanf(name + prefix_len, "%2dprio%3d", &policy, &prio) != 2 ||
+		    policy < 0 || policy >= CGRULES_MAX_POLICY || prio < 0 || prio >= CGRULES_MAX_PRIO ||
+		    cache[policy][prio] != CGRULES_TARGET_NONE)
+			continue;
+
+		last_matched = true;
+		if (strchr(destination, '%') != NULL)
+		{
+			resolved = false;
+			continue;
+		}
+		cache[policy][prio] = (signed char)get_target(destination, controllers);
+	}
+
+	if (!resolved)
+		memset(cache, CGRULES_TARGET_NONE, sizeof(cgrules_prio_cache));
+	return resolved;
+}
+
+int cgrules_conf_lookup(cgrules_prio_cache cache, int policy, int prio)
+{
+	if (policy < 0 || policy >= CGRULES_MAX_POLICY || prio < 0 || prio >= CGRULES_MAX_PRIO)
+		return CGRULES_TARGET_NONE;
+	return cache[policy][prio];
+}
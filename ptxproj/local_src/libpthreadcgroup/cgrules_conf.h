@@ -0,0 +1,53 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2018-2022 WAGO GmbH & Co. KG
+
+
+#ifndef _CGRULES_CONF_H_
+#define _CGRULES_CONF_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#define CGRULES_MAX_POLICY 3
+#define CGRULES_MAX_PRIO 100
+
+/* Target id per policy and priority, CGRULES_TARGET_NONE if not resolved. */
+typedef signed char cgrules_prio_cache[CGRULES_MAX_POLICY][CGRULES_MAX_PRIO];
+
+/* Checks the user part of a rule ("*", "name" or "@group"), len characters long. */
+typedef bool (*cgrules_user_matcher)(const char *user, size_t len);
+
+/* Returns the target id of a destination group or CGRULES_TARGET_NONE. */
+typedef int (*cgrules_target_resolver)(const char *destination, const char *controllers);
+
+/*
+ * Resolves the destinations of the thread priority rules of a cgrules.conf
+ * file into cache. Only the subset of the libcgroup syntax needed for them is
+ * understood, every other line is skipped:
+ *
+ *  - "user:<prefix>NNprioNNN controllers destination" with the policy NN
+ *    below CGRULES_MAX_POLICY and the priority NNN below CGRULES_MAX_PRIO,
+ *  - "user controllers destination" and "user:* controllers destination",
+ *    which apply to every priority not resolved before and end the parsing,
+ *  - comments ('#') and empty lines.
+ *
+ * The user part is checked by user_matches. As in libcgroup the first line
+ * matching user and process name wins. Destinations with templates ('%')
+ * and continuation lines ('%' as user) following a used rule can only be
+ * resolved by the libcgroup rule engine.
+ *
+ * Returns false if a rule needs the rule engine, the cache is empty then.
+ */
+bool cgrules_conf_load_prio_rules(FILE *conf, const char *prefix,
+                                  cgrules_user_matcher user_matches,
+                                  cgrules_target_resolver get_target,
+                                  cgrules_prio_cache cache);
+
+/* Returns the cached target id of policy and prio or CGRULES_TARGET_NONE. */
+int cgrules_conf_lookup(cgrules_prio_cache cache, int policy, int prio);
+
+#endif
@@ -24,12 +24,30 @@
 #include "helper.h"
 #include "log.h"
 
-typedef struct thread_info_list thread_info_list;
-struct thread_info_list
+/*
+ * Registry of the runtime's threads: an open-addressed hash table keyed by
+ * pthread_t with linear probing. Inserts, removals and moves of a thread are
+ * serialized by thread_table_lock, so the cached target of a slot always
+ * belongs to the last move. A slot is published by storing its key last;
+ * removed slots become tombstones unless they end a probe chain. Threads which
+ * don't fit into the table are kept in an overflow list.
+ */
+#define THREAD_TABLE_SIZE 4096U /* power of two */
+#define SLOT_EMPTY ((pthread_t)0)
+#define SLOT_DELETED (~(pthread_t)0)
+
+typedef struct thread_slot thread_slot;
+struct thread_slot
 {
-    thread_info_list *next;
     struct thread_info thread_info;
+    int target; /* cgroup the thread was moved to, see cgrules.h, guarded by thread_table_lock */
+};
 
+typedef struct thread_overflow thread_overflow;
+struct thread_overflow
+{
+    thread_overflow *next;
+    thread_slot slot;
 };
 
 #define LOAD_REAL_FUNC(funcname)                                               \
@@ -61,11 +79,13 @@ typedef struct thread_params
     void *arg;
 } thread_params;
 
-static thread_info_list first;
+static thread_slot thread_table[THREAD_TABLE_SIZE];
+
+static thread_overflow *overflow_list;
 
-static __thread thread_info_list self;
+static unsigned int overflow_count;
 
-static pthread_mutex_t thread_info_list_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t thread_table_lock = PTHREAD_MUTEX_INITIALIZER;
 
 __attribute__((constructor)) static void initialize()
 {
@@ -74,109 +94,205 @@ __attribute__((constructor)) static void initialize()
     cgrules_init();
 }
 
-static bool add_to_thread_list(struct thread_info_list *thread_info_list)
+static size_t thread_hash(pthread_t thread)
 {
-	bool alreadyInList = false;
+	/* pthread_t is the address of the thread descriptor */
+	uint32_t h = (uint32_t)((uintptr_t)thread >> 4);
+	h ^= (uint32_t)((uint64_t)(uintptr_t)thread >> 32);
+	return (size_t)(h * 2654435761U) & (THREAD_TABLE_SIZE - 1U);
+}
 
-	struct thread_info thread_info = thread_info_list->thread_info;
-	struct thread_info_list *current = &first;
-	while (current->next != NULL)
-	{
-		if (current->next->thread_info.pthread == thread_info.pthread)
-		{
-			void *tmp = current->next;
-			current->next = current->next->next;
-			free(tmp);
-			alreadyInList = true;
-		}
+static thread_slot *find_thread(pthread_t thread)
+{
+	size_t i = thread_hash(thread);
 
-		if(current->next)
-			current = current->next;
+	for (size_t n = 0; n < THREAD_TABLE_SIZE; n++, i = (i + 1U) & (THREAD_TABLE_SIZE - 1U))
+	{
+		pthread_t key = __atomic_load_n(&thread_table[i].thread_info.pthread, __ATOMIC_ACQUIRE);
+		if (key == thread)
+			return &thread_table[i];
+		if (key == SLOT_EMPTY)
+			break;
 	}
-
-	current->next = thread_info_list;
-	return alreadyInList;
+	return NULL;
 }
 
-static void register_thread()
+/* called with thread_table_lock held */
+static thread_slot *find_overflow_thread(pthread_t thread)
 {
-    self.thread_info.thread_pid = syscall(SYS_gettid);
-    self.thread_info.pthread = pthread_self();
-    self.next = NULL;
+	for (thread_overflow *current = overflow_list; current != NULL; current = current->next)
+	{
+		if (current->slot.thread_info.pthread == thread)
+			return &current->slot;
+	}
+	return NULL;
+}
 
-    pthread_mutex_lock(&thread_info_list_lock);
+/* called with thread_table_lock held */
+static thread_slot *add_to_overflow_list(pthread_t thread, pid_t thread_pid)
+{
+	thread_overflow *entry = calloc(1, sizeof(*entry));
+	if (entry == NULL)
+	{
+		ERROR("%s", "can't register thread: out of memory");
+		return NULL;
+	}
 
-    add_to_thread_list(&self);
-    cgrules_move_to_default(self.thread_info.thread_pid);
+	if (overflow_count == 0)
+		WARN("thread table full (%u entries), using overflow list", THREAD_TABLE_SIZE);
 
-	int policy;
-	struct sched_param sched_param;
-	pthread_getschedparam(pthread_self(), &policy, &sched_param);
-	cgrules_apply_rule_by_prio(self.thread_info.thread_pid, sched_param.__sched_priority, policy);
+	entry->slot.thread_info.pthread = thread;
+	entry->slot.thread_info.thread_pid = thread_pid;
+	entry->slot.target = CGRULES_TARGET_NONE;
+	entry->next = overflow_list;
+	overflow_list = entry;
+	__atomic_add_fetch(&overflow_count, 1U, __ATOMIC_RELEASE);
+	return &entry->slot;
+}
 
-    pthread_mutex_unlock(&thread_info_list_lock);
+/* called with thread_table_lock held */
+static bool remove_from_overflow_list(pthread_t thread)
+{
+	for (thread_overflow **current = &overflow_list; *current != NULL; current = &(*current)->next)
+	{
+		if ((*current)->slot.thread_info.pthread == thread)
+		{
+			thread_overflow *entry = *current;
+			*current = entry->next;
+			free(entry);
+			__atomic_sub_fetch(&overflow_count, 1U, __ATOMIC_RELEASE);
+			return true;
+		}
+	}
+	return false;
 }
 
-static void unregister_thread(void*  arg)
+/* called with thread_table_lock held */
+static thread_slot *add_to_thread_table(pthread_t thread, pid_t thread_pid)
 {
-    (void)arg;
-    //DBG("%s", __func__);
-    pthread_mutex_lock(&thread_info_list_lock);
+	thread_slot *slot = NULL;
+	size_t i = thread_hash(thread);
+
+	if (overflow_count > 0)
+	{
+		slot = find_overflow_thread(thread);
+		if (slot != NULL)
+		{
+			/* stale entry of an exited thread with a reused pthread_t */
+			slot->thread_info.thread_pid = thread_pid;
+			slot->target = CGRULES_TARGET_NONE;
+			return slot;
+		}
+	}
 
-    thread_info_list *current = &first;
-    while (current->next != &self)
-        current = current->next;
+	for (size_t n = 0; n < THREAD_TABLE_SIZE; n++, i = (i + 1U) & (THREAD_TABLE_SIZE - 1U))
+	{
+		pthread_t key = thread_table[i].thread_info.pthread;
+		if (key == thread)
+		{
+			/* stale entry of an exited thread with a reused pthread_t */
+			__atomic_store_n(&thread_table[i].thread_info.thread_pid, thread_pid, __ATOMIC_RELEASE);
+			thread_table[i].target = CGRULES_TARGET_NONE;
+			return &thread_table[i];
+		}
+		if (key == SLOT_DELETED && slot == NULL)
+			slot = &thread_table[i];
+		if (key == SLOT_EMPTY)
+		{
+			if (slot == NULL)
+				slot = &thread_table[i];
+			break;
+		}
+	}
 
-    current->next = self.next;
+	if (slot == NULL)
+		return add_to_overflow_list(thread, thread_pid);
 
-    pthread_mutex_unlock(&thread_info_list_lock);
+	__atomic_store_n(&slot->thread_info.thread_pid, thread_pid, __ATOMIC_RELAXED);
+	slot->target = CGRULES_TARGET_NONE;
+	__atomic_store_n(&slot->thread_info.pthread, thread, __ATOMIC_RELEASE);
+	return slot;
 }
 
-static void add_dummy_entry_to_list(pthread_t thread)
+/* called with thread_table_lock held */
+static void remove_from_thread_table(pthread_t thread)
 {
-	pthread_mutex_lock(&thread_info_list_lock);
-
-	struct thread_info_list *current = &first;
-
-	while(current != NULL && current->thread_info.pthread != thread)
-		current = current->next;
-
-	if (current == NULL)
+	thread_slot *slot = find_thread(thread);
+	if (slot == NULL)
 	{
-		struct thread_info_list *thread_info_list = calloc(1, sizeof(*thread_info_list));
-		thread_info_list->thread_info.pthread = thread;
+		if (overflow_count > 0)
+			remove_from_overflow_list(thread);
+		return;
+	}
 
-		current = &first;
-		while(current->next != NULL)
-			current = current->next;
+	size_t i = (size_t)(slot - thread_table);
+	size_t next = (i + 1U) & (THREAD_TABLE_SIZE - 1U);
+	if (thread_table[next].thread_info.pthread != SLOT_EMPTY)
+	{
+		__atomic_store_n(&slot->thread_info.pthread, SLOT_DELETED, __ATOMIC_RELEASE);
+		return;
+	}
 
-		current->next = thread_info_list;
+	/* end of a probe chain: free the slot and the tombstones in front of it */
+	__atomic_store_n(&slot->thread_info.pthread, SLOT_EMPTY, __ATOMIC_RELEASE);
+	i = (i - 1U) & (THREAD_TABLE_SIZE - 1U);
+	while (thread_table[i].thread_info.pthread == SLOT_DELETED)
+	{
+		__atomic_store_n(&thread_table[i].thread_info.pthread, SLOT_EMPTY, __ATOMIC_RELEASE);
+		i = (i - 1U) & (THREAD_TABLE_SIZE - 1U);
 	}
+}
 
-	pthread_mutex_unlock(&thread_info_list_lock);
+/*
+ * Moves a registered thread by its current scheduling parameters, not by
+ * those of the caller, so a later priority change can't be overwritten by an
+ * earlier one. Called with thread_table_lock held.
+ */
+static void move_by_prio(thread_slot *slot, pthread_t thread)
+{
+	int policy;
+	struct sched_param sched_param;
+
+	if (pthread_getschedparam(thread, &policy, &sched_param) != 0)
+		return;
+	slot->target = cgrules_apply_rule_by_prio(slot->thread_info.thread_pid, sched_param.__sched_priority,
+	                                          policy, slot->target);
 }
 
-static pid_t get_thread_pid(pthread_t thread)
+static void register_thread()
 {
-	pthread_mutex_lock(&thread_info_list_lock);
+	pid_t thread_pid = (pid_t)syscall(SYS_gettid);
 
-	thread_info_list *current = &first;
-	while (current != NULL)
-		if (current->thread_info.pthread == thread)
-			break;
-		else
-			current = current->next;
+	pthread_mutex_lock(&thread_table_lock);
 
-	pthread_mutex_unlock(&thread_info_list_lock);
+	thread_slot *slot = add_to_thread_table(pthread_self(), thread_pid);
+	int target = cgrules_move_to_default(thread_pid);
 
-	// is the thread not started yet?
-	if (current == NULL)
+	if (slot != NULL)
+	{
+		slot->target = target;
+		move_by_prio(slot, pthread_self());
+	}
+	else
 	{
-		add_dummy_entry_to_list(thread);
-		return get_thread_pid(thread);
+		int policy;
+		struct sched_param sched_param;
+		pthread_getschedparam(pthread_self(), &policy, &sched_param);
+		cgrules_apply_rule_by_prio(thread_pid, sched_param.__sched_priority, policy, target);
 	}
 
-	return current->thread_info.thread_pid;
+	pthread_mutex_unlock(&thread_table_lock);
+}
+
+static void unregister_thread(void*  arg)
+{
+    (void)arg;
+    //DBG("%s", __func__);
+    pthread_mutex_lock(&thread_table_lock);
+
+    remove_from_thread_table(pthread_self());
+
+    pthread_mutex_unlock(&thread_table_lock);
 }
 
 static void *start_routine2(thread_params *params)
@@ -310,9 +426,14 @@ static int rts_pthread_setschedparam (pthread_t __target_thread,
 
 	if (real_setschedparam_result == 0)
 	{
-		pid_t tpid = get_thread_pid(__target_thread);
-		if (tpid != 0)
-			cgrules_apply_rule_by_prio(tpid, __param->__sched_priority, __policy);
+		/* a thread which didn't register yet picks up its priority in register_thread() */
+		pthread_mutex_lock(&thread_table_lock);
+		thread_slot *slot = find_thread(__target_thread);
+		if (slot == NULL && overflow_count > 0)
+			slot = find_overflow_thread(__target_thread);
+		if (slot != NULL && slot->thread_info.thread_pid != 0)
+			move_by_prio(slot, __target_thread);
+		pthread_mutex_unlock(&thread_table_lock);
 
 		DBG("Param: %d policy: %d", __param->sched_priority, __policy);
 	}
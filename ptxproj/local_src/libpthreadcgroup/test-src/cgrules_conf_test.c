@@ -0,0 +1,143 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2018-2022 WAGO GmbH & Co. KG
+
+/* Checks the cgrules.conf subset resolved into the priority cache. Returns 0 if all checks pass. */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "cgrules.h"
+#include "cgrules_conf.h"
+
+static int failed = 0;
+
+#define CHECK_INT(actual, expected)                                            \
+    check_int(__LINE__, #actual, (actual), (expected))
+
+static void check_int(int line, const char *what, int actual, int expected)
+{
+	if (actual != expected)
+	{
+		fprintf(stderr, "line %d: %s: got %d, expected %d\n", line, what, actual, expected);
+		failed++;
+	}
+}
+
+/* "root" and the group "@rts" match, every other user doesn't */
+static bool user_matches(const char *user, size_t len)
+{
+	return (len == 1 && strncmp(user, "*", len) == 0) ||
+	       (len == 4 && strncmp(user, "root", len) == 0) ||
+	       (len == 4 && strncmp(user, "@rts", len) == 0);
+}
+
+/* target ids are given in order of the first use of a destination */
+static char destinations[8][128];
+static int destination_count;
+
+static int get_target(const char *destination, const char *controllers)
+{
+	(void)controllers;
+	for (int i = 0; i < destination_count; i++)
+	{
+		if (strcmp(destinations[i], destination) == 0)
+			return i;
+	}
+	snprintf(destinations[destination_count], sizeof(destinations[0]), "%s", destination);
+	return destination_count++;
+}
+
+static bool load(const char *conf, cgrules_prio_cache cache)
+{
+	FILE *f = fmemopen((void *)(uintptr_t)conf, strlen(conf), "r");
+	bool resolved;
+
+	destination_count = 0;
+	resolved = cgrules_conf_load_prio_rules(f, "cdsv3_pol", user_matches, get_target, cache);
+	fclose(f);
+	return resolved;
+}
+
+static void resolves_prio_rules(void)
+{
+	cgrules_prio_cache cache;
+
+	CHECK_INT(load("# rts task prio names\n"
+	               "root:cdsv3_pol00prio000   cpuacct   rts/def\n"
+	               "\n"
+	               "root:cdsv3_pol01prio014   cpuacct   rts/iec\n"
+	               "root:cdsv2_pol01prio015   cpuacct   rts/iec\n"
+	               "root:codesys3             cpuacct   rts/iec\n"
+	               "@rts:cdsv3_pol02prio099   cpuacct   /rts/comm\n", cache), true);
+
+	CHECK_INT(cgrules_conf_lookup(cache, 0, 0), 0);
+	CHECK_INT(cgrules_conf_lookup(cache, 1, 14), 1);
+	CHECK_INT(cgrules_conf_lookup(cache, 2, 99), 2);
+	/* other runtime and process name rules are not for threads */
+	CHECK_INT(cgrules_conf_lookup(cache, 1, 15), CGRULES_TARGET_NONE);
+	CHECK_INT(destination_count, 3);
+	/* out of range */
+	CHECK_INT(cgrules_conf_lookup(cache, 3, 0), CGRULES_TARGET_NONE);
+	CHECK_INT(cgrules_conf_lookup(cache, 1, 100), CGRULES_TARGET_NONE);
+	CHECK_INT(cgrules_conf_lookup(cache, -1, 1), CGRULES_TARGET_NONE);
+}
+
+static void first_matching_rule_wins(void)
+{
+	cgrules_prio_cache cache;
+
+	CHECK_INT(load("nobody:cdsv3_pol01prio010  cpuacct   default/other\n"
+	               "root:cdsv3_pol01prio010    cpuacct   rts/iec\n"
+	               "root:cdsv3_pol01prio010    cpuacct   rts/def\n", cache), true);
+
+	CHECK_INT(cgrules_conf_lookup(cache, 1, 10), 0);
+	CHECK_INT(destination_count, 1);
+}
+
+static void wildcard_rule_resolves_the_rest(void)
+{
+	cgrules_prio_cache cache;
+
+	CHECK_INT(load("root:cdsv3_pol01prio010    cpuacct   rts/iec\n"
+	               "root:*                     cpuacct   rts/def\n"
+	               "root:cdsv3_pol01prio011    cpuacct   rts/iec\n", cache), true);
+
+	CHECK_INT(cgrules_conf_lookup(cache, 1, 10), 0);
+	CHECK_INT(cgrules_conf_lookup(cache, 1, 11), 1);
+	CHECK_INT(cgrules_conf_lookup(cache, 0, 0), 1);
+	CHECK_INT(cgrules_conf_lookup(cache, 2, 99), 1);
+}
+
+static void templates_are_left_to_the_rule_engine(void)
+{
+	cgrules_prio_cache cache;
+
+	CHECK_INT(load("root:cdsv3_pol01prio010    cpuacct   rts/%u\n", cache), false);
+	CHECK_INT(cgrules_conf_lookup(cache, 1, 10), CGRULES_TARGET_NONE);
+
+	/* a continuation line adds destinations to the rule before */
+	CHECK_INT(load("root:cdsv3_pol01prio010    cpuacct   rts/iec\n"
+	               "%                          memory    rts/iec\n", cache), false);
+	CHECK_INT(cgrules_conf_lookup(cache, 1, 10), CGRULES_TARGET_NONE);
+
+	/* but not to an unused one */
+	CHECK_INT(load("root:codesys3              cpuacct   rts/iec\n"
+	               "%                          memory    rts/iec\n"
+	               "root:cdsv3_pol01prio010    cpuacct   rts/iec\n", cache), true);
+	CHECK_INT(cgrules_conf_lookup(cache, 1, 10), 0);
+}
+
+int main(void)
+{
+	resolves_prio_rules();
+	first_matching_rule_wins();
+	wildcard_rule_resolves_the_rest();
+	templates_are_left_to_the_rule_engine();
+
+	printf("%s\n", failed ? "FAILED" : "OK");
+	return failed ? 1 : 0;
+}
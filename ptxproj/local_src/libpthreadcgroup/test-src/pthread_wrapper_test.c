@@ -0,0 +1,139 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2018-2022 WAGO GmbH & Co. KG
+
+/*
+ * Checks the target cache of the thread registry. The wrapper is linked into
+ * this program, the cgroup moves are replaced by the stubs below. Returns 0 if
+ * all checks pass.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <syscall.h>
+
+#include "cgrules.h"
+
+#define DEFAULT_TARGET 7
+#define PRIO_TARGET(policy) (100 + (policy))
+
+static int failed = 0;
+
+#define CHECK_INT(actual, expected)                                            \
+    check_int(__LINE__, #actual, (actual), (expected))
+
+static void check_int(int line, const char *what, int actual, int expected)
+{
+	if (actual != expected)
+	{
+		fprintf(stderr, "line %d: %s: got %d, expected %d\n", line, what, actual, expected);
+		failed++;
+	}
+}
+
+/* last move by priority */
+static struct
+{
+	int calls;
+	pid_t tpid;
+	int policy;
+	int current_target;
+} moved;
+
+void cgrules_init() {}
+
+bool cgrules_is_rts_proc(void)
+{
+	return true;
+}
+
+int cgrules_move_to_default(pid_t pid)
+{
+	(void)pid;
+	return DEFAULT_TARGET;
+}
+
+void cgrules_apply_rule_by_name(const char* name, pid_t tpid)
+{
+	(void)name;
+	(void)tpid;
+}
+
+int cgrules_apply_rule_by_prio(pid_t tpid, int prio, int policy, int current_target)
+{
+	(void)prio;
+	moved.calls++;
+	moved.tpid = tpid;
+	moved.policy = policy;
+	moved.current_target = current_target;
+	return PRIO_TARGET(policy);
+}
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
+static pid_t thread_pid;
+static bool stop;
+
+static void *thread_routine(void *arg)
+{
+	(void)arg;
+	pthread_mutex_lock(&lock);
+	thread_pid = (pid_t)syscall(SYS_gettid);
+	pthread_cond_broadcast(&cond);
+	while (!stop)
+		pthread_cond_wait(&cond, &lock);
+	pthread_mutex_unlock(&lock);
+	return NULL;
+}
+
+static void set_policy(pthread_t thread, int policy)
+{
+	struct sched_param param = { .sched_priority = 0 };
+	CHECK_INT(pthread_setschedparam(thread, policy, &param), 0);
+}
+
+int main(void)
+{
+	pthread_t thread;
+
+	CHECK_INT(pthread_create(&thread, NULL, thread_routine, NULL), 0);
+	pthread_mutex_lock(&lock);
+	while (thread_pid == 0)
+		pthread_cond_wait(&cond, &lock);
+	pthread_mutex_unlock(&lock);
+
+	/* registration moves the thread from the default group by its priority */
+	CHECK_INT(moved.calls, 1);
+	CHECK_INT(moved.tpid, thread_pid);
+	CHECK_INT(moved.policy, SCHED_OTHER);
+	CHECK_INT(moved.current_target, DEFAULT_TARGET);
+
+	/* a priority change starts from the target of the last move */
+	set_policy(thread, SCHED_BATCH);
+	CHECK_INT(moved.calls, 2);
+	CHECK_INT(moved.tpid, thread_pid);
+	CHECK_INT(moved.policy, SCHED_BATCH);
+	CHECK_INT(moved.current_target, PRIO_TARGET(SCHED_OTHER));
+
+	set_policy(thread, SCHED_OTHER);
+	CHECK_INT(moved.calls, 3);
+	CHECK_INT(moved.policy, SCHED_OTHER);
+	CHECK_INT(moved.current_target, PRIO_TARGET(SCHED_BATCH));
+
+	/* threads not created through the wrapper are not registered */
+	set_policy(pthread_self(), SCHED_OTHER);
+	CHECK_INT(moved.calls, 3);
+
+	pthread_mutex_lock(&lock);
+	stop = true;
+	pthread_cond_broadcast(&cond);
+	pthread_mutex_unlock(&lock);
+	pthread_join(thread, NULL);
+
+	printf("%s\n", failed ? "FAILED" : "OK");
+	return failed ? 1 : 0;
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <sys/types.h>
+
 #include "Status.hpp"
 #include "DynamicIPEventAction.hpp"
 #include "BaseTypes.hpp"
@@ -9,8 +11,18 @@ namespace api {
 
 Status NotifyDynamicIPAction(const ::std::string &interface, DynamicIPEventAction action);
 
+/**
+ * Sends the event together with the lease of the client script to netconfd (datagram on a local socket).
+ * Uses dbus if netconfd does not provide the socket, netconfd then reads the lease file.
+ * The pid of the DHCP/BOOTP client lets netconfd drop events of a client it has already stopped.
+ */
+Status NotifyDynamicIPAction(const ::std::string &interface, DynamicIPEventAction action, const ::std::string &lease,
+                             pid_t client_pid);
+
 
 Status MakeDynamicIPAction(const std::string &json_str, ::std::string &interface, DynamicIPEventAction& action);
+Status MakeDynamicIPAction(const std::string &json_str, ::std::string &interface, DynamicIPEventAction& action,
+                           ::std::string &lease, pid_t &client_pid);
 
 Status ReloadHostConf();
 
@@ -1,5 +1,6 @@
 #include "Event.hpp"
 #include "JsonConverter.hpp"
+#include "LeaseEvent.hpp"
 #include "NetconfdDbusClient.hpp"
 
 namespace netconf {
@@ -15,11 +16,32 @@ Status NotifyDynamicIPAction(const ::std::string &interface, DynamicIPEventActio
   return result.error_;
 }
 
+Status NotifyDynamicIPAction(const ::std::string &interface, DynamicIPEventAction action, const ::std::string &lease,
+                             pid_t client_pid) {
+  auto status = SendLeaseEvent(LeaseEvent{interface, action, lease, client_pid});
+  if (status.IsNotOk()) {
+    status = NotifyDynamicIPAction(interface, action);
+  }
+  return status;
+}
+
 Status MakeDynamicIPAction(const std::string &json_str, ::std::string &interface, DynamicIPEventAction& action) {
   JsonConverter jc;
   return jc.FromJsonString(json_str, interface, action);
 }
 
+Status MakeDynamicIPAction(const std::string &json_str, ::std::string &interface, DynamicIPEventAction& action,
+                           ::std::string &lease, pid_t &client_pid) {
+  JsonConverter jc;
+  LeaseEvent event;
+  auto status = jc.FromJsonString(json_str, event);
+  interface   = event.interface_;
+  action      = event.action_;
+  lease       = event.lease_;
+  client_pid  = event.pid_;
+  return status;
+}
+
 Status ReloadHostConf() {
   NetconfdDbusClient client;
   auto result = client.ReloadHostConf();
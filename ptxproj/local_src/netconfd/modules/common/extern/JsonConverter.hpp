@@ -4,6 +4,7 @@
 #include "Types.hpp"
 #include "Status.hpp"
 #include "DynamicIPEventAction.hpp"
+#include "LeaseEvent.hpp"
 
 namespace netconf {
 
@@ -57,6 +58,8 @@ class JsonConverter {
   ::std::string ToJsonString(const ::std::string &itf_name, DynamicIPEventAction action, JsonFormat format =
                                  JsonFormat::COMPACT) const;
   Status FromJsonString(const ::std::string &str, ::std::string &itf_name, DynamicIPEventAction &action) const;
+  // Dynamic IP event with the optional "lease" of the client script.
+  Status FromJsonString(const ::std::string &str, LeaseEvent &event) const;
 };
 
 }  // namespace netconf
@@ -0,0 +1,49 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <sys/types.h>
+
+#include <string>
+
+#include "DynamicIPEventAction.hpp"
+#include "Status.hpp"
+
+namespace netconf {
+
+// Local datagram socket of netconfd that receives the events of the DHCP/BOOTP client scripts.
+// It is created in the run directory of netconfd; the default path belongs to the default run directory.
+constexpr auto LEASE_EVENT_SOCKET_NAME = "lease-event.socket";
+constexpr auto LEASE_EVENT_SOCKET_PATH = "/var/run/netconfd/lease-event.socket";
+constexpr ::std::size_t LEASE_EVENT_MAX_SIZE = 4096;
+
+// netconfd passes the socket path to the client processes and their scripts in this environment variable.
+constexpr auto LEASE_EVENT_SOCKET_ENV = "NETCONFD_LEASE_EVENT_SOCKET";
+
+/*
+ * Event of a DHCP/BOOTP client script together with the lease it got.
+ * The lease uses the format of the lease file: one "KEY=value" per line (IPADDRESS, NETMASK, DHCPHOSTNAME, ...).
+ */
+struct LeaseEvent {
+  ::std::string interface_;
+  DynamicIPEventAction action_ = DynamicIPEventAction::UNKNOWN;
+  ::std::string lease_;
+  pid_t pid_ = 0;  // process of the DHCP/BOOTP client that sent the event, 0 if unknown
+};
+
+/*
+ * One datagram holds one complete event, the header lines are always the first three:
+ *   INTERFACE=<interface>
+ *   ACTION=<bound|renew|release|nak>
+ *   PID=<client pid>
+ *   <lease lines>
+ */
+::std::string ToDatagram(const LeaseEvent &event);
+Status FromDatagram(const ::std::string &datagram, LeaseEvent &event);
+
+// Path of the socket from LEASE_EVENT_SOCKET_ENV, LEASE_EVENT_SOCKET_PATH if it is not set.
+::std::string GetLeaseEventSocketPath();
+
+// Sends the event without waiting for netconfd, fails if netconfd does not listen on the socket.
+Status SendLeaseEvent(const LeaseEvent &event, const ::std::string &socket_path = GetLeaseEventSocketPath());
+
+}  // namespace netconf
@@ -305,4 +305,24 @@ Status JsonConverter::FromJsonString(const ::std::string &str, ::std::string &it
   return status;
 }
 
+Status JsonConverter::FromJsonString(const ::std::string &str, LeaseEvent &event) const {
+  event = LeaseEvent{};
+
+  json j;
+  auto status = JsonToNJson(str, j);
+
+  if (status.IsOk()) {
+    status = GetToOrError("interface", j, event.interface_);
+  }
+  if (status.IsOk()) {
+    status = GetToOrError("action", j, event.action_);
+  }
+  if (status.IsOk()) {
+    GetToIfExists("lease", j, event.lease_);
+    GetToIfExists("pid", j, event.pid_);
+  }
+
+  return status;
+}
+
 }  // namespace netconf
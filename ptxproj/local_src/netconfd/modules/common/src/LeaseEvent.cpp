@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "LeaseEvent.hpp"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <array>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+
+#include "Socket.hpp"
+
+namespace netconf {
+
+namespace {
+
+constexpr auto KEY_INTERFACE = ::std::string_view{"INTERFACE="};
+constexpr auto KEY_ACTION    = ::std::string_view{"ACTION="};
+constexpr auto KEY_PID       = ::std::string_view{"PID="};
+
+constexpr ::std::array<::std::pair<DynamicIPEventAction, ::std::string_view>, 4> action_names{{
+    {DynamicIPEventAction::BOUND, "bound"},
+    {DynamicIPEventAction::RELEASE, "release"},
+    {DynamicIPEventAction::RENEW, "renew"},
+    {DynamicIPEventAction::NAK, "nak"},
+}};
+
+::std::string_view ToString(DynamicIPEventAction action) {
+  for (const auto &[value, name] : action_names) {
+    if (value == action) {
+      return name;
+    }
+  }
+  return "";
+}
+
+DynamicIPEventAction ToAction(::std::string_view name) {
+  for (const auto &[value, action_name] : action_names) {
+    if (action_name == name) {
+      return value;
+    }
+  }
+  return DynamicIPEventAction::UNKNOWN;
+}
+
+// Takes the value of the next line if it has the key, the line is removed from the content.
+bool TakeHeaderValue(::std::string_view &content, ::std::string_view key, ::std::string_view &value) {
+  auto line_end = content.find('\n');
+  auto line     = content.substr(0, line_end);
+  if (line.substr(0, key.size()) != key) {
+    return false;
+  }
+  value = line.substr(key.size());
+  content.remove_prefix(line_end == ::std::string_view::npos ? content.size() : line_end + 1);
+  return true;
+}
+
+}  // namespace
+
+::std::string ToDatagram(const LeaseEvent &event) {
+  ::std::string datagram;
+  datagram.reserve(KEY_INTERFACE.size() + KEY_ACTION.size() + KEY_PID.size() + event.interface_.size() +
+                   event.lease_.size() + 32);
+  datagram.append(KEY_INTERFACE).append(event.interface_).append(1, '\n');
+  datagram.append(KEY_ACTION).append(ToString(event.action_)).append(1, '\n');
+  datagram.append(KEY_PID).append(::std::to_string(event.pid_)).append(1, '\n');
+  datagram.append(event.lease_);
+  return datagram;
+}
+
+Status FromDatagram(const ::std::string &datagram, LeaseEvent &event) {
+  event = LeaseEvent{};
+
+  // Only the header sets the event fields, lease lines with the same keys are part of the lease.
+  ::std::string_view content{datagram};
+  ::std::string_view interface;
+  ::std::string_view action;
+  ::std::string_view pid;
+  if (not TakeHeaderValue(content, KEY_INTERFACE, interface) || interface.empty()) {
+    return Status{StatusCode::GENERIC_ERROR, "Lease event without interface"};
+  }
+  if (not TakeHeaderValue(content, KEY_ACTION, action) || not TakeHeaderValue(content, KEY_PID, pid)) {
+    return Status{StatusCode::GENERIC_ERROR, "Lease event with invalid header"};
+  }
+
+  event.interface_ = interface;
+  event.action_    = ToAction(action);
+  event.pid_       = static_cast<pid_t>(::std::strtol(::std::string{pid}.c_str(), nullptr, 10));
+  event.lease_     = content;
+  return Status{};
+}
+
+::std::string GetLeaseEventSocketPath() {
+  const char *path = ::std::getenv(LEASE_EVENT_SOCKET_ENV);
+  return (path != nullptr && *path != '\0') ? ::std::string{path} : ::std::string{LEASE_EVENT_SOCKET_PATH};
+}
+
+Status SendLeaseEvent(const LeaseEvent &event, const ::std::string &socket_path) {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (socket_path.size() >= sizeof(address.sun_path)) {
+    return Status{StatusCode::GENERIC_ERROR, "Lease event socket path is too long: " + socket_path};
+  }
+  ::std::strncpy(&address.sun_path[0], socket_path.c_str(), sizeof(address.sun_path) - 1);
+
+  auto datagram = ToDatagram(event);
+  if (datagram.size() > LEASE_EVENT_MAX_SIZE) {
+    return Status{StatusCode::GENERIC_ERROR, "Lease event is too large"};
+  }
+
+  try {
+    Socket socket{AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0};
+    auto sent = ::sendto(socket.fd(), datagram.data(), datagram.size(), 0,
+                         reinterpret_cast<sockaddr *>(&address),  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+                         sizeof(address));
+    if (sent != static_cast<ssize_t>(datagram.size())) {
+      return Status{StatusCode::SYSTEM_CALL, "sendto " + socket_path + ": " + ::std::strerror(errno)};
+    }
+  } catch (::std::system_error &e) {
+    return Status{StatusCode::SYSTEM_CALL, e.what()};
+  }
+  return Status{};
+}
+
+}  // namespace netconf
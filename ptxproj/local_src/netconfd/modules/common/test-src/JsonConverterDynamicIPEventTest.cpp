@@ -78,4 +78,31 @@ TEST_F(JsonConverterDynamicIPEventTest, ParsesIncorrectJsonString) {
   ASSERT_EQ(StatusCode::JSON_CONVERT, status.GetStatusCode());
 }
 
+TEST_F(JsonConverterDynamicIPEventTest, ParsesLeaseEvent) {
+  ::std::string const json_dynamic_ip_event =
+      R"({"interface": "br0", "action": "bound", "lease": "IPADDRESS=192.168.1.17\nNETMASK=255.255.255.0\n", "pid": 4711})";
+
+  LeaseEvent event;
+  Status status = parser_->FromJsonString(json_dynamic_ip_event, event);
+
+  ASSERT_EQ(StatusCode::OK, status.GetStatusCode());
+  EXPECT_EQ("br0", event.interface_);
+  EXPECT_EQ(DynamicIPEventAction::BOUND, event.action_);
+  EXPECT_EQ("IPADDRESS=192.168.1.17\nNETMASK=255.255.255.0\n", event.lease_);
+  EXPECT_EQ(4711, event.pid_);
+}
+
+TEST_F(JsonConverterDynamicIPEventTest, ParsesLeaseEventWithoutLease) {
+  ::std::string const json_dynamic_ip_event = R"({"interface": "br0", "action": "release"})";
+
+  LeaseEvent event;
+  Status status = parser_->FromJsonString(json_dynamic_ip_event, event);
+
+  ASSERT_EQ(StatusCode::OK, status.GetStatusCode());
+  EXPECT_EQ("br0", event.interface_);
+  EXPECT_EQ(DynamicIPEventAction::RELEASE, event.action_);
+  EXPECT_TRUE(event.lease_.empty());
+  EXPECT_EQ(0, event.pid_);
+}
+
 }  // namespace netconf
@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "CommonTestDependencies.hpp"
+
+#include <cstdlib>
+#include <string>
+
+#include "LeaseEvent.hpp"
+
+namespace netconf {
+
+TEST(LeaseEventTest, ConvertsEventToDatagramAndBack) {
+  LeaseEvent event{"br0", DynamicIPEventAction::BOUND,
+                   "IPADDRESS=192.168.1.17\nNETMASK=255.255.255.0\nDHCPHOSTNAME=PFC-4711\nDNS_SERVER_1=192.168.1.1\n", 4711};
+
+  auto datagram = ToDatagram(event);
+  EXPECT_EQ(0, datagram.find("INTERFACE=br0\nACTION=bound\nPID=4711\nIPADDRESS=192.168.1.17\n"));
+
+  LeaseEvent received;
+  ASSERT_EQ(StatusCode::OK, FromDatagram(datagram, received).GetStatusCode());
+  EXPECT_EQ(event.interface_, received.interface_);
+  EXPECT_EQ(event.action_, received.action_);
+  EXPECT_EQ(event.lease_, received.lease_);
+  EXPECT_EQ(4711, received.pid_);
+}
+
+TEST(LeaseEventTest, ConvertsEventWithoutLease) {
+  LeaseEvent event{"br1", DynamicIPEventAction::RELEASE, ""};
+
+  LeaseEvent received;
+  ASSERT_EQ(StatusCode::OK, FromDatagram(ToDatagram(event), received).GetStatusCode());
+  EXPECT_EQ("br1", received.interface_);
+  EXPECT_EQ(DynamicIPEventAction::RELEASE, received.action_);
+  EXPECT_TRUE(received.lease_.empty());
+}
+
+TEST(LeaseEventTest, KeepsLeaseValuesThatLookLikeEventKeys) {
+  LeaseEvent event{"br0", DynamicIPEventAction::RENEW, "VENDORINFO=ACTION=nak\nIPADDRESS=10.0.0.1"};
+
+  LeaseEvent received;
+  ASSERT_EQ(StatusCode::OK, FromDatagram(ToDatagram(event), received).GetStatusCode());
+  EXPECT_EQ(DynamicIPEventAction::RENEW, received.action_);
+  EXPECT_EQ(event.lease_, received.lease_);
+}
+
+TEST(LeaseEventTest, TakesEventFieldsOnlyFromHeader) {
+  LeaseEvent event{"br0", DynamicIPEventAction::BOUND, "INTERFACE=br1\nACTION=release\nPID=1\nIPADDRESS=10.0.0.1\n", 42};
+
+  LeaseEvent received;
+  ASSERT_EQ(StatusCode::OK, FromDatagram(ToDatagram(event), received).GetStatusCode());
+  EXPECT_EQ("br0", received.interface_);
+  EXPECT_EQ(DynamicIPEventAction::BOUND, received.action_);
+  EXPECT_EQ(42, received.pid_);
+  EXPECT_EQ(event.lease_, received.lease_);
+}
+
+TEST(LeaseEventTest, RejectsDatagramWithIncompleteHeader) {
+  LeaseEvent received;
+  EXPECT_EQ(StatusCode::GENERIC_ERROR,
+            FromDatagram("INTERFACE=br0\nIPADDRESS=10.0.0.1\nACTION=bound\nPID=1\n", received).GetStatusCode());
+  EXPECT_EQ(StatusCode::GENERIC_ERROR, FromDatagram("INTERFACE=br0\nACTION=bound\n", received).GetStatusCode());
+}
+
+TEST(LeaseEventTest, RejectsDatagramWithoutInterface) {
+  LeaseEvent received;
+  EXPECT_EQ(StatusCode::GENERIC_ERROR,
+            FromDatagram("ACTION=bound\nIPADDRESS=10.0.0.1\n", received).GetStatusCode());
+}
+
+TEST(LeaseEventTest, ParsesUnknownAction) {
+  LeaseEvent received;
+  ASSERT_EQ(StatusCode::OK, FromDatagram("INTERFACE=br0\nACTION=xxx\nPID=0\n", received).GetStatusCode());
+  EXPECT_EQ(DynamicIPEventAction::UNKNOWN, received.action_);
+}
+
+TEST(LeaseEventTest, TakesSocketPathFromEnvironment) {
+  ::setenv(LEASE_EVENT_SOCKET_ENV, "/tmp/netconfd/lease-event.socket", 1);
+  EXPECT_EQ("/tmp/netconfd/lease-event.socket", GetLeaseEventSocketPath());
+
+  ::unsetenv(LEASE_EVENT_SOCKET_ENV);
+  EXPECT_EQ(LEASE_EVENT_SOCKET_PATH, GetLeaseEventSocketPath());
+}
+
+}  // namespace netconf
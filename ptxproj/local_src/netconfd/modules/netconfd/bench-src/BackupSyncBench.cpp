@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+//------------------------------------------------------------------------------
+///  \file     BackupSyncBench.cpp
+///
+///  \brief    Time and sync calls of a netconfd backup of a large configuration.
+///
+///            Runs BackupRestore::Backup with the real FileEditor for growing
+///            network data and prints the time per backup and the number of
+///            sync, syncfs, fsync and fdatasync calls it made. The calls are
+///            counted by the wrappers below, which only exist in this binary,
+///            and are forwarded to the kernel.
+///
+///            usage: netconfd_backup_sync.elf [backups per size]
+//------------------------------------------------------------------------------
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "BackupRestore.hpp"
+#include "FileEditor.hpp"
+
+namespace {
+
+::std::atomic<int> sync_calls{0};  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+}  // namespace
+
+extern "C" {
+
+void sync() {
+  ++sync_calls;
+  ::syscall(SYS_sync);
+}
+
+int syncfs(int fd) {
+  ++sync_calls;
+  return static_cast<int>(::syscall(SYS_syncfs, fd));
+}
+
+int fsync(int fd) {
+  ++sync_calls;
+  return static_cast<int>(::syscall(SYS_fsync, fd));
+}
+
+int fdatasync(int fd) {
+  ++sync_calls;
+  return static_cast<int>(::syscall(SYS_fdatasync, fd));
+}
+
+}
+
+namespace netconf {
+namespace {
+
+using Clock = ::std::chrono::steady_clock;
+
+// Network data of a configuration with many bridges and interfaces, the content does not matter.
+::std::string CreateNetworkData(::std::size_t size) {
+  ::std::string data;
+  while (data.size() < size) {
+    data.append(R"({"bridge-config":{"br0":["ethX1","ethX2"]},"ip-config":{"br0":{"source":"static"}}})");
+  }
+  data.resize(size);
+  return data;
+}
+
+int Run(int backups) {
+  char path[] = "/tmp/netconfd_backup_sync_XXXXXX";
+  if (::mkdtemp(path) == nullptr) {
+    ::std::perror("mkdtemp");
+    return EXIT_FAILURE;
+  }
+  ::std::filesystem::path directory{path};
+  auto backup_file = directory / "backup";
+
+  FileEditor file_editor;
+  BackupRestore backup_restore{file_editor, 75};
+  int result = EXIT_SUCCESS;
+
+  for (::std::size_t size : {4096U, 65536U, 1048576U, 4194304U}) {
+    auto network_data = CreateNetworkData(size);
+    Clock::duration time{};
+    int syncs = 0;
+
+    for (int i = 0; i < backups; ++i) {
+      // the backup script creates the file, netconfd appends to it
+      ::std::ofstream{backup_file};
+
+      sync_calls = 0;
+      auto start  = Clock::now();
+      auto status = backup_restore.Backup(backup_file, network_data, "dipswitch", 2);
+      time += Clock::now() - start;
+      syncs += sync_calls;
+
+      if (status.IsNotOk()) {
+        ::std::fprintf(stderr, "backup of %zu bytes failed: %s\n", size, status.ToString().c_str());
+        result = EXIT_FAILURE;
+        break;
+      }
+    }
+
+    auto us = ::std::chrono::duration_cast<::std::chrono::microseconds>(time).count();
+    ::std::printf("%8zu bytes: %8lld us/backup, %d sync calls/backup\n", size,
+                  static_cast<long long>(us / backups), syncs / backups);
+  }
+
+  ::std::filesystem::remove_all(directory);
+  return result;
+}
+
+}  // namespace
+}  // namespace netconf
+
+int main(int argc, char *argv[]) {
+  int backups = argc > 1 ? ::std::atoi(argv[1]) : 20;
+  if (backups <= 0) {
+    ::std::fprintf(stderr, "usage: %s [backups per size]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  return netconf::Run(backups);
+}
@@ -0,0 +1,264 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+//------------------------------------------------------------------------------
+///  \file     LeaseLatencyBench.cpp
+///
+///  \brief    Latency from a lease of the DHCP client script to the configured address.
+///
+///            Drives the IPManager with a bound event for br0 until it calls
+///            IIPController::Configure with the address of the lease, in two ways:
+///             - lease event: datagram to the LeaseEventSocket, the lease is sent with
+///               the event (NetworkConfigBrain::ReceiveLeaseEvent);
+///             - lease file: the script writes the lease file, the client reads it on
+///               the event. The dbus call carrying this event is not included.
+///            All other dependencies of the IPManager are stand-ins doing nothing.
+///
+///            usage: netconfd_lease_latency.elf [events]
+//------------------------------------------------------------------------------
+#include <glib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "DipSwitchFake.hpp"
+#include "IPManager.hpp"
+#include "LeaseEvent.hpp"
+#include "LeaseEventSocket.hpp"
+#include "LeaseFile.hpp"
+
+namespace netconf {
+namespace {
+
+using Clock = ::std::chrono::steady_clock;
+
+constexpr auto lease_content =
+    "IPADDRESS=192.168.1.17\nNETMASK=255.255.255.0\nDEFAULT_GATEWAY_1=192.168.1.1\nDHCPHOSTNAME=PFC-4711\n"
+    "DHCPDOMAIN=local\nDNS_SERVER_1=192.168.1.1\nNTP_SERVER_1=192.168.1.1\n";
+
+class NoEventManager : public IEventManager {
+ public:
+  void NotifyNetworkChanges(EventLayer) override {}
+  void NotifyNetworkChanges(EventLayer, ::std::optional<Interface>) override {}
+  void ProcessPendingEvents() override {}
+};
+
+class NoPersistence : public IPersistenceProvider {
+ public:
+  Status Write(const BridgeConfig &) override { return {}; }
+  Status Read(BridgeConfig &) override { return {}; }
+  Status Write(const IPConfigs &) override { return {}; }
+  Status Read(IPConfigs &) override { return {}; }
+  Status Write(const DipSwitchIpConfig &) override { return {}; }
+  Status Read(DipSwitchIpConfig &) override { return {}; }
+  Status Write(const Interfaces &) override { return {}; }
+  void Read(Interfaces &) override {}
+  Status Read(BridgeConfig &, IPConfigs &, Interfaces &) override { return {}; }
+  Status Backup(const std::string &, const std::string &) override { return {}; }
+  Status Restore(const std::string &, BridgeConfig &, IPConfigs &, InterfaceConfigs &, DipSwitchIpConfig &,
+                 Interfaces &) override {
+    return {};
+  }
+  uint32_t GetBackupParameterCount() const override { return 0; }
+};
+
+class NoNetDevs : public INetDevManager {
+ public:
+  void RegisterForNetDevConstructionEvents(INetDevEvents &) override {}
+  NetDevPtr GetByInterface(Interface) override { return nullptr; }
+  NetDevPtr GetByIfIndex(::std::int32_t) override { return nullptr; }
+  NetDevPtr GetByName(const ::std::string &) override { return nullptr; }
+  NetDevs GetNetDevs() override { return {}; }
+  NetDevs GetNetDevs(::std::vector<DeviceType>) override { return {}; }
+  Interfaces GetInterfaces() override { return {}; }
+  Interfaces GetInterfacesByDeviceType(::std::vector<DeviceType>) override { return {}; }
+  Interfaces GetBridgesWithAssignetPort() override { return {}; }
+  NetDevPtr GetParent(NetDevPtr) override { return nullptr; }
+  NetDevs GetChildren(NetDevPtr) override { return {}; }
+  bool IsAnyChildUp(NetDevPtr) override { return false; }
+  void SetMac(NetDevPtr, const ::std::string &) override {}
+  Status AddInterface(const Interface &) override { return {}; }
+  Status AddInterfaces(const Interfaces &) override { return {}; }
+  Status Delete(const Interface &) override { return {}; }
+  Status Delete(const Interfaces &) override { return {}; }
+  void SetUp(const Interface &) override {}
+  void SetDown(const Interface &) override {}
+  Interfaces GetPorts(const Interface &) override { return {}; }
+  void BridgePortLeave(const Interface &) override {}
+  Status BridgePortJoin(const Interface &, const Interface &) override { return {}; }
+};
+
+class NoInterfaceInformation : public IInterfaceInformation {
+ public:
+  InterfaceConfigs const &GetPortConfigs() override { return configs_; }
+  Status GetCurrentPortStatuses(InterfaceStatuses &) override { return {}; }
+  InterfaceInformations GetInterfaceInformations() override { return {}; }
+
+ private:
+  InterfaceConfigs configs_;
+};
+
+class NoIPMonitor : public IIPMonitor {
+ public:
+  Address GetIPAddress(int) override { return {}; }
+  Netmask GetNetmask(int) override { return {}; }
+  void RegisterEventHandler(IIPEvent &) override {}
+  void UnregisterEventHandler(IIPEvent &) override {}
+};
+
+class NoHostnameManager : public IHostnameManager {
+ public:
+  ::std::string GetHostname() override { return "PFC"; }
+  void OnLeaseFileRemove(const Interface &) override {}
+  void OnLeaseFileChange(const Interface &) override {}
+  void OnLeaseChange(const Interface &, const ::std::string &, const ::std::string &) override {}
+  void OnInterfaceIPChange() override {}
+  void RegisterIPManager(IIPManager &) override {}
+};
+
+// Keeps the lease like the DHCPClient, the lease file is read from lease_file_path.
+class LeaseClient : public IDynamicIPClient {
+ public:
+  explicit LeaseClient(::std::string lease_file_path) : lease_file_path_{::std::move(lease_file_path)} {}
+
+  void Release() override {}
+  void Renew() override {}
+  void RestartWithHostname(::std::string) override {}
+  void RestartWithClientID(::std::string) override {}
+  void NotifyEvent(DynamicIPEventAction) override {}
+  DynamicIPType GetType() override { return DynamicIPType::DHCP; }
+  void UpdateContentFromLease() override { lease_file_.Parse(lease_file_path_); }
+  void UpdateContentFromLease(const ::std::string &lease) override { lease_file_.ParseContent(lease); }
+  Address GetAddressFromLease() override { return lease_file_.GetAddress(); }
+  Netmask GetNetmaskFromLease() override { return lease_file_.GetNetmask(); }
+  ::std::string GetHostnameFromLease() override { return lease_file_.GetDHCPHostname(); }
+  ::std::string GetDomainFromLease() override { return lease_file_.GetDHCPDomain(); }
+  ::std::string GetClientID() override { return {}; }
+  pid_t GetPid() const override { return 0; }
+
+ private:
+  ::std::string lease_file_path_;
+  LeaseFile lease_file_;
+};
+
+class OneClientAdministrator : public IDynamicIPClientAdministrator {
+ public:
+  explicit OneClientAdministrator(IDynamicIPClientPtr client) : client_{::std::move(client)} {}
+
+  IDynamicIPClientPtr AddClient(DynamicIPType, const Interface &, const ::std::string &,
+                                const ::std::string &) override {
+    return client_;
+  }
+  void DeleteClient(const Interface &) override {}
+  IDynamicIPClientPtr GetClient(const Interface &) const override { return client_; }
+  void RestartAllClients(const ::std::string &) override {}
+
+ private:
+  IDynamicIPClientPtr client_;
+};
+
+// The end of the measured path: counts the addresses that would be configured.
+class CountingIPController : public IIPController {
+ public:
+  Status Configure(const ::std::string &, const Address &address, const Netmask &) const override {
+    last_address_ = address;
+    ++configured_;
+    return {};
+  }
+  Status Configure(const IPConfig &) const override { return {}; }
+  void Flush(const ::std::string &) const override {}
+
+  mutable ::std::size_t configured_ = 0;
+  mutable Address last_address_;
+};
+
+}  // namespace
+}  // namespace netconf
+
+using namespace netconf;  // NOLINT(google-build-using-namespace)
+
+int main(int argc, char *argv[]) {
+  long events = (argc > 1) ? ::std::strtol(argv[1], nullptr, 10) : 500;
+  if (events <= 0) {
+    ::std::fprintf(stderr, "usage: %s [events]\n", argv[0]);
+    return 1;
+  }
+
+  char path[] = "/tmp/lease_latency_bench_XXXXXX";
+  if (::mkdtemp(path) == nullptr) {
+    ::std::perror("mkdtemp");
+    return 1;
+  }
+  ::std::filesystem::path directory = path;
+  auto lease_file_path              = (directory / "dhcp-bootp-data-br0").string();
+  int result                        = 0;
+
+  try {
+    NoEventManager event_manager;
+    NoPersistence persistence;
+    NoNetDevs netdevs;
+    DipSwitchFake dip_switch;
+    NoInterfaceInformation interface_information;
+    NoHostnameManager hostname_manager;
+    CountingIPController ip_controller;
+    ::std::shared_ptr<IIPMonitor> ip_monitor = ::std::make_shared<NoIPMonitor>();
+    OneClientAdministrator clients{::std::make_shared<LeaseClient>(lease_file_path)};
+    IPManager ip_manager{event_manager, persistence,   netdevs,    dip_switch,      interface_information,
+                         clients,       ip_controller, ip_monitor, hostname_manager};
+
+    auto br0 = Interface::CreateBridge("br0");
+    LeaseEventSocket socket{[&](const LeaseEvent &event) {
+                              ip_manager.OnDynamicIPEvent(br0, event.action_, event.lease_, event.pid_);
+                            },
+                            (directory / "lease-event.socket").string()};
+
+    auto configured = [&](::std::size_t count) {
+      return ip_controller.configured_ == count && ip_controller.last_address_ == "192.168.1.17";
+    };
+
+    auto start = Clock::now();
+    for (long i = 1; i <= events; ++i) {
+      auto status = SendLeaseEvent(LeaseEvent{"br0", DynamicIPEventAction::BOUND, lease_content},
+                                   (directory / "lease-event.socket").string());
+      auto deadline = Clock::now() + ::std::chrono::seconds{2};
+      while (status.IsOk() && ip_controller.configured_ < static_cast<::std::size_t>(i) && Clock::now() < deadline) {
+        g_main_context_iteration(nullptr, TRUE);
+      }
+      if (!configured(static_cast<::std::size_t>(i))) {
+        throw ::std::runtime_error("lease event " + ::std::to_string(i) + " did not configure the address");
+      }
+    }
+    auto event_time = ::std::chrono::duration<double, ::std::micro>(Clock::now() - start).count() / events;
+
+    ip_controller.configured_ = 0;
+    start                     = Clock::now();
+    for (long i = 1; i <= events; ++i) {
+      {
+        ::std::ofstream file{lease_file_path};
+        file << lease_content;
+      }
+      ip_manager.OnDynamicIPEvent(br0, DynamicIPEventAction::BOUND);
+      if (!configured(static_cast<::std::size_t>(i))) {
+        throw ::std::runtime_error("lease file " + ::std::to_string(i) + " did not configure the address");
+      }
+    }
+    auto file_time = ::std::chrono::duration<double, ::std::micro>(Clock::now() - start).count() / events;
+
+    ::std::printf("lease to configured address (%ld events): lease event %.1f us, lease file %.1f us"
+                  " (without the dbus call)\n",
+                  events, event_time, file_time);
+  } catch (const ::std::exception &e) {
+    ::std::fprintf(stderr, "%s\n", e.what());
+    result = 1;
+  }
+
+  ::std::error_code ec;
+  ::std::filesystem::remove_all(directory, ec);
+  return result;
+}
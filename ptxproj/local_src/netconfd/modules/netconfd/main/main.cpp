@@ -7,6 +7,7 @@
 
 #include <csignal>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <gsl/gsl>
 #include <optional>
@@ -16,6 +17,7 @@
 
 #include "Daemonizer.hpp"
 #include "InterprocessCondition.h"
+#include "LeaseEvent.hpp"
 #include "Logger.hpp"
 #include "NetworkConfigurator.hpp"
 #include "NetworkConfiguratorSettings.hpp"
@@ -117,6 +119,11 @@ int main(int argc, char *argv[]) {
     }
   }
 
+  /* The lease event socket lives in the run directory. The DHCP/BOOTP clients and their scripts inherit its path,
+   * it is set before any thread is started. */
+  auto lease_event_socket_path = run_dir + "/" + netconf::LEASE_EVENT_SOCKET_NAME;
+  setenv(netconf::LEASE_EVENT_SOCKET_ENV, lease_event_socket_path.c_str(), 1);
+
   netconf::SetLogSink(netconf::LogSink::SYSLOG);
   netconf::SetLogLevel(netconf::LogLevelFromString(loglevel));
 
@@ -174,7 +181,7 @@ int main(int argc, char *argv[]) {
   sigaction(SIGTERM, &action, nullptr);
 
   try {
-    netconf::NetworkConfigurator network_configurator{start_condition, startupPortState};
+    netconf::NetworkConfigurator network_configurator{start_condition, lease_event_socket_path, startupPortState};
     if (!terminate) {  // Check for early quit signals
       g_main_loop_run(loop);
     }
@@ -10,7 +10,9 @@ libnetconfd.a \
 netconfd.elf
 
 TEST_BUILDTARGETS += \
-netconfd_tests.elf
+netconfd_tests.elf \
+netconfd_lease_latency.elf \
+netconfd_backup_sync.elf
 
 INSTALL_TARGETS += \
 $(DESTDIR)/usr/bin/netconfd.elf
@@ -150,3 +152,49 @@ netconfd_tests.elf_CLANG_TIDY_CHECKS += $(SHARED_CLANG_TIDY_CHECKS)
 netconfd_tests.elf_GCOVR_FILTER += $(libnetconfd_PROJECT_ROOT)
 # modules to include into this test's coverage report
 netconfd_tests.elf_GCOVR_SEARCH_PATH += libnetconfd.a
+
+
+#######################################################################################################################
+# Settings for build target netconfd_lease_latency.elf (benchmark, not run by the tests)
+
+netconfd_lease_latency.elf_INCLUDES = \
+$(netconfd_tests.elf_INCLUDES) \
+-I$(libnetconfd_PROJECT_ROOT)/test-src
+
+netconfd_lease_latency.elf_STATICALLYLINKED += netconfd common utility
+netconfd_lease_latency.elf_LIBS += netconfd common utility boost_log boost_thread boost_system boost_filesystem boost_serialization
+netconfd_lease_latency.elf_PKG_CONFIGS += $(libnetconfd.a_PKG_CONFIGS)
+netconfd_lease_latency.elf_PKG_CONFIG_LIBS += $(libnetconfd.a_PKG_CONFIG_LIBS)
+netconfd_lease_latency.elf_CXXDISABLEDWARNINGS += $(netconfd_tests.elf_CXXDISABLEDWARNINGS)
+netconfd_lease_latency.elf_PREREQUISITES += $(call lib_buildtarget_raw,$(netconfd_lease_latency.elf_LIBS) $(netconfd_lease_latency.elf_PKG_CONFIG_LIBS),$(netconfd_lease_latency.elf_STATICALLYLINKED))
+netconfd_lease_latency.elf_CPPFLAGS += $(call uniq, $(netconfd_lease_latency.elf_INCLUDES))
+netconfd_lease_latency.elf_CPPFLAGS += $(call uniq, $(libnetconfd.a_DEFINES))
+netconfd_lease_latency.elf_CPPFLAGS += $(call pkg_config_cppflags,$(netconfd_lease_latency.elf_PKG_CONFIGS))
+netconfd_lease_latency.elf_CXXFLAGS += $(call option_std,gnu++17)
+netconfd_lease_latency.elf_CXXFLAGS += $(call option_disable_warning,$(netconfd_lease_latency.elf_CXXDISABLEDWARNINGS))
+netconfd_lease_latency.elf_LDFLAGS += $(call option_lib,$(netconfd_lease_latency.elf_LIBS),netconfd_lease_latency.elf)
+netconfd_lease_latency.elf_LDFLAGS += $(call pkg_config_ldflags,$(netconfd_lease_latency.elf_PKG_CONFIGS))
+netconfd_lease_latency.elf_SOURCES += $(libnetconfd_PROJECT_ROOT)/bench-src/LeaseLatencyBench.cpp
+netconfd_lease_latency.elf_CLANG_TIDY_RULESET = $(CLANG_TIDY_CHECKS)
+netconfd_lease_latency.elf_CLANG_TIDY_CHECKS += $(SHARED_CLANG_TIDY_CHECKS)
+
+#######################################################################################################################
+# Settings for build target netconfd_backup_sync.elf (benchmark, not run by the tests)
+
+netconfd_backup_sync.elf_INCLUDES = \
+$(libnetconfd.a_INCLUDES)
+
+netconfd_backup_sync.elf_STATICALLYLINKED += netconfd common utility
+netconfd_backup_sync.elf_LIBS += netconfd common utility boost_log boost_thread boost_system boost_filesystem boost_serialization
+netconfd_backup_sync.elf_PKG_CONFIGS += $(libnetconfd.a_PKG_CONFIGS)
+netconfd_backup_sync.elf_PKG_CONFIG_LIBS += $(libnetconfd.a_PKG_CONFIG_LIBS)
+netconfd_backup_sync.elf_PREREQUISITES += $(call lib_buildtarget_raw,$(netconfd_backup_sync.elf_LIBS) $(netconfd_backup_sync.elf_PKG_CONFIG_LIBS),$(netconfd_backup_sync.elf_STATICALLYLINKED))
+netconfd_backup_sync.elf_CPPFLAGS += $(call uniq, $(netconfd_backup_sync.elf_INCLUDES))
+netconfd_backup_sync.elf_CPPFLAGS += $(call uniq, $(libnetconfd.a_DEFINES))
+netconfd_backup_sync.elf_CPPFLAGS += $(call pkg_config_cppflags,$(netconfd_backup_sync.elf_PKG_CONFIGS))
+netconfd_backup_sync.elf_CXXFLAGS += $(call option_std,gnu++17)
+netconfd_backup_sync.elf_LDFLAGS += $(call option_lib,$(netconfd_backup_sync.elf_LIBS),netconfd_backup_sync.elf)
+netconfd_backup_sync.elf_LDFLAGS += $(call pkg_config_ldflags,$(netconfd_backup_sync.elf_PKG_CONFIGS))
+netconfd_backup_sync.elf_SOURCES += $(libnetconfd_PROJECT_ROOT)/bench-src/BackupSyncBench.cpp
+netconfd_backup_sync.elf_CLANG_TIDY_RULESET = $(CLANG_TIDY_CHECKS)
+netconfd_backup_sync.elf_CLANG_TIDY_CHECKS += $(SHARED_CLANG_TIDY_CHECKS)
@@ -28,23 +28,18 @@ LeaseFile GetLeaseFile(const Interface &interface) {
   return ips;
 }
 
-void UpdateEtcHosts(const IPConfigs &ip_configs, const ::std::string &hostname, ::std::string& domain) {
-
-  auto ips = GetIPsOfIPConfigs(ip_configs);
-  UpdateHostsFile(ips, hostname, domain);
-}
-
 }
 
-HostnameManager::HostnameManager(const MacAddress& mac_address) {
+HostnameManager::HostnameManager(const MacAddress& mac_address) : hosts_file_{file_editor_} {
   default_hostname_ = GetDefaultHostname(mac_address);
 
   auto host_conf = HostConfFile::ParseFile();
   hostname_ = host_conf.GetHostname().empty() ? default_hostname_ : host_conf.GetHostname();
   domain_ = host_conf.GetDomain();
 
-  SetKernelHostname(hostname_);
-  UpdateEtcHosts(GetCurrentIPConfigs(), hostname_, domain_);
+  UpdateKernelHostname();
+  UpdateEtcHosts();
+  hosts_file_.Flush();
 }
 
 ::std::string HostnameManager::GetHostname() {
@@ -60,8 +55,8 @@ void HostnameManager::OnReloadHostConf() {
   domain_ = host_conf.GetDomain();
 
   LogInfo("use /etc/host.conf hostname: " + hostname_ + " domain: " + domain_);
-  SetKernelHostname(hostname_);
-  UpdateEtcHosts(GetCurrentIPConfigs(), hostname_, domain_);
+  UpdateKernelHostname();
+  UpdateEtcHosts();
 
   if (ip_manager_ != nullptr && hostname_ != old_hostname) {
     ip_manager_->OnHostnameChanged();
@@ -72,20 +67,25 @@ void HostnameManager::OnLeaseFileChange(const Interface &interface) {
 
   auto lease_file = GetLeaseFile(interface);
   if (lease_file.Exists()) {
-    prioritized_dhcp_host_domainname_.Add(interface, lease_file.GetDHCPHostname(), lease_file.GetDHCPDomain());
-    prioritized_dhcp_host_domainname_.GetPrioritizedValues(hostname_, domain_);
-
-    LogInfo("use lease file hostname: " + hostname_ + " domain: " + domain_ + " of interface: " + interface.GetName());
-    SetKernelHostname(hostname_);
-    UpdateEtcHosts(GetCurrentIPConfigs(), hostname_, domain_);
+    OnLeaseChange(interface, lease_file.GetDHCPHostname(), lease_file.GetDHCPDomain());
   } else {
     OnLeaseFileRemove(interface);
   }
 
 }
 
+void HostnameManager::OnLeaseChange(const Interface &interface, const ::std::string &hostname,
+                                    const ::std::string &domain) {
+  prioritized_dhcp_host_domainname_.Add(interface, hostname, domain);
+  prioritized_dhcp_host_domainname_.GetPrioritizedValues(hostname_, domain_);
+
+  LogInfo("use lease hostname: " + hostname_ + " domain: " + domain_ + " of interface: " + interface.GetName());
+  UpdateKernelHostname();
+  UpdateEtcHosts();
+}
+
 void HostnameManager::OnInterfaceIPChange() {
-  UpdateEtcHosts(GetCurrentIPConfigs(), hostname_, domain_);
+  UpdateEtcHosts();
 }
 
 void HostnameManager::OnLeaseFileRemove(const Interface &interface) {
@@ -107,4 +107,14 @@ IPConfigs HostnameManager::GetCurrentIPConfigs() {
   return (ip_manager_ != nullptr) ? ip_manager_->GetCurrentIPConfigs() : IPConfigs();
 }
 
+void HostnameManager::UpdateKernelHostname() {
+  if (GetKernelHostname() != hostname_) {
+    SetKernelHostname(hostname_);
+  }
+}
+
+void HostnameManager::UpdateEtcHosts() {
+  hosts_file_.Update(GetIPsOfIPConfigs(GetCurrentIPConfigs()), hostname_, domain_);
+}
+
 } /* namespace netconf */
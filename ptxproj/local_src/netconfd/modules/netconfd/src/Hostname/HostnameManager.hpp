@@ -4,7 +4,9 @@
 #include <map>
 #include <tuple>
 
+#include "FileEditor.hpp"
 #include "HostConfFile.hpp"
+#include "HostsFile.hpp"
 #include "IHostnameManager.hpp"
 #include "IHostnameWillChange.hpp"
 #include "HostnameController.hpp"
@@ -27,6 +29,7 @@ class HostnameManager : public IHostnameManager, public IHostnameWillChange {
 
   void OnReloadHostConf() override;
   void OnLeaseFileChange(const Interface &interface) override;
+  void OnLeaseChange(const Interface &interface, const ::std::string &hostname, const ::std::string &domain) override;
   void OnInterfaceIPChange() override;
   void OnLeaseFileRemove(const Interface &interface) override;
 
@@ -41,7 +44,12 @@ class HostnameManager : public IHostnameManager, public IHostnameWillChange {
 
   PrioritizedHostAndDomainname prioritized_dhcp_host_domainname_;
 
+  FileEditor file_editor_;
+  HostsFile hosts_file_;
+
   IPConfigs GetCurrentIPConfigs();
+  void UpdateKernelHostname();
+  void UpdateEtcHosts();
   void SetPrioritizedDHCPHostAndDomainname();
 
 };
@@ -2,10 +2,11 @@
 
 #include "HostsFile.hpp"
 
-#include "FileEditor.hpp"
 #include "Logger.hpp"
 #include "Status.hpp"
 
+#include <utility>
+
 namespace netconf {
 
 namespace {
@@ -19,10 +20,6 @@ namespace {
 
 const auto LOCAL_HOST_ENTRY = "127.0.0.1\tlocalhost";
 
-::std::string HOSTS_FILE_PATH() {
-  return "/etc/hosts";
-}
-
 ::std::string SYSTEM_HOST_ENTRY_MARKER_BEGIN() {
   return "\n#SYSTEM HOST ENTRY -- DO NOT REMOVE -- WILL BE CREATED BY NETCONF\n";
 }
@@ -70,21 +67,58 @@ const auto LOCAL_HOST_ENTRY = "127.0.0.1\tlocalhost";
 
 }  // namespace
 
-void UpdateHostsFile(::std::vector<Address> &ip_addresses, const ::std::string &hostname, const ::std::string &domain) {
-  FileEditor file_editor;
+HostsFile::HostsFile(IFileEditor &file_editor, ::std::string file_path)
+    : file_editor_{file_editor},
+      file_path_{::std::move(file_path)} {
+}
+
+HostsFile::~HostsFile() {
+  Flush();
+}
+
+void HostsFile::Update(::std::vector<Address> ip_addresses, const ::std::string &hostname,
+                       const ::std::string &domain) {
+  ip_addresses_ = ::std::move(ip_addresses);
+  hostname_     = hostname;
+  domain_       = domain;
+
+  if (timeout_id_ == 0) {
+    timeout_id_ = g_timeout_add(WRITE_DELAY_MS, &HostsFile::OnWriteTimeout, this);
+  }
+}
+
+void HostsFile::Flush() {
+  if (timeout_id_ != 0) {
+    g_source_remove(timeout_id_);
+    timeout_id_ = 0;
+    Write();
+  }
+}
+
+gboolean HostsFile::OnWriteTimeout(gpointer user_data) {
+  auto *this_        = static_cast<HostsFile *>(user_data);
+  this_->timeout_id_ = 0;
+  this_->Write();
+  return G_SOURCE_REMOVE;
+}
+
+void HostsFile::Write() {
   ::std::string old_hosts;
   ::std::string new_hosts;
 
-  Status status = file_editor.Read(HOSTS_FILE_PATH(), old_hosts);
+  Status status = file_editor_.Read(file_path_, old_hosts);
   if (status.IsOk()) {
-    new_hosts = UpdateFileContent(old_hosts, ip_addresses, hostname, domain);
+    new_hosts = UpdateFileContent(old_hosts, ip_addresses_, hostname_, domain_);
+    if (new_hosts == old_hosts) {
+      return;
+    }
   } else {
-    new_hosts = CreateEntriesSection(ip_addresses, true, hostname, domain);
+    new_hosts = CreateEntriesSection(ip_addresses_, true, hostname_, domain_);
   }
 
-  status = file_editor.WriteAndReplace(HOSTS_FILE_PATH(), new_hosts);
+  status = file_editor_.WriteAndReplace(file_path_, new_hosts);
   if (status.IsNotOk()) {
-    LogError("Failed to update /etc/hosts file. " + status.ToString());
+    LogError("Failed to update " + file_path_ + " file. " + status.ToString());
   }
 }
 
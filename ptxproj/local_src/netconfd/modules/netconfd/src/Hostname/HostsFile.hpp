@@ -2,17 +2,56 @@
 
 #pragma once
 
+#include <glib.h>
+
 #include "BaseTypes.hpp"
+#include "IFileEditor.hpp"
 
 #include <vector>
 #include <string>
 
 namespace netconf {
 
-void UpdateHostsFile(::std::vector<Address>& ip_addresses, const ::std::string &hostname, const ::std::string &domain);
+constexpr auto HOSTS_FILE_PATH = "/etc/hosts";
+
+/*
+ * Keeps the netconf section of the hosts file up to date.
+ * A burst of updates (e.g. DHCP renews or flapping links) is collected and written once after a short delay,
+ * the file is not written at all if its content does not change.
+ */
+class HostsFile {
+ public:
+  explicit HostsFile(IFileEditor &file_editor, ::std::string file_path = HOSTS_FILE_PATH);
+  ~HostsFile();
+
+  HostsFile(const HostsFile &other)            = delete;
+  HostsFile(HostsFile &&other)                 = delete;
+  HostsFile &operator=(const HostsFile &other) = delete;
+  HostsFile &operator=(HostsFile &&other)      = delete;
+
+  void Update(::std::vector<Address> ip_addresses, const ::std::string &hostname, const ::std::string &domain);
+
+  // Writes a pending update immediately.
+  void Flush();
+
+ private:
+  static constexpr guint WRITE_DELAY_MS = 100;
+
+  IFileEditor &file_editor_;
+  ::std::string file_path_;
+
+  ::std::vector<Address> ip_addresses_;
+  ::std::string hostname_;
+  ::std::string domain_;
+
+  guint timeout_id_ = 0;
+
+  void Write();
+
+  static gboolean OnWriteTimeout(gpointer user_data);
+};
 
 ::std::string UpdateFileContent(::std::string old_hosts, ::std::vector<Address>& ip_addresses,
                                 const ::std::string &hostname, const ::std::string &domain);
 
 } /* namespace netconf */
-
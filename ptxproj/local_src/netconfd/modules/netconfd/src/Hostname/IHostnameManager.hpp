@@ -23,6 +23,7 @@ class IHostnameManager {
   virtual ::std::string GetHostname() = 0;
   virtual void OnLeaseFileRemove(const Interface &interface) = 0;
   virtual void OnLeaseFileChange(const Interface &interface) = 0;
+  virtual void OnLeaseChange(const Interface &interface, const ::std::string &hostname, const ::std::string &domain) = 0;
   virtual void OnInterfaceIPChange() = 0;
   virtual void RegisterIPManager(IIPManager& ip_manager) = 0;
 
@@ -48,6 +48,10 @@ void BOOTPClient::UpdateContentFromLease() {
   lease_file_.Parse(LeaseFile::GetLeaseFilePath(interface_));
 }
 
+void BOOTPClient::UpdateContentFromLease(const ::std::string &lease) {
+  lease_file_.ParseContent(lease);
+}
+
 Address BOOTPClient::GetAddressFromLease() {
   return lease_file_.GetAddress();
 }
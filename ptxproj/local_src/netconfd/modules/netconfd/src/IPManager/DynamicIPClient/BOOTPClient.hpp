@@ -27,8 +27,10 @@ class BOOTPClient : public IDynamicIPClient {
 
   void RestartWithHostname(::std::string hostname) override;
   void RestartWithClientID(::std::string clientID) override;
+  void NotifyEvent([[maybe_unused]] DynamicIPEventAction action) override {}
 
   void UpdateContentFromLease() override;
+  void UpdateContentFromLease(const ::std::string &lease) override;
   Address GetAddressFromLease() override;
   Netmask GetNetmaskFromLease() override;
   ::std::string GetHostnameFromLease() override;
@@ -36,6 +38,9 @@ class BOOTPClient : public IDynamicIPClient {
   ::std::string GetClientID() override {
     return "";
   }
+  GPid GetPid() const override {
+    return pid_;
+  }
 
  private:
   LeaseFile lease_file_;
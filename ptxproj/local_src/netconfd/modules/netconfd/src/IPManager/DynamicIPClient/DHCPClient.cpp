@@ -7,13 +7,13 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <array>
 #include <boost/filesystem.hpp>
 #include <csignal>
 #include <cstdlib>
 #include <optional>
 #include <string>
-#include <thread>
 #include <vector>
 
 #include "CollectionUtils.hpp"
@@ -33,8 +33,9 @@ void RemoveFile(::std::string path) {
 }  // namespace
 
 DHCPClient::DHCPClient(Interface interface, ::std::string hostname, ::std::string vendorclass,
-                       ::std::string clientid)
-    : pid_{}, interface_{::std::move(interface)}, hostname_{::std::move(hostname)}, vendorclass_{::std::move(vendorclass)}, clientID_{::std::move(clientid)} {
+                       ::std::string clientid, ::std::string client_path, DHCPClientTimer timer)
+    : pid_{}, interface_{::std::move(interface)}, hostname_{::std::move(hostname)}, vendorclass_{::std::move(vendorclass)}, clientID_{::std::move(clientid)},
+      client_path_{::std::move(client_path)}, timer_{timer} {
 
   pid_file_path_ = "/var/run/udhcpc_" + interface_.GetName() + ".pid";
   Start();
@@ -45,12 +46,18 @@ DHCPClient::~DHCPClient() {
 }
 
 void DHCPClient::Release() {
+  if (pid_ <= 0) {
+    return;
+  }
   LOG_DEBUG("DHCPClient::Release | Send SIGUSR2 to dhcp client for interface " << interface_.GetName() <<
             " to release its ip address");
   kill(pid_, SIGUSR2);
 }
 
 void DHCPClient::Renew() {
+  if (pid_ <= 0) {
+    return;
+  }
   LOG_DEBUG("DHCPClient::Renew | Send SIGUSR1 to dhcp client for interface " << interface_.GetName() << " to renew its ip address");
   kill(pid_, SIGUSR1);
 }
@@ -63,6 +70,10 @@ void DHCPClient::UpdateContentFromLease() {
   lease_file_.Parse(LeaseFile::GetLeaseFilePath(interface_));
 }
 
+void DHCPClient::UpdateContentFromLease(const ::std::string &lease) {
+  lease_file_.ParseContent(lease);
+}
+
 Address DHCPClient::GetAddressFromLease() {
   return lease_file_.GetAddress();
 }
@@ -79,27 +90,6 @@ Netmask DHCPClient::GetNetmaskFromLease() {
   return lease_file_.GetDHCPDomain();
 }
 
-static void OnProcessStop(GPid pid, gint status, gpointer user_data) {
-  (void)user_data;
-  GError *err = nullptr;
-  if (g_spawn_check_exit_status(status, &err) == FALSE) {
-    LOG_DEBUG("Stopped DHCP client with pid " << ::std::to_string(pid) << " and exit status abnormally");
-  }
-
-  if (err != nullptr) {
-    LOG_DEBUG("GError message: " << ::std::string(err->message));
-    g_error_free(err);
-  }
-
-  // Free any resources associated with the child here, such as I/O channels
-  // on its stdout and stderr FDs. If you have no code to put in the
-  // child_watch_cb() callback, you can remove it and the g_child_watch_add()
-  // call, but you must also remove the G_SPAWN_DO_NOT_REAP_CHILD flag,
-  // otherwise the child process will stay around as a zombie until this
-  // process exits.
-  g_spawn_close_pid(pid);
-}
-
 void DHCPClient::RestartWithHostname(::std::string hostname) {
   LOG_DEBUG("DHCP client restart with hostname: " << hostname);
   hostname_ = hostname;
@@ -116,11 +106,28 @@ void DHCPClient::RestartWithClientID(::std::string clientID) {
   Start();
 }
 
+void DHCPClient::NotifyEvent([[maybe_unused]] DynamicIPEventAction action) {
+  if (state_ == State::STARTING) {
+    LOG_DEBUG("DHCP client for interface " << interface_.GetName() << " is running, pid: " << ::std::to_string(pid_));
+    RemoveTimeout();
+    state_           = State::RUNNING;
+    failed_attempts_ = 0;
+  }
+}
+
+DHCPClient::State DHCPClient::GetState() const {
+  return state_;
+}
+
+GPid DHCPClient::GetPid() const {
+  return pid_;
+}
+
 void DHCPClient::Start() {
   auto hostname_option = "hostname:" + hostname_;
   auto clientid_option = "61:'" + clientID_ + "'";
 
-  ::std::vector<const char *> options{DHCP_CLIENT_PATH.c_str(),
+  ::std::vector<const char *> options{client_path_.c_str(),
                                       "--syslog",
                                       "--foreground",
                                       "--interface",
@@ -146,24 +153,27 @@ void DHCPClient::Start() {
                                   G_SPAWN_DO_NOT_REAP_CHILD,
                                   nullptr, nullptr, &pid_, &g_error);
 
-  LOG_DEBUG("Started DHCP Client for interface " << interface_.GetName() << ", pid: " << ::std::to_string(pid_));
-  if (g_error != nullptr) {
-    LOG_DEBUG("g_error: code: " << ::std::to_string(g_error->code) << ", message: " << g_error->message);
+  if (spawned != TRUE || g_error != nullptr) {
+    if (g_error != nullptr) {
+      LOG_DEBUG("g_error: code: " << ::std::to_string(g_error->code) << ", message: " << g_error->message);
+      g_error_free(g_error);
+    }
+    LogError("Failed to spawn DHCP client for interface " + interface_.GetName());
+    pid_ = 0;
+    ScheduleRestart();
+    return;
   }
+
+  LOG_DEBUG("Started DHCP Client for interface " << interface_.GetName() << ", pid: " << ::std::to_string(pid_));
+
   /*
-   * TODO: Es wurde beobachtet, dass der Spawn des DHCP-Client-Prozesses sporadisch nicht funktioniert.
-   * Das heißt, g_spawn_async gibt TRUE zurück und eine PID existiert, aber der udhcpc client wurde nicht gestartet.
-   * Wir sehen, dass in Busybox die main und main_udhcp nicht aufgerufen werden.
-   * Tests zeigen, dass ein sleep das Problem zumindest bei manuellen Neustarts des netconfd umgeht.
+   * It was observed that the spawned udhcpc sporadically does not start although g_spawn_async succeeds.
+   * Instead of waiting a fixed time, the client is considered running as soon as its script reports the first
+   * event (deconfig at startup). The child watch (glib uses a pidfd where the kernel supports it) reports an early exit.
    */
-  sleep(1);
-
-  int process_state = kill(pid_, 0);
-  if (spawned == TRUE && g_error == nullptr && 0 == process_state) {
-    g_child_watch_add(pid_, OnProcessStop, nullptr);
-  } else {
-    LogError("Failed to spawn DHCP client for interface " + interface_.GetName());
-  }
+  state_          = State::STARTING;
+  child_watch_id_ = g_child_watch_add(pid_, &DHCPClient::OnProcessStop, this);
+  timeout_id_     = timer_.add(READY_TIMEOUT_MS, &DHCPClient::OnReadyTimeout, this);
 }
 
 void DHCPClient::Stop() {
@@ -173,16 +183,91 @@ void DHCPClient::Stop() {
    * sind, wenn man eine schnelle umkonfiguration vornimmt (dhcp -> static -> dhcp). Wenn sich dann der erste Client
    * beendet und am Ende das deconfig aufruft, löscht er das Lease des neu gestarteten Clients.
    */
+  RemoveTimeout();
+  KillProcess();
+
+  RemoveFile(LeaseFile::GetLeaseFilePath(interface_));
+  RemoveFile(pid_file_path_);
+
+  state_           = State::STOPPED;
+  failed_attempts_ = 0;
+}
+
+void DHCPClient::KillProcess() {
+  if (pid_ <= 0) {
+    return;
+  }
+
   if (0 == kill(pid_, SIGKILL)) {
     LOG_DEBUG("Stopped DHCP Client for interface " << interface_.GetName() << ", pid: " << ::std::to_string(pid_));
   }
 
-  RemoveFile(LeaseFile::GetLeaseFilePath(interface_));
-  RemoveFile(pid_file_path_);
+  // The killed process is reaped by a watch that does not refer to this client anymore.
+  if (child_watch_id_ != 0) {
+    g_source_remove(child_watch_id_);
+    child_watch_id_ = 0;
+  }
+  g_child_watch_add(pid_, &DHCPClient::OnProcessStop, nullptr);
 
   pid_ = 0;
 }
 
+void DHCPClient::RemoveTimeout() {
+  if (timeout_id_ != 0) {
+    timer_.remove(timeout_id_);
+    timeout_id_ = 0;
+  }
+}
+
+void DHCPClient::ScheduleRestart() {
+  auto delay = RESTART_DELAY_MS << ::std::min(failed_attempts_, 6U);
+  delay      = ::std::min(delay, MAX_RESTART_DELAY_MS);
+  ++failed_attempts_;
+
+  LOG_DEBUG("Restart DHCP client for interface " << interface_.GetName() << " in " << delay << "ms");
+  RemoveTimeout();
+  state_      = State::RESTART_PENDING;
+  timeout_id_ = timer_.add(delay, &DHCPClient::OnRestartTimeout, this);
+}
+
+void DHCPClient::OnProcessStop(GPid pid, gint status, gpointer user_data) {
+  GError *err = nullptr;
+  if (g_spawn_check_exit_status(status, &err) == FALSE) {
+    LOG_DEBUG("Stopped DHCP client with pid " << ::std::to_string(pid) << " and exit status abnormally");
+  }
+
+  if (err != nullptr) {
+    LOG_DEBUG("GError message: " << ::std::string(err->message));
+    g_error_free(err);
+  }
+  g_spawn_close_pid(pid);
+
+  auto *client = static_cast<DHCPClient *>(user_data);
+  if (client != nullptr && client->pid_ == pid) {
+    LogWarning("DHCP client for interface " + client->interface_.GetName() + " terminated unexpectedly");
+    client->child_watch_id_ = 0;
+    client->pid_            = 0;
+    client->ScheduleRestart();
+  }
+}
+
+gboolean DHCPClient::OnReadyTimeout(gpointer user_data) {
+  auto *client        = static_cast<DHCPClient *>(user_data);
+  client->timeout_id_ = 0;
+
+  LogWarning("DHCP client for interface " + client->interface_.GetName() + " did not start");
+  client->KillProcess();
+  client->ScheduleRestart();
+  return G_SOURCE_REMOVE;
+}
+
+gboolean DHCPClient::OnRestartTimeout(gpointer user_data) {
+  auto *client        = static_cast<DHCPClient *>(user_data);
+  client->timeout_id_ = 0;
+  client->Start();
+  return G_SOURCE_REMOVE;
+}
+
 ::std::string DHCPClient::GetClientID() {
   return clientID_;
 }
@@ -15,10 +15,28 @@ enum class DHCPClientStatus {
   STOPPED,
 };
 
+constexpr auto DHCP_CLIENT_PATH = "/sbin/udhcpc";
+
+// Timeouts of the client; tests replace them to fire the timeouts without waiting.
+struct DHCPClientTimer {
+  guint (*add)(guint interval_ms, GSourceFunc function, gpointer data) = g_timeout_add;
+  gboolean (*remove)(guint id)                                        = g_source_remove;
+};
+
+/*
+ * Supervises one udhcpc process without blocking the main loop:
+ *
+ *   STARTING --(first script event)--> RUNNING
+ *   STARTING --(no event in time / exit)--> RESTART_PENDING
+ *   RUNNING  --(unexpected exit)--> RESTART_PENDING
+ *   RESTART_PENDING --(backoff timer)--> STARTING
+ */
 class DHCPClient : public IDynamicIPClient {
  public:
-  DHCPClient(Interface interface, ::std::string hostname, ::std::string vendorclass,
-             ::std::string clientid);
+  enum class State { STOPPED, STARTING, RUNNING, RESTART_PENDING };
+
+  DHCPClient(Interface interface, ::std::string hostname, ::std::string vendorclass, ::std::string clientid,
+             ::std::string client_path = DHCP_CLIENT_PATH, DHCPClientTimer timer = {});
   ~DHCPClient() override;
 
   DHCPClient(const DHCPClient &other)            = delete;
@@ -33,16 +51,24 @@ class DHCPClient : public IDynamicIPClient {
 
   void RestartWithHostname(::std::string hostname) override;
   void RestartWithClientID(::std::string clientID) override;
+  void NotifyEvent(DynamicIPEventAction action) override;
 
   void UpdateContentFromLease() override;
+  void UpdateContentFromLease(const ::std::string &lease) override;
   Address GetAddressFromLease() override;
   Netmask GetNetmaskFromLease() override;
   ::std::string GetHostnameFromLease() override;
   ::std::string GetDomainFromLease() override;
   ::std::string GetClientID() override;
 
+  State GetState() const;
+  GPid GetPid() const override;
+
  private:
-  const ::std::string DHCP_CLIENT_PATH = "/sbin/udhcpc";
+  // udhcpc calls its script with "deconfig" right after start
+  static constexpr guint READY_TIMEOUT_MS     = 5000;
+  static constexpr guint RESTART_DELAY_MS     = 500;
+  static constexpr guint MAX_RESTART_DELAY_MS = 30000;
 
   LeaseFile lease_file_;
 
@@ -52,10 +78,23 @@ class DHCPClient : public IDynamicIPClient {
   ::std::string vendorclass_;
   ::std::string pid_file_path_;
   ::std::string clientID_;
+  ::std::string client_path_;
+  DHCPClientTimer timer_;
+
+  State state_           = State::STOPPED;
+  guint child_watch_id_  = 0;
+  guint timeout_id_      = 0;
+  guint failed_attempts_ = 0;
 
   void Start();
   void Stop();
+  void KillProcess();
+  void RemoveTimeout();
+  void ScheduleRestart();
 
+  static void OnProcessStop(GPid pid, gint status, gpointer user_data);
+  static gboolean OnReadyTimeout(gpointer user_data);
+  static gboolean OnRestartTimeout(gpointer user_data);
 };
 
 } /* namespace netconf */
@@ -2,9 +2,12 @@
 
 #pragma once
 
+#include <sys/types.h>
+
 #include <memory>
 #include <map>
 #include "BaseTypes.hpp"
+#include "DynamicIPEventAction.hpp"
 #include "DynamicIPType.hpp"
 
 namespace netconf {
@@ -30,13 +33,20 @@ class IDynamicIPClient {
   virtual void RestartWithHostname(::std::string hostname) = 0;
   virtual void RestartWithClientID(::std::string clientID) = 0;
 
+  // Events of the client script; the first one shows that the client is up and running.
+  virtual void NotifyEvent(DynamicIPEventAction action) = 0;
+
   virtual DynamicIPType GetType() = 0;
   virtual void UpdateContentFromLease() = 0;
+  // Takes the lease sent with the event of the client script, the lease file is not read.
+  virtual void UpdateContentFromLease(const ::std::string& lease) = 0;
   virtual Address GetAddressFromLease() = 0;
   virtual Netmask GetNetmaskFromLease() = 0;
   virtual ::std::string GetHostnameFromLease() = 0;
   virtual ::std::string GetDomainFromLease() = 0;
   virtual ::std::string GetClientID() = 0;
+  // Process of the running client, 0 if no client process is running.
+  virtual pid_t GetPid() const = 0;
 };
 
 } /* namespace netconf */
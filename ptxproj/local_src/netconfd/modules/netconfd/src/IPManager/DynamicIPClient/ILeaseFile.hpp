@@ -21,6 +21,8 @@ class ILeaseFile {
   ILeaseFile& operator=(const ILeaseFile&&) = delete;
 
   virtual void Parse(const ::std::string &lease_file_path) = 0;
+  // Parses a lease that was received with the event of the client script instead of reading the file.
+  virtual void ParseContent(const ::std::string &content) = 0;
   virtual Address GetAddress() = 0;
   virtual Netmask GetNetmask() = 0;
   virtual ::std::string GetDHCPHostname() = 0;
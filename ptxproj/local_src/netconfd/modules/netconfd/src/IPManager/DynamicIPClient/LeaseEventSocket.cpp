@@ -0,0 +1,83 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "LeaseEventSocket.hpp"
+
+#include <glib-unix.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+#include <utility>
+
+#include "Logger.hpp"
+
+namespace netconf {
+
+LeaseEventSocket::LeaseEventSocket(Handler handler, ::std::string path)
+    : handler_{::std::move(handler)},
+      path_{::std::move(path)},
+      socket_{AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0} {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (path_.size() >= sizeof(address.sun_path)) {
+    throw ::std::system_error(ENAMETOOLONG, ::std::system_category(), "Lease event socket path " + path_);
+  }
+  ::std::strncpy(&address.sun_path[0], path_.c_str(), sizeof(address.sun_path) - 1);
+
+  // A socket file of a previous run would block the bind.
+  ::unlink(path_.c_str());
+  if (::bind(socket_.fd(), reinterpret_cast<sockaddr *>(&address),  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+             sizeof(address)) != 0) {
+    throw ::std::system_error(errno, ::std::system_category(), "Failed to bind lease event socket " + path_);
+  }
+  ::chmod(path_.c_str(), S_IRUSR | S_IWUSR);
+
+  source_id_ = g_unix_fd_add(socket_.fd(), G_IO_IN, &LeaseEventSocket::OnDataReady, this);
+}
+
+LeaseEventSocket::~LeaseEventSocket() {
+  if (source_id_ != 0) {
+    g_source_remove(source_id_);
+  }
+  ::unlink(path_.c_str());
+}
+
+void LeaseEventSocket::ReceiveEvents() {
+  ::std::array<char, LEASE_EVENT_MAX_SIZE> buffer{};
+  while (true) {
+    auto length = ::recv(socket_.fd(), buffer.data(), buffer.size(), MSG_TRUNC);
+    if (length < 0) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        LogWarning(::std::string{"Receive lease event: "} + ::std::strerror(errno));
+      }
+      if (errno != EINTR) {
+        return;
+      }
+      continue;
+    }
+    if (static_cast<::std::size_t>(length) > buffer.size()) {
+      LogWarning("Dropped lease event of " + ::std::to_string(length) + " bytes");
+      continue;
+    }
+
+    LeaseEvent event;
+    auto status = FromDatagram(::std::string{buffer.data(), static_cast<::std::size_t>(length)}, event);
+    if (status.IsOk()) {
+      handler_(event);
+    } else {
+      LogWarning("Dropped lease event: " + status.ToString());
+    }
+  }
+}
+
+gboolean LeaseEventSocket::OnDataReady([[maybe_unused]] gint fd, [[maybe_unused]] GIOCondition condition,
+                                       gpointer user_data) {
+  static_cast<LeaseEventSocket *>(user_data)->ReceiveEvents();
+  return G_SOURCE_CONTINUE;
+}
+
+}  // namespace netconf
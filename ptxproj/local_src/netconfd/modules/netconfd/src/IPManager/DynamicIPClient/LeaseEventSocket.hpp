@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <glib.h>
+
+#include <functional>
+#include <string>
+
+#include "LeaseEvent.hpp"
+#include "Socket.hpp"
+
+namespace netconf {
+
+/*
+ * Receives the events of the DHCP/BOOTP client scripts on a local datagram socket in the main loop.
+ * Each datagram holds the complete lease, so the lease file does not have to be read on an event.
+ */
+class LeaseEventSocket {
+ public:
+  using Handler = ::std::function<void(const LeaseEvent &)>;
+
+  explicit LeaseEventSocket(Handler handler, ::std::string path = LEASE_EVENT_SOCKET_PATH);
+  ~LeaseEventSocket();
+
+  LeaseEventSocket(const LeaseEventSocket &)            = delete;
+  LeaseEventSocket &operator=(const LeaseEventSocket &) = delete;
+  LeaseEventSocket(LeaseEventSocket &&)                 = delete;
+  LeaseEventSocket &operator=(LeaseEventSocket &&)      = delete;
+
+ private:
+  Handler handler_;
+  ::std::string path_;
+  Socket socket_;
+  guint source_id_ = 0;
+
+  void ReceiveEvents();
+  static gboolean OnDataReady(gint fd, GIOCondition condition, gpointer user_data);
+};
+
+}  // namespace netconf
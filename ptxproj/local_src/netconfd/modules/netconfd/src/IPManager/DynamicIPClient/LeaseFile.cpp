@@ -18,6 +18,11 @@ void LeaseFile::Parse(const ::std::string &lease_file_path) {
   }
 }
 
+void LeaseFile::ParseContent(const ::std::string &content) {
+  lease_file_exists_ = true;
+  parser_.Parse(content);
+}
+
 Address LeaseFile::GetAddress() {
   return parser_.GetAddress();
 }
@@ -21,6 +21,7 @@ class LeaseFile : public ILeaseFile {
   LeaseFile& operator=(LeaseFile &&other) = delete;
 
   void Parse(const ::std::string& lease_file_path) override;
+  void ParseContent(const ::std::string& content) override;
 
   bool Exists();
   Address GetAddress() override;
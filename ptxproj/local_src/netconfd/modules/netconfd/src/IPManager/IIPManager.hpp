@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include <sys/types.h>
+
 #include "Status.hpp"
 #include "Types.hpp"
 #include "DynamicIPEventAction.hpp"
@@ -28,6 +30,10 @@ class IIPManager {
   virtual IPConfigs GetCurrentIPConfigs() const = 0;
 
   virtual void OnDynamicIPEvent(const Interface& interface, DynamicIPEventAction action) = 0;
+  // Event with the lease of the client script, an empty lease is read from the lease file.
+  // Events of another client process than the running one (client_pid != 0) are dropped.
+  virtual void OnDynamicIPEvent(const Interface& interface, DynamicIPEventAction action, const ::std::string& lease,
+                                pid_t client_pid) = 0;
   virtual void OnHostnameChanged() = 0;
 
 };
@@ -292,15 +292,41 @@ void IPManager::OnAddressChange(ChangeType change_type, int index, Address addre
 }
 
 void IPManager::OnDynamicIPEvent(const Interface &interface, DynamicIPEventAction action) {
+  HandleDynamicIPEvent(interface, action, ::std::nullopt, 0);
+}
+
+void IPManager::OnDynamicIPEvent(const Interface &interface, DynamicIPEventAction action, const ::std::string &lease,
+                                 pid_t client_pid) {
+  HandleDynamicIPEvent(interface, action, lease.empty() ? ::std::nullopt : ::std::optional<::std::string>{lease},
+                       client_pid);
+}
+
+void IPManager::HandleDynamicIPEvent(const Interface &interface, DynamicIPEventAction action,
+                                     const ::std::optional<::std::string> &lease, pid_t client_pid) {
+  auto update_content = [&](IDynamicIPClient &client) {
+    if (lease) {
+      client.UpdateContentFromLease(*lease);
+    } else {
+      client.UpdateContentFromLease();
+    }
+  };
+
   auto client = dyn_ip_client_admin_.GetClient(interface);
+  /* A client that was stopped or restarted may still have queued events, their lease is outdated. */
+  if (client && client_pid != 0 && client_pid != client->GetPid()) {
+    LOG_DEBUG("Dropped dynamic IP event of stopped client " << ::std::to_string(client_pid) << " for interface "
+              << interface.GetName());
+    return;
+  }
   if (client) {
+    client->NotifyEvent(action);
     switch (action) {
       case DynamicIPEventAction::BOUND: {
         /* bound: This argument is used when udhcpc moves from an unbound, to a bound state. All of the paramaters are
          set in enviromental variables, The script should configure the interface, and set any other relavent parameters
          (default gateway, dns server, etc). */
 
-        client->UpdateContentFromLease();
+        update_content(*client);
         ip_controller_.Configure(interface.GetName(), client->GetAddressFromLease(), client->GetNetmaskFromLease());
       } break;
       case DynamicIPEventAction::RELEASE: {
@@ -327,7 +353,7 @@ void IPManager::OnDynamicIPEvent(const Interface &interface, DynamicIPEventActio
         /* renew: This argument is used when a DHCP lease is renewed. All of the paramaters are set in enviromental
          variables. This argument is used when the interface is already configured, so the IP address, will not change,
          however, the other DHCP paramaters, such as the default gateway, subnet mask, and dns server may change. */
-        client->UpdateContentFromLease();
+        update_content(*client);
         ip_controller_.Configure(interface.GetName(), client->GetAddressFromLease(), client->GetNetmaskFromLease());
         break;
       case DynamicIPEventAction::NAK:
@@ -340,7 +366,28 @@ void IPManager::OnDynamicIPEvent(const Interface &interface, DynamicIPEventActio
         LogError("IPManager::OnDynamicIPEvent IP Event: found unknown action");
         break;
     }
+    UpdateHostnameFromLease(interface, action, *client, lease);
+  }
+}
+
+void IPManager::UpdateHostnameFromLease(const Interface &interface, DynamicIPEventAction action,
+                                        IDynamicIPClient &client, const ::std::optional<::std::string> &lease) {
+  if (not lease) {
     hostname_manager_.OnLeaseFileChange(interface);
+    return;
+  }
+
+  // The lease of the event is the current one, the lease file may already belong to another client.
+  switch (action) {
+    case DynamicIPEventAction::BOUND:
+    case DynamicIPEventAction::RENEW:
+      hostname_manager_.OnLeaseChange(interface, client.GetHostnameFromLease(), client.GetDomainFromLease());
+      break;
+    case DynamicIPEventAction::RELEASE:
+      hostname_manager_.OnLeaseFileRemove(interface);
+      break;
+    default:
+      break;
   }
 }
 
@@ -5,6 +5,7 @@
 #include "IIPManager.hpp"
 
 #include <memory>
+#include <optional>
 #include <set>
 
 #include "IPValidator.hpp"
@@ -62,10 +63,16 @@ class IPManager : public IIPManager, public INetDevEvents, public IIPLinks, publ
   void OnAddressChange(ChangeType change_type, int index, Address address,
                        Netmask netmask) override;
   void OnDynamicIPEvent(const Interface &interface, DynamicIPEventAction action) override;
+  void OnDynamicIPEvent(const Interface &interface, DynamicIPEventAction action, const ::std::string &lease,
+                        pid_t client_pid) override;
   void OnHostnameChanged() override;
 
  private:
   Status Configure(const IPConfigs &config);
+  void HandleDynamicIPEvent(const Interface &interface, DynamicIPEventAction action,
+                            const ::std::optional<::std::string> &lease, pid_t client_pid);
+  void UpdateHostnameFromLease(const Interface &interface, DynamicIPEventAction action, IDynamicIPClient &client,
+                               const ::std::optional<::std::string> &lease);
   ::std::shared_ptr<IPLink> CreateOrGet(const Interface &interface) override;
 
   IPLinkPtr GetIPLinkByInterface(const Interface &interface) const;
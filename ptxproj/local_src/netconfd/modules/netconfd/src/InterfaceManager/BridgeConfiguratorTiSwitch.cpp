@@ -6,13 +6,20 @@
 #include <cstddef>
 
 #include "CollectionUtils.hpp"
-#include "CommandExecutor.hpp"
 #include "Logger.hpp"
 
 namespace netconf {
 
-BridgeConfiguratorTiSwitch::BridgeConfiguratorTiSwitch(INetDevManager &netdev_manager, IBridgeChangeEvent &bridge_change_event)
-    : netdev_manager_{netdev_manager}, bridge_change_event_{bridge_change_event} {
+namespace {
+
+constexpr auto SWITCH_DEVICE     = "platform/8000000.ethernet";
+constexpr auto SWITCH_MODE_PARAM = "switch_mode";
+
+}  // namespace
+
+BridgeConfiguratorTiSwitch::BridgeConfiguratorTiSwitch(INetDevManager &netdev_manager, IBridgeChangeEvent &bridge_change_event,
+                                                       IDevlink &devlink)
+    : netdev_manager_{netdev_manager}, bridge_change_event_{bridge_change_event}, devlink_{devlink} {
       LogDebug("use pfc300 specific BridgeConfigurator");
 }
 
@@ -51,6 +58,12 @@ Status BridgeConfiguratorTiSwitch::RemoveAllActualBridgeInterfacesThatAreNotNeed
   return status;
 }
 
+Status BridgeConfiguratorTiSwitch::JoinBridge(Interface const &port_interface, Interface const &bridge_interface) const {
+  // INFO Ports müssen up sein damit sie beim hinzufügen der bridge in die untagged vid1 liste aufgenommen werden
+  netdev_manager_.SetUp(port_interface);
+  return netdev_manager_.BridgePortJoin(port_interface, bridge_interface);
+}
+
 Status BridgeConfiguratorTiSwitch::AddMissingInterfacesToActualBridges(BridgeConfig const &config,
                                                                Interfaces const &current_bridges) const {
   Status status;
@@ -60,7 +73,7 @@ Status BridgeConfiguratorTiSwitch::AddMissingInterfacesToActualBridges(BridgeCon
 
     for (const auto &port_interface : port_interfaces) {
       if (IsNotIncluded(port_interface, actual_interfaces)) {
-        status = netdev_manager_.BridgePortJoin(port_interface, bridge_interface);
+        status = JoinBridge(port_interface, bridge_interface);
         if (status.IsNotOk()) {
           break;
         }
@@ -82,7 +95,7 @@ Status BridgeConfiguratorTiSwitch::AddMissingBridgesAndTheirInterfaces(BridgeCon
         break;
       }
       for (const auto &port_interface : port_interfaces) {
-        status = netdev_manager_.BridgePortJoin(port_interface, bridge_interface);
+        status = JoinBridge(port_interface, bridge_interface);
         if (status.IsNotOk()) {
           break;
         }
@@ -101,22 +114,23 @@ Status BridgeConfiguratorTiSwitch::SetAllBridgesUp(Interfaces const &bridges) co
   return status;
 }
 
-namespace {
-  void PFC300QickfixChangeSwitchMode(INetDevManager& netdev_manager, const BridgeConfig& config){
-
-    netdev_manager.BridgePortLeave(Interface::CreatePort("ethX1"));
-    netdev_manager.BridgePortLeave(Interface::CreatePort("ethX2"));
+/*
+ * The switch mode (both ports in one bridge) is changed only on a real transition,
+ * the ports are detached from their bridges for the change only then.
+ * If the current mode cannot be read, it is set unconditionally.
+ */
+Status BridgeConfiguratorTiSwitch::ChangeSwitchModeIfRequired(BridgeConfig const &config) const {
+  bool switch_mode = config.size() == 1;
+
+  auto current_switch_mode = devlink_.GetBoolParameter(SWITCH_DEVICE, SWITCH_MODE_PARAM);
+  if (current_switch_mode == switch_mode) {
+    return Status{};
+  }
 
-    // INFO Ports müssen up sein damit sie beim hinzufügen der bridge in die untagged vid1 liste aufgenommen werden
-    netdev_manager.SetUp(Interface::CreatePort("ethX1"));
-    netdev_manager.SetUp(Interface::CreatePort("ethX2"));
+  netdev_manager_.BridgePortLeave(Interface::CreatePort("ethX1"));
+  netdev_manager_.BridgePortLeave(Interface::CreatePort("ethX2"));
 
-    if(config.size() == 1){
-      ::std::system("/usr/sbin/devlink dev param set platform/8000000.ethernet name switch_mode value true cmode runtime");
-    } else {
-      ::std::system("/usr/sbin/devlink dev param set platform/8000000.ethernet name switch_mode value false cmode runtime");
-    }
-  }
+  return devlink_.SetBoolParameter(SWITCH_DEVICE, SWITCH_MODE_PARAM, switch_mode);
 }
 
 Status BridgeConfiguratorTiSwitch::Configure(const BridgeConfig &config) const {
@@ -129,7 +143,8 @@ Status BridgeConfiguratorTiSwitch::Configure(const BridgeConfig &config) const {
     LOG_STATUS(status);
   }
 
-  PFC300QickfixChangeSwitchMode(netdev_manager_,config);
+  auto switch_mode_status = ChangeSwitchModeIfRequired(config);
+  LOG_STATUS(switch_mode_status);
 
   if (status.IsOk()) {
     status = AddMissingInterfacesToActualBridges(config, current_bridges);
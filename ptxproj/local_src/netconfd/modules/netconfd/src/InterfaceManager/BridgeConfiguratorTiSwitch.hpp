@@ -8,6 +8,7 @@
 #include <memory>
 
 #include "IBridgeChangeEvent.hpp"
+#include "IDevlink.hpp"
 
 //------------------------------------------------------------------------------
 // function implementation
@@ -18,7 +19,8 @@ namespace netconf {
 class BridgeConfiguratorTiSwitch: public IBridgeConfigurator{
 
  public:
-  explicit BridgeConfiguratorTiSwitch(INetDevManager& netdev_manager, IBridgeChangeEvent& bridge_change_event);
+  BridgeConfiguratorTiSwitch(INetDevManager& netdev_manager, IBridgeChangeEvent& bridge_change_event,
+                             IDevlink& devlink);
   ~BridgeConfiguratorTiSwitch() = default;
 
   BridgeConfiguratorTiSwitch(const BridgeConfiguratorTiSwitch&) = delete;
@@ -35,14 +37,17 @@ class BridgeConfiguratorTiSwitch: public IBridgeConfigurator{
                                                 Interfaces &current_bridges) const;
   Status RemoveAllActualBridgeInterfacesThatAreNotNeeded(BridgeConfig const& config_os,
                                                          Interfaces const& current_bridges) const;
+  Status JoinBridge(Interface const& port_interface, Interface const& bridge_interface) const;
   Status AddMissingInterfacesToActualBridges(BridgeConfig const& config_os,
                                              Interfaces const& current_bridges) const;
   Status AddMissingBridgesAndTheirInterfaces(BridgeConfig const& config_os,
                                              Interfaces& current_bridges) const;
   Status SetAllBridgesUp(Interfaces const &bridges) const;
+  Status ChangeSwitchModeIfRequired(BridgeConfig const &config) const;
 
   INetDevManager& netdev_manager_;
   IBridgeChangeEvent& bridge_change_event_;
+  IDevlink& devlink_;
 
 };
 
@@ -6,6 +6,7 @@
 #include "BridgeConfigValidator.hpp"
 #include "BridgeConfigurator.hpp"
 #include "BridgeConfiguratorTiSwitch.hpp"
+#include "Devlink.hpp"
 #include "Logger.hpp"
 #include "NetDev.hpp"
 
@@ -47,7 +48,8 @@ BridgeManager::BridgeManager(INetDevManager &netdev_manager, IMacDistributor &ma
     : netdev_manager_{netdev_manager},
       mac_distributor_{mac_distributor} {
         if(order_number == "750-8302"){
-          bridge_configurator_ = ::std::make_shared<BridgeConfiguratorTiSwitch>(netdev_manager, bridge_change_event);
+          devlink_             = ::std::make_shared<Devlink>();
+          bridge_configurator_ = ::std::make_shared<BridgeConfiguratorTiSwitch>(netdev_manager, bridge_change_event, *devlink_);
         }else{
           bridge_configurator_ = ::std::make_shared<BridgeConfigurator>(netdev_manager, bridge_change_event);
         }
@@ -7,6 +7,7 @@
 #include "BridgeConfigurator.hpp"
 #include "IBridgeInformation.hpp"
 #include "IBridgeManager.hpp"
+#include "IDevlink.hpp"
 #include "IMacDistributor.hpp"
 #include "INetDevManager.hpp"
 
@@ -29,6 +30,7 @@ class BridgeManager : public IBridgeManager, public IBridgeInformation {
  private:
   INetDevManager& netdev_manager_;
   IMacDistributor& mac_distributor_;
+  ::std::shared_ptr<IDevlink> devlink_;
   ::std::shared_ptr<IBridgeConfigurator> bridge_configurator_;
 };
 
@@ -63,6 +63,12 @@ class EthToolSettings {
         if_state_ { eth::DeviceState::Down },
         if_link_state_ { eth::InterfaceLinkState::Down } {
   }
+  constexpr EthToolSettings(const EthToolLinkSettings &ls, eth::DeviceState if_state,
+                            eth::InterfaceLinkState if_link_state) noexcept
+      : e_ { ls },
+        if_state_ { if_state },
+        if_link_state_ { if_link_state } {
+  }
 
   gsl::span<const uint32_t> GetSupported() const;
   gsl::span<const uint32_t> GetAutonegAdvertising() const;
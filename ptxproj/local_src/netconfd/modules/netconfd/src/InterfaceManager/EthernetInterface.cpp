@@ -32,10 +32,12 @@ using eth::MediaType;
 using gsl::span;
 using namespace std::literals;
 
-EthernetInterface::EthernetInterface(::std::string name)
+EthernetInterface::EthernetInterface(::std::string name, IPortStatusSnapshot& port_status_snapshot)
 
     : mac_{0},
       name_(std::move(name)),
+      if_index_{0},
+      port_status_snapshot_{port_status_snapshot},
       ifreq_{},
       socket_{AF_INET, SOCK_DGRAM, IPPROTO_IP},
       mtu_{},
@@ -77,6 +79,16 @@ Status EthernetInterface::UpdateMtu() {
 }
 
 Status EthernetInterface::UpdateConfig() {
+  auto port_status = port_status_snapshot_.GetPortStatus(name_);
+  if (port_status) {
+    if_index_           = port_status->if_index_;
+    mtu_                = port_status->mtu_;
+    mac_                = port_status->mac_.addr_;
+    ethtool_settings_r_ = port_status->settings_;
+    ethtool_settings_w_ = ethtool_settings_r_;
+    return Status{};
+  }
+
   if_index_ = if_nametoindex(name_.c_str());
   if (if_index_ == 0) {
     return Status{StatusCode::GENERIC_ERROR, ::std::string(__func__) + ": failed to get interface index for " + name_};
@@ -154,7 +166,9 @@ InterfaceLinkState EthernetInterface::GetLinkState() const {
 }
 
 Status EthernetInterface::Commit() {
-  return ethtool_.Commit(ethtool_settings_w_);
+  auto status = ethtool_.Commit(ethtool_settings_w_);
+  port_status_snapshot_.Invalidate(name_);
+  return status;
 }
 
 void EthernetInterface::SetAutoneg(eth::Autoneg autoneg) {
@@ -9,12 +9,13 @@
 #include "NetworkInterfaceConstants.hpp"
 #include "IEthernetInterface.hpp"
 #include "EthTool.hpp"
+#include "IPortStatusSnapshot.hpp"
 
 namespace netconf {
 
 class EthernetInterface : public IEthernetInterface {
  public:
-  explicit EthernetInterface(::std::string name);
+  EthernetInterface(::std::string name, IPortStatusSnapshot& port_status_snapshot);
   ~EthernetInterface() override = default;
   EthernetInterface(const EthernetInterface& other) = delete;
   EthernetInterface& operator=(const EthernetInterface& other) = delete;
@@ -54,6 +55,7 @@ class EthernetInterface : public IEthernetInterface {
 
   ::std::string name_;
   ::std::uint32_t if_index_;
+  IPortStatusSnapshot& port_status_snapshot_;
 
   ::ifreq ifreq_;
   Socket socket_;
@@ -12,8 +12,12 @@
 
 namespace netconf {
 
+EthernetInterfaceFactory::EthernetInterfaceFactory(IPortStatusSnapshot &port_status_snapshot)
+    : port_status_snapshot_{port_status_snapshot} {
+}
+
 ::std::unique_ptr<IEthernetInterface> EthernetInterfaceFactory::getEthernetInterface(Interface interface) {
-  return ::std::make_unique<EthernetInterface>(interface.GetName());
+  return ::std::make_unique<EthernetInterface>(interface.GetName(), port_status_snapshot_);
 }
 
 } /* namespace netconf */
@@ -3,12 +3,13 @@
 #pragma once
 
 #include "IEthernetInterfaceFactory.hpp"
+#include "IPortStatusSnapshot.hpp"
 
 namespace netconf {
 
 class EthernetInterfaceFactory : public IEthernetInterfaceFactory {
  public:
-  EthernetInterfaceFactory() = default;
+  explicit EthernetInterfaceFactory(IPortStatusSnapshot &port_status_snapshot);
   ~EthernetInterfaceFactory() override = default;
 
   EthernetInterfaceFactory(const EthernetInterfaceFactory &other) = delete;
@@ -18,6 +19,8 @@ class EthernetInterfaceFactory : public IEthernetInterfaceFactory {
 
   ::std::unique_ptr<IEthernetInterface> getEthernetInterface(Interface interface) override;
 
+ private:
+  IPortStatusSnapshot &port_status_snapshot_;
 };
 
 } /* namespace netconf */
@@ -0,0 +1,38 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "EthTool.hpp"
+#include "MacAddress.hpp"
+
+namespace netconf {
+
+struct PortStatus {
+  ::std::uint32_t if_index_ = 0;
+  ::std::uint32_t mtu_      = 0;
+  MacAddress mac_;
+  EthToolSettings settings_{EthToolLinkSettings{}};
+};
+
+class IPortStatusSnapshot {
+ public:
+  IPortStatusSnapshot() = default;
+  virtual ~IPortStatusSnapshot() = default;
+
+  IPortStatusSnapshot(const IPortStatusSnapshot&) = delete;
+  IPortStatusSnapshot& operator=(const IPortStatusSnapshot&) = delete;
+  IPortStatusSnapshot(const IPortStatusSnapshot&&) = delete;
+  IPortStatusSnapshot& operator=(const IPortStatusSnapshot&&) = delete;
+
+  // No value if the snapshot is not available, the caller has to read the port by itself then.
+  virtual ::std::optional<PortStatus> GetPortStatus(const ::std::string& name) = 0;
+
+  // Marks the port as outdated, e.g. after changing its settings.
+  virtual void Invalidate(const ::std::string& name) = 0;
+};
+
+}  // namespace netconf
@@ -9,7 +9,6 @@
 #include "Logger.hpp"
 #include "LinkModeConversion.hpp"
 #include "InterfaceConfigurationValidator.hpp"
-#include "BridgeUtil.hpp"
 
 namespace netconf {
 
@@ -22,10 +21,12 @@ using ::std::transform;
 
 InterfaceConfigManager::InterfaceConfigManager(INetDevManager &netdev_manager,
                                                IPersistence<InterfaceConfigs> &persistence_provider,
-                                               IEthernetInterfaceFactory &eth_factory)
+                                               IEthernetInterfaceFactory &eth_factory,
+                                               IBridgePortMonitor &bridge_port_monitor)
     : netdev_manager_ { netdev_manager },
       persistence_provider_ { persistence_provider },
-      ethernet_interface_factory_ { eth_factory } {
+      ethernet_interface_factory_ { eth_factory },
+      bridge_port_monitor_ { bridge_port_monitor } {
 
   InterfaceConfigs peristet_configs;
   auto read_persistence_data_status = persistence_provider.Read(peristet_configs);
@@ -105,7 +106,7 @@ Status InterfaceConfigManager::GetCurrentPortStatuses(InterfaceStatuses& itf_sta
 
     itf_status.mac_ = eth_itf->GetMac();
 
-    itf_status.mac_learning_ = GetMacLearning(eth_itf->GetInterfaceIndex());
+    itf_status.mac_learning_ = bridge_port_monitor_.GetMacLearning(eth_itf->GetInterfaceIndex());
 
     itf_statuses.emplace_back(itf_status);
 
@@ -169,7 +170,7 @@ Status InterfaceConfigManager::ApplyPortConfig(InterfaceConfig const &cfg) {
     eif->SetSpeed(static_cast<::std::uint32_t>(cfg.speed_));
   }
   if (cfg.mac_learning_ != MacLearning::UNKNOWN) {
-    SetMacLearning(eif->GetInterfaceIndex(), cfg.mac_learning_);
+    bridge_port_monitor_.SetMacLearning(eif->GetInterfaceIndex(), cfg.mac_learning_);
   }
 
   return eif->Commit();
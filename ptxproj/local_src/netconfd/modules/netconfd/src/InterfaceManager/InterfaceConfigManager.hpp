@@ -6,6 +6,7 @@
 #include <string>
 
 #include "IBridgeInformation.hpp"
+#include "IBridgePortMonitor.hpp"
 #include "IEthernetInterfaceFactory.hpp"
 #include "IEthernetInterface.hpp"
 #include "IInterfaceInformation.hpp"
@@ -15,13 +16,13 @@
 
 namespace netconf {
 
-class BridgeUtil;
 class InterfaceConfigManager : public IInterfaceInformation{
  public:
 
   InterfaceConfigManager(INetDevManager& netdev_manager,
       IPersistence<InterfaceConfigs>& persistence_provider,
-      IEthernetInterfaceFactory& eth_factory);
+      IEthernetInterfaceFactory& eth_factory,
+      IBridgePortMonitor& bridge_port_monitor);
   ~InterfaceConfigManager() override = default;
 
   InterfaceConfigManager(const InterfaceConfigManager &other) = delete;
@@ -46,6 +47,7 @@ class InterfaceConfigManager : public IInterfaceInformation{
   INetDevManager& netdev_manager_;
   IPersistence<InterfaceConfigs>& persistence_provider_;
   IEthernetInterfaceFactory& ethernet_interface_factory_;
+  IBridgePortMonitor& bridge_port_monitor_;
   ::std::map<Interface, ::std::unique_ptr<IEthernetInterface>> ethernet_interfaces_;
   InterfaceConfigs current_config_;
 };
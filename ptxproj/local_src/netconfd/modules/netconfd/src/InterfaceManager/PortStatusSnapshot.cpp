@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "PortStatusSnapshot.hpp"
+
+#include <linux/if.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include "Logger.hpp"
+
+namespace netconf {
+
+PortStatusSnapshot::PortStatusSnapshot(IEthtoolNetlink& ethtool, IInterfaceMonitor& interface_monitor,
+                                       ::std::chrono::milliseconds retry_delay)
+    : ethtool_{ethtool},
+      interface_monitor_{interface_monitor},
+      retry_delay_{retry_delay} {
+}
+
+::std::optional<PortStatus> PortStatusSnapshot::GetPortStatus(const ::std::string& name) {
+  if (not ethtool_.IsAvailable()) {
+    return ::std::nullopt;
+  }
+
+  if (IsOutdated(name)) {
+    Refresh();
+  }
+
+  auto port = ports_.find(name);
+  if (port == ports_.end()) {
+    return ::std::nullopt;
+  }
+  return port->second;
+}
+
+void PortStatusSnapshot::Invalidate(const ::std::string& name) {
+  outdated_ports_.insert(name);
+}
+
+bool PortStatusSnapshot::IsOutdated(const ::std::string& name) {
+  if (failed_) {
+    return ::std::chrono::steady_clock::now() >= retry_time_;
+  }
+  return not valid_ || change_count_ != interface_monitor_.GetChangeCount() || outdated_ports_.count(name) != 0;
+}
+
+void PortStatusSnapshot::Refresh() {
+  ports_.clear();
+  outdated_ports_.clear();
+  change_count_ = interface_monitor_.GetChangeCount();
+
+  EthtoolPorts ethtool_ports;
+  auto status = ethtool_.GetPorts(ethtool_ports);
+  valid_      = status.IsOk();
+  if (not valid_) {
+    if (not failed_) {
+      LogWarning("PortStatusSnapshot: " + status.ToString());
+    }
+    failed_     = true;
+    retry_time_ = ::std::chrono::steady_clock::now() + retry_delay_;
+    return;
+  }
+  failed_ = false;
+
+  for (auto& [index, port] : ethtool_ports) {
+    auto port_status = ToPortStatus(port);
+    if (port_status) {
+      ports_.emplace(port.name_, *port_status);
+    }
+  }
+}
+
+::std::optional<PortStatus> PortStatusSnapshot::ToPortStatus(const EthtoolPort& port) {
+  // The link modes are missing if the driver cannot report its link settings.
+  if (port.link_mode_bits_ == 0) {
+    return ::std::nullopt;
+  }
+
+  PortStatus status;
+  try {
+    status.mac_ = MacAddress::FromString(interface_monitor_.GetMac(port.index_));
+  } catch (::std::invalid_argument&) {
+    return ::std::nullopt;
+  }
+
+  EthToolLinkSettings link_settings{};
+  link_settings.s_.cmd              = ETHTOOL_GLINKSETTINGS;
+  link_settings.s_.speed            = port.speed_;
+  link_settings.s_.duplex           = port.duplex_;
+  link_settings.s_.port             = port.port_;
+  link_settings.s_.phy_address      = port.phy_address_;
+  link_settings.s_.autoneg          = port.autoneg_;
+  link_settings.s_.eth_tp_mdix      = port.tp_mdix_;
+  link_settings.s_.eth_tp_mdix_ctrl = port.tp_mdix_ctrl_;
+  link_settings.s_.transceiver      = port.transceiver_;
+
+  // The masks are stored one after another: supported, advertising, link partner advertising
+  auto nwords = ::std::min<::std::size_t>((port.link_mode_bits_ + 31) / 32, link_settings.maxwords());
+  link_settings.s_.link_mode_masks_nwords = static_cast<__s8>(nwords);
+  auto copy_mask = [&](const ::std::vector<::std::uint32_t>& mask, ::std::size_t offset) {
+    ::std::copy_n(mask.begin(), ::std::min(nwords, mask.size()), &gsl::at(link_settings.link_mode_masks_, offset));
+  };
+  copy_mask(port.supported_, 0);
+  copy_mask(port.advertising_, nwords);
+  copy_mask(port.lp_advertising_, 2 * nwords);
+
+  auto if_state = ((interface_monitor_.GetIffFlags(port.index_) & IFF_UP) == IFF_UP) ? eth::DeviceState::Up
+                                                                                    : eth::DeviceState::Down;
+  auto link_state = port.link_ ? eth::InterfaceLinkState::Up : eth::InterfaceLinkState::Down;
+
+  status.if_index_ = port.index_;
+  status.mtu_      = interface_monitor_.GetMtu(port.index_);
+  status.settings_ = EthToolSettings{link_settings, if_state, link_state};
+  return status;
+}
+
+}  // namespace netconf
@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <set>
+
+#include "IEthtoolNetlink.hpp"
+#include "IInterfaceMonitor.hpp"
+#include "IPortStatusSnapshot.hpp"
+
+namespace netconf {
+
+/*
+ * Holds the ethtool settings and link states of all ports, read by one ethtool netlink dump per message type.
+ * MAC address, MTU and interface flags are taken from the interface monitor (netlink link cache).
+ * The snapshot is read again on the next query after a link change was reported by the interface monitor
+ * or after a port was invalidated.
+ * Without ethtool netlink support no snapshot is provided and the ports are read by ioctl.
+ * The same applies for retry_delay after a failed dump, so a failing request is not repeated for every query.
+ */
+class PortStatusSnapshot : public IPortStatusSnapshot {
+ public:
+  static constexpr ::std::chrono::milliseconds default_retry_delay{10000};
+
+  PortStatusSnapshot(IEthtoolNetlink& ethtool, IInterfaceMonitor& interface_monitor,
+                     ::std::chrono::milliseconds retry_delay = default_retry_delay);
+  ~PortStatusSnapshot() override = default;
+
+  PortStatusSnapshot(const PortStatusSnapshot&)             = delete;
+  PortStatusSnapshot& operator=(const PortStatusSnapshot&)  = delete;
+  PortStatusSnapshot(const PortStatusSnapshot&&)            = delete;
+  PortStatusSnapshot& operator=(const PortStatusSnapshot&&) = delete;
+
+  ::std::optional<PortStatus> GetPortStatus(const ::std::string& name) override;
+  void Invalidate(const ::std::string& name) override;
+
+ private:
+  IEthtoolNetlink& ethtool_;
+  IInterfaceMonitor& interface_monitor_;
+  ::std::chrono::milliseconds retry_delay_;
+
+  bool valid_                   = false;
+  bool failed_                  = false;
+  ::std::chrono::steady_clock::time_point retry_time_;
+  ::std::uint64_t change_count_ = 0;
+  ::std::map<::std::string, PortStatus> ports_;
+  ::std::set<::std::string> outdated_ports_;
+
+  bool IsOutdated(const ::std::string& name);
+  void Refresh();
+  ::std::optional<PortStatus> ToPortStatus(const EthtoolPort& port);
+};
+
+}  // namespace netconf
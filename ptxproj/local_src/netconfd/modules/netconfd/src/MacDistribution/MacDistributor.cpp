@@ -2,6 +2,11 @@
 
 #include "MacDistributor.hpp"
 
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
 #include <boost/algorithm/string.hpp>
 #include <gsl/gsl>
 
@@ -24,139 +29,145 @@ int DetermineBridgeMacIncrement(Interface &interface) {
   return -1;
 }
 
+// A MAC that cannot be read (e.g. empty) counts as different and is written.
+bool HasMac(const NetDevPtr &net_dev, const MacAddress &mac) {
+  try {
+    return net_dev->GetMac() == mac;
+  } catch (const ::std::invalid_argument &) {
+    return false;
+  }
+}
+
 }  // namespace
 
 MacDistributor::MacDistributor(MacAddress mac_address, uint32_t mac_inc,
                                INetDevManager &netdev_manager)
     : base_mac_address_{mac_address},
       mac_inc_{mac_inc},
-      netdev_manager_{netdev_manager},
-      mac_counter_{0} {
+      netdev_manager_{netdev_manager} {
 }
 
 void MacDistributor::AssignMacs(NetDevs &net_devs) {
+  ApplyMacs(DetermineMacs(net_devs));
+}
+
+MacAssignment MacDistributor::DetermineMacs(NetDevs &net_devs) const {
   auto sort_alphanum = [](const NetDevPtr &lhs, const NetDevPtr &rhs) {
-    return doj::alphanum_comp(lhs->GetInterface().GetName(), rhs->GetInterface().GetName()) < 0;
+    return doj::alphanum_comp(lhs->GetName(), rhs->GetName()) < 0;
   };
   ::std::sort(net_devs.begin(), net_devs.end(), sort_alphanum);
 
-  mac_counter_ = 0;
-
-  auto port_count = static_cast<uint32_t>(::std::count_if(net_devs.begin(), net_devs.end(), [&](NetDevPtr netdev) {
+  auto port_count = static_cast<uint32_t>(::std::count_if(net_devs.begin(), net_devs.end(), [&](const NetDevPtr &netdev) {
     return DeviceTypeIsAnyOf(netdev->GetDeviceType(), DeviceType::Port);
   }));
 
   if (IsMacAddressAssignmentFull(mac_inc_, port_count)) {
-    AssignFullMacSupport(net_devs);
-  } else if (IsMacAddressAssignmentMultiple(mac_inc_, port_count)) {
-    AssignMultipleMacSupport(net_devs);
-  } else {
-    AssignSingleMacSupport(net_devs);
+    return DetermineFullMacSupport(net_devs);
   }
+  if (IsMacAddressAssignmentMultiple(mac_inc_, port_count)) {
+    return DetermineMultipleMacSupport(net_devs);
+  }
+  return DetermineSingleMacSupport(net_devs);
 }
 
-void MacDistributor::AssignMac(NetDevPtr &net_dev, MacAddress mac) {
-  netdev_manager_.SetMac(net_dev, mac.ToString());
-}
-
-void MacDistributor::AssignMac(NetDevPtr &net_dev) {
-  auto mac = base_mac_address_.Increment(mac_counter_);
-  AssignMac(net_dev, mac);
-}
-
-void MacDistributor::AssignMacAndIncrement(NetDevPtr &net_dev) {
-  auto mac = base_mac_address_.Increment(mac_counter_);
-  AssignMac(net_dev, mac);
-  mac_counter_++;
+void MacDistributor::ApplyMacs(const MacAssignment &assignment) {
+  for (const auto &[net_dev, mac] : assignment) {
+    if (not HasMac(net_dev, mac)) {
+      netdev_manager_.SetMac(net_dev, mac.ToString());
+    }
+  }
 }
 
-void MacDistributor::AssignSingleMacSupport(NetDevs &net_devs) {
-  auto assign_macs = [&](NetDevPtr &net_dev) {
+MacAssignment MacDistributor::DetermineSingleMacSupport(const NetDevs &net_devs) const {
+  MacAssignment assignment;
+  for (const auto &net_dev : net_devs) {
     if (net_dev->GetDeviceType() == DeviceType::Bridge || net_dev->GetDeviceType() == DeviceType::Port) {
-      AssignMac(net_dev, base_mac_address_);
+      assignment.emplace_back(net_dev, base_mac_address_);
     }
-  };
-
-  ::std::for_each(net_devs.begin(), net_devs.end(), assign_macs);
+  }
+  return assignment;
 }
 
-void MacDistributor::AssignMultipleMacSupport(NetDevs &net_devs) {
-  auto assign_mac_to_bridge = [&](NetDevPtr &net_dev) {
+MacAssignment MacDistributor::DetermineMultipleMacSupport(const NetDevs &net_devs) const {
+  MacAssignment assignment;
+  for (const auto &net_dev : net_devs) {
     if (net_dev->GetDeviceType() == DeviceType::Bridge) {
-      AssignMac(net_dev, base_mac_address_);
+      assignment.emplace_back(net_dev, base_mac_address_);
     }
-  };
-
-  ::std::for_each(net_devs.begin(), net_devs.end(), assign_mac_to_bridge);
-  mac_counter_++;
+  }
 
-  auto assign_mac_to_ports = [&](NetDevPtr &net_dev) {
+  uint32_t mac_counter = 1;
+  for (const auto &net_dev : net_devs) {
     if (net_dev->GetDeviceType() == DeviceType::Port) {
-      AssignMacAndIncrement(net_dev);
+      assignment.emplace_back(net_dev, base_mac_address_.Increment(mac_counter++));
     }
-  };
-
-  ::std::for_each(net_devs.begin(), net_devs.end(), assign_mac_to_ports);
+  }
+  return assignment;
 }
 
-void MacDistributor::AssignFullMacSupport(NetDevs &net_devs) {
-  ::std::list<uint32_t> mac_incs(mac_inc_);
-  std::generate(mac_incs.begin(), mac_incs.end(), [n = 0]() mutable { return n++; });
+MacAssignment MacDistributor::DetermineFullMacSupport(const NetDevs &net_devs) const {
+  MacAssignment assignment;
+  ::std::vector<bool> mac_inc_used(mac_inc_, false);
+  ::std::map<int, MacAddress> bridge_macs;
 
-  auto assign_mac_to_bridge = [&](NetDevPtr &net_dev) {
+  for (const auto &net_dev : net_devs) {
     if (net_dev->GetDeviceType() == DeviceType::Bridge) {
       LOG_DEBUG("assign_mac_to_bridge: " << net_dev->GetName());
       auto name    = net_dev->GetInterface();
       auto inc_num = DetermineBridgeMacIncrement(name);
+      auto mac     = base_mac_address_;
       if ((inc_num >= 0) && (static_cast<uint32_t>(inc_num) < mac_inc_)) {
-        auto it = ::std::find(mac_incs.begin(), mac_incs.end(), inc_num);
-        if(it == mac_incs.end()){
+        auto inc = static_cast<uint32_t>(inc_num);
+        if (mac_inc_used[inc]) {
           LogError("Mac for interface index " + ::std::to_string(inc_num) + " has already been assigned. " + net_dev->GetName() + " was not assigned a MAC.");
-          return;
+          continue;
         }
-        mac_incs.erase(it);
-        AssignMac(net_dev, base_mac_address_.Increment(static_cast<uint32_t>(inc_num)));
+        mac_inc_used[inc] = true;
+        mac               = base_mac_address_.Increment(inc);
       } else {
         LogWarning("MAC increment couldn't be determined, taking base: " + net_dev->GetInterface().GetName());
-        AssignMac(net_dev, base_mac_address_);
       }
+      assignment.emplace_back(net_dev, mac);
+      bridge_macs.emplace(net_dev->GetIndex(), mac);
     }
-  };
-
-  ::std::for_each(net_devs.begin(), net_devs.end(), assign_mac_to_bridge);
+  }
 
-  auto assign_from_mac_incs = [&](NetDevPtr &net_dev) {
+  // The remaining increments are taken in ascending order.
+  uint32_t next_inc = 0;
+  auto take_from_mac_incs = [&](const NetDevPtr &net_dev) {
     LOG_DEBUG("assign_from_mac_incs: " << net_dev->GetName());
-    if (!mac_incs.empty()) {
-      auto mac = base_mac_address_.Increment(mac_incs.front());
-      mac_incs.pop_front();
-      AssignMac(net_dev, mac);
-    } else {
-      LogWarning("No MAC increment left, taking base MAC: " + net_dev->GetInterface().GetName());
-      AssignMac(net_dev, base_mac_address_);
+    while (next_inc < mac_inc_ && mac_inc_used[next_inc]) {
+      next_inc++;
+    }
+    if (next_inc < mac_inc_) {
+      mac_inc_used[next_inc] = true;
+      return base_mac_address_.Increment(next_inc);
     }
+    LogWarning("No MAC increment left, taking base MAC: " + net_dev->GetInterface().GetName());
+    return base_mac_address_;
   };
 
-  auto assign_mac_to_ports = [&](NetDevPtr &net_dev) {
+  for (const auto &net_dev : net_devs) {
     if (net_dev->GetDeviceType() == DeviceType::Port) {
       LOG_DEBUG("assign_mac_to_ports: " << net_dev->GetName());
       auto bridge = netdev_manager_.GetParent(net_dev);
       if (BridgeHasMoreThenOneAssignedPort(bridge)) {
         LOG_DEBUG("assign_mac_to_ports: " << net_dev->GetName() << " has more then one assigned port");
-        assign_from_mac_incs(net_dev);
+        assignment.emplace_back(net_dev, take_from_mac_incs(net_dev));
       }
       if (BridgeHasOneAssignedPort(bridge)) {
         LOG_DEBUG("assign_mac_to_ports: " << net_dev->GetName() << " has one assigned port");
-        AssignMac(net_dev, bridge->GetMac());
+        // A single port takes the MAC its bridge gets, not the MAC the bridge has at the moment.
+        auto bridge_mac = bridge_macs.find(bridge->GetIndex());
+        assignment.emplace_back(net_dev, bridge_mac != bridge_macs.end() ? bridge_mac->second : bridge->GetMac());
       }
       if (not bridge) {
         LOG_DEBUG("assign_mac_to_ports: " << net_dev->GetName() << " has no bridge");
-        assign_from_mac_incs(net_dev);
+        assignment.emplace_back(net_dev, take_from_mac_incs(net_dev));
       }
     }
-  };
-
-  ::std::for_each(net_devs.begin(), net_devs.end(), assign_mac_to_ports);
+  }
+  return assignment;
 }
 
 bool MacDistributor::IsMacAddressAssignmentMultiple(uint32_t mac_count, uint32_t port_count) const {
@@ -175,7 +186,7 @@ bool MacDistributor::IsMacAddressAssignmentFull(uint32_t mac_count, uint32_t por
   return mac_count >= required_macs;
 }
 
-bool MacDistributor::BridgeHasMoreThenOneAssignedPort(NetDevPtr& net_dev) const {
+bool MacDistributor::BridgeHasMoreThenOneAssignedPort(const NetDevPtr& net_dev) const {
   if (net_dev) {
     auto ports = netdev_manager_.GetChildren(net_dev);
     return (ports.size() > 1);
@@ -183,7 +194,7 @@ bool MacDistributor::BridgeHasMoreThenOneAssignedPort(NetDevPtr& net_dev) const
   return false;
 }
 
-bool MacDistributor::BridgeHasOneAssignedPort(NetDevPtr& net_dev) const {
+bool MacDistributor::BridgeHasOneAssignedPort(const NetDevPtr& net_dev) const {
   if (net_dev) {
     auto ports = netdev_manager_.GetChildren(net_dev);
     return (ports.size() == 1);
@@ -2,6 +2,9 @@
 
 #pragma once
 
+#include <utility>
+#include <vector>
+
 #include "IDeviceTypeLabel.hpp"
 #include "IMacDistributor.hpp"
 #include "INetDevManager.hpp"
@@ -10,6 +13,13 @@
 
 namespace netconf {
 
+// Desired MAC of each bridge and port, in the order the MACs are written.
+using MacAssignment = ::std::vector<::std::pair<NetDevPtr, MacAddress>>;
+
+/*
+ * Determines the MACs of the bridges and ports from the base MAC and the number of available MACs.
+ * Only MACs that differ from the current MAC of a netdev (netlink link cache) are written.
+ */
 class MacDistributor : public IMacDistributor {
  public:
   MacDistributor(MacAddress mac_address, uint32_t mac_inc, INetDevManager &netdev_manager);
@@ -28,21 +38,18 @@ class MacDistributor : public IMacDistributor {
 
   INetDevManager &netdev_manager_;
 
-  uint32_t mac_counter_;
-
-  void AssignFullMacSupport(NetDevs &net_devs);
-  void AssignSingleMacSupport(NetDevs &net_devs);
-  void AssignMultipleMacSupport(NetDevs &net_devs);
+  MacAssignment DetermineMacs(NetDevs &net_devs) const;
+  MacAssignment DetermineFullMacSupport(const NetDevs &net_devs) const;
+  MacAssignment DetermineSingleMacSupport(const NetDevs &net_devs) const;
+  MacAssignment DetermineMultipleMacSupport(const NetDevs &net_devs) const;
 
-  void AssignMac(NetDevPtr &net_dev, MacAddress mac);
-  void AssignMac(NetDevPtr &net_dev);
-  void AssignMacAndIncrement(NetDevPtr &net_dev);
+  void ApplyMacs(const MacAssignment &assignment);
 
   bool IsMacAddressAssignmentMultiple(uint32_t mac_count, uint32_t port_count) const;
   bool IsMacAddressAssignmentFull(uint32_t mac_count, uint32_t port_count) const;
 
-  bool BridgeHasMoreThenOneAssignedPort(NetDevPtr& net_dev) const;
-  bool BridgeHasOneAssignedPort(NetDevPtr& net_dev) const;
+  bool BridgeHasMoreThenOneAssignedPort(const NetDevPtr& net_dev) const;
+  bool BridgeHasOneAssignedPort(const NetDevPtr& net_dev) const;
 
 };
 
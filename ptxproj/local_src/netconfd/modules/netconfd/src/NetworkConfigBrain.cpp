@@ -606,6 +606,16 @@ Status NetworkConfigBrain::ContainOnlyInterfacesOfTypePort(const InterfaceConfig
   return jc.ToJsonString(status);
 }
 
+void NetworkConfigBrain::ReceiveLeaseEvent(const LeaseEvent &event) {
+  auto netdev = netdev_manager_.GetByName(event.interface_);
+  if (netdev) {
+    ip_manager_.OnDynamicIPEvent(netdev->GetInterface(), event.action_, event.lease_, event.pid_);
+  } else {
+    LogWarning("Received lease event [" + ::std::to_string(static_cast<int>(event.action_)) +
+               "] for unknown interface: " + event.interface_);
+  }
+}
+
 ::std::string NetworkConfigBrain::ReceiveReloadHostConfEvent() {
   hostname_will_change_.OnReloadHostConf();
 
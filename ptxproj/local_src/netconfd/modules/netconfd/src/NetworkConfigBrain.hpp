@@ -10,6 +10,7 @@
 #include "IBridgeManager.hpp"
 #include "IIPManager.hpp"
 #include "JsonConverter.hpp"
+#include "LeaseEvent.hpp"
 #include "IHostnameWillChange.hpp"
 
 namespace netconf {
@@ -56,6 +57,7 @@ class NetworkConfigBrain {
   ::std::string SetTemporaryFixIp();
   
   ::std::string ReceiveDynamicIPEvent(const ::std::string& event);
+  void ReceiveLeaseEvent(const LeaseEvent& event);
   ::std::string ReceiveReloadHostConfEvent();
 
   ::std::string AddInterface(const ::std::string& data);
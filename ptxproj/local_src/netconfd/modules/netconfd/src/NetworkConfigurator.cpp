@@ -4,6 +4,7 @@
 
 #include <cerrno>
 #include <cstring>
+#include <system_error>
 #include <utility>
 
 #include "BridgeManager.hpp"
@@ -11,8 +12,10 @@
 #include "DipSwitch.hpp"
 #include "DynamicIPClientAdministrator.hpp"
 #include "EthernetInterfaceFactory.hpp"
+#include "EthtoolNetlink.hpp"
 #include "EventManager.hpp"
 #include "IPManager.hpp"
+#include "LeaseEventSocket.hpp"
 #include "Logger.hpp"
 #include "MacDistributor.hpp"
 #include "NetlinkLink.hpp"
@@ -22,6 +25,7 @@
 #include "NetlinkMonitor.hpp"
 #include "NetworkConfigBrain.hpp"
 #include "PersistenceProvider.hpp"
+#include "PortStatusSnapshot.hpp"
 #include "Redundancy.hpp"
 #include "Server.h"
 #include "UriEscape.hpp"
@@ -35,7 +39,8 @@ using namespace std::string_literals;
 
 class NetworkConfiguratorImpl {
  public:
-  explicit NetworkConfiguratorImpl(InterprocessCondition &start_condition, StartWithPortstate startWithPortState);
+  NetworkConfiguratorImpl(InterprocessCondition &start_condition, const ::std::string &lease_event_socket_path,
+                          StartWithPortstate startWithPortState);
   virtual ~NetworkConfiguratorImpl() = default;
 
   NetworkConfiguratorImpl(const NetworkConfiguratorImpl&) = delete;
@@ -49,6 +54,7 @@ class NetworkConfiguratorImpl {
 
   NetlinkLink netlink_link_;
   NetlinkMonitor netlink_monitor_;
+  ::std::shared_ptr<NetlinkLinkCache> link_cache_;
   ::std::shared_ptr<IInterfaceMonitor> interface_monitor_;
   ::std::shared_ptr<IIPMonitor> ip_monitor_;
   CommandExecutor command_executer_;
@@ -60,6 +66,8 @@ class NetworkConfiguratorImpl {
   PersistenceProvider persistence_provider_;
   Redundancy stp_;
   BridgeManager bridge_manager_;
+  EthtoolNetlink ethtool_netlink_;
+  PortStatusSnapshot port_status_snapshot_;
   EthernetInterfaceFactory ethernet_interface_factory_;
   InterfaceConfigManager interface_manager_;
   DynamicIPClientAdministrator dyn_ip_client_admin_;
@@ -68,14 +76,18 @@ class NetworkConfiguratorImpl {
   IPManager ip_manager_;
   NetworkConfigBrain network_config_brain_;
 
+  ::std::unique_ptr<LeaseEventSocket> lease_event_socket_;
+
   dbus::Server dbus_server_;
   dbus::DBusHandlerRegistry dbus_handler_registry_;
   ::UriEscape uri_escape_;
 };
 
 NetworkConfiguratorImpl::NetworkConfiguratorImpl(InterprocessCondition &start_condition,
+                                                 const ::std::string &lease_event_socket_path,
                                                  StartWithPortstate startWithPortState)
-    : interface_monitor_ { static_cast<::std::shared_ptr<IInterfaceMonitor>>(netlink_monitor_.Add<NetlinkLinkCache>()) },
+    : link_cache_ { netlink_monitor_.Add<NetlinkLinkCache>() },
+      interface_monitor_ { static_cast<::std::shared_ptr<IInterfaceMonitor>>(link_cache_) },
       ip_monitor_ { static_cast<::std::shared_ptr<IIPMonitor>>(netlink_monitor_.Add<NetlinkAddressCache>()) },
       device_type_label_ { command_executer_ },
       netdev_manager_ { interface_monitor_, event_manager_, netlink_link_},
@@ -83,7 +95,9 @@ NetworkConfiguratorImpl::NetworkConfiguratorImpl(InterprocessCondition &start_co
       ip_dip_switch_ { DEV_DIP_SWITCH_VALUE },
       persistence_provider_ { persistence_file_path, ip_dip_switch_, static_cast<uint32_t>(netdev_manager_.GetNetDevs({DeviceType::Port}).size()) },
       bridge_manager_ { netdev_manager_, mac_distributor_, stp_, device_type_label_.GetOrderNumber() },
-      interface_manager_ { netdev_manager_, persistence_provider_, ethernet_interface_factory_ },
+      port_status_snapshot_ { ethtool_netlink_, *link_cache_ },
+      ethernet_interface_factory_ { port_status_snapshot_ },
+      interface_manager_ { netdev_manager_, persistence_provider_, ethernet_interface_factory_, *link_cache_ },
       dyn_ip_client_admin_ {device_type_label_.GetOrderNumber() },
       hostname_manager_{device_type_label_.GetMac()},
       ip_manager_ { event_manager_, persistence_provider_, netdev_manager_, ip_dip_switch_, interface_manager_,
@@ -216,6 +230,15 @@ NetworkConfiguratorImpl::NetworkConfiguratorImpl(InterprocessCondition &start_co
     return this->network_config_brain_.DeleteInterface(data);
   });
 
+  // The client scripts send their events by dbus if the socket is not available.
+  try {
+    lease_event_socket_ = ::std::make_unique<LeaseEventSocket>(
+        [this](const LeaseEvent &event) { this->network_config_brain_.ReceiveLeaseEvent(event); },
+        lease_event_socket_path);
+  } catch (::std::system_error &e) {
+    LogWarning("Lease event socket not available: "s + e.what());
+  }
+
   LogInfo("NetworkConfigurator completed DBUS registration");
   start_condition.Notify();
 
@@ -223,9 +246,10 @@ NetworkConfiguratorImpl::NetworkConfiguratorImpl(InterprocessCondition &start_co
   LogInfo("NetworkConfigurator ready");
 }
 
-NetworkConfigurator::NetworkConfigurator(InterprocessCondition &start_condition,
+NetworkConfigurator::NetworkConfigurator(InterprocessCondition &start_condition, ::std::string lease_event_socket_path,
                                          StartWithPortstate startWithPortState) {
-  network_configurator_ = ::std::make_unique<NetworkConfiguratorImpl>(start_condition, startWithPortState);
+  network_configurator_ =
+      ::std::make_unique<NetworkConfiguratorImpl>(start_condition, lease_event_socket_path, startWithPortState);
 }
 
 NetworkConfigurator::~NetworkConfigurator() {
@@ -4,6 +4,7 @@
 
 
 #include <memory>
+#include <string>
 #include "InterprocessCondition.h"
 #include "NetworkConfiguratorSettings.hpp"
 
@@ -14,7 +15,8 @@ class NetworkConfiguratorImpl;
 class NetworkConfigurator {
 
  public:
-  explicit NetworkConfigurator(InterprocessCondition& start_condition, StartWithPortstate startWithPortState = StartWithPortstate::Normal);
+  NetworkConfigurator(InterprocessCondition& start_condition, ::std::string lease_event_socket_path,
+                      StartWithPortstate startWithPortState = StartWithPortstate::Normal);
   virtual ~NetworkConfigurator();
 
   NetworkConfigurator(const NetworkConfigurator&) = delete;
@@ -4,6 +4,7 @@
 
 #include <sstream>
 #include <cmath>
+#include <map>
 
 #include <vector>
 #include <boost/algorithm/string/predicate.hpp>
@@ -18,11 +19,12 @@ namespace netconf {
 
 using namespace std::literals::string_literals;
 
-static Status GetKeyValue(const ::std::string &backup_content, const ::std::string &key, ::std::string &value) {
+static Status GetKeyValue(const ::std::map<::std::string, ::std::string> &backup_values, const ::std::string &key,
+                          ::std::string &value) {
 
   Status status;
 
-  value = GetValueByKey(backup_content, key);
+  value = backup_values.at(key);
 
   if (value.empty()) {
     status.Set(StatusCode::BACKUP_CONTENT_MISSING, key);
@@ -41,43 +43,34 @@ uint32_t BackupRestore::GetBackupParameterCount() const {
   return 2;
 }
 
-Status BackupRestore::AppendTextWithKeyAndSeparateOnNewLine(const ::std::string &file_path, const ::std::string &key,
+void BackupRestore::AppendTextWithKeyAndSeparateOnNewLine(::std::string &backup_content, const ::std::string &key,
                                                            const ::std::string &data) const {
 
-  Status status;
+  backup_content.reserve(backup_content.size() + data.size() + (data.size() / chars_per_line_ + 1) * (key.size() + 2));
 
   auto lines = static_cast<uint32_t>(::std::floor(data.size() / chars_per_line_));
   for (uint32_t line = 0; line < lines; line++) {
-    ::std::string substring = data.substr(line * chars_per_line_, chars_per_line_);
-    substring = key + '=' + substring + '\n';
-    status = file_editor_.Append(file_path, substring);
-    if (status.IsNotOk()) {
-      break;
-    }
+    backup_content.append(key).append(1, '=').append(data, line * chars_per_line_, chars_per_line_).append(1, '\n');
   }
 
   uint32_t remaining_chars = data.size() % chars_per_line_;
   if (remaining_chars > 0) {
-    ::std::string substring = data.substr(lines * chars_per_line_, data.size());
-    substring = key + '=' + substring + '\n';
-    status = file_editor_.Append(file_path, substring);
+    backup_content.append(key).append(1, '=').append(data, lines * chars_per_line_, remaining_chars).append(1, '\n');
   }
-
-  return status;
 }
 
 Status BackupRestore::Backup(const ::std::string &file_path, const ::std::string &network_data,
                             const ::std::string &dip_switch_data, uint32_t version) const {
 
-  Status status = AppendTextWithKeyAndSeparateOnNewLine(file_path, KEY_NETCONFD_VERSION, ::std::to_string(version));
-  if (status.IsOk()) {
-    status = AppendTextWithKeyAndSeparateOnNewLine(file_path, KEY_NETCONFD_NETWORK_DATA, network_data);
-  }
-  if (status.IsOk() && not dip_switch_data.empty()) {
-    status = AppendTextWithKeyAndSeparateOnNewLine(file_path, KEY_NETCONFD_DIPSWITCH_DATA, dip_switch_data);
+  // Collect all lines and append them at once, the file editor syncs the file with every append.
+  ::std::string backup_content;
+  AppendTextWithKeyAndSeparateOnNewLine(backup_content, KEY_NETCONFD_VERSION, ::std::to_string(version));
+  AppendTextWithKeyAndSeparateOnNewLine(backup_content, KEY_NETCONFD_NETWORK_DATA, network_data);
+  if (not dip_switch_data.empty()) {
+    AppendTextWithKeyAndSeparateOnNewLine(backup_content, KEY_NETCONFD_DIPSWITCH_DATA, dip_switch_data);
   }
 
-  return status;
+  return file_editor_.Append(file_path, backup_content);
 
 }
 
@@ -89,9 +82,13 @@ Status BackupRestore::Restore(const ::std::string &file_path, ::std::string &bac
 
   Status status = file_editor_.Read(file_path, backup_content);
 
+  // The backup file contains the values of all backup parameters, parse it once for all netconfd keys.
+  auto backup_values = GetValuesByKeys(backup_content,
+                                       {KEY_NETCONFD_VERSION, KEY_NETCONFD_NETWORK_DATA, KEY_NETCONFD_DIPSWITCH_DATA});
+
   auto stored_version = ::std::string { };
   if (status.IsOk()) {
-    status = GetKeyValue(backup_content, KEY_NETCONFD_VERSION, stored_version);
+    status = GetKeyValue(backup_values, KEY_NETCONFD_VERSION, stored_version);
 
   }
 
@@ -104,11 +101,11 @@ Status BackupRestore::Restore(const ::std::string &file_path, ::std::string &bac
   }
 
   if (status.IsOk()) {
-    status = GetKeyValue(backup_content, KEY_NETCONFD_NETWORK_DATA, backup_network_data);
+    status = GetKeyValue(backup_values, KEY_NETCONFD_NETWORK_DATA, backup_network_data);
   }
 
   if (status.IsOk()) {
-    GetKeyValue(backup_content, KEY_NETCONFD_DIPSWITCH_DATA, backup_dipswitch_data);
+    GetKeyValue(backup_values, KEY_NETCONFD_DIPSWITCH_DATA, backup_dipswitch_data);
   }
 
   return status;
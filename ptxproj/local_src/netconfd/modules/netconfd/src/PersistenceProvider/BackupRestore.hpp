@@ -30,7 +30,7 @@ class BackupRestore : public IBackupRestore {
   const ::std::string KEY_NETCONFD_DIPSWITCH_DATA = "network.dipswitch";
  private:
 
-  Status AppendTextWithKeyAndSeparateOnNewLine(const ::std::string& file_path, const ::std::string& key, const ::std::string& data) const;
+  void AppendTextWithKeyAndSeparateOnNewLine(::std::string& backup_content, const ::std::string& key, const ::std::string& data) const;
 
 
   IFileEditor& file_editor_;
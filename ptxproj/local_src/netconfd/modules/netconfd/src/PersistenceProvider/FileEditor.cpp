@@ -4,18 +4,57 @@
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
 #include <unistd.h>
 #include <sys/stat.h>
 
 namespace netconf {
 
+namespace {
+
+bool WriteAll(int fd, const ::std::string& data) {
+  const char* pos = data.data();
+  auto remaining = data.size();
+  while (remaining > 0) {
+    auto written = ::write(fd, pos, remaining);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    pos += written;
+    remaining -= static_cast<size_t>(written);
+  }
+  return true;
+}
+
+// Makes a rename in the directory of the file persistent.
+void SyncDirectory(const ::std::string& file_path) {
+  auto separator = file_path.find_last_of('/');
+  auto directory = (separator == ::std::string::npos) ? ::std::string{"."} : file_path.substr(0, separator + 1);
+
+  int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd >= 0) {
+    ::fsync(fd);
+    ::close(fd);
+  }
+}
+
+}  // namespace
+
 Status FileEditor::Read(const ::std::string& file_path, ::std::string& data) const {
 
   ::std::ifstream stream(file_path);
 
   if (stream.good()) {
-    data = ::std::string((std::istreambuf_iterator<char>(stream)),
-                         std::istreambuf_iterator<char>());
+    // Copy the stream buffer at once, reading it char by char is slow for large backup files.
+    ::std::ostringstream content;
+    content << stream.rdbuf();
+    data = content.str();
     stream.close();
 
   } else {
@@ -47,52 +86,42 @@ Status FileEditor::Write(const ::std::string& file_path,
 
 Status FileEditor::WriteAndReplace(const ::std::string& file_path,
                          const ::std::string& data) const {
-  Status status(StatusCode::OK);
-
   ::std::string file_path_tmp = file_path + ".tmp";
 
   umask(0022);
 
-  ::std::ofstream stream(file_path_tmp);
-
-  if (stream.good()) {
-
-    stream << data;
-    stream.flush();
-    stream.close();
-
-    sync();
-    ::std::rename(file_path_tmp.c_str(), file_path.c_str());
-    sync();
+  /* Only the written file and its directory are synced. A global sync() would flush all dirty pages of
+   * all file systems and delays the caller by the amount of data other processes have written. */
+  int fd = ::open(file_path_tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    return Status{StatusCode::FILE_WRITE, file_path};
+  }
 
-  } else {
+  bool written = WriteAll(fd, data) && ::fsync(fd) == 0;
+  written = (::close(fd) == 0) && written;
+  if (not written || ::rename(file_path_tmp.c_str(), file_path.c_str()) != 0) {
+    ::unlink(file_path_tmp.c_str());
     return Status{StatusCode::FILE_WRITE, file_path};
   }
 
-  return status;
+  SyncDirectory(file_path);
+
+  return {};
 }
 
 Status FileEditor::Append(const ::std::string& file_path,
                           const ::std::string& data) const {
 
-  ::std::ifstream in_stream(file_path);
-  if (not in_stream.good()) {
+  // The file has to exist already, O_APPEND without O_CREAT fails otherwise.
+  int fd = ::open(file_path.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+  if (fd < 0) {
     return Status{StatusCode::FILE_WRITE, file_path};
   }
-  in_stream.close();
-
-  ::std::ofstream stream;
-  stream.open(file_path, ::std::ios_base::app);
 
-  if (stream.good()) {
-
-    stream << data;
-    stream.flush();
-    stream.close();
-
-    sync();
-
-  } else {
+  // fdatasync includes the file size, the other metadata does not need to be written.
+  bool written = WriteAll(fd, data) && ::fdatasync(fd) == 0;
+  written = (::close(fd) == 0) && written;
+  if (not written) {
     return Status{StatusCode::FILE_WRITE, file_path };
   }
 
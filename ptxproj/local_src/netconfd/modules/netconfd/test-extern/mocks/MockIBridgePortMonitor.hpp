@@ -0,0 +1,19 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <gmock/gmock.h>
+
+#include "../../../utility/extern/IBridgePortMonitor.hpp"
+
+namespace netconf {
+
+class MockIBridgePortMonitor : public IBridgePortMonitor {
+ public:
+
+  MOCK_METHOD1(GetBridgePortInfo, ::std::optional<BridgePortInfo>(::std::uint32_t if_index) );
+  MOCK_METHOD1(GetMacLearning, MacLearning(::std::uint32_t if_index) );
+  MOCK_METHOD2(SetMacLearning, void(::std::uint32_t if_index, MacLearning learning) );
+
+};
+
+}  // namespace netconf
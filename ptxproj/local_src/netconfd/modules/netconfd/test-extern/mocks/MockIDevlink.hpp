@@ -0,0 +1,18 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <gmock/gmock.h>
+
+#include "../../../utility/extern/IDevlink.hpp"
+
+namespace netconf {
+
+class MockIDevlink : public IDevlink {
+ public:
+
+  MOCK_METHOD2(GetBoolParameter, ::std::optional<bool>(const ::std::string& device, const ::std::string& name) );
+  MOCK_METHOD3(SetBoolParameter, Status(const ::std::string& device, const ::std::string& name, bool value) );
+
+};
+
+}  // namespace netconf
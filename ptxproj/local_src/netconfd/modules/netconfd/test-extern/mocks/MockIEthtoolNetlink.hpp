@@ -0,0 +1,18 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <gmock/gmock.h>
+
+#include "../../../utility/extern/IEthtoolNetlink.hpp"
+
+namespace netconf {
+
+class MockIEthtoolNetlink : public IEthtoolNetlink {
+ public:
+
+  MOCK_METHOD0(IsAvailable, bool() );
+  MOCK_METHOD1(GetPorts, Status(EthtoolPorts& ports) );
+
+};
+
+}  // namespace netconf
@@ -16,6 +16,9 @@ class MockIInterfaceMonitor : public IInterfaceMonitor {
   MOCK_METHOD0(GetLinks, Links() );
   MOCK_METHOD1(GetIffFlags, ::std::uint32_t(::std::uint32_t if_index) );
   MOCK_METHOD1(GetAddressFamily, ::std::int32_t(::std::uint32_t if_index) );
+  MOCK_METHOD1(GetMtu, ::std::uint32_t(::std::uint32_t if_index) );
+  MOCK_METHOD1(GetMac, ::std::string(::std::uint32_t if_index) );
+  MOCK_METHOD0(GetChangeCount, ::std::uint64_t() );
 
 };
 
@@ -0,0 +1,120 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "BackupRestore.hpp"
+#include "CommonTestDependencies.hpp"
+#include "FileEditor.hpp"
+#include "KeyValueParser.hpp"
+#include "MockIFileEditor.hpp"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+
+namespace netconf {
+
+class BackupRestoreIoTest : public testing::TestWithParam<::std::size_t> {
+ public:
+  ::std::filesystem::path directory_;
+  ::std::filesystem::path backup_file_;
+  FileEditor file_editor_;
+  // Forwards to the real file editor, every append is synced to the storage by it.
+  NiceMock<MockIFileEditor> file_editor_mock_;
+
+  void SetUp() override {
+    ON_CALL(file_editor_mock_, Read(_, _)).WillByDefault(Invoke(&file_editor_, &FileEditor::Read));
+    ON_CALL(file_editor_mock_, Append(_, _)).WillByDefault(Invoke(&file_editor_, &FileEditor::Append));
+
+    char path[] = "/tmp/backup_restore_io_test_XXXXXX";
+    ASSERT_NE(nullptr, ::mkdtemp(path));
+    directory_   = path;
+    backup_file_ = directory_ / "backup";
+    // the backup script creates the file, netconfd appends to it
+    ::std::ofstream{backup_file_};
+  }
+
+  void TearDown() override {
+    ::std::filesystem::remove_all(directory_);
+  }
+
+  // Network data of a configuration with many bridges and interfaces, the content does not matter.
+  static ::std::string CreateNetworkData(::std::size_t size) {
+    ::std::string data;
+    while (data.size() < size) {
+      data.append(R"({"bridge-config":{"br0":["ethX1","ethX2"]},"ip-config":{"br0":{"source":"static"}}})");
+    }
+    data.resize(size);
+    return data;
+  }
+};
+
+TEST_P(BackupRestoreIoTest, WritesBackupWithOneSyncedAppend) {
+  BackupRestore backup_restore{file_editor_mock_, 75};
+  auto network_data = CreateNetworkData(GetParam());
+
+  EXPECT_CALL(file_editor_mock_, Append(backup_file_.string(), _)).Times(1);
+  EXPECT_CALL(file_editor_mock_, Write(_, _)).Times(0);
+  EXPECT_CALL(file_editor_mock_, WriteAndReplace(_, _)).Times(0);
+  auto status = backup_restore.Backup(backup_file_, network_data, "dipswitch", 2);
+
+  ASSERT_EQ(StatusCode::OK, status.GetStatusCode());
+
+  ::std::string restored_data;
+  ::std::string restored_dipswitch;
+  uint32_t version = 0;
+  status = backup_restore.Restore(backup_file_, restored_data, restored_dipswitch, version);
+  ASSERT_EQ(StatusCode::OK, status.GetStatusCode());
+  EXPECT_EQ(network_data, restored_data);
+  EXPECT_EQ(2, version);
+}
+
+TEST_P(BackupRestoreIoTest, RestoresFirmwareBackupInOnePass) {
+  BackupRestore backup_restore{file_editor_mock_, 75};
+  auto network_data = CreateNetworkData(GetParam());
+
+  // The firmware backup writes the settings of the other config tools before and after netconfd.
+  {
+    ::std::ofstream backup{backup_file_};
+    for (int i = 0; i < 200; ++i) {
+      backup << "default-gw-" << i << "-state=disabled\nntp-timeserver-" << i << "=0.0.0.0\n";
+    }
+  }
+  ASSERT_EQ(StatusCode::OK, backup_restore.Backup(backup_file_, network_data, "dipswitch", 2).GetStatusCode());
+  {
+    ::std::ofstream backup{backup_file_, ::std::ios::app};
+    backup << "hostname=PFC-4711\ndomain-name=local\n";
+  }
+
+  ::std::string restored_data;
+  ::std::string restored_dipswitch;
+  uint32_t version = 0;
+  EXPECT_CALL(file_editor_mock_, Read(backup_file_.string(), _)).Times(1);
+  auto status = backup_restore.Restore(backup_file_, restored_data, restored_dipswitch, version);
+
+  ASSERT_EQ(StatusCode::OK, status.GetStatusCode());
+  EXPECT_EQ(network_data, restored_data);
+  EXPECT_EQ("dipswitch", restored_dipswitch);
+  EXPECT_EQ(2, version);
+
+  // The values parsed in one pass match a scan of the backup content per key.
+  ::std::string content;
+  ASSERT_EQ(StatusCode::OK, file_editor_.Read(backup_file_, content).GetStatusCode());
+  const ::std::vector<::std::string> keys = {"network.version", "network.data", "network.dipswitch"};
+  auto values = GetValuesByKeys(content, keys);
+  for (const auto &key : keys) {
+    EXPECT_EQ(GetValueByKey(content, key), values.at(key));
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(NetworkDataSizes, BackupRestoreIoTest,
+                         testing::Values<::std::size_t>(4096, 65536, 1048576, 4194304));
+
+}  // namespace netconf
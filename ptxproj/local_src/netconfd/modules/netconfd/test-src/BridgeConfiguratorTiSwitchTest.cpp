@@ -0,0 +1,142 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "BridgeConfiguratorTiSwitch.hpp"
+#include "CommonTestDependencies.hpp"
+#include "MockIBridgeChangeEvent.hpp"
+#include "MockIDevlink.hpp"
+#include "MockINetDevManager.hpp"
+#include "Types.hpp"
+
+using testing::_;
+using testing::InSequence;
+using testing::Return;
+using testing::StrictMock;
+
+namespace netconf {
+
+class BridgeConfiguratorTiSwitchTest : public testing::Test {
+ public:
+  StrictMock<MockINetDevManager> mock_netdev_manager_;
+  StrictMock<MockIBridgeChangeEvent> mock_bridge_change_event_;
+  StrictMock<MockIDevlink> mock_devlink_;
+  BridgeConfiguratorTiSwitch bridge_configurator_{mock_netdev_manager_, mock_bridge_change_event_, mock_devlink_};
+
+  const Interface br0_   = Interface::CreateBridge("br0");
+  const Interface br1_   = Interface::CreateBridge("br1");
+  const Interface ethX1_ = Interface::CreatePort("ethX1");
+  const Interface ethX2_ = Interface::CreatePort("ethX2");
+
+  void ExpectSwitchMode(bool switch_mode) {
+    EXPECT_CALL(mock_devlink_, GetBoolParameter("platform/8000000.ethernet", "switch_mode"))
+        .WillRepeatedly(Return(switch_mode));
+  }
+
+  void ExpectNoLinkDisruption() {
+    EXPECT_CALL(mock_netdev_manager_, BridgePortLeave(_)).Times(0);
+    EXPECT_CALL(mock_netdev_manager_, BridgePortJoin(_, _)).Times(0);
+    EXPECT_CALL(mock_netdev_manager_, SetUp(ethX1_)).Times(0);
+    EXPECT_CALL(mock_netdev_manager_, SetUp(ethX2_)).Times(0);
+    EXPECT_CALL(mock_devlink_, SetBoolParameter(_, _, _)).Times(0);
+  }
+};
+
+TEST_F(BridgeConfiguratorTiSwitchTest, ReapplySwitchModeConfigurationWithoutLinkDisruption) {
+  BridgeConfig config = {{br0_, {ethX1_, ethX2_}}};
+
+  ExpectSwitchMode(true);
+  EXPECT_CALL(mock_netdev_manager_, GetBridgesWithAssignetPort()).WillRepeatedly(Return(Interfaces{br0_}));
+  EXPECT_CALL(mock_netdev_manager_, GetPorts(br0_)).WillRepeatedly(Return(Interfaces{ethX1_, ethX2_}));
+  EXPECT_CALL(mock_netdev_manager_, SetUp(br0_)).Times(3);
+  ExpectNoLinkDisruption();
+
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(StatusCode::OK, bridge_configurator_.Configure(config).GetStatusCode());
+  }
+}
+
+TEST_F(BridgeConfiguratorTiSwitchTest, ReapplySeparatedPortsConfigurationWithoutLinkDisruption) {
+  BridgeConfig config = {{br0_, {ethX1_}}, {br1_, {ethX2_}}};
+
+  ExpectSwitchMode(false);
+  EXPECT_CALL(mock_netdev_manager_, GetBridgesWithAssignetPort()).WillRepeatedly(Return(Interfaces{br0_, br1_}));
+  EXPECT_CALL(mock_netdev_manager_, GetPorts(br0_)).WillRepeatedly(Return(Interfaces{ethX1_}));
+  EXPECT_CALL(mock_netdev_manager_, GetPorts(br1_)).WillRepeatedly(Return(Interfaces{ethX2_}));
+  EXPECT_CALL(mock_netdev_manager_, SetUp(br0_)).Times(3);
+  EXPECT_CALL(mock_netdev_manager_, SetUp(br1_)).Times(3);
+  ExpectNoLinkDisruption();
+
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(StatusCode::OK, bridge_configurator_.Configure(config).GetStatusCode());
+  }
+}
+
+TEST_F(BridgeConfiguratorTiSwitchTest, ChangeToSwitchModeDetachesPorts) {
+  BridgeConfig config = {{br0_, {ethX1_, ethX2_}}};
+
+  ExpectSwitchMode(false);
+  EXPECT_CALL(mock_netdev_manager_, GetBridgesWithAssignetPort()).WillRepeatedly(Return(Interfaces{br0_, br1_}));
+  EXPECT_CALL(mock_netdev_manager_, SetDown(br1_));
+  EXPECT_CALL(mock_netdev_manager_, Delete(br1_)).WillOnce(Return(Status{}));
+  EXPECT_CALL(mock_bridge_change_event_, OnBridgeRemove(br1_));
+  EXPECT_CALL(mock_netdev_manager_, GetPorts(br0_))
+      .WillOnce(Return(Interfaces{ethX1_}))
+      .WillOnce(Return(Interfaces{}));
+
+  EXPECT_CALL(mock_netdev_manager_, BridgePortLeave(ethX1_));
+  EXPECT_CALL(mock_netdev_manager_, BridgePortLeave(ethX2_));
+  EXPECT_CALL(mock_devlink_, SetBoolParameter("platform/8000000.ethernet", "switch_mode", true))
+      .WillOnce(Return(Status{}));
+
+  {
+    InSequence s;
+    EXPECT_CALL(mock_netdev_manager_, SetUp(ethX1_));
+    EXPECT_CALL(mock_netdev_manager_, BridgePortJoin(ethX1_, br0_)).WillOnce(Return(Status{}));
+    EXPECT_CALL(mock_netdev_manager_, SetUp(ethX2_));
+    EXPECT_CALL(mock_netdev_manager_, BridgePortJoin(ethX2_, br0_)).WillOnce(Return(Status{}));
+  }
+  EXPECT_CALL(mock_netdev_manager_, SetUp(br0_));
+
+  EXPECT_EQ(StatusCode::OK, bridge_configurator_.Configure(config).GetStatusCode());
+}
+
+TEST_F(BridgeConfiguratorTiSwitchTest, SetUpPortJoiningABridgeWithoutModeChange) {
+  BridgeConfig config = {{br0_, {ethX1_}}, {br1_, {ethX2_}}};
+
+  ExpectSwitchMode(false);
+  EXPECT_CALL(mock_netdev_manager_, GetBridgesWithAssignetPort()).WillRepeatedly(Return(Interfaces{br0_}));
+  EXPECT_CALL(mock_netdev_manager_, GetPorts(br0_)).WillRepeatedly(Return(Interfaces{ethX1_}));
+  EXPECT_CALL(mock_netdev_manager_, BridgePortLeave(_)).Times(0);
+  EXPECT_CALL(mock_devlink_, SetBoolParameter(_, _, _)).Times(0);
+
+  EXPECT_CALL(mock_netdev_manager_, AddInterface(br1_)).WillOnce(Return(Status{}));
+  {
+    InSequence s;
+    EXPECT_CALL(mock_netdev_manager_, SetUp(ethX2_));
+    EXPECT_CALL(mock_netdev_manager_, BridgePortJoin(ethX2_, br1_)).WillOnce(Return(Status{}));
+  }
+  EXPECT_CALL(mock_bridge_change_event_, OnBridgeAddOrPortChange(br1_, Interfaces{ethX2_}));
+  EXPECT_CALL(mock_netdev_manager_, SetUp(br0_));
+  EXPECT_CALL(mock_netdev_manager_, SetUp(br1_));
+
+  EXPECT_EQ(StatusCode::OK, bridge_configurator_.Configure(config).GetStatusCode());
+}
+
+TEST_F(BridgeConfiguratorTiSwitchTest, SetSwitchModeIfCurrentModeIsUnknown) {
+  BridgeConfig config = {{br0_, {ethX1_}}, {br1_, {ethX2_}}};
+
+  EXPECT_CALL(mock_devlink_, GetBoolParameter(_, _)).WillOnce(Return(::std::nullopt));
+  EXPECT_CALL(mock_netdev_manager_, GetBridgesWithAssignetPort()).WillOnce(Return(Interfaces{br0_, br1_}));
+  EXPECT_CALL(mock_netdev_manager_, GetPorts(br0_)).WillRepeatedly(Return(Interfaces{ethX1_}));
+  EXPECT_CALL(mock_netdev_manager_, GetPorts(br1_)).WillRepeatedly(Return(Interfaces{ethX2_}));
+
+  EXPECT_CALL(mock_netdev_manager_, BridgePortLeave(ethX1_));
+  EXPECT_CALL(mock_netdev_manager_, BridgePortLeave(ethX2_));
+  EXPECT_CALL(mock_devlink_, SetBoolParameter("platform/8000000.ethernet", "switch_mode", false))
+      .WillOnce(Return(Status{}));
+  EXPECT_CALL(mock_netdev_manager_, SetUp(br0_));
+  EXPECT_CALL(mock_netdev_manager_, SetUp(br1_));
+
+  EXPECT_EQ(StatusCode::OK, bridge_configurator_.Configure(config).GetStatusCode());
+}
+
+}  // namespace netconf
@@ -0,0 +1,257 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <glib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CommonTestDependencies.hpp"
+#include "DHCPClient.hpp"
+
+namespace netconf {
+
+using namespace std::chrono_literals;
+using Clock = ::std::chrono::steady_clock;
+
+// Timeouts of the clients under test; they fire when the test says so, not after their interval.
+class FakeTimer {
+ public:
+  struct Timeout {
+    guint id;
+    guint interval_ms;
+    GSourceFunc function;
+    gpointer data;
+  };
+
+  static DHCPClientTimer Get() {
+    return DHCPClientTimer{&FakeTimer::Add, &FakeTimer::Remove};
+  }
+
+  static ::std::vector<Timeout> &Pending() {
+    static ::std::vector<Timeout> pending;
+    return pending;
+  }
+
+  // Fires the oldest pending timeout.
+  static void Fire() {
+    ASSERT_FALSE(Pending().empty());
+    auto timeout = Pending().front();
+    Pending().erase(Pending().begin());
+    EXPECT_EQ(G_SOURCE_REMOVE, timeout.function(timeout.data));
+  }
+
+ private:
+  static guint Add(guint interval_ms, GSourceFunc function, gpointer data) {
+    static guint next_id = 0;
+    Pending().push_back(Timeout{++next_id, interval_ms, function, data});
+    return next_id;
+  }
+
+  static gboolean Remove(guint id) {
+    auto &pending = Pending();
+    auto it = ::std::find_if(pending.begin(), pending.end(), [id](const Timeout &t) { return t.id == id; });
+    if (it == pending.end()) {
+      return FALSE;
+    }
+    pending.erase(it);
+    return TRUE;
+  }
+};
+
+class DHCPClientTest : public testing::Test {
+ public:
+  ::std::filesystem::path directory_;
+  ::std::filesystem::path starts_file_;
+
+  void SetUp() override {
+    char path[] = "/tmp/dhcp_client_test_XXXXXX";
+    ASSERT_NE(nullptr, ::mkdtemp(path));
+    directory_   = path;
+    starts_file_ = directory_ / "starts";
+    FakeTimer::Pending().clear();
+  }
+
+  void TearDown() override {
+    // reap the killed clients
+    RunMainLoop(50ms);
+    ::std::filesystem::remove_all(directory_);
+  }
+
+  // Fake udhcpc: logs its start and keeps running or terminates at once.
+  ::std::string CreateClientScript(bool keep_running) {
+    auto script = directory_ / (keep_running ? "udhcpc" : "udhcpc_exit");
+    ::std::ofstream out{script};
+    out << "#!/bin/sh\n"
+        << "echo $$ >> " << starts_file_.string() << "\n"
+        << (keep_running ? "exec sleep 60\n" : "exit 1\n");
+    out.close();
+    ::chmod(script.c_str(), 0755);
+    return script;
+  }
+
+  size_t CountStarts() {
+    ::std::ifstream in{starts_file_};
+    ::std::string line;
+    size_t count = 0;
+    while (::std::getline(in, line)) {
+      ++count;
+    }
+    return count;
+  }
+
+  static void RunMainLoop(Clock::duration duration) {
+    auto end = Clock::now() + duration;
+    while (Clock::now() < end) {
+      g_main_context_iteration(nullptr, FALSE);
+      g_usleep(1000);
+    }
+  }
+
+  // Dispatches the main loop until done() holds; the deadline only keeps a broken test from hanging.
+  static bool RunMainLoopUntil(const ::std::function<bool()> &done) {
+    auto deadline = Clock::now() + 5s;
+    while (!done() && Clock::now() < deadline) {
+      g_main_context_iteration(nullptr, FALSE);
+      g_usleep(1000);
+    }
+    return done();
+  }
+
+  static ::std::vector<::std::shared_ptr<DHCPClient>> CreateClients(const ::std::string &script) {
+    ::std::vector<::std::shared_ptr<DHCPClient>> clients;
+    for (auto port : {"ethX1", "ethX2", "ethX11", "ethX12"}) {
+      clients.push_back(::std::make_shared<DHCPClient>(Interface::CreatePort(port), "hostname", "vendor", "", script,
+                                                       FakeTimer::Get()));
+    }
+    return clients;
+  }
+
+  static ::std::vector<guint> PendingIntervals() {
+    ::std::vector<guint> intervals;
+    for (auto &timeout : FakeTimer::Pending()) {
+      intervals.push_back(timeout.interval_ms);
+    }
+    return intervals;
+  }
+};
+
+::std::atomic<int> received_signals{0};
+
+void CountSignal(int) {
+  ++received_signals;
+}
+
+TEST_F(DHCPClientTest, SwitchFourPortsToDhcpWithoutBlocking) {
+  auto script = CreateClientScript(true);
+
+  // Runs like a D-Bus request on the main loop: the clients do not wait for their process, they leave that to a
+  // ready timeout each.
+  auto clients = CreateClients(script);
+
+  for (auto &client : clients) {
+    EXPECT_EQ(DHCPClient::State::STARTING, client->GetState());
+    EXPECT_GT(client->GetPid(), 0);
+  }
+  EXPECT_EQ(::std::vector<guint>(4, 5000), PendingIntervals());
+
+  EXPECT_TRUE(RunMainLoopUntil([&]() { return CountStarts() == 4; }));
+
+  for (auto &client : clients) {
+    client->NotifyEvent(DynamicIPEventAction::RELEASE);
+    EXPECT_EQ(DHCPClient::State::RUNNING, client->GetState());
+  }
+  EXPECT_TRUE(FakeTimer::Pending().empty());
+}
+
+TEST_F(DHCPClientTest, RestartAllClientsWithoutBlocking) {
+  auto script  = CreateClientScript(true);
+  auto clients = CreateClients(script);
+  ASSERT_TRUE(RunMainLoopUntil([&]() { return CountStarts() == 4; }));
+
+  ::std::vector<GPid> old_pids;
+  for (auto &client : clients) {
+    client->NotifyEvent(DynamicIPEventAction::RELEASE);
+    old_pids.push_back(client->GetPid());
+  }
+  EXPECT_TRUE(FakeTimer::Pending().empty());
+
+  for (auto &client : clients) {
+    client->RestartWithHostname("new-hostname");
+  }
+
+  for (size_t i = 0; i < clients.size(); ++i) {
+    EXPECT_EQ(DHCPClient::State::STARTING, clients[i]->GetState());
+    EXPECT_NE(old_pids[i], clients[i]->GetPid());
+  }
+  EXPECT_EQ(::std::vector<guint>(4, 5000), PendingIntervals());
+
+  EXPECT_TRUE(RunMainLoopUntil([&]() { return CountStarts() == 8; }));
+}
+
+TEST_F(DHCPClientTest, RestartTerminatedClientWithBackoff) {
+  auto script = CreateClientScript(false);
+  DHCPClient client{Interface::CreatePort("ethX1"), "hostname", "vendor", "", script, FakeTimer::Get()};
+
+  auto restart_pending = [&]() { return client.GetState() == DHCPClient::State::RESTART_PENDING; };
+  ASSERT_TRUE(RunMainLoopUntil(restart_pending));
+  EXPECT_EQ(0, client.GetPid());
+  EXPECT_EQ(1, CountStarts());
+
+  // the delay doubles with every failed start, the ready timeout of the failed one is gone
+  for (guint delay : {500U, 1000U, 2000U}) {
+    EXPECT_EQ(::std::vector<guint>{delay}, PendingIntervals());
+    FakeTimer::Fire();
+    EXPECT_EQ(DHCPClient::State::STARTING, client.GetState());
+    ASSERT_TRUE(RunMainLoopUntil(restart_pending));
+  }
+  EXPECT_EQ(4, CountStarts());
+  EXPECT_EQ(::std::vector<guint>{4000U}, PendingIntervals());
+}
+
+TEST_F(DHCPClientTest, RestartClientWithoutEventAfterReadyTimeout) {
+  auto script = CreateClientScript(true);
+  DHCPClient client{Interface::CreatePort("ethX1"), "hostname", "vendor", "", script, FakeTimer::Get()};
+  ASSERT_TRUE(RunMainLoopUntil([&]() { return CountStarts() == 1; }));
+
+  EXPECT_EQ(::std::vector<guint>{5000U}, PendingIntervals());
+  FakeTimer::Fire();
+  EXPECT_EQ(DHCPClient::State::RESTART_PENDING, client.GetState());
+  EXPECT_EQ(0, client.GetPid());
+  EXPECT_EQ(::std::vector<guint>{500U}, PendingIntervals());
+}
+
+TEST_F(DHCPClientTest, SignalsAreNotSentWithoutProcess) {
+  auto script = CreateClientScript(false);
+  DHCPClient client{Interface::CreatePort("ethX1"), "hostname", "vendor", "", script, FakeTimer::Get()};
+  ASSERT_TRUE(RunMainLoopUntil([&]() { return client.GetState() == DHCPClient::State::RESTART_PENDING; }));
+  ASSERT_EQ(0, client.GetPid());
+
+  // kill(0, ...) would hit the whole process group, this test included
+  struct sigaction count{};
+  struct sigaction old_usr1{};
+  struct sigaction old_usr2{};
+  count.sa_handler = CountSignal;
+  ::sigaction(SIGUSR1, &count, &old_usr1);
+  ::sigaction(SIGUSR2, &count, &old_usr2);
+  received_signals = 0;
+
+  client.Renew();
+  client.Release();
+
+  ::sigaction(SIGUSR1, &old_usr1, nullptr);
+  ::sigaction(SIGUSR2, &old_usr2, nullptr);
+  EXPECT_EQ(0, received_signals);
+}
+
+}  // namespace netconf
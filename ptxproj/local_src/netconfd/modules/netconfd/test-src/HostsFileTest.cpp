@@ -2,9 +2,20 @@
 
 #include "CommonTestDependencies.hpp"
 
+#include <glib.h>
+
+#include <chrono>
 #include <string>
 
 #include "HostsFile.hpp"
+#include "MockIFileEditor.hpp"
+
+using testing::_;
+using testing::DoAll;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+using testing::SaveArg;
 
 namespace netconf {
 
@@ -94,5 +105,56 @@ TEST(HostsFileTest, LeaveExistingLocalHostEntryUntouched) {
   EXPECT_EQ(expected_new_hosts, new_hosts);
 }
 
+class HostsFileUpdateTest : public testing::Test {
+ public:
+  NiceMock<MockIFileEditor> file_editor_;
+  ::std::string content_ = "127.0.0.1\tlocalhost\n";
+
+  void SetUp() override {
+    ON_CALL(file_editor_, Read(_, _)).WillByDefault(Invoke([this](const ::std::string &, ::std::string &data) {
+      data = content_;
+      return Status{};
+    }));
+    ON_CALL(file_editor_, WriteAndReplace(_, _)).WillByDefault(DoAll(SaveArg<1>(&content_), Return(Status{})));
+  }
+
+  static void RunMainLoop(::std::chrono::milliseconds duration) {
+    auto end = ::std::chrono::steady_clock::now() + duration;
+    while (::std::chrono::steady_clock::now() < end) {
+      g_main_context_iteration(nullptr, FALSE);
+      g_usleep(1000);
+    }
+  }
+};
+
+TEST_F(HostsFileUpdateTest, WritesBurstOfChangesOnce) {
+  EXPECT_CALL(file_editor_, WriteAndReplace("/etc/hosts", _)).Times(1);
+
+  HostsFile hosts_file{file_editor_};
+  for (int i = 0; i < 100; ++i) {
+    hosts_file.Update(::std::vector<Address>{Address{"192.168.1." + ::std::to_string(i)}}, "fred", "mydomain.org");
+  }
+  RunMainLoop(::std::chrono::milliseconds{300});
+
+  EXPECT_NE(::std::string::npos, content_.find("192.168.1.99\tfred.mydomain.org\tfred\n"));
+  EXPECT_EQ(::std::string::npos, content_.find("192.168.1.98\t"));
+}
+
+TEST_F(HostsFileUpdateTest, SkipsWriteOfUnchangedContent) {
+  EXPECT_CALL(file_editor_, WriteAndReplace(_, _)).Times(1);
+
+  HostsFile hosts_file{file_editor_};
+  for (int i = 0; i < 100; ++i) {
+    hosts_file.Update({"192.168.1.1", "192.168.2.1"}, "fred", "mydomain.org");
+    hosts_file.Flush();
+  }
+}
+
+TEST_F(HostsFileUpdateTest, WritesPendingUpdateOnDestruction) {
+  EXPECT_CALL(file_editor_, WriteAndReplace(_, _)).Times(1);
+
+  HostsFile hosts_file{file_editor_};
+  hosts_file.Update({"192.168.1.1"}, "fred", "");
+}
 
 }  // namespace netconf
@@ -1,6 +1,5 @@
 #pragma once
 
-#include "BridgeUtil.hpp"
 #include "InterfaceConfigManager.hpp"
 #include "IEthernetInterfaceFactory.hpp"
 #include "MacAddress.hpp"
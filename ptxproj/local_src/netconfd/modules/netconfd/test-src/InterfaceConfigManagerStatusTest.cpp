@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <memory>
+
+#include "CommonTestDependencies.hpp"
+#include "IEthernetInterfaceFactory.hpp"
+#include "InterfaceConfigManager.hpp"
+#include "InterfaceConfigManagerBaseTest.h"
+#include "LinkInfo.hpp"
+#include "MockIBridgePortMonitor.hpp"
+#include "MockINetDevManager.hpp"
+#include "MockIPersistencePortConfigs.hpp"
+
+using testing::_;
+using testing::NiceMock;
+using testing::Return;
+
+namespace netconf {
+
+class InterfaceConfigManagerStatusTest : public InterfaceConfigManagerBaseTest,
+                                         public testing::TestWithParam<::std::size_t> {
+ public:
+  NiceMock<MockINetDevManager> netdev_manager_;
+  NiceMock<MockIPersistencePortConfigs> persist_portconfig_mock_;
+  MockIBridgePortMonitor bridge_port_monitor_;
+  ::std::unique_ptr<InterfaceConfigManager> sut_;
+
+  ::std::unique_ptr<FakeEthernetInterfaceFactory> fake_fac_;
+
+  NetDevs netdevs_;
+
+  void SetUp() override {
+    for (int i = 1; i <= static_cast<int>(GetParam()); ++i) {
+      netdevs_.push_back(::std::make_shared<NetDev>(LinkInfo{i, "ethX" + ::std::to_string(i), "ethernet"}));
+    }
+
+    ON_CALL(netdev_manager_, GetNetDevs(_)).WillByDefault(Return(netdevs_));
+    ON_CALL(netdev_manager_, GetNetDevs()).WillByDefault(Return(netdevs_));
+    ON_CALL(persist_portconfig_mock_, Write(_)).WillByDefault(Return(Status{StatusCode::OK}));
+    ON_CALL(persist_portconfig_mock_, Read(_)).WillByDefault(Return(Status{StatusCode::PERSISTENCE_READ}));
+
+    fake_fac_ = ::std::make_unique<FakeEthernetInterfaceFactory>(*this);
+    sut_ = ::std::make_unique<InterfaceConfigManager>(netdev_manager_, persist_portconfig_mock_, *fake_fac_,
+                                                      bridge_port_monitor_);
+  }
+};
+
+TEST_P(InterfaceConfigManagerStatusTest, ReadsMacLearningOncePerPort) {
+  auto ports = GetParam();
+  EXPECT_CALL(bridge_port_monitor_, GetMacLearning(_)).Times(static_cast<int>(ports)).WillRepeatedly(Return(MacLearning::OFF));
+
+  InterfaceStatuses statuses;
+  auto status = sut_->GetCurrentPortStatuses(statuses);
+
+  EXPECT_EQ(StatusCode::OK, status.GetStatusCode());
+  ASSERT_EQ(ports, statuses.size());
+  for (auto &itf_status : statuses) {
+    EXPECT_EQ(MacLearning::OFF, itf_status.mac_learning_);
+  }
+}
+
+TEST_P(InterfaceConfigManagerStatusTest, AppliesMacLearningToBridgePort) {
+  EXPECT_CALL(bridge_port_monitor_, SetMacLearning(_, MacLearning::OFF)).Times(1);
+  EXPECT_CALL(bridge_port_monitor_, SetMacLearning(_, MacLearning::ON)).Times(static_cast<int>(GetParam() - 1));
+
+  auto status = sut_->Configure(InterfaceConfigs{InterfaceConfig{Interface::CreatePort("ethX1"), InterfaceState::UP,
+                                                                 Autonegotiation::ON, 100, Duplex::FULL, MacLearning::OFF}});
+
+  EXPECT_EQ(StatusCode::OK, status.GetStatusCode());
+}
+
+INSTANTIATE_TEST_SUITE_P(PortCounts, InterfaceConfigManagerStatusTest, testing::Values<::std::size_t>(2, 8, 32));
+
+}  // namespace netconf
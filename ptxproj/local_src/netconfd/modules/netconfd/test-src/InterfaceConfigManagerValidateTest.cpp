@@ -7,6 +7,7 @@
 #include "InterfaceConfigManager.hpp"
 #include "InterfaceConfigManagerBaseTest.h"
 #include "LinkInfo.hpp"
+#include "MockIBridgePortMonitor.hpp"
 #include "MockIEthernetInterface.hpp"
 #include "MockINetDevManager.hpp"
 #include "MockIPersistencePortConfigs.hpp"
@@ -21,6 +22,7 @@ class InterfaceConfigManagerValidateTest : public InterfaceConfigManagerBaseTest
  public:
   NiceMock<MockINetDevManager> netdev_manager_;
   NiceMock<MockIPersistencePortConfigs> persist_portconfig_mock_;
+  NiceMock<MockIBridgePortMonitor> bridge_port_monitor_;
   ::std::unique_ptr<InterfaceConfigManager> sut_;
 
   ::std::unique_ptr<FakeEthernetInterfaceFactory> fake_fac_;
@@ -45,7 +47,7 @@ class InterfaceConfigManagerValidateTest : public InterfaceConfigManagerBaseTest
   }
 
   void InstantiateSut() {
-    sut_ = ::std::make_unique<InterfaceConfigManager>(netdev_manager_, persist_portconfig_mock_, *fake_fac_);
+    sut_ = ::std::make_unique<InterfaceConfigManager>(netdev_manager_, persist_portconfig_mock_, *fake_fac_, bridge_port_monitor_);
     sut_->InitializePorts();
     EXPECT_EQ(netdevs_.size(), created_ethernet_interfaces.size());
   }
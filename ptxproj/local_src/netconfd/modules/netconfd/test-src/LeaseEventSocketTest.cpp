@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <glib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CommonTestDependencies.hpp"
+#include "LeaseEvent.hpp"
+#include "LeaseEventSocket.hpp"
+#include "LeaseFile.hpp"
+
+namespace netconf {
+
+using Clock = ::std::chrono::steady_clock;
+
+class LeaseEventSocketTest : public testing::Test {
+ public:
+  ::std::filesystem::path directory_;
+  ::std::string socket_path_;
+  ::std::vector<LeaseEvent> events_;
+  ::std::unique_ptr<LeaseEventSocket> sut_;
+
+  static constexpr auto lease_ =
+      "IPADDRESS=192.168.1.17\nNETMASK=255.255.255.0\nDEFAULT_GATEWAY_1=192.168.1.1\nDHCPHOSTNAME=PFC-4711\n"
+      "DHCPDOMAIN=local\nDNS_SERVER_1=192.168.1.1\nNTP_SERVER_1=192.168.1.1\n";
+
+  void SetUp() override {
+    char path[] = "/tmp/lease_event_socket_test_XXXXXX";
+    ASSERT_NE(nullptr, ::mkdtemp(path));
+    directory_   = path;
+    socket_path_ = directory_ / "lease-event.socket";
+    sut_ = ::std::make_unique<LeaseEventSocket>([this](const LeaseEvent &event) { events_.push_back(event); },
+                                                socket_path_);
+  }
+
+  void TearDown() override {
+    sut_.reset();
+    ::std::filesystem::remove_all(directory_);
+  }
+
+  void DispatchUntilReceived(::std::size_t count) {
+    auto deadline = Clock::now() + ::std::chrono::seconds{2};
+    while (events_.size() < count && Clock::now() < deadline) {
+      g_main_context_iteration(nullptr, FALSE);
+    }
+    ASSERT_EQ(count, events_.size());
+  }
+};
+
+TEST_F(LeaseEventSocketTest, ReceivesEventWithLease) {
+  ASSERT_EQ(StatusCode::OK,
+            SendLeaseEvent(LeaseEvent{"br0", DynamicIPEventAction::BOUND, lease_}, socket_path_).GetStatusCode());
+
+  DispatchUntilReceived(1);
+  EXPECT_EQ("br0", events_[0].interface_);
+  EXPECT_EQ(DynamicIPEventAction::BOUND, events_[0].action_);
+  EXPECT_EQ(lease_, events_[0].lease_);
+
+  LeaseFile lease;
+  lease.ParseContent(events_[0].lease_);
+  EXPECT_EQ("192.168.1.17", lease.GetAddress());
+  EXPECT_EQ("255.255.255.0", lease.GetNetmask());
+  EXPECT_EQ("PFC-4711", lease.GetDHCPHostname());
+  EXPECT_EQ("local", lease.GetDHCPDomain());
+}
+
+TEST_F(LeaseEventSocketTest, ReceivesEventsInOrder) {
+  ASSERT_EQ(StatusCode::OK,
+            SendLeaseEvent(LeaseEvent{"br0", DynamicIPEventAction::BOUND, lease_}, socket_path_).GetStatusCode());
+  ASSERT_EQ(StatusCode::OK,
+            SendLeaseEvent(LeaseEvent{"br0", DynamicIPEventAction::RELEASE, ""}, socket_path_).GetStatusCode());
+  ASSERT_EQ(StatusCode::OK,
+            SendLeaseEvent(LeaseEvent{"br1", DynamicIPEventAction::RENEW, lease_}, socket_path_).GetStatusCode());
+
+  DispatchUntilReceived(3);
+  EXPECT_EQ(DynamicIPEventAction::BOUND, events_[0].action_);
+  EXPECT_EQ(DynamicIPEventAction::RELEASE, events_[1].action_);
+  EXPECT_TRUE(events_[1].lease_.empty());
+  EXPECT_EQ("br1", events_[2].interface_);
+}
+
+TEST_F(LeaseEventSocketTest, SendFailsWithoutReceiver) {
+  sut_.reset();
+
+  // The client falls back to dbus in this case.
+  EXPECT_EQ(StatusCode::SYSTEM_CALL,
+            SendLeaseEvent(LeaseEvent{"br0", DynamicIPEventAction::BOUND, lease_}, socket_path_).GetStatusCode());
+}
+
+}  // namespace netconf
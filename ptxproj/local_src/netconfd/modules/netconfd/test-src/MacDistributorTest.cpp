@@ -8,6 +8,7 @@
 //------------------------------------------------------------------------------
 #include "CommonTestDependencies.hpp"
 #include "MacDistributor.hpp"
+#include <algorithm>
 #include <memory>
 #include <unistd.h>
 
@@ -41,6 +42,11 @@ ACTION_P(PutToAssignmentList, list){
   list.get().push_back( {netdev->GetInterface(), mac});
 }
 
+// Like the netlink link cache the netdev reports the written MAC afterwards.
+ACTION(UpdateNetDevMac){
+  SetNetDevMac(arg0, MacAddress::FromString(arg1));
+}
+
 class AMacDistributor : public testing::Test {
  public:
 
@@ -151,11 +157,6 @@ TEST_F(AMacDistributor, AssignsBridgesWithSinglePorts) {
   AssignPortsToBridge(br3, { ethX12 });
   netdevs.assign( { br0, br1, br2, br3, ethX1, ethX2, ethX11, ethX12 });
 
-  SetNetDevMac(br0, base_mac_);
-  SetNetDevMac(br1, base_mac_.Increment(1));
-  SetNetDevMac(br2, base_mac_.Increment(2));
-  SetNetDevMac(br3, base_mac_.Increment(3));
-
   EXPECT_CALL(mock_netdev_manager_, GetParent(ethX1)).WillOnce(Return(br0));
   EXPECT_CALL(mock_netdev_manager_, GetParent(ethX2)).WillOnce(Return(br1));
   EXPECT_CALL(mock_netdev_manager_, GetParent(ethX11)).WillOnce(Return(br2));
@@ -287,10 +288,6 @@ TEST_F(AMacDistributor, AssignsAlwaysSameMacsToBridges) {
   AssignPortsToBridge(br2, { ethX11, ethX12 });
   netdevs.assign( { br0, br1, br2, ethX1, ethX2, ethX11, ethX12 });
 
-  SetNetDevMac(br0, base_mac_);
-  SetNetDevMac(br1, base_mac_.Increment(1));
-  SetNetDevMac(br2, base_mac_.Increment(2));
-
   EXPECT_CALL(mock_netdev_manager_, GetParent(ethX1)).WillOnce(Return(br0));
   EXPECT_CALL(mock_netdev_manager_, GetParent(ethX2)).WillOnce(Return(br1));
   EXPECT_CALL(mock_netdev_manager_, GetParent(ethX11)).WillOnce(Return(br2));
@@ -313,4 +310,137 @@ TEST_F(AMacDistributor, AssignsAlwaysSameMacsToBridges) {
                                                ));
 }
 
+TEST_F(AMacDistributor, AssignsNoMacsOnIdempotentReconfiguration) {
+
+  CreateDistributorWithMacInc(6);
+
+  AssignPortsToBridge(br0, { ethX1, ethX2 });
+  AssignPortsToBridge(br2, { ethX11, ethX12 });
+  netdevs.assign( { br0, br2, ethX1, ethX2, ethX11, ethX12 });
+
+  EXPECT_CALL(mock_netdev_manager_, GetParent(ethX1)).WillRepeatedly(Return(br0));
+  EXPECT_CALL(mock_netdev_manager_, GetParent(ethX2)).WillRepeatedly(Return(br0));
+  EXPECT_CALL(mock_netdev_manager_, GetParent(ethX11)).WillRepeatedly(Return(br2));
+  EXPECT_CALL(mock_netdev_manager_, GetParent(ethX12)).WillRepeatedly(Return(br2));
+  EXPECT_CALL(mock_netdev_manager_, GetChildren(br0)).WillRepeatedly(Return(NetDevs{ethX1, ethX2}));
+  EXPECT_CALL(mock_netdev_manager_, GetChildren(br2)).WillRepeatedly(Return(NetDevs{ethX11, ethX12}));
+
+  EXPECT_CALL(mock_netdev_manager_, SetMac(_, _)).Times(6).WillRepeatedly(UpdateNetDevMac());
+  mac_distributor_->AssignMacs(netdevs);
+  testing::Mock::VerifyAndClearExpectations(&mock_netdev_manager_);
+
+  EXPECT_CALL(mock_netdev_manager_, GetParent(_)).WillRepeatedly([&](const NetDevPtr& port) {
+    return (port == ethX1 || port == ethX2) ? br0 : br2;
+  });
+  EXPECT_CALL(mock_netdev_manager_, GetChildren(br0)).WillRepeatedly(Return(NetDevs{ethX1, ethX2}));
+  EXPECT_CALL(mock_netdev_manager_, GetChildren(br2)).WillRepeatedly(Return(NetDevs{ethX11, ethX12}));
+  EXPECT_CALL(mock_netdev_manager_, SetMac(_, _)).Times(0);
+
+  mac_distributor_->AssignMacs(netdevs);
+  mac_distributor_->AssignMacs(netdevs);
+
+}
+
+TEST_F(AMacDistributor, AssignsOnlyChangedMacs) {
+
+  CreateDistributorWithMacInc(6);
+
+  SetNetDevMac(br0, base_mac_.Increment(0));
+  SetNetDevMac(br2, base_mac_.Increment(2));
+  SetNetDevMac(ethX1, base_mac_.Increment(1));
+  SetNetDevMac(ethX2, base_mac_.Increment(3));
+  SetNetDevMac(ethX11, base_mac_.Increment(4));
+  SetNetDevMac(ethX12, base_mac_.Increment(5));
+
+  AssignPortsToBridge(br0, { ethX1 });
+  AssignPortsToBridge(br1, { ethX2 });
+  AssignPortsToBridge(br2, { ethX11, ethX12 });
+  netdevs.assign( { br0, br1, br2, ethX1, ethX2, ethX11, ethX12 });
+
+  EXPECT_CALL(mock_netdev_manager_, GetParent(ethX1)).WillOnce(Return(br0));
+  EXPECT_CALL(mock_netdev_manager_, GetParent(ethX2)).WillOnce(Return(br1));
+  EXPECT_CALL(mock_netdev_manager_, GetParent(ethX11)).WillOnce(Return(br2));
+  EXPECT_CALL(mock_netdev_manager_, GetParent(ethX12)).WillOnce(Return(br2));
+  EXPECT_CALL(mock_netdev_manager_, GetChildren(br0)).WillRepeatedly(Return(NetDevs{ethX1}));
+  EXPECT_CALL(mock_netdev_manager_, GetChildren(br1)).WillRepeatedly(Return(NetDevs{ethX2}));
+  EXPECT_CALL(mock_netdev_manager_, GetChildren(br2)).WillRepeatedly(Return(NetDevs{ethX11, ethX12}));
+
+  EXPECT_CALL(mock_netdev_manager_, SetMac(_, _)).WillRepeatedly(PutToAssignmentList(std::ref(mac_assingment_list)));
+
+  mac_distributor_->AssignMacs(netdevs);
+
+  EXPECT_THAT(mac_assingment_list, ElementsAre(AssigmentPair { Interface::CreateBridge("br1"), base_mac_.Increment(1) },
+                                               AssigmentPair { Interface::CreatePort("ethX1"), base_mac_.Increment(0) },
+                                               AssigmentPair { Interface::CreatePort("ethX2"), base_mac_.Increment(1) },
+                                               AssigmentPair { Interface::CreatePort("ethX11"), base_mac_.Increment(3) },
+                                               AssigmentPair { Interface::CreatePort("ethX12"), base_mac_.Increment(4) }
+                                               ));
+}
+
+TEST_F(AMacDistributor, AssignsMacIfCurrentMacIsUnreadable) {
+
+  CreateDistributorWithMacInc(1);
+
+  auto link_info = br0->GetLinkInfo();
+  link_info.mac_ = "";
+  br0->SetLinkInfo(link_info);
+  SetNetDevMac(ethX1, base_mac_);
+
+  AssignPortsToBridge(br0, { ethX1 });
+  netdevs.assign( { br0, ethX1 });
+
+  EXPECT_CALL(mock_netdev_manager_, SetMac(_, _)).WillRepeatedly(PutToAssignmentList(std::ref(mac_assingment_list)));
+
+  mac_distributor_->AssignMacs(netdevs);
+
+  EXPECT_THAT(mac_assingment_list, ElementsAre(AssigmentPair { Interface::CreateBridge("br0"), base_mac_ }));
+}
+
+TEST_F(AMacDistributor, AssignsMacsOf64BridgesAndPorts) {
+  constexpr int bridge_count = 32;
+
+  CreateDistributorWithMacInc(bridge_count + bridge_count / 2);
+
+  NetDevs bridges;
+  NetDevs ports;
+  for (int i = 0; i < bridge_count; ++i) {
+    bridges.push_back(::std::make_shared<NetDev>(LinkInfo{100 + i, "br" + ::std::to_string(i), "bridge"}));
+    ports.push_back(::std::make_shared<NetDev>(LinkInfo{200 + i, "ethX" + ::std::to_string(i + 1), ""}));
+    AssignPortsToBridge(bridges.back(), { ports.back() });
+  }
+
+  EXPECT_CALL(mock_netdev_manager_, GetParent(_)).WillRepeatedly([&](const NetDevPtr& port) {
+    return bridges.at(static_cast<size_t>(port->GetParentIndex() - 100));
+  });
+  EXPECT_CALL(mock_netdev_manager_, GetChildren(_)).WillRepeatedly([&](const NetDevPtr& bridge) {
+    return NetDevs{ports.at(static_cast<size_t>(bridge->GetIndex() - 100))};
+  });
+
+  int mac_writes = 0;
+  EXPECT_CALL(mock_netdev_manager_, SetMac(_, _)).WillRepeatedly([&](const NetDevPtr& netdev, const ::std::string& mac) {
+    SetNetDevMac(netdev, MacAddress::FromString(mac));
+    ++mac_writes;
+  });
+
+  auto reversed = [&]() {
+    NetDevs all = ports;
+    all.insert(all.end(), bridges.begin(), bridges.end());
+    ::std::reverse(all.begin(), all.end());
+    return all;
+  };
+
+  netdevs = reversed();
+  mac_distributor_->AssignMacs(netdevs);
+  EXPECT_EQ(2 * bridge_count, mac_writes);
+  for (int i = 0; i < bridge_count; ++i) {
+    EXPECT_EQ(base_mac_.Increment(static_cast<uint32_t>(i)), ports.at(static_cast<size_t>(i))->GetMac());
+  }
+
+  // a second assignment of the unchanged devices writes nothing
+  mac_writes = 0;
+  netdevs = reversed();
+  mac_distributor_->AssignMacs(netdevs);
+  EXPECT_EQ(0, mac_writes);
+}
+
 } /* namespace netconf */
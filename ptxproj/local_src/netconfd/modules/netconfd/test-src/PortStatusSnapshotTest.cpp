@@ -0,0 +1,162 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <linux/ethtool.h>
+#include <linux/if.h>
+
+#include <memory>
+#include <string>
+
+#include "CommonTestDependencies.hpp"
+#include "EthernetInterface.hpp"
+#include "MockIEthtoolNetlink.hpp"
+#include "MockIInterfaceMonitor.hpp"
+#include "PortStatusSnapshot.hpp"
+
+using testing::_;
+using testing::DoAll;
+using testing::NiceMock;
+using testing::Return;
+using testing::SetArgReferee;
+
+namespace netconf {
+
+class PortStatusSnapshotTest : public testing::TestWithParam<::std::size_t> {
+ public:
+  NiceMock<MockIEthtoolNetlink> ethtool_;
+  NiceMock<MockIInterfaceMonitor> interface_monitor_;
+  ::std::unique_ptr<PortStatusSnapshot> sut_;
+
+  EthtoolPorts ports_;
+  ::std::uint64_t change_count_ = 0;
+
+  void SetUp() override {
+    for (::std::uint32_t i = 1; i <= GetParam(); ++i) {
+      EthtoolPort port;
+      port.index_          = i;
+      port.name_           = "ethX" + ::std::to_string(i);
+      port.speed_          = 100;
+      port.duplex_         = DUPLEX_FULL;
+      port.autoneg_        = AUTONEG_ENABLE;
+      port.port_           = PORT_TP;
+      port.link_           = (i % 2) != 0;
+      port.link_mode_bits_ = 92;
+      port.supported_      = {0x6fu, 0x1u, 0x2u};
+      port.advertising_    = {0x4fu, 0x0u, 0x0u};
+      port.lp_advertising_ = {0x0fu, 0x0u, 0x0u};
+      ports_.emplace(i, port);
+    }
+
+    ON_CALL(ethtool_, IsAvailable()).WillByDefault(Return(true));
+    ON_CALL(ethtool_, GetPorts(_)).WillByDefault(DoAll(SetArgReferee<0>(ports_), Return(Status{})));
+    ON_CALL(interface_monitor_, GetChangeCount()).WillByDefault([this]() { return change_count_; });
+    ON_CALL(interface_monitor_, GetIffFlags(_)).WillByDefault(Return(IFF_UP));
+    ON_CALL(interface_monitor_, GetMtu(_)).WillByDefault(Return(1500));
+    ON_CALL(interface_monitor_, GetMac(_)).WillByDefault(Return("00:30:de:11:22:33"));
+
+    sut_ = ::std::make_unique<PortStatusSnapshot>(ethtool_, interface_monitor_);
+  }
+
+  void QueryAllPorts(::std::size_t times) {
+    for (::std::size_t n = 0; n < times; ++n) {
+      for (auto &[index, port] : ports_) {
+        ASSERT_TRUE(sut_->GetPortStatus(port.name_).has_value());
+      }
+    }
+  }
+};
+
+TEST_P(PortStatusSnapshotTest, ReadsAllPortsWithOneRequest) {
+  EXPECT_CALL(ethtool_, GetPorts(_)).Times(1);
+
+  QueryAllPorts(10);
+}
+
+TEST_P(PortStatusSnapshotTest, ReadsAgainAfterLinkChange) {
+  EXPECT_CALL(ethtool_, GetPorts(_)).Times(2);
+
+  QueryAllPorts(3);
+  ++change_count_;
+  QueryAllPorts(3);
+}
+
+TEST_P(PortStatusSnapshotTest, ReadsAgainAfterInvalidate) {
+  EXPECT_CALL(ethtool_, GetPorts(_)).Times(2);
+
+  QueryAllPorts(1);
+  sut_->Invalidate("ethX1");
+  QueryAllPorts(3);
+}
+
+TEST_P(PortStatusSnapshotTest, ConvertsLinkSettings) {
+  auto status = sut_->GetPortStatus("ethX1");
+  ASSERT_TRUE(status.has_value());
+
+  EXPECT_EQ(1, status->if_index_);
+  EXPECT_EQ(1500, status->mtu_);
+  EXPECT_EQ(MacAddress::FromString("00:30:de:11:22:33"), status->mac_);
+  EXPECT_EQ(100, status->settings_.GetSpeed());
+  EXPECT_EQ(eth::Duplex::Full, status->settings_.GetDuplex());
+  EXPECT_TRUE(status->settings_.IsAutonegEnabled());
+  EXPECT_EQ(eth::MediaType::TP, status->settings_.GetMediaType());
+  EXPECT_EQ(eth::DeviceState::Up, status->settings_.GetIfState());
+  EXPECT_EQ(eth::InterfaceLinkState::Up, status->settings_.GetIfLinkState());
+
+  ASSERT_EQ(3, status->settings_.GetSupported().size());
+  EXPECT_EQ(0x6fu, status->settings_.GetSupported()[0]);
+  EXPECT_EQ(0x2u, status->settings_.GetSupported()[2]);
+  ASSERT_EQ(3, status->settings_.GetAutonegAdvertising().size());
+  EXPECT_EQ(0x4fu, status->settings_.GetAutonegAdvertising()[0]);
+}
+
+TEST_P(PortStatusSnapshotTest, ProvidesNoStatusWithoutEthtoolNetlink) {
+  EXPECT_CALL(ethtool_, IsAvailable()).WillRepeatedly(Return(false));
+  EXPECT_CALL(ethtool_, GetPorts(_)).Times(0);
+
+  EXPECT_FALSE(sut_->GetPortStatus("ethX1").has_value());
+}
+
+TEST_P(PortStatusSnapshotTest, ProvidesNoStatusIfRequestFails) {
+  EXPECT_CALL(ethtool_, GetPorts(_)).WillRepeatedly(Return(Status{StatusCode::SYSTEM_CALL}));
+
+  EXPECT_FALSE(sut_->GetPortStatus("ethX1").has_value());
+}
+
+TEST_P(PortStatusSnapshotTest, DoesNotRepeatFailedRequestBeforeRetryDelay) {
+  EXPECT_CALL(ethtool_, GetPorts(_)).WillOnce(Return(Status{StatusCode::SYSTEM_CALL}));
+
+  for (auto &[index, port] : ports_) {
+    EXPECT_FALSE(sut_->GetPortStatus(port.name_).has_value());
+  }
+  ++change_count_;
+  sut_->Invalidate("ethX1");
+  EXPECT_FALSE(sut_->GetPortStatus("ethX1").has_value());
+}
+
+TEST_P(PortStatusSnapshotTest, RetriesFailedRequestAfterRetryDelay) {
+  sut_ = ::std::make_unique<PortStatusSnapshot>(ethtool_, interface_monitor_, ::std::chrono::milliseconds{0});
+  EXPECT_CALL(ethtool_, GetPorts(_))
+      .WillOnce(Return(Status{StatusCode::SYSTEM_CALL}))
+      .WillOnce(DoAll(SetArgReferee<0>(ports_), Return(Status{})));
+
+  EXPECT_FALSE(sut_->GetPortStatus("ethX1").has_value());
+  QueryAllPorts(3);
+}
+
+TEST_P(PortStatusSnapshotTest, EthernetInterfaceUsesSnapshot) {
+  EXPECT_CALL(ethtool_, GetPorts(_)).Times(1);
+
+  // The ports do not exist, the interfaces can only be read from the snapshot.
+  for (auto &[index, port] : ports_) {
+    EthernetInterface itf{port.name_, *sut_};
+    EXPECT_EQ(index, itf.GetInterfaceIndex());
+    EXPECT_EQ(1500, itf.GetMTU());
+    EXPECT_EQ(100, itf.GetSpeed());
+    EXPECT_EQ(port.link_ ? eth::InterfaceLinkState::Up : eth::InterfaceLinkState::Down, itf.GetLinkState());
+    EXPECT_TRUE(itf.GetAutonegSupport());
+    EXPECT_EQ(StatusCode::OK, itf.UpdateConfig().GetStatusCode());
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(PortCounts, PortStatusSnapshotTest, testing::Values<::std::size_t>(2, 8, 32));
+
+}  // namespace netconf
@@ -0,0 +1,21 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace netconf {
+
+struct BridgePortInfo {
+  bool learning_         = false;
+  bool unicast_flooding_ = false;
+  ::std::uint8_t state_  = 0;  // BR_STATE_* (linux/if_bridge.h)
+
+  ::std::string ToString() const {
+    return "BridgePortInfo: learning: " + ::std::to_string(static_cast<int>(learning_)) +
+           " unicast_flooding: " + ::std::to_string(static_cast<int>(unicast_flooding_)) +
+           " state: " + ::std::to_string(state_);
+  }
+};
+
+}  // namespace netconf
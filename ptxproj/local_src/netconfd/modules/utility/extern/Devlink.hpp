@@ -0,0 +1,36 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "IDevlink.hpp"
+
+struct nl_msg;
+struct nl_sock;
+
+namespace netconf {
+
+class Devlink : public IDevlink {
+ public:
+  Devlink();
+  ~Devlink() override = default;
+
+  Devlink(const Devlink &other) = delete;
+  Devlink& operator=(const Devlink &other) = delete;
+  Devlink(Devlink &&other) = delete;
+  Devlink& operator=(Devlink &&other) = delete;
+
+  ::std::optional<bool> GetBoolParameter(const ::std::string &device, const ::std::string &name) override;
+  Status SetBoolParameter(const ::std::string &device, const ::std::string &name, bool value) override;
+
+ private:
+  ::std::unique_ptr<nl_sock, ::std::function<void(nl_sock *)>> socket_;
+  int family_ = -1;
+
+  ::std::unique_ptr<nl_msg, void (*)(nl_msg *)> CreateRequest(::std::uint8_t command, int flags,
+                                                             const ::std::string &device, const ::std::string &name);
+};
+
+}  // namespace netconf
@@ -0,0 +1,33 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <functional>
+#include <memory>
+
+#include "IEthtoolNetlink.hpp"
+
+struct nl_sock;
+
+namespace netconf {
+
+class EthtoolNetlink : public IEthtoolNetlink {
+ public:
+  EthtoolNetlink();
+  ~EthtoolNetlink() override = default;
+
+  EthtoolNetlink(const EthtoolNetlink &other) = delete;
+  EthtoolNetlink& operator=(const EthtoolNetlink &other) = delete;
+  EthtoolNetlink(EthtoolNetlink &&other) = delete;
+  EthtoolNetlink& operator=(EthtoolNetlink &&other) = delete;
+
+  bool IsAvailable() override;
+  Status GetPorts(EthtoolPorts &ports) override;
+
+ private:
+  ::std::unique_ptr<nl_sock, ::std::function<void(nl_sock *)>> socket_;
+  int family_ = -1;
+
+  Status Dump(::std::uint8_t command, EthtoolPorts &ports);
+};
+
+}  // namespace netconf
@@ -0,0 +1,28 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+#include "BaseTypes.hpp"
+#include "BridgePortInfo.hpp"
+
+namespace netconf {
+
+class IBridgePortMonitor {
+ public:
+  IBridgePortMonitor() = default;
+  virtual ~IBridgePortMonitor() = default;
+
+  IBridgePortMonitor(const IBridgePortMonitor &other) = delete;
+  IBridgePortMonitor& operator=(const IBridgePortMonitor &other) = delete;
+  IBridgePortMonitor(IBridgePortMonitor &&other) = delete;
+  IBridgePortMonitor& operator=(IBridgePortMonitor &&other) = delete;
+
+  virtual ::std::optional<BridgePortInfo> GetBridgePortInfo(::std::uint32_t if_index) = 0;
+
+  virtual MacLearning GetMacLearning(::std::uint32_t if_index) = 0;
+  virtual void SetMacLearning(::std::uint32_t if_index, MacLearning learning) = 0;
+};
+
+}  // namespace netconf
@@ -0,0 +1,30 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <optional>
+#include <string>
+
+#include "Status.hpp"
+
+namespace netconf {
+
+/* Access to the parameters of devlink devices (generic netlink family "devlink").
+ * A device is addressed by its handle "<bus>/<device>", e.g. "platform/8000000.ethernet".
+ * Only runtime configuration mode values are read and written.
+ */
+class IDevlink {
+ public:
+  IDevlink() = default;
+  virtual ~IDevlink() = default;
+
+  IDevlink(const IDevlink &other) = delete;
+  IDevlink& operator=(const IDevlink &other) = delete;
+  IDevlink(IDevlink &&other) = delete;
+  IDevlink& operator=(IDevlink &&other) = delete;
+
+  // No value if the parameter cannot be read, e.g. the device or the devlink family does not exist.
+  virtual ::std::optional<bool> GetBoolParameter(const ::std::string &device, const ::std::string &name) = 0;
+  virtual Status SetBoolParameter(const ::std::string &device, const ::std::string &name, bool value) = 0;
+};
+
+}  // namespace netconf
@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Status.hpp"
+
+namespace netconf {
+
+/* Settings and link state of one port as reported by the ethtool netlink family.
+ * The values use the encoding of struct ethtool_link_settings (linux/ethtool.h).
+ */
+struct EthtoolPort {
+  ::std::uint32_t index_ = 0;
+  ::std::string name_;
+
+  ::std::uint32_t speed_       = 0;
+  ::std::uint8_t duplex_       = 0;
+  ::std::uint8_t autoneg_      = 0;
+  ::std::uint8_t port_         = 0;
+  ::std::uint8_t phy_address_  = 0;
+  ::std::uint8_t tp_mdix_      = 0;
+  ::std::uint8_t tp_mdix_ctrl_ = 0;
+  ::std::uint8_t transceiver_  = 0;
+  bool link_                   = false;
+
+  // number of link mode bits, the masks hold (link_mode_bits_ + 31) / 32 words
+  ::std::uint32_t link_mode_bits_ = 0;
+  ::std::vector<::std::uint32_t> supported_;
+  ::std::vector<::std::uint32_t> advertising_;
+  ::std::vector<::std::uint32_t> lp_advertising_;
+};
+
+using EthtoolPorts = ::std::map<::std::uint32_t, EthtoolPort>;
+
+class IEthtoolNetlink {
+ public:
+  IEthtoolNetlink() = default;
+  virtual ~IEthtoolNetlink() = default;
+
+  IEthtoolNetlink(const IEthtoolNetlink &other) = delete;
+  IEthtoolNetlink& operator=(const IEthtoolNetlink &other) = delete;
+  IEthtoolNetlink(IEthtoolNetlink &&other) = delete;
+  IEthtoolNetlink& operator=(IEthtoolNetlink &&other) = delete;
+
+  // False if the kernel has no ethtool netlink family (before 5.6 or CONFIG_ETHTOOL_NETLINK=n).
+  virtual bool IsAvailable() = 0;
+
+  // Reads all ports with one dump request per message type, independent of the number of ports.
+  virtual Status GetPorts(EthtoolPorts &ports) = 0;
+};
+
+}  // namespace netconf
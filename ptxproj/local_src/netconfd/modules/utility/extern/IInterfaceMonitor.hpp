@@ -26,6 +26,11 @@ class IInterfaceMonitor {
 
   virtual ::std::uint32_t GetIffFlags(::std::uint32_t if_index) = 0;
   virtual ::std::int32_t GetAddressFamily(::std::uint32_t if_index) = 0;
+  virtual ::std::uint32_t GetMtu(::std::uint32_t if_index) = 0;
+  virtual ::std::string GetMac(::std::uint32_t if_index) = 0;
+
+  // Incremented with every reported link change, allows to detect outdated data derived from the links.
+  virtual ::std::uint64_t GetChangeCount() = 0;
 
 };
 
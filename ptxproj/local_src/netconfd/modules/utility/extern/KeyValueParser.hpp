@@ -2,6 +2,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 namespace netconf {
 
@@ -9,6 +10,13 @@ namespace netconf {
 ::std::map<::std::string, ::std::string> ParseKeyValuePairs(const ::std::string& content);
 ::std::string GetValueByKey(const ::std::string &data, const ::std::string &key);
 
+/* Collects the values of all "<key>=<value>" lines of the given keys in one pass over the data.
+ * The values of a key spread over several lines are concatenated in line order, other keys are skipped.
+ * The result contains every requested key, the value is empty if the key is missing.
+ */
+::std::map<::std::string, ::std::string> GetValuesByKeys(const ::std::string &data,
+                                                         const ::std::vector<::std::string> &keys);
+
 
 
 } /* namespace netconf */
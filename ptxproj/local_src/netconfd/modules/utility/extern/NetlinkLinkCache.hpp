@@ -5,11 +5,17 @@
 
 #include <memory>
 
+#include "IBridgePortMonitor.hpp"
 #include "IInterfaceMonitor.hpp"
 
 namespace netconf {
 
-class NetlinkLinkCache : public NetlinkCache, public IInterfaceMonitor {
+/*
+ * Besides the links, the cache holds the bridge port entries (AF_BRIDGE) of all enslaved links.
+ * They are loaded once and then kept up to date by the RTM_NEWLINK/RTM_DELLINK notifications of the bridge,
+ * so that bridge port queries do not need a netlink request.
+ */
+class NetlinkLinkCache : public NetlinkCache, public IInterfaceMonitor, public IBridgePortMonitor {
  public:
   NetlinkLinkCache() = delete;
   NetlinkLinkCache(nl_sock* nl_sock, nl_cache_mngr* nl_cache_mgr);
@@ -27,6 +33,13 @@ class NetlinkLinkCache : public NetlinkCache, public IInterfaceMonitor {
 
   ::std::uint32_t GetIffFlags(::std::uint32_t if_index) override;
   ::std::int32_t GetAddressFamily(::std::uint32_t if_index) override;
+  ::std::uint32_t GetMtu(::std::uint32_t if_index) override;
+  ::std::string GetMac(::std::uint32_t if_index) override;
+  ::std::uint64_t GetChangeCount() override;
+
+  ::std::optional<BridgePortInfo> GetBridgePortInfo(::std::uint32_t if_index) override;
+  MacLearning GetMacLearning(::std::uint32_t if_index) override;
+  void SetMacLearning(::std::uint32_t if_index, MacLearning learning) override;
 
 
  private:
@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "Devlink.hpp"
+
+#include <linux/devlink.h>
+#include <linux/genetlink.h>
+#include <netlink/attr.h>
+#include <netlink/genl/ctrl.h>
+#include <netlink/genl/genl.h>
+#include <netlink/msg.h>
+#include <netlink/netlink.h>
+#include <netlink/socket.h>
+
+#include <array>
+#include <string>
+
+#include "Logger.hpp"
+
+namespace netconf {
+
+namespace {
+
+using namespace std::string_literals;
+
+// devlink parameter type of boolean values, the value is true if the data attribute is present (NLA_FLAG)
+constexpr ::std::uint8_t PARAM_TYPE_BOOL = NLA_FLAG;
+
+struct ParameterValue {
+  bool found_ = false;
+  bool value_ = false;
+};
+
+int ParseParameterReply(nl_msg *msg, void *arg) {
+  auto &parameter = *static_cast<ParameterValue *>(arg);
+
+  ::std::array<nlattr *, DEVLINK_ATTR_MAX + 1> tb{};
+  if (genlmsg_parse(nlmsg_hdr(msg), 0, tb.data(), DEVLINK_ATTR_MAX, nullptr) < 0 || tb[DEVLINK_ATTR_PARAM] == nullptr) {
+    return NL_SKIP;
+  }
+
+  ::std::array<nlattr *, DEVLINK_ATTR_MAX + 1> param{};
+  if (nla_parse_nested(param.data(), DEVLINK_ATTR_MAX, tb[DEVLINK_ATTR_PARAM], nullptr) < 0 ||
+      param[DEVLINK_ATTR_PARAM_VALUES_LIST] == nullptr) {
+    return NL_SKIP;
+  }
+
+  nlattr *value = nullptr;
+  int remaining = 0;
+  nla_for_each_nested(value, param[DEVLINK_ATTR_PARAM_VALUES_LIST], remaining) {
+    ::std::array<nlattr *, DEVLINK_ATTR_MAX + 1> entry{};
+    if (nla_parse_nested(entry.data(), DEVLINK_ATTR_MAX, value, nullptr) < 0 ||
+        entry[DEVLINK_ATTR_PARAM_VALUE_CMODE] == nullptr ||
+        nla_get_u8(entry[DEVLINK_ATTR_PARAM_VALUE_CMODE]) != DEVLINK_PARAM_CMODE_RUNTIME) {
+      continue;
+    }
+    parameter.found_ = true;
+    parameter.value_ = entry[DEVLINK_ATTR_PARAM_VALUE_DATA] != nullptr;
+  }
+  return NL_OK;
+}
+
+}  // namespace
+
+Devlink::Devlink() {
+  auto nl_socket_deleter = [](nl_sock *s) {
+    if (s != nullptr) {
+      nl_close(s);
+      nl_socket_free(s);
+    }
+  };
+
+  socket_ = {nl_socket_alloc(), nl_socket_deleter};
+  if (not socket_ || genl_connect(socket_.get()) < 0) {
+    LogWarning("Devlink: failed to connect generic netlink socket");
+    return;
+  }
+
+  // Requests that expect an acknowledgement request it explicitly, get requests are answered by the reply only.
+  nl_socket_disable_auto_ack(socket_.get());
+
+  family_ = genl_ctrl_resolve(socket_.get(), DEVLINK_GENL_NAME);
+  if (family_ < 0) {
+    LogInfo("Devlink: devlink netlink is not supported by the kernel");
+  }
+}
+
+::std::unique_ptr<nl_msg, void (*)(nl_msg *)> Devlink::CreateRequest(::std::uint8_t command, int flags,
+                                                                     const ::std::string &device,
+                                                                     const ::std::string &name) {
+  auto msg = ::std::unique_ptr<nl_msg, void (*)(nl_msg *)>{nullptr, &nlmsg_free};
+
+  auto separator = device.find('/');
+  if (family_ < 0 || separator == ::std::string::npos) {
+    return msg;
+  }
+
+  msg.reset(nlmsg_alloc());
+  if (not msg ||
+      genlmsg_put(msg.get(), NL_AUTO_PORT, NL_AUTO_SEQ, family_, 0, flags, command, DEVLINK_GENL_VERSION) == nullptr ||
+      nla_put_string(msg.get(), DEVLINK_ATTR_BUS_NAME, device.substr(0, separator).c_str()) < 0 ||
+      nla_put_string(msg.get(), DEVLINK_ATTR_DEV_NAME, device.substr(separator + 1).c_str()) < 0 ||
+      nla_put_string(msg.get(), DEVLINK_ATTR_PARAM_NAME, name.c_str()) < 0) {
+    msg.reset();
+  }
+  return msg;
+}
+
+::std::optional<bool> Devlink::GetBoolParameter(const ::std::string &device, const ::std::string &name) {
+  auto msg = CreateRequest(DEVLINK_CMD_PARAM_GET, 0, device, name);
+  if (not msg) {
+    return ::std::nullopt;
+  }
+
+  ParameterValue parameter;
+  nl_socket_modify_cb(socket_.get(), NL_CB_VALID, NL_CB_CUSTOM, ParseParameterReply, &parameter);
+
+  auto result = nl_send_auto(socket_.get(), msg.get());
+  if (result >= 0) {
+    result = nl_recvmsgs_default(socket_.get());
+  }
+  if (result < 0) {
+    LogDebug("Devlink: get " + device + " " + name + " failed: "s + nl_geterror(result));
+    return ::std::nullopt;
+  }
+  if (not parameter.found_) {
+    return ::std::nullopt;
+  }
+  return parameter.value_;
+}
+
+Status Devlink::SetBoolParameter(const ::std::string &device, const ::std::string &name, bool value) {
+  if (family_ < 0) {
+    return Status{StatusCode::GENERIC_ERROR, "Devlink: devlink netlink is not available"};
+  }
+
+  auto msg = CreateRequest(DEVLINK_CMD_PARAM_SET, NLM_F_ACK, device, name);
+  if (not msg || nla_put_u8(msg.get(), DEVLINK_ATTR_PARAM_TYPE, PARAM_TYPE_BOOL) < 0 ||
+      nla_put_u8(msg.get(), DEVLINK_ATTR_PARAM_VALUE_CMODE, DEVLINK_PARAM_CMODE_RUNTIME) < 0 ||
+      (value && nla_put_flag(msg.get(), DEVLINK_ATTR_PARAM_VALUE_DATA) < 0)) {
+    return Status{StatusCode::GENERIC_ERROR, "Devlink: failed to create request for " + device + " " + name};
+  }
+
+  // nl_send_sync frees the message
+  auto result = nl_send_sync(socket_.get(), msg.release());
+  if (result < 0) {
+    return Status{StatusCode::SYSTEM_CALL, "Devlink: set " + device + " " + name + " failed: "s + nl_geterror(result)};
+  }
+  return Status{};
+}
+
+}  // namespace netconf
@@ -0,0 +1,196 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "EthtoolNetlink.hpp"
+
+#include <linux/ethtool.h>
+#include <linux/ethtool_netlink.h>
+#include <linux/genetlink.h>
+#include <netlink/attr.h>
+#include <netlink/genl/ctrl.h>
+#include <netlink/genl/genl.h>
+#include <netlink/msg.h>
+#include <netlink/netlink.h>
+#include <netlink/socket.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <string>
+
+#include "Logger.hpp"
+
+namespace netconf {
+
+namespace {
+
+using namespace std::string_literals;
+
+// The replies of all requested message types are parsed into one attribute table.
+constexpr int MAX_ATTRIBUTES = ::std::max<int>({ETHTOOL_A_LINKINFO_MAX, ETHTOOL_A_LINKMODES_MAX, ETHTOOL_A_LINKSTATE_MAX});
+
+// All requests and replies carry the device header with the same attribute id.
+static_assert(ETHTOOL_A_LINKINFO_HEADER == ETHTOOL_A_LINKMODES_HEADER);
+static_assert(ETHTOOL_A_LINKINFO_HEADER == ETHTOOL_A_LINKSTATE_HEADER);
+
+// A dump of all ports should fit into few reads.
+constexpr size_t RECEIVE_BUFFER_SIZE = 32768;
+
+::std::vector<::std::uint32_t> ToWords(const nlattr *attr) {
+  ::std::vector<::std::uint32_t> words(static_cast<size_t>(nla_len(attr)) / sizeof(::std::uint32_t));
+  ::std::memcpy(words.data(), nla_data(attr), words.size() * sizeof(::std::uint32_t));
+  return words;
+}
+
+/* Compact bitsets (ETHTOOL_FLAG_COMPACT_BITSETS) hold the bits in u32 words.
+ * For ETHTOOL_A_LINKMODES_OURS the value are the advertised and the mask the supported link modes.
+ */
+void ParseLinkModesBitset(nlattr *bitset, EthtoolPort &port, ::std::vector<::std::uint32_t> &value,
+                          ::std::vector<::std::uint32_t> *mask) {
+  ::std::array<nlattr *, ETHTOOL_A_BITSET_MAX + 1> tb{};
+  if (nla_parse_nested(tb.data(), ETHTOOL_A_BITSET_MAX, bitset, nullptr) < 0) {
+    return;
+  }
+
+  if (tb[ETHTOOL_A_BITSET_SIZE] != nullptr) {
+    port.link_mode_bits_ = nla_get_u32(tb[ETHTOOL_A_BITSET_SIZE]);
+  }
+  if (tb[ETHTOOL_A_BITSET_VALUE] != nullptr) {
+    value = ToWords(tb[ETHTOOL_A_BITSET_VALUE]);
+  }
+  if (mask != nullptr && tb[ETHTOOL_A_BITSET_MASK] != nullptr) {
+    *mask = ToWords(tb[ETHTOOL_A_BITSET_MASK]);
+  }
+}
+
+int ParseReply(nl_msg *msg, void *arg) {
+  auto &ports  = *static_cast<EthtoolPorts *>(arg);
+  auto *header = nlmsg_hdr(msg);
+  auto *genl_header = static_cast<genlmsghdr *>(nlmsg_data(header));
+
+  ::std::array<nlattr *, MAX_ATTRIBUTES + 1> tb{};
+  if (genlmsg_parse(header, 0, tb.data(), MAX_ATTRIBUTES, nullptr) < 0 || tb[ETHTOOL_A_LINKINFO_HEADER] == nullptr) {
+    return NL_SKIP;
+  }
+
+  ::std::array<nlattr *, ETHTOOL_A_HEADER_MAX + 1> device{};
+  if (nla_parse_nested(device.data(), ETHTOOL_A_HEADER_MAX, tb[ETHTOOL_A_LINKINFO_HEADER], nullptr) < 0 ||
+      device[ETHTOOL_A_HEADER_DEV_INDEX] == nullptr) {
+    return NL_SKIP;
+  }
+
+  auto index = nla_get_u32(device[ETHTOOL_A_HEADER_DEV_INDEX]);
+  auto &port = ports[index];
+  port.index_ = index;
+  if (device[ETHTOOL_A_HEADER_DEV_NAME] != nullptr) {
+    port.name_ = nla_get_string(device[ETHTOOL_A_HEADER_DEV_NAME]);
+  }
+
+  auto get_u8 = [&tb](int attribute, ::std::uint8_t &value) {
+    if (tb.at(static_cast<size_t>(attribute)) != nullptr) {
+      value = nla_get_u8(tb.at(static_cast<size_t>(attribute)));
+    }
+  };
+
+  switch (genl_header->cmd) {
+    case ETHTOOL_MSG_LINKINFO_GET_REPLY:
+      get_u8(ETHTOOL_A_LINKINFO_PORT, port.port_);
+      get_u8(ETHTOOL_A_LINKINFO_PHYADDR, port.phy_address_);
+      get_u8(ETHTOOL_A_LINKINFO_TP_MDIX, port.tp_mdix_);
+      get_u8(ETHTOOL_A_LINKINFO_TP_MDIX_CTRL, port.tp_mdix_ctrl_);
+      get_u8(ETHTOOL_A_LINKINFO_TRANSCEIVER, port.transceiver_);
+      break;
+    case ETHTOOL_MSG_LINKMODES_GET_REPLY:
+      get_u8(ETHTOOL_A_LINKMODES_AUTONEG, port.autoneg_);
+      get_u8(ETHTOOL_A_LINKMODES_DUPLEX, port.duplex_);
+      if (tb[ETHTOOL_A_LINKMODES_SPEED] != nullptr) {
+        port.speed_ = nla_get_u32(tb[ETHTOOL_A_LINKMODES_SPEED]);
+      }
+      if (tb[ETHTOOL_A_LINKMODES_OURS] != nullptr) {
+        ParseLinkModesBitset(tb[ETHTOOL_A_LINKMODES_OURS], port, port.advertising_, &port.supported_);
+      }
+      if (tb[ETHTOOL_A_LINKMODES_PEER] != nullptr) {
+        ParseLinkModesBitset(tb[ETHTOOL_A_LINKMODES_PEER], port, port.lp_advertising_, nullptr);
+      }
+      break;
+    case ETHTOOL_MSG_LINKSTATE_GET_REPLY:
+      if (tb[ETHTOOL_A_LINKSTATE_LINK] != nullptr) {
+        port.link_ = nla_get_u8(tb[ETHTOOL_A_LINKSTATE_LINK]) != 0;
+      }
+      break;
+    default:
+      break;
+  }
+
+  return NL_OK;
+}
+
+}  // namespace
+
+EthtoolNetlink::EthtoolNetlink() {
+  auto nl_socket_deleter = [](nl_sock *s) {
+    if (s != nullptr) {
+      nl_close(s);
+      nl_socket_free(s);
+    }
+  };
+
+  socket_ = {nl_socket_alloc(), nl_socket_deleter};
+  if (not socket_ || genl_connect(socket_.get()) < 0) {
+    LogWarning("EthtoolNetlink: failed to connect generic netlink socket");
+    return;
+  }
+
+  nl_socket_set_msg_buf_size(socket_.get(), RECEIVE_BUFFER_SIZE);
+  nl_socket_disable_msg_peek(socket_.get());
+
+  family_ = genl_ctrl_resolve(socket_.get(), ETHTOOL_GENL_NAME);
+  if (family_ < 0) {
+    LogInfo("EthtoolNetlink: ethtool netlink is not supported by the kernel, use ioctl");
+  }
+}
+
+bool EthtoolNetlink::IsAvailable() {
+  return family_ >= 0;
+}
+
+Status EthtoolNetlink::GetPorts(EthtoolPorts &ports) {
+  ports.clear();
+  if (not IsAvailable()) {
+    return Status{StatusCode::GENERIC_ERROR, "EthtoolNetlink: ethtool netlink is not available"};
+  }
+
+  for (auto command : {ETHTOOL_MSG_LINKINFO_GET, ETHTOOL_MSG_LINKMODES_GET, ETHTOOL_MSG_LINKSTATE_GET}) {
+    auto status = Dump(static_cast<::std::uint8_t>(command), ports);
+    if (status.IsNotOk()) {
+      ports.clear();
+      return status;
+    }
+  }
+  return Status{};
+}
+
+Status EthtoolNetlink::Dump(::std::uint8_t command, EthtoolPorts &ports) {
+  auto msg = ::std::unique_ptr<nl_msg, decltype(&nlmsg_free)>{nlmsg_alloc(), &nlmsg_free};
+  if (not msg || genlmsg_put(msg.get(), NL_AUTO_PORT, NL_AUTO_SEQ, family_, 0, NLM_F_DUMP, command,
+                             ETHTOOL_GENL_VERSION) == nullptr) {
+    return Status{StatusCode::GENERIC_ERROR, "EthtoolNetlink: failed to create request"};
+  }
+
+  auto *header = nla_nest_start(msg.get(), ETHTOOL_A_LINKINFO_HEADER);
+  nla_put_u32(msg.get(), ETHTOOL_A_HEADER_FLAGS, ETHTOOL_FLAG_COMPACT_BITSETS);
+  nla_nest_end(msg.get(), header);
+
+  nl_socket_modify_cb(socket_.get(), NL_CB_VALID, NL_CB_CUSTOM, ParseReply, &ports);
+
+  auto result = nl_send_auto(socket_.get(), msg.get());
+  if (result >= 0) {
+    result = nl_recvmsgs_default(socket_.get());
+  }
+  if (result < 0) {
+    return Status{StatusCode::SYSTEM_CALL,
+                  "EthtoolNetlink: dump " + ::std::to_string(command) + " failed: "s + nl_geterror(result)};
+  }
+  return Status{};
+}
+
+}  // namespace netconf
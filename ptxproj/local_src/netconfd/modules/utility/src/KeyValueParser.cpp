@@ -4,6 +4,7 @@
 #include <exception>
 #include <regex>
 #include <sstream>
+#include <string_view>
 
 namespace netconf {
 
@@ -37,4 +38,44 @@ namespace netconf {
 
   return value;
 }
+
+::std::map<::std::string, ::std::string> GetValuesByKeys(const ::std::string &data,
+                                                         const ::std::vector<::std::string> &keys) {
+  // First collect the value parts without copying, then build each value with one allocation.
+  ::std::map<::std::string, ::std::vector<::std::string_view>, ::std::less<>> parts;
+  for (const auto &key : keys) {
+    parts[key];
+  }
+
+  ::std::string_view content{data};
+  while (not content.empty()) {
+    auto line_end = content.find('\n');
+    auto line     = content.substr(0, line_end);
+    content.remove_prefix(line_end == ::std::string_view::npos ? content.size() : line_end + 1);
+
+    auto separator = line.find('=');
+    if (separator == ::std::string_view::npos) {
+      continue;
+    }
+    auto key_parts = parts.find(line.substr(0, separator));
+    if (key_parts != parts.end()) {
+      key_parts->second.push_back(line.substr(separator + 1));
+    }
+  }
+
+  ::std::map<::std::string, ::std::string> values;
+  for (const auto &[key, value_parts] : parts) {
+    auto &value = values[key];
+    ::std::size_t size = 0;
+    for (const auto &part : value_parts) {
+      size += part.size();
+    }
+    value.reserve(size);
+    for (const auto &part : value_parts) {
+      value.append(part);
+    }
+  }
+  return values;
+}
+
 }
@@ -6,12 +6,17 @@
 #include <netlink/cache.h>
 #include <netlink/netlink.h>
 #include <netlink/route/link.h>
+#include <netlink/route/link/bridge.h>
 #include <netlink/route/link/vlan.h>
+#include <netlink/socket.h>
 #include <netlink/types.h>
 
+#include <array>
 #include <bitset>
 #include <boost/format.hpp>
 #include <exception>
+#include <functional>
+#include <string>
 #include <system_error>
 
 #include "Logger.hpp"
@@ -30,11 +35,27 @@ auto nl_obj_put_deleter = [](nl_object *o) {  // NOLINT(cert-err58-cpp)
 };
 
 using nl_object_ptr = std::unique_ptr<nl_object, decltype(nl_obj_put_deleter)>;
+using nl_sock_ptr   = ::std::unique_ptr<nl_sock, ::std::function<void(nl_sock *)>>;
 
 nl_object_ptr GetFromCache(nl_cache *cache, nl_object *obj) {
   return nl_object_ptr{nl_cache_find(cache, obj), nl_obj_put_deleter};
 }
 
+nl_sock_ptr AllocateRequestSocket() {
+  auto nl_socket_deleter = [](nl_sock *s) {
+    if (s != nullptr) {
+      nl_close(s);
+      nl_socket_free(s);
+    }
+  };
+
+  nl_sock_ptr socket{nl_socket_alloc(), nl_socket_deleter};
+  if (not socket || nl_connect(socket.get(), NETLINK_ROUTE) < 0) {
+    throw ::std::system_error(EINVAL, ::std::system_category(), "Error connecting netlink request socket");
+  }
+  return socket;
+}
+
 bool IsParentEvent(nl_object *obj) {
   auto l = reinterpret_cast<rtnl_link *>(nl_object_priv(obj));  // NOLINT: Need reinterpret_cast to cast from void*.
   if (rtnl_link_get_family(l) == AF_BRIDGE) {
@@ -51,7 +72,7 @@ bool IsParentEvent(nl_object *obj) {
 
 class NetlinkLinkCache::Impl {
  public:
-  Impl(nl_sock *nl_sock, nl_cache_mngr *nl_cache_mgr) : nl_sock_{nl_sock} {
+  Impl(nl_sock *nl_sock, nl_cache_mngr *nl_cache_mgr) : nl_sock_{nl_sock}, request_sock_{nl::AllocateRequestSocket()} {
     if (rtnl_link_alloc_cache(nl_sock_, AF_UNSPEC, &nl_cache_) < 0) {
       throw ::std::system_error(EINVAL, ::std::system_category(), "Error allocating rtnl cache");
     }
@@ -59,6 +80,9 @@ class NetlinkLinkCache::Impl {
     if (nl_cache_mngr_add_cache(nl_cache_mgr, nl_cache_, CacheChange, this) < 0) {
       throw ::std::system_error(EINVAL, ::std::system_category(), "Error adding cache to manager");
     }
+
+    // after adding, the manager refills the cache
+    AddBridgePorts();
   }
   virtual ~Impl() = default;
 
@@ -98,6 +122,7 @@ class NetlinkLinkCache::Impl {
     }
 
     auto this_ = reinterpret_cast<Impl *>(user);  // NOLINT
+    ++this_->change_count_;
     this_->CallEventHandler(link_info, if_action);
   }
 
@@ -107,9 +132,38 @@ class NetlinkLinkCache::Impl {
     }
   }
 
+  /* The link dump (AF_UNSPEC) does not contain the bridge port entries, only their notifications do.
+   * Add the current ones from a single AF_BRIDGE dump; entries already received by a notification are kept.
+   */
+  void AddBridgePorts() {
+    nl_cache *bridge_cache = nullptr;
+    auto result            = rtnl_link_alloc_cache(request_sock_.get(), AF_BRIDGE, &bridge_cache);
+    if (result < 0) {
+      LogError(::std::string("AddBridgePorts: rtnl_link_alloc_cache: ") + nl_geterror(result));
+      return;
+    }
+
+    for (auto *obj = nl_cache_get_first(bridge_cache); obj != nullptr; obj = nl_cache_get_next(obj)) {
+      nl_cache_add(nl_cache_, obj);
+    }
+    nl_cache_free(bridge_cache);
+  }
+
+  nl::nl_object_ptr FindBridgePort(::std::uint32_t if_index) {
+    auto *filter = rtnl_link_alloc();
+    rtnl_link_set_ifindex(filter, static_cast<int32_t>(if_index));
+    rtnl_link_set_family(filter, AF_BRIDGE);
+
+    auto port = nl::GetFromCache(nl_cache_, reinterpret_cast<nl_object *>(filter));  // NOLINT: Need reinterpret_cast to cast to nl_object.
+    rtnl_link_put(filter);
+    return port;
+  }
+
   IInterfaceEvent *event_handler_ = nullptr;
   nl_cache *nl_cache_      = nullptr;
   nl_sock *nl_sock_        = nullptr;
+  nl::nl_sock_ptr request_sock_;
+  ::std::uint64_t change_count_ = 0;
 };
 
 NetlinkLinkCache::NetlinkLinkCache(nl_sock *nl_sock, nl_cache_mngr *nl_cache_mgr) {
@@ -124,6 +178,12 @@ void NetlinkLinkCache::Resync(nl_sock *nl_sock) {
     auto message = (boost::format("NetlinkDataReady: resync error #%1%") % resync_result).str();
     LogError(message);
   }
+
+  // The resync removes the bridge port entries, they are not part of the link dump.
+  impl_->AddBridgePorts();
+
+  // Changes may have been lost before the resync.
+  ++impl_->change_count_;
 }
 
 ::std::int32_t NetlinkLinkCache::GetAddressFamily(::std::uint32_t if_index) {
@@ -148,6 +208,96 @@ void NetlinkLinkCache::Resync(nl_sock *nl_sock) {
   return flags;
 }
 
+::std::uint32_t NetlinkLinkCache::GetMtu(::std::uint32_t if_index) {
+  rtnl_link *link = rtnl_link_get(impl_->nl_cache_, static_cast<std::int32_t>(if_index));
+  uint32_t mtu           = 0;
+  if (link != nullptr) {
+    mtu = rtnl_link_get_mtu(link);
+  }
+  rtnl_link_put(link);
+
+  return mtu;
+}
+
+::std::string NetlinkLinkCache::GetMac(::std::uint32_t if_index) {
+  rtnl_link *link = rtnl_link_get(impl_->nl_cache_, static_cast<std::int32_t>(if_index));
+  ::std::string mac;
+  if (link != nullptr) {
+    ::std::array<char, 40> buffer{};
+    mac = nl_addr2str(rtnl_link_get_addr(link), buffer.data(), buffer.size());
+  }
+  rtnl_link_put(link);
+
+  return mac;
+}
+
+::std::uint64_t NetlinkLinkCache::GetChangeCount() {
+  return impl_->change_count_;
+}
+
+::std::optional<BridgePortInfo> NetlinkLinkCache::GetBridgePortInfo(::std::uint32_t if_index) {
+  auto port = impl_->FindBridgePort(if_index);
+  if (not port) {
+    return ::std::nullopt;
+  }
+
+  auto *link = reinterpret_cast<rtnl_link *>(nl_object_priv(port.get()));  // NOLINT: Need reinterpret_cast to cast from void*.
+  auto flags = rtnl_link_bridge_get_flags(link);
+
+  BridgePortInfo info;
+  info.learning_         = (flags & RTNL_BRIDGE_LEARNING) != 0;
+  info.unicast_flooding_ = (flags & RTNL_BRIDGE_UNICAST_FLOOD) != 0;
+  info.state_            = static_cast<::std::uint8_t>(rtnl_link_bridge_get_port_state(link));
+  return info;
+}
+
+MacLearning NetlinkLinkCache::GetMacLearning(::std::uint32_t if_index) {
+  auto info = GetBridgePortInfo(if_index);
+  if (not info) {
+    LogError("GetMacLearning: no bridge port with index " + ::std::to_string(if_index));
+    return MacLearning::UNKNOWN;
+  }
+
+  return info->learning_ ? MacLearning::ON : MacLearning::OFF;
+}
+
+void NetlinkLinkCache::SetMacLearning(::std::uint32_t if_index, MacLearning learning) {
+  if (learning == MacLearning::UNKNOWN) {
+    return;
+  }
+
+  auto port = impl_->FindBridgePort(if_index);
+  if (not port) {
+    LogError("SetMacLearning: no bridge port with index " + ::std::to_string(if_index));
+    return;
+  }
+
+  auto set_learning = [learning](rtnl_link *link) {
+    if (learning == MacLearning::ON) {
+      rtnl_link_bridge_set_flags(link, RTNL_BRIDGE_LEARNING);
+    } else {
+      rtnl_link_bridge_unset_flags(link, RTNL_BRIDGE_LEARNING);
+    }
+  };
+
+  // Send only the changed flag, a request with all attributes of the cached entry is answered with an error.
+  auto *change = rtnl_link_alloc();
+  rtnl_link_set_ifindex(change, static_cast<int32_t>(if_index));
+  rtnl_link_set_family(change, AF_BRIDGE);
+  set_learning(change);
+
+  auto *link  = reinterpret_cast<rtnl_link *>(nl_object_priv(port.get()));  // NOLINT: Need reinterpret_cast to cast from void*.
+  auto result = rtnl_link_change(impl_->request_sock_.get(), link, change, 0);
+  rtnl_link_put(change);
+  if (result < 0) {
+    LogError(::std::string("SetMacLearning: rtnl_link_change: ") + nl_geterror(result));
+    return;
+  }
+
+  // Keep the cache valid until the notification of the change arrives.
+  set_learning(link);
+}
+
 void NetlinkLinkCache::RegisterEventHandler(IInterfaceEvent &event_handler) {
   impl_->event_handler_ = &event_handler;
 }
@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "KeyValueParser.hpp"
+
+namespace netconf {
+
+namespace {
+
+const ::std::vector<::std::string> netconfd_keys = {"network.version", "network.data", "network.dipswitch"};
+
+struct BackupCorpusEntry {
+  ::std::string name;
+  ::std::string content;
+  ::std::map<::std::string, ::std::string> expected;
+};
+
+// Backup file contents that were or could be produced by the firmware backup and netconfd.
+const ::std::vector<BackupCorpusEntry> backup_corpus = {
+    {"Empty", "", {{"network.version", ""}, {"network.data", ""}, {"network.dipswitch", ""}}},
+    {"SingleLines",
+     "network.version=2\nnetwork.data=abc\nnetwork.dipswitch=xxx\n",
+     {{"network.version", "2"}, {"network.data", "abc"}, {"network.dipswitch", "xxx"}}},
+    {"SeveralLines",
+     "network.version=2\nnetwork.data=01234\nnetwork.data=56789\nnetwork.data=abcd\n",
+     {{"network.version", "2"}, {"network.data", "0123456789abcd"}, {"network.dipswitch", ""}}},
+    {"FirmwareBackup",
+     "hostname=PFC200V3-4711\ndomain-name=local\nntp-timeserver=pool.ntp.org\nnetwork.version=2\n"
+     "network.data=%7B%22bridge\nnetwork.data=-config%22\ndefault-gw-1-state=disabled\nnetwork.dipswitch=%7B%7D\n",
+     {{"network.version", "2"}, {"network.data", "%7B%22bridge-config%22"}, {"network.dipswitch", "%7B%7D"}}},
+    {"MissingTrailingNewline",
+     "network.version=2\nnetwork.data=abc",
+     {{"network.version", "2"}, {"network.data", "abc"}, {"network.dipswitch", ""}}},
+    {"ValueWithSeparator",
+     "network.data=a=b\nnetwork.data==c\n",
+     {{"network.version", ""}, {"network.data", "a=b=c"}, {"network.dipswitch", ""}}},
+    {"LinesWithoutSeparator",
+     "network.data\nnetwork.version\n\n\nnetwork.data=abc\n",
+     {{"network.version", ""}, {"network.data", "abc"}, {"network.dipswitch", ""}}},
+    {"EmptyValues",
+     "network.data=\nnetwork.data=abc\nnetwork.data=\n",
+     {{"network.version", ""}, {"network.data", "abc"}, {"network.dipswitch", ""}}},
+    {"KeyIsPrefixOfOtherKey",
+     "network.data=abc\nnetwork.data-legacy=xyz\nnetwork.version2=3\nnetwork.version=2\n",
+     {{"network.version", "2"}, {"network.data", "abc"}, {"network.dipswitch", ""}}},
+    {"KeyInsideValue",
+     "hostname=network.data=abc\n network.data=def\n",
+     {{"network.version", ""}, {"network.data", ""}, {"network.dipswitch", ""}}},
+    {"CarriageReturnIsPartOfValue",
+     "network.version=2\r\n",
+     {{"network.version", "2\r"}, {"network.data", ""}, {"network.dipswitch", ""}}},
+};
+
+}  // namespace
+
+TEST(KeyValueParserTest, GetValuesByKeysOfBackupCorpus) {
+  for (const auto &entry : backup_corpus) {
+    EXPECT_EQ(entry.expected, GetValuesByKeys(entry.content, netconfd_keys)) << entry.name;
+  }
+}
+
+TEST(KeyValueParserTest, GetValuesByKeysProvidesRequestedKeysOnly) {
+  auto values = GetValuesByKeys("hostname=abc\nnetwork.data=xyz\n", {"network.data"});
+
+  EXPECT_EQ((::std::map<::std::string, ::std::string>{{"network.data", "xyz"}}), values);
+}
+
+/* Random backup contents, the result has to match the value of GetValueByKey for each key.
+ * Random lines contain no '.', they cannot start with a netconfd key.
+ */
+TEST(KeyValueParserTest, GetValuesByKeysMatchesGetValueByKeyOnRandomContent) {
+  const ::std::vector<::std::string> foreign_keys = {"hostname", "domain-name", "ntp-port", "default-gw-1-state"};
+  const ::std::string value_chars = "abcXYZ019%=-_ \r";
+  const ::std::string random_chars = "abcxyz019%=\r\n ";
+
+  ::std::mt19937 random{4711};  // NOLINT(cert-msc32-c,cert-msc51-cpp) reproducible content
+  auto random_string = [&random](const ::std::string &chars, ::std::size_t max_length) {
+    ::std::string s(random() % (max_length + 1), ' ');
+    for (auto &c : s) {
+      c = chars.at(random() % chars.size());
+    }
+    return s;
+  };
+
+  for (int run = 0; run < 1000; ++run) {
+    ::std::string content;
+    auto lines = random() % 50;
+    for (::std::size_t line = 0; line < lines; ++line) {
+      switch (random() % 3) {
+        case 0:
+          content += netconfd_keys.at(random() % netconfd_keys.size()) + "=" + random_string(value_chars, 80) + "\n";
+          break;
+        case 1:
+          content += foreign_keys.at(random() % foreign_keys.size()) + "=" + random_string(value_chars, 20) + "\n";
+          break;
+        default:
+          content += random_string(random_chars, 20);
+          break;
+      }
+    }
+
+    auto values = GetValuesByKeys(content, netconfd_keys);
+    for (const auto &key : netconfd_keys) {
+      ASSERT_EQ(GetValueByKey(content, key), values.at(key)) << "run " << run << " content:\n" << content;
+    }
+  }
+}
+
+}  // namespace netconf
@@ -0,0 +1,42 @@
+//------------------------------------------------------------------------------
+// Copyright (c) WAGO GmbH & Co. KG
+//
+// PROPRIETARY RIGHTS are involved in the subject matter of this material. All
+// manufacturing, reproduction, use and sales rights pertaining to this
+// subject matter are governed by the license agreement. The recipient of this
+// software implicitly accepts the terms of the license.
+//------------------------------------------------------------------------------
+
+#include "ConfigDiff.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace wago::snmp_config_lib {
+
+namespace {
+
+// The order of the entries does not matter to snmpd.
+template<typename T>
+bool HaveSameEntries(::std::vector<T> lhs, ::std::vector<T> rhs) {
+  ::std::sort(lhs.begin(), lhs.end());
+  ::std::sort(rhs.begin(), rhs.end());
+  return lhs == rhs;
+}
+
+}  //namespace
+
+ConfigChange ClassifyConfigChange(const SnmpConfig &actual_config, const SnmpConfig &new_config) {
+  if (actual_config.snmp_enable_ != new_config.snmp_enable_
+      || not HaveSameEntries(actual_config.user_, new_config.user_)) {
+    return ConfigChange::Restart;
+  }
+
+  if (actual_config == new_config) {
+    return ConfigChange::None;
+  }
+
+  return ConfigChange::Reload;
+}
+
+}
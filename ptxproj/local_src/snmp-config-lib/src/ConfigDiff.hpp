@@ -0,0 +1,29 @@
+//------------------------------------------------------------------------------
+// Copyright (c) WAGO GmbH & Co. KG
+//
+// PROPRIETARY RIGHTS are involved in the subject matter of this material. All
+// manufacturing, reproduction, use and sales rights pertaining to this
+// subject matter are governed by the license agreement. The recipient of this
+// software implicitly accepts the terms of the license.
+//------------------------------------------------------------------------------
+
+#pragma once
+
+#include "SnmpConfig.hpp"
+
+namespace wago::snmp_config_lib {
+
+enum class ConfigChange {
+  None,     // nothing to write, the daemons keep running
+  Reload,   // snmpd re-reads its configuration on SIGHUP
+  Restart   // daemons have to be stopped and started again
+};
+
+/*
+ * Classifies the change from the actual to the new configuration.
+ * Users are created by snmpd at startup and persisted as usmUser entries,
+ * so changes of v3 users and of the enable state need a restart.
+ */
+ConfigChange ClassifyConfigChange(const SnmpConfig &actual_config, const SnmpConfig &new_config);
+
+}
@@ -12,11 +12,13 @@
 namespace wago::snmp_config_lib {
 
 LinuxDaemonFilePaths Constants::GetSnmpFilePaths() {
-  return LinuxDaemonFilePaths { "/usr/sbin/snmpd", "/etc/init.d/net-snmpd", "/etc/rc.d/S21_netsnmpd" };
+  return LinuxDaemonFilePaths { "/usr/sbin/snmpd", "/etc/init.d/net-snmpd", "/etc/rc.d/S21_netsnmpd",
+                                "/var/run/snmpd.pid" };
 }
 
 LinuxDaemonFilePaths Constants::GetSnmpTrapFilePaths() {
-  return LinuxDaemonFilePaths { "/usr/sbin/snmptrapd", "/etc/init.d/net-snmptrapd", "/etc/rc.d/S22_netsnmptrapd" };
+  return LinuxDaemonFilePaths { "/usr/sbin/snmptrapd", "/etc/init.d/net-snmptrapd", "/etc/rc.d/S22_netsnmptrapd",
+                                "" };
 }
 
 ::std::string Constants::GetSnmpConfPath() {
@@ -31,5 +33,10 @@ LinuxDaemonFilePaths Constants::GetSnmpTrapFilePaths() {
   return "/etc/specific/snmp_user.conf";
 }
 
+SnmpConfigPaths Constants::GetSnmpConfigPaths() {
+  return SnmpConfigPaths { GetSnmpConfPath(), GetSnmpV3ConfPath(), GetSnmpFilePaths(), GetSnmpTrapFilePaths(),
+                           "/proc" };
+}
+
 
 }
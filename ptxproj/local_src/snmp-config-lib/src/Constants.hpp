@@ -17,6 +17,16 @@ struct LinuxDaemonFilePaths {
   ::std::string daemon;
   ::std::string init_d;
   ::std::string rc_d;
+  ::std::string pid_file;
+};
+
+// Files ReadSnmpConfig depends on: the configuration files and the daemons looked up in procfs.
+struct SnmpConfigPaths {
+  ::std::string snmp_conf;
+  ::std::string snmp_v3_conf;
+  LinuxDaemonFilePaths snmp;
+  LinuxDaemonFilePaths snmp_trap;
+  ::std::string proc_root;
 };
 
 struct Constants {
@@ -25,6 +35,7 @@ struct Constants {
     static ::std::string GetSnmpConfPath();
     static ::std::string GetSnmpV3ConfPath();
     static ::std::string GetSnmpUserConfPath();
+    static SnmpConfigPaths GetSnmpConfigPaths();
 
 };
 
@@ -1,10 +1,11 @@
 #include "ControlSnmp.hpp"
 
-#include <glib.h>
+#include <csignal>
 #include <filesystem>
 #include <string>
 
 #include "Constants.hpp"
+#include "Process.hpp"
 #include "Program.hpp"
 
 namespace wago::snmp_config_lib {
@@ -13,21 +14,8 @@ namespace fs = std::filesystem;
 
 namespace {
 
-int GetPidOf(const ::std::string &daemon_path) {
-  ::std::string command_line = "/usr/bin/pidof " + daemon_path;
-  auto program = wago::util::Program::Execute(command_line);
-
-  if (program.GetResult() == 0) {
-    char *end;
-    return ::std::strtol(program.GetStdout().c_str(), &end, 0);
-  }
-
-  return 0;
-}
-
-bool IsRunning(const ::std::string &daemon_path) {
-  int pid = GetPidOf(daemon_path);
-  return pid > 0;
+bool IsRunning(const LinuxDaemonFilePaths &paths, const ::std::string &proc_root = "/proc") {
+  return wago::util::FindPid(paths.daemon, paths.pid_file, proc_root) > 0;
 }
 
 void AddLink(const LinuxDaemonFilePaths paths) {
@@ -43,7 +31,7 @@ void RemoveLink(const LinuxDaemonFilePaths paths) {
 }
 
 DaemonState Start(const LinuxDaemonFilePaths paths) {
-  if (not IsRunning(paths.daemon)) {
+  if (not IsRunning(paths)) {
     ::std::string command_line = paths.init_d + " start";
     wago::util::Program::Execute(command_line);
     return NewlyStarted;
@@ -52,7 +40,7 @@ DaemonState Start(const LinuxDaemonFilePaths paths) {
 }
 
 void Stop(const LinuxDaemonFilePaths paths) {
-  if (IsRunning(paths.daemon)) {
+  if (IsRunning(paths)) {
     ::std::string command_line = paths.init_d + " stop";
     wago::util::Program::Execute(command_line);
   }
@@ -83,15 +71,21 @@ void StopDaemons() {
 }
 
 bool IsSnmpRunning() {
-  auto snmp_paths = Constants::GetSnmpFilePaths();
-  auto snmp_trap_paths = Constants::GetSnmpTrapFilePaths();
-  return (IsRunning(snmp_paths.daemon) && IsRunning(snmp_trap_paths.daemon));
+  auto paths = Constants::GetSnmpConfigPaths();
+  return IsSnmpRunning(paths.snmp, paths.snmp_trap, paths.proc_root);
+}
+
+bool IsSnmpRunning(const LinuxDaemonFilePaths &snmp_paths, const LinuxDaemonFilePaths &snmp_trap_paths,
+                   const ::std::string &proc_root) {
+  return (IsRunning(snmp_paths, proc_root) && IsRunning(snmp_trap_paths, proc_root));
 }
 
 void InformDaemonAboutChangedConfig() {
   auto paths = Constants::GetSnmpFilePaths();
-  auto pid = GetPidOf(paths.daemon);
-  wago::util::Program::Execute("/usr/bin/kill -HUP " + ::std::to_string(pid));
+  auto pid = wago::util::FindPid(paths.daemon, paths.pid_file);
+  if (pid > 0) {
+    ::kill(pid, SIGHUP);
+  }
 }
 
 }  // namespace wago::snmp_config_lib
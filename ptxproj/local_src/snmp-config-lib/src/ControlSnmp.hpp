@@ -9,6 +9,10 @@
 
 #pragma once
 
+#include <string>
+
+#include "Constants.hpp"
+
 namespace wago::snmp_config_lib {
 
 enum DaemonState {
@@ -20,5 +24,7 @@ DaemonState StartDaemons();
 void StopDaemons();
 void InformDaemonAboutChangedConfig();
 bool IsSnmpRunning();
+bool IsSnmpRunning(const LinuxDaemonFilePaths &snmp_paths, const LinuxDaemonFilePaths &snmp_trap_paths,
+                   const ::std::string &proc_root);
 
 }
@@ -8,8 +8,10 @@
 //------------------------------------------------------------------------------
 
 #include "SnmpConfig.hpp"
+#include "SnmpConfigReader.hpp"
 
 #include "ConfigConversion.hpp"
+#include "ConfigDiff.hpp"
 #include "Constants.hpp"
 #include "ControlSnmp.hpp"
 #include "ConfigLine.hpp"
@@ -32,20 +34,18 @@ void FromConfigLines(const std::vector<ConfigLine> &lines, SnmpConfig &sc) {
   ExtractTrapV3Parameters(lines, sc);
 }
 
-void ReadConfigFile(const ::std::string &&path, SnmpConfig &snmp_config) {
+void ReadConfigFile(const ::std::string &path, SnmpConfig &snmp_config) {
   auto data = wago::util::ReadFile(path);
   std::vector<ConfigLine> config_lines = ExtractConfigLines(data);
   FromConfigLines(config_lines, snmp_config);
 }
 
-void ReadConfigFiles(SnmpConfig &snmp_config) {
-  ReadConfigFile(Constants::GetSnmpConfPath(), snmp_config);
-  ReadConfigFile(Constants::GetSnmpV3ConfPath(), snmp_config);
+void ReadConfigFiles(const SnmpConfigPaths &paths, SnmpConfig &snmp_config) {
+  ReadConfigFile(paths.snmp_conf, snmp_config);
+  ReadConfigFile(paths.snmp_v3_conf, snmp_config);
 }
 
-void WriteConfigFiles(const SnmpConfig &config) {
-  SnmpConfig actual_config;
-  ReadConfigFile(Constants::GetSnmpConfPath(), actual_config);
+void WriteConfigFiles(const SnmpConfig &config, const SnmpConfig &actual_config) {
   UpdateSnmpUserConfFile(Constants::GetSnmpUserConfPath(), config, actual_config);
 
   wago::util::WriteFile(Constants::GetSnmpConfPath(), SnmpBasicAndV1V2cParameterToString(config));
@@ -154,11 +154,15 @@ bool SnmpConfig::operator !=(const SnmpConfig &rhs) const {
 }
 
 SnmpConfig ReadSnmpConfig() {
+  return ReadSnmpConfig(Constants::GetSnmpConfigPaths());
+}
+
+SnmpConfig ReadSnmpConfig(const SnmpConfigPaths &paths) {
   SnmpConfig snmp_config;
 
-  ReadConfigFiles(snmp_config);
+  ReadConfigFiles(paths, snmp_config);
 
-  snmp_config.snmp_enable_ = IsSnmpRunning();
+  snmp_config.snmp_enable_ = IsSnmpRunning(paths.snmp, paths.snmp_trap, paths.proc_root);
 
   return snmp_config;
 }
@@ -170,14 +174,24 @@ Statuses WriteSnmpConfig(const SnmpConfig &config) {
     return s;
   }
 
-  WriteConfigFiles(config);
+  auto actual_config = ReadSnmpConfig();
+  auto change = ClassifyConfigChange(actual_config, config);
+  if (change == ConfigChange::None) {
+    return s;
+  }
 
-  StopDaemons();  
-  wago::util::RemoveSnmpUser("/var/net-snmp/snmpd.conf");
-  
-  if (config.snmp_enable_) {
-    StartDaemons();
-  } 
+  WriteConfigFiles(config, actual_config);
+
+  if (change == ConfigChange::Restart) {
+    StopDaemons();
+    wago::util::RemoveSnmpUser("/var/net-snmp/snmpd.conf");
+
+    if (config.snmp_enable_) {
+      StartDaemons();
+    }
+  } else if (config.snmp_enable_) {
+    InformDaemonAboutChangedConfig();
+  }
 
   TriggerEventFolder();
 
@@ -0,0 +1,20 @@
+//------------------------------------------------------------------------------
+// Copyright (c) WAGO GmbH & Co. KG
+//
+// PROPRIETARY RIGHTS are involved in the subject matter of this material. All
+// manufacturing, reproduction, use and sales rights pertaining to this
+// subject matter are governed by the license agreement. The recipient of this
+// software implicitly accepts the terms of the license.
+//------------------------------------------------------------------------------
+
+#pragma once
+
+#include "Constants.hpp"
+#include "SnmpConfig.hpp"
+
+namespace wago::snmp_config_lib {
+
+// ReadSnmpConfig with the files of the given paths instead of the ones of the system.
+SnmpConfig ReadSnmpConfig(const SnmpConfigPaths &paths);
+
+}
@@ -0,0 +1,85 @@
+//------------------------------------------------------------------------------
+// Copyright (c) WAGO GmbH & Co. KG
+//
+// PROPRIETARY RIGHTS are involved in the subject matter of this material. All
+// manufacturing, reproduction, use and sales rights pertaining to this
+// subject matter are governed by the license agreement. The recipient of this
+// software implicitly accepts the terms of the license.
+//------------------------------------------------------------------------------
+
+#include "Process.hpp"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+#include <system_error>
+
+namespace wago::util {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+::std::string ReadLink(const fs::path &path) {
+  ::std::error_code ec;
+  auto target = fs::read_symlink(path, ec);
+  return ec ? ::std::string { } : target.string();
+}
+
+// argv[0] of the process, used if the exe link is not readable.
+::std::string ReadCommand(const fs::path &path) {
+  ::std::ifstream cmdline(path);
+  ::std::string command;
+  ::std::getline(cmdline, command, '\0');
+  return command;
+}
+
+bool IsProcessOf(const ::std::string &executable, const fs::path &process_dir) {
+  auto exe = ReadLink(process_dir / "exe");
+  if (not exe.empty()) {
+    // The link target of a replaced executable, e.g. after an update, is marked as deleted.
+    constexpr ::std::string_view deleted_suffix = " (deleted)";
+    if (exe.size() > deleted_suffix.size()
+        && exe.compare(exe.size() - deleted_suffix.size(), deleted_suffix.size(), deleted_suffix) == 0) {
+      exe.resize(exe.size() - deleted_suffix.size());
+    }
+    return exe == executable;
+  }
+  return ReadCommand(process_dir / "cmdline") == executable;
+}
+
+pid_t ToPid(const ::std::string &value) {
+  char *end = nullptr;
+  auto pid = ::std::strtol(value.c_str(), &end, 10);
+  return (end != value.c_str() && pid > 0) ? static_cast<pid_t>(pid) : 0;
+}
+
+pid_t ReadPidFile(const ::std::string &pid_file) {
+  ::std::ifstream file(pid_file);
+  ::std::string value;
+  file >> value;
+  return ToPid(value);
+}
+
+}  // namespace
+
+pid_t FindPid(const ::std::string &executable, const ::std::string &pid_file, const ::std::string &proc_root) {
+  if (not pid_file.empty()) {
+    auto pid = ReadPidFile(pid_file);
+    if (pid > 0 && IsProcessOf(executable, fs::path(proc_root) / ::std::to_string(pid))) {
+      return pid;
+    }
+  }
+
+  ::std::error_code ec;
+  for (const auto &entry : fs::directory_iterator(proc_root, ec)) {
+    auto pid = ToPid(entry.path().filename().string());
+    if (pid > 0 && IsProcessOf(executable, entry.path())) {
+      return pid;
+    }
+  }
+  return 0;
+}
+
+}  // namespace wago::util
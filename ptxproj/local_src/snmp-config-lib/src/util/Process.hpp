@@ -0,0 +1,22 @@
+//------------------------------------------------------------------------------
+// Copyright (c) WAGO GmbH & Co. KG
+//
+// PROPRIETARY RIGHTS are involved in the subject matter of this material. All
+// manufacturing, reproduction, use and sales rights pertaining to this
+// subject matter are governed by the license agreement. The recipient of this
+// software implicitly accepts the terms of the license.
+//------------------------------------------------------------------------------
+
+#pragma once
+
+#include <string>
+#include <sys/types.h>
+
+namespace wago::util {
+
+// Pid of the running process of the executable, 0 if it does not run.
+// The pid file is checked first, without it the processes in procfs are searched (like pidof).
+pid_t FindPid(const ::std::string &executable, const ::std::string &pid_file = "",
+              const ::std::string &proc_root = "/proc");
+
+}  // namespace wago::util
@@ -15,9 +15,19 @@
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <sys/stat.h>
+#include <utility>
 
 namespace wago::util {
 
+namespace {
+
+Program::Executor &CustomExecutor() {
+  static Program::Executor executor;
+  return executor;
+}
+
+}  // namespace
+
 Program::Program(Program &&other) noexcept {
   this->operator =(::std::move(other));
 }
@@ -40,6 +50,12 @@ Program Program::Execute(std::string &cmdline) {
   GError *g_error;
   Program p;
 
+  const auto &executor = CustomExecutor();
+  if (executor) {
+    p.result_ = executor(cmdline, p.stdout_, p.stderr_);
+    return p;
+  }
+
   if (g_spawn_command_line_sync(cmdline.c_str(), &stdout, &stderr, &p.result_, &g_error) == 0) {
     g_error_free(g_error);
   } else {
@@ -52,6 +68,10 @@ Program Program::Execute(std::string &cmdline) {
   return p;
 }
 
+void Program::SetExecutor(Executor executor) {
+  CustomExecutor() = ::std::move(executor);
+}
+
 ::std::string Program::GetStdout() const {
   return stdout_;
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <string>
 #include <unistd.h>
 
@@ -7,6 +8,10 @@ namespace wago::util {
 
 class Program {
  public:
+  // Runs the command line, returns its wait status and fills its output.
+  using Executor = ::std::function<int(const ::std::string &cmdline, ::std::string &stdout_data,
+                                       ::std::string &stderr_data)>;
+
   Program() = default;
   ~Program() = default;
   Program(const Program&) = delete;
@@ -21,6 +26,9 @@ class Program {
   static Program Execute(std::string &&cmdline);
   static Program Execute(std::string &cmdline);
 
+  // Replaces the process spawning of Execute, e.g. in tests. An empty executor restores it.
+  static void SetExecutor(Executor executor);
+
  private:
   int result_ = -1;
   ::std::string stdout_;
@@ -0,0 +1,170 @@
+//------------------------------------------------------------------------------
+// Copyright (c) WAGO GmbH & Co. KG
+//
+// PROPRIETARY RIGHTS are involved in the subject matter of this material. All
+// manufacturing, reproduction, use and sales rights pertaining to this
+// subject matter are governed by the license agreement. The recipient of this
+// software implicitly accepts the terms of the license.
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include "ConfigDiff.hpp"
+#include "Program.hpp"
+#include "SnmpConfig.hpp"
+#include "SnmpConfigReader.hpp"
+
+namespace wago::snmp_config_lib {
+
+class ConfigDiffTest : public ::testing::Test {
+ public:
+  SnmpConfig actual_;
+
+  void SetUp() override {
+    actual_.snmp_enable_ = true;
+    actual_.sys_name_ = "PFC200";
+    actual_.sys_location_ = "Minden";
+    actual_.communities_.emplace_back("public", Access::ReadOnly);
+    actual_.trap_receivers_V1V2c_.emplace_back("192.168.1.10", "public", VersionV1V2c::V2c);
+    actual_.user_.emplace_back("admin", Access::ReadWrite, SecurityLevel::AuthPriv, AuthenticationType::SHA,
+                               "authkey123", Privacy::AES, "privkey123");
+    actual_.user_.emplace_back("reader", Access::ReadOnly, SecurityLevel::AuthNoPriv, AuthenticationType::MD5,
+                               "readkey123", Privacy::None, "");
+    actual_.trap_receivers_V3_.emplace_back("admin", SecurityLevel::AuthPriv, AuthenticationType::SHA,
+                                            "authkey123", Privacy::AES, "privkey123", "192.168.1.10");
+  }
+};
+
+TEST_F(ConfigDiffTest, UnchangedConfigNeedsNothing) {
+  auto new_config = actual_;
+
+  EXPECT_EQ(ConfigChange::None, ClassifyConfigChange(actual_, new_config));
+}
+
+TEST_F(ConfigDiffTest, ChangedBasicParameterIsReloaded) {
+  auto new_config = actual_;
+  new_config.sys_location_ = "Hall 2";
+
+  EXPECT_EQ(ConfigChange::Reload, ClassifyConfigChange(actual_, new_config));
+}
+
+TEST_F(ConfigDiffTest, ChangedCommunityIsReloaded) {
+  auto new_config = actual_;
+  new_config.communities_.emplace_back("private", Access::ReadWrite);
+
+  EXPECT_EQ(ConfigChange::Reload, ClassifyConfigChange(actual_, new_config));
+}
+
+TEST_F(ConfigDiffTest, ChangedTrapReceiverIsReloaded) {
+  auto new_config = actual_;
+  new_config.trap_receivers_V1V2c_.clear();
+  new_config.trap_receivers_V3_.front().host_ = "192.168.1.11";
+
+  EXPECT_EQ(ConfigChange::Reload, ClassifyConfigChange(actual_, new_config));
+}
+
+TEST_F(ConfigDiffTest, ReorderedUsersAreNotRestarted) {
+  auto new_config = actual_;
+  ::std::swap(new_config.user_.front(), new_config.user_.back());
+
+  EXPECT_EQ(ConfigChange::Reload, ClassifyConfigChange(actual_, new_config));
+}
+
+TEST_F(ConfigDiffTest, ChangedUserKeyNeedsRestart) {
+  auto new_config = actual_;
+  new_config.user_.front().authentication_key_ = "authkey456";
+
+  EXPECT_EQ(ConfigChange::Restart, ClassifyConfigChange(actual_, new_config));
+}
+
+TEST_F(ConfigDiffTest, AddedOrRemovedUserNeedsRestart) {
+  auto added = actual_;
+  added.user_.emplace_back("writer", Access::ReadWrite, SecurityLevel::AuthNoPriv, AuthenticationType::SHA256,
+                           "writekey123", Privacy::None, "");
+  auto removed = actual_;
+  removed.user_.pop_back();
+
+  EXPECT_EQ(ConfigChange::Restart, ClassifyConfigChange(actual_, added));
+  EXPECT_EQ(ConfigChange::Restart, ClassifyConfigChange(actual_, removed));
+}
+
+TEST_F(ConfigDiffTest, EnableOrDisableNeedsRestart) {
+  auto disabled = actual_;
+  disabled.snmp_enable_ = false;
+
+  EXPECT_EQ(ConfigChange::Restart, ClassifyConfigChange(actual_, disabled));
+  EXPECT_EQ(ConfigChange::Restart, ClassifyConfigChange(disabled, actual_));
+}
+
+class ReadSnmpConfigTest : public ::testing::Test {
+ public:
+  ::std::filesystem::path directory_;
+  SnmpConfigPaths paths_;
+  int spawned_processes_ = 0;
+
+  void SetUp() override {
+    char path[] = "/tmp/read_snmp_config_test_XXXXXX";
+    ASSERT_NE(nullptr, ::mkdtemp(path));
+    directory_ = path;
+
+    paths_.snmp_conf = directory_ / "snmpd.conf";
+    paths_.snmp_v3_conf = directory_ / "snmpdv3.conf";
+    paths_.snmp = { "/usr/sbin/snmpd", "", "", directory_ / "snmpd.pid" };
+    paths_.snmp_trap = { "/usr/sbin/snmptrapd", "", "", "" };
+    paths_.proc_root = directory_ / "proc";
+
+    ::std::ofstream(paths_.snmp_conf) << "sysName PFC200\nsysLocation Minden\nrocommunity public\n";
+    ::std::ofstream(paths_.snmp_v3_conf) << "createUser admin SHA authkey123 AES privkey123\nrwuser admin priv\n";
+    ::std::filesystem::create_directories(paths_.proc_root);
+
+    wago::util::Program::SetExecutor([this](const ::std::string&, ::std::string&, ::std::string&) {
+      ++spawned_processes_;
+      return 0;
+    });
+  }
+
+  void TearDown() override {
+    wago::util::Program::SetExecutor(nullptr);
+    ::std::filesystem::remove_all(directory_);
+  }
+
+  void AddProcess(int pid, const ::std::string &executable) {
+    auto process_dir = ::std::filesystem::path(paths_.proc_root) / ::std::to_string(pid);
+    ::std::filesystem::create_directories(process_dir);
+    ::std::filesystem::create_symlink(executable, process_dir / "exe");
+  }
+};
+
+TEST_F(ReadSnmpConfigTest, ReadsConfigWithoutSpawningProcesses) {
+  AddProcess(4711, paths_.snmp.daemon);
+  AddProcess(815, paths_.snmp_trap.daemon);
+  ::std::ofstream(paths_.snmp.pid_file) << "4711\n";
+
+  for (int i = 0; i < 10; ++i) {
+    auto config = ReadSnmpConfig(paths_);
+
+    EXPECT_TRUE(config.snmp_enable_);
+    EXPECT_EQ("PFC200", config.sys_name_);
+    EXPECT_EQ("Minden", config.sys_location_);
+    ASSERT_EQ(1, config.communities_.size());
+    EXPECT_EQ(Community("public", Access::ReadOnly), config.communities_.front());
+    ASSERT_EQ(1, config.user_.size());
+    EXPECT_EQ("admin", config.user_.front().name_);
+  }
+
+  EXPECT_EQ(0, spawned_processes_);
+}
+
+TEST_F(ReadSnmpConfigTest, IsDisabledIfOneDaemonIsNotRunning) {
+  AddProcess(4711, paths_.snmp.daemon);
+
+  EXPECT_FALSE(ReadSnmpConfig(paths_).snmp_enable_);
+  EXPECT_EQ(0, spawned_processes_);
+}
+
+}  // wago::snmp_config_lib
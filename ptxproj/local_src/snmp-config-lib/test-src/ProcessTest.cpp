@@ -0,0 +1,88 @@
+//------------------------------------------------------------------------------
+// Copyright (c) WAGO GmbH & Co. KG
+//
+// PROPRIETARY RIGHTS are involved in the subject matter of this material. All
+// manufacturing, reproduction, use and sales rights pertaining to this
+// subject matter are governed by the license agreement. The recipient of this
+// software implicitly accepts the terms of the license.
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+
+#include "Process.hpp"
+
+namespace wago::util {
+
+namespace fs = std::filesystem;
+
+class ProcessTest : public ::testing::Test {
+ public:
+  fs::path directory_;
+  fs::path proc_root_;
+
+  void SetUp() override {
+    char path[] = "/tmp/process_test_XXXXXX";
+    ASSERT_NE(nullptr, ::mkdtemp(path));
+    directory_ = path;
+    proc_root_ = directory_ / "proc";
+    AddProcess(1, "/sbin/init");
+    AddProcess(815, "/usr/sbin/snmptrapd");
+    AddProcess(4711, "/usr/sbin/snmpd");
+    fs::create_directories(proc_root_ / "self");
+  }
+
+  void TearDown() override {
+    fs::remove_all(directory_);
+  }
+
+  void AddProcess(int pid, const ::std::string &executable) {
+    auto process_dir = proc_root_ / ::std::to_string(pid);
+    fs::create_directories(process_dir);
+    fs::create_symlink(executable, process_dir / "exe");
+  }
+
+  ::std::string WritePidFile(int pid) {
+    auto pid_file = directory_ / "snmpd.pid";
+    ::std::ofstream(pid_file) << pid << "\n";
+    return pid_file;
+  }
+};
+
+TEST_F(ProcessTest, FindsProcessByPidFile) {
+  EXPECT_EQ(4711, FindPid("/usr/sbin/snmpd", WritePidFile(4711), proc_root_));
+}
+
+TEST_F(ProcessTest, SearchesProcessesWithoutPidFile) {
+  EXPECT_EQ(815, FindPid("/usr/sbin/snmptrapd", "", proc_root_));
+  EXPECT_EQ(4711, FindPid("/usr/sbin/snmpd", (directory_ / "missing.pid").string(), proc_root_));
+}
+
+TEST_F(ProcessTest, IgnoresStalePidFile) {
+  // The pid was reused by another process after snmpd stopped.
+  EXPECT_EQ(4711, FindPid("/usr/sbin/snmpd", WritePidFile(1), proc_root_));
+  fs::remove_all(proc_root_ / "4711");
+  EXPECT_EQ(0, FindPid("/usr/sbin/snmpd", WritePidFile(1), proc_root_));
+}
+
+TEST_F(ProcessTest, FindsProcessOfReplacedExecutable) {
+  // The executable of a running daemon was replaced, e.g. by a firmware update.
+  fs::remove_all(proc_root_ / "4711");
+  AddProcess(4711, "/usr/sbin/snmpd (deleted)");
+
+  EXPECT_EQ(4711, FindPid("/usr/sbin/snmpd", WritePidFile(4711), proc_root_));
+  EXPECT_EQ(4711, FindPid("/usr/sbin/snmpd", "", proc_root_));
+}
+
+TEST_F(ProcessTest, FindsOwnProcess) {
+  auto executable = fs::read_symlink("/proc/self/exe").string();
+  EXPECT_LT(0, FindPid(executable));
+  EXPECT_EQ(0, FindPid("/usr/sbin/not-existing-daemon"));
+}
+
+}  // wago::util
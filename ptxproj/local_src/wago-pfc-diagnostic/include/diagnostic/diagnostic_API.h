@@ -46,6 +46,8 @@ typedef void(*log_tEventHandler)(com_tConnection*, com_tComMessage*, log_tEventI
 #define LOG_DIAG_PATH     "/wago/diagnose"
 #define LOG_GET_INFO      "getInfo"
 
+#define LED_SNAPSHOT_SHM_NAME "/wago_led_snapshot"
+
 
 #define DIAGNOSTIG_API 2
 //#define openlog    diag_ConnectToLog
@@ -74,8 +76,58 @@ typedef struct
     tIdCtrlInfo   info;
 }tLedStatus;
 
+typedef enum
+{
+    LOG_ASYNC_OVERFLOW_DROP,   // discard the new event and count it
+    LOG_ASYNC_OVERFLOW_BLOCK   // wait until the sender thread made room
+}log_tAsyncOverflow;
+
+typedef struct
+{
+    unsigned long depth;      // number of events the queue can hold
+    unsigned long pending;    // events waiting to be sent
+    unsigned long enqueued;   // events accepted into the queue
+    unsigned long sent;       // events handed to the D-Bus connection
+    unsigned long dropped;    // events discarded because the queue was full
+    unsigned long blocked;    // calls that had to wait for a free slot
+    unsigned long flushes;    // connection flushes done by the sender
+    unsigned long highWater;  // highest queue fill seen
+}log_tAsyncStats;
+
 void log_EVENT_Init(          const char       * name);
 
+//-- Function: log_EVENT_SetAsync ----------------------------------------------
+///
+///  Switch log_EVENT_LogIdParam/log_EVENT_LogId to asynchronous emission. Events
+///  are timestamped (CLOCK_REALTIME) and copied into a bounded queue; a
+///  background thread sends them and flushes the connection once per burst.
+///  If the sender thread has terminated, events are sent synchronously again.
+///  Must be called after log_EVENT_Init; calling it again only changes the
+///  overflow policy.
+///
+///  \param depth     queue size in events (rounded up to a power of two; 0 for default)
+///  \param overflow  what to do when the queue is full
+///
+///  \return 0 on success; -1 on error (events stay synchronous)
+//------------------------------------------------------------------------------
+int log_EVENT_SetAsync(       uint32_t           depth,
+                              log_tAsyncOverflow overflow);
+
+//-- Function: log_EVENT_Flush --------------------------------------------------
+///
+///  Wait (at most one second) until all events queued so far are sent.
+///  Registered with atexit() when the asynchronous mode is enabled.
+//------------------------------------------------------------------------------
+void log_EVENT_Flush(void);
+
+//-- Function: log_EVENT_GetAsyncStats -----------------------------------------
+///
+///  Read the counters of the asynchronous mode
+///
+///  \return 0 on success; -1 if the asynchronous mode is not enabled
+//------------------------------------------------------------------------------
+int log_EVENT_GetAsyncStats(  log_tAsyncStats  * stats);
+
 void log_EVENT_LogIdParam(    log_tEventId           id,
                               bool               set,
                               int                first_arg_type, ...);
@@ -96,6 +148,46 @@ bool log_EVENT_HandlerIdSet(com_tConnection * con, com_tComMessage * msg);
 
 int log_EVENT_DeregisterId(com_tSignalHandle  handle);
 
+//-- Function: log_EVENT_RegisterForIdLocal ------------------------------------
+///
+///  Like log_EVENT_RegisterForId, but without a match rule per ID: the first
+///  call subscribes once to the whole diagnostic interface and signals are
+///  dispatched in-process through a hash table keyed by the event ID.
+///  Meant for processes that listen to many IDs (e.g. ledserverd).
+///  Handles are only valid for log_EVENT_DeregisterIdLocal.
+///
+///  \return handle (>0) on success; -1 on error
+//------------------------------------------------------------------------------
+com_tSignalHandle log_EVENT_RegisterForIdLocal(  log_tEventId           eventId,
+                                                 log_tEventHandler      callback,
+                                                 void                 * user_data);
+
+//-- Function: log_EVENT_DeregisterIdLocal -------------------------------------
+///
+///  Remove a handler registered with log_EVENT_RegisterForIdLocal
+///
+///  \return 0 on success; -1 if the handle is unknown
+//------------------------------------------------------------------------------
+int log_EVENT_DeregisterIdLocal(com_tSignalHandle  handle);
+
+//-- Function: log_EVENT_LocalBegin --------------------------------------------
+///
+///  Hold back the dispatching of locally registered IDs, so a set of
+///  log_EVENT_RegisterForIdLocal/log_EVENT_DeregisterIdLocal calls takes
+///  effect at once. Handlers that run in the meantime wait until
+///  log_EVENT_LocalCommit. Keep the section short and do no D-Bus method
+///  calls inside it.
+///
+///  \return 0 on success; -1 if the interface could not be subscribed
+//------------------------------------------------------------------------------
+int log_EVENT_LocalBegin(void);
+
+//-- Function: log_EVENT_LocalCommit -------------------------------------------
+///
+///  End a section started with log_EVENT_LocalBegin
+//------------------------------------------------------------------------------
+void log_EVENT_LocalCommit(void);
+
 bool log_EVENT_GetState(     log_tEventId           eventId,
                              struct timeval   * timestamp,
                              int                first_arg_type, ...);
@@ -118,9 +210,64 @@ int led_GetLedStateWithIdInfo(   const char       * ledName,
                              tIdCtrlInfo      * id,
                              struct timeval   * timestamp);*/
 
+//-- Function: led_GetLedStatus ------------------------------------------------
+///
+///  Get the state of one LED. Read from the shared memory snapshot of
+///  ledserverd if available, otherwise asked over D-Bus.
+///  status->info.info is allocated and has to be freed by the caller.
+///
+///  \return 0 on success
+//------------------------------------------------------------------------------
 int led_GetLedStatus(const char * led_name,
                      tLedStatus * status);
 
+//-- Function: led_GetLedStatusSnapshot ----------------------------------------
+///
+///  Get the state of one LED from the shared memory snapshot only; no IPC.
+///  The name is compared case-insensitively, aliases are not resolved.
+///
+///  \return 0 on success; -1 if there is no snapshot or the LED is unknown
+//------------------------------------------------------------------------------
+int led_GetLedStatusSnapshot(const char * ledName,
+                             tLedStatus * status);
+
+//-- Function: led_GetAllLedStatusSnapshot -------------------------------------
+///
+///  Get the state of all LEDs from the shared memory snapshot in one
+///  consistent copy; no IPC. At most maxLeds states are copied.
+///
+///  \return number of LEDs in the snapshot, if this is more than maxLeds the
+///          result is truncated; -1 if there is no snapshot
+//------------------------------------------------------------------------------
+int led_GetAllLedStatusSnapshot(tLedStatus * status,
+                                int          maxLeds);
+
+//-- Function: led_SnapshotCreate ----------------------------------------------
+///
+///  Writer side, used by ledserverd: create (or take over) the shared memory
+///  snapshot for ledCount LEDs.
+///
+///  \return 0 on success; -1 on error
+//------------------------------------------------------------------------------
+int led_SnapshotCreate(uint32_t ledCount);
+
+//-- Function: led_SnapshotPublish ---------------------------------------------
+///
+///  Writer side: replace the snapshot with the given states. Does nothing if
+///  no LED changed. Calls must be serialized by the caller.
+///
+///  \return 0 on success; -1 if no snapshot was created
+//------------------------------------------------------------------------------
+int led_SnapshotPublish(const tLedStatus * status,
+                        uint32_t           count);
+
+//-- Function: led_SnapshotInvalidate ------------------------------------------
+///
+///  Writer side: mark the snapshot as stale, readers fall back to D-Bus.
+///  Async-signal-safe.
+//------------------------------------------------------------------------------
+void led_SnapshotInvalidate(void);
+
 void led_GetDbusInfoByState(DBusMessageIter * iter,tLedStatus * status);
 
 
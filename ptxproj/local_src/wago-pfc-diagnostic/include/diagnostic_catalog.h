@@ -0,0 +1,67 @@
+//------------------------------------------------------------------------------
+/// Copyright (c) WAGO GmbH & Co. KG
+///
+/// PROPRIETARY RIGHTS are involved in the subject matter of this material. All
+/// manufacturing, reproduction, use, and sales rights pertaining to this
+/// subject matter are governed by the license agreement. The recipient of this
+/// software implicitly accepts the terms of the license.
+//------------------------------------------------------------------------------
+/*
+ * diagnostic_catalog.h
+ *
+ * Binary catalog of the event strings of a diagnostic XML document.
+ *
+ * The catalog is compiled from the XML document on first use and cached in
+ * DIAGCAT_CACHE_DIR. It holds the set and reset strings of every event, sorted
+ * by ID, and is mapped read-only so a lookup is a binary search instead of a
+ * walk through the XML tree. A cached catalog is recompiled as soon as the
+ * modification time, size or inode of its XML document changes. A cached file
+ * is only used if it is owned by root (or the calling user) and not writable
+ * by group or others.
+ */
+
+#ifndef DIAGNOSTIC_CATALOG_H_
+#define DIAGNOSTIC_CATALOG_H_
+
+#include <stdint.h>
+#include "diagnostic_xml.h"
+
+#ifndef DIAGCAT_CACHE_DIR
+#define DIAGCAT_CACHE_DIR  "/var/cache/diagnostic"
+#endif
+#define DIAGCAT_SUFFIX     ".cat"
+
+typedef struct stDiagCatalog tDiagCatalog;
+
+/* string source of one document: the catalog or, if that fails, the XML tree */
+typedef struct {
+  tDiagCatalog * cat;
+  tDiagXml     * xml;
+}tDiagStrings;
+
+/*
+ * Returns the catalog of the given XML document, compiling it if the cached
+ * one is missing or outdated. Returns NULL if the document does not exist or
+ * cannot be parsed; the caller may then fall back to ParseDoc().
+ */
+tDiagCatalog * DIAGCAT_Open(const char * xmlPath);
+void DIAGCAT_Close(tDiagCatalog * cat);
+
+/*
+ * Same semantics as GetStringOfId()/GetResetStringOfId(): lan == NULL selects
+ * the default language, which is also used if lan is not translated. The
+ * returned strings belong to the catalog and must not be freed.
+ */
+const char * DIAGCAT_GetStringOfId(tDiagCatalog * cat, uint32_t id, const char * lan);
+const char * DIAGCAT_GetResetStringOfId(tDiagCatalog * cat, uint32_t id, const char * lan);
+
+/*
+ * Convenience for the two-document lookups of the tools: opens the catalog of
+ * xmlPath and parses the XML document only if the catalog is not available.
+ */
+void DIAGCAT_OpenStrings(tDiagStrings * strings, const char * xmlPath);
+void DIAGCAT_CloseStrings(tDiagStrings * strings);
+const char * DIAGCAT_StringOfId(tDiagStrings * strings, uint32_t id, const char * lan);
+const char * DIAGCAT_ResetStringOfId(tDiagStrings * strings, uint32_t id, const char * lan);
+
+#endif /* DIAGNOSTIC_CATALOG_H_ */
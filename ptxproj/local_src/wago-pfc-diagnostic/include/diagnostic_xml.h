@@ -178,6 +178,7 @@ int CreateLedEventList(tLedBehavior * ledBehavior, tLedFiles * ledFiles, tLedEve
 void FreeLedDefaults(tLedDefaults * pDef);
 void FreeLedNames(   tLedNames * pNames);
 int UpdateLedEventList(tLedBehavior * ledBehavior, tLedFiles * ledFiles, tLedEventList ** ledEvents);
+void FreeLedEvent(tLedEventList * event);
 
 //dirty
 void InitLedInfo(tLedInfo * ledInfo);
@@ -30,6 +30,7 @@
 #include "eactingbox.h"
 #include "parse_log.h"
 #include "diagnostic_xml.h"
+#include "diagnostic_catalog.h"
 
 //------------------------------------------------------------------------------
 // Defines
@@ -82,7 +83,7 @@ static void ShowHelp(void)
 int decodeid_main(int argc, char **argv)
 {
     char buffer[4096];
-    tDiagXml * docs[2];
+    tDiagStrings docs[2];
     char * lan = NULL;
     int exitval = -1;
 
@@ -97,8 +98,8 @@ int decodeid_main(int argc, char **argv)
       lan = argv[1];
     }
 
-    docs[0] = ParseDoc(DIAGNOSTIC_XML_DOCUMENT_CUSTOM);
-    docs[1] = ParseDoc(DIAGNOSTIC_XML_DOCUMENT);
+    DIAGCAT_OpenStrings(&docs[0], DIAGNOSTIC_XML_DOCUMENT_CUSTOM);
+    DIAGCAT_OpenStrings(&docs[1], DIAGNOSTIC_XML_DOCUMENT);
 
 
 
@@ -114,33 +115,30 @@ int decodeid_main(int argc, char **argv)
         int i;
         for(i = 0; i < 2; i++)
         {
-          if(docs[i] != NULL)
+          if(logData->set == true)
           {
-            if(logData->set == true)
+            //puts("setted");
+            string = DIAGCAT_StringOfId(&docs[i], logData->id, lan);
+            if(string != NULL)
             {
-              //puts("setted");
-              string = GetStringOfId(logData->id, docs[i], lan);
-              if(string != NULL)
-              {
-                break;
-              }
+              break;
             }
-            else
+          }
+          else
+          {
+            //puts("Resetted");
+            string = DIAGCAT_ResetStringOfId(&docs[i], logData->id, lan);
+            if(string != NULL)
             {
-              //puts("Resetted");
-              string = GetResetStringOfId(logData->id, docs[i], lan);
-              if(string != NULL)
-              {
-                resetStr = true;
-                break;
-              }
-              string = GetStringOfId(logData->id, docs[i], lan);
-              if(string != NULL)
-              {
-                break;
-              }
-
+              resetStr = true;
+              break;
             }
+            string = DIAGCAT_StringOfId(&docs[i], logData->id, lan);
+            if(string != NULL)
+            {
+              break;
+            }
+
           }
         }
 
@@ -158,6 +156,8 @@ int decodeid_main(int argc, char **argv)
         printf("%s",buffer);
       }
     }
+    DIAGCAT_CloseStrings(&docs[0]);
+    DIAGCAT_CloseStrings(&docs[1]);
     return exitval;
 }
 //---- End of source file ------------------------------------------------------
@@ -34,12 +34,14 @@
 #include "eactingbox.h"
 #include "parse_log.h"
 #include "diagnostic_xml.h"
+#include "diagnostic_catalog.h"
 #include "led_info_json.h"
 
 
 //------------------------------------------------------------------------------
 // Defines
 //------------------------------------------------------------------------------
+#define LED_STATE_LEDS_GUESS 64   // first buffer size for the snapshot
 
 
 //------------------------------------------------------------------------------
@@ -61,7 +63,7 @@ typedef enum
 } tTimestringFormat;
 
 typedef struct {
-    tDiagXml ** doc;
+    tDiagStrings * doc;
     tTimestringFormat tsformat;
 }tLedPrintParameters;
 
@@ -169,7 +171,7 @@ static int _StateToDepricated(tLedStatus * ledStatus,char * statestring,uint32_t
 
    return ret;
 }
-static void _PrintLedState(tDiagXml ** doc, tTimestringFormat tsformat, tLedStatus * ledStatus)
+static void _PrintLedState(tDiagStrings * doc, tTimestringFormat tsformat, tLedStatus * ledStatus)
 {
   char statestring[255];
   uint32_t var1=0;
@@ -198,7 +200,7 @@ static void _PrintLedState(tDiagXml ** doc, tTimestringFormat tsformat, tLedStat
 
     for(docnum=0;docnum<2;docnum++)
     {
-      valString = (char*)GetStringOfId(ledStatus->info.id, doc[docnum], NULL);
+      valString = (char*)DIAGCAT_StringOfId(&doc[docnum], ledStatus->info.id, NULL);
       if(valString != NULL)
       {
         break;
@@ -245,6 +247,50 @@ static void _PrintLedState(tDiagXml ** doc, tTimestringFormat tsformat, tLedStat
   }
 }
 
+static GList * _CreateLedStateListFromSnapshot(void)
+{
+  GList * list = NULL;
+  tLedStatus * states = NULL;
+  int maxLeds = LED_STATE_LEDS_GUESS;
+  int count;
+  int i;
+
+  // the snapshot tells how many LEDs it holds; retry with a buffer that fits
+  for(;;)
+  {
+    states = malloc(maxLeds * sizeof(tLedStatus));
+    if(states == NULL)
+    {
+      return NULL;
+    }
+    count = led_GetAllLedStatusSnapshot(states, maxLeds);
+    if(count <= maxLeds)
+    {
+      break;
+    }
+    for(i = 0; i < maxLeds; i++)
+    {
+      free(states[i].info.info);
+    }
+    free(states);
+    maxLeds = count;
+  }
+
+  for(i = 0; i < count; i++)
+  {
+    tLedStatus * ledState = malloc(sizeof(tLedStatus));
+    if(ledState == NULL)
+    {
+      free(states[i].info.info);
+      continue;
+    }
+    *ledState = states[i];
+    list = g_list_append(list, ledState);
+  }
+  free(states);
+  return list;
+}
+
 static GList * _CreateLedStateList(void)
 {
   GList * list = NULL;
@@ -254,6 +300,12 @@ static GList * _CreateLedStateList(void)
 
   int type;
   com_tConnection   dBusCon = { .bus = NULL };
+
+  list = _CreateLedStateListFromSnapshot();
+  if(list != NULL)
+  {
+    return list;
+  }
   com_GEN_Init(&dBusCon);
   message = dbus_message_new_method_call(LED_DBUS_NAME, LED_DBUS_PATH_ALL,
                                          NULL, LED_DBUS_GET_STATE_ALL);
@@ -390,7 +442,7 @@ static gint _CompareLedOrder(gconstpointer pLed1, gconstpointer pLed2, gpointer
 
 }
 
-static int _ShowLedInfoList(tDiagXml ** doc, tTimestringFormat tsformat)
+static int _ShowLedInfoList(tDiagStrings * doc, tTimestringFormat tsformat)
 {
   int exitval = 0;
 
@@ -421,7 +473,7 @@ static int _ShowLedInfoList(tDiagXml ** doc, tTimestringFormat tsformat)
   return exitval;
 }
 
-static int _ShowLedInfo(tDiagXml ** doc, tTimestringFormat tsformat, char *argName)
+static int _ShowLedInfo(tDiagStrings * doc, tTimestringFormat tsformat, char *argName)
 {
   int exitval = 0;
   tLedStatus ledState;
@@ -459,7 +511,7 @@ static int _ShowLedInfo(tDiagXml ** doc, tTimestringFormat tsformat, char *argNa
  */
 int getledstate_main(int argc, char **argv)
 {
-  tDiagXml * doc[2];
+  tDiagStrings doc[2];
   int exitval = 0;
 
   //expect either one or two additional arguments, see help
@@ -481,8 +533,8 @@ int getledstate_main(int argc, char **argv)
   closelog();
   openlog("getledstate",LOG_PERROR,LOG_USER);
 
-  doc[0] = ParseDoc(DIAGNOSTIC_XML_DOCUMENT_CUSTOM);
-  doc[1] = ParseDoc(DIAGNOSTIC_XML_DOCUMENT);
+  DIAGCAT_OpenStrings(&doc[0], DIAGNOSTIC_XML_DOCUMENT_CUSTOM);
+  DIAGCAT_OpenStrings(&doc[1], DIAGNOSTIC_XML_DOCUMENT);
   if(argc==2)
   {
     if(strcmp(argv[1], "--all") == 0 || strcmp(argv[1], "-a") == 0)
@@ -519,8 +571,8 @@ int getledstate_main(int argc, char **argv)
       }
     }
   }
-  FreeDiagXml(doc[0]);
-  FreeDiagXml(doc[1]);
+  DIAGCAT_CloseStrings(&doc[0]);
+  DIAGCAT_CloseStrings(&doc[1]);
   return exitval;
 }
 //---- End of source file ------------------------------------------------------
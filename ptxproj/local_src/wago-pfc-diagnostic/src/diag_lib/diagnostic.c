@@ -16,6 +16,7 @@
 ///
 ///  \author   <author> : WAGO GmbH & Co. KG
 //------------------------------------------------------------------------------
+#include "config.h"
 #include <diagnostic/diagnostic_API.h>
 #include <LedCtl_API.h>
 #include <dbus/dbus.h>
@@ -25,16 +26,93 @@
 #include <stdarg.h>
 #include <string.h>
 #include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
 
 #define LOG_ID_NAME_FORMAT    "ID%.8X"
 #define LOG_ID_NAME_PREALLOC  "ID00000000"
 
+#define LOG_ASYNC_DEFAULT_DEPTH  256
+#define LOG_ASYNC_MAX_DEPTH      (64 * 1024)
+#define LOG_ASYNC_MAX_ARGS       8     // parameters stored in the slot itself
+#define LOG_ASYNC_FLUSH_TIMEOUT  1000  // ms to wait for the sender in log_EVENT_Flush
+
 typedef struct {
     log_tEventId      id;
     log_tEventHandler callback;
     void *        user_data;
 }tEvent;
 
+typedef struct {
+    int type;
+    union {
+        int32_t  i32;
+        uint32_t u32;
+        int16_t  i16;
+        uint16_t u16;
+        uint8_t  byte;
+    } value;
+}tLogArg;
+
+// one queued event; everything is copied at enqueue time, so the caller's
+// parameters may go out of scope right after log_EVENT_LogIdParam returns;
+// parameters beyond LOG_ASYNC_MAX_ARGS go to a heap array freed by the sender
+typedef struct {
+    unsigned long   seq;
+    log_tEventId    id;
+    bool            set;
+    unsigned int    argc;
+    struct timespec stamp;
+    tLogArg         args[LOG_ASYNC_MAX_ARGS];
+    tLogArg       * moreArgs;
+}tLogSlot;
+
+typedef struct {
+    tLogSlot         * ring;
+    unsigned long      mask;
+    unsigned long      head;     // next slot to claim for producers
+    unsigned long      tail;     // next slot to send, sender thread only
+    int                fdWake;
+    int                sleeping;
+    int                alive;    // cleared when the sender thread terminates
+    log_tAsyncOverflow overflow;
+    pthread_t          thread;
+    unsigned long      enqueued;
+    unsigned long      sent;
+    unsigned long      dropped;
+    unsigned long      blocked;
+    unsigned long      flushes;
+    unsigned long      highWater;
+}tLogAsync;
+
+static tLogAsync * logAsync = NULL;
+
+// handlers registered with log_EVENT_RegisterForIdLocal; all of them share one
+// match rule for the whole interface and are looked up by ID in a hash table
+typedef struct stLocalEvent {
+    log_tEventId          id;
+    com_tSignalHandle     handle;
+    log_tEventHandler     callback;
+    void                * user_data;
+    struct stLocalEvent * pNext;    // next handler for the same ID
+    bool                  removed;  // deregistered while a dispatch was running
+    struct stLocalEvent * pFree;    // next entry to free after the dispatch
+}tLocalEvent;
+
+static pthread_mutex_t   localMutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+static pthread_mutex_t   localSubscribeMutex = PTHREAD_MUTEX_INITIALIZER;
+static GHashTable      * localById = NULL;
+static GHashTable      * localByHandle = NULL;
+static com_tSignalHandle localSignal = -1;
+static com_tSignalHandle localNextHandle = 1;
+// entries deregistered from inside a handler are freed when the dispatch ends
+static unsigned int      localDispatchDepth = 0;
+static tLocalEvent     * localFreeList = NULL;
+
 #if 1
 static char   programNameArray[64];
 static char   *programName;
@@ -61,9 +139,10 @@ void log_EVENT_LogId(         log_tEventId           id,
   log_EVENT_LogIdParam(id,set,LOG_TYPE_INVALID);
 }
 
-void log_EVENT_LogIdParam(    log_tEventId           id,
-                                   bool          set,
-                                   int           first_arg_type, ...)
+static void LogIdParamSync(  log_tEventId           id,
+                              bool               set,
+                              int                first_arg_type,
+                              va_list            var_args)
 {
   struct timeval tv;
   static char strId[16] = LOG_ID_NAME_PREALLOC;
@@ -73,7 +152,6 @@ void log_EVENT_LogIdParam(    log_tEventId           id,
   DBusMessage *message;
   DBusMessageIter iter;
   int type;
-  va_list var_args;
 
   gettimeofday(&tv, NULL);
   if(set == false)
@@ -98,7 +176,6 @@ void log_EVENT_LogIdParam(    log_tEventId           id,
   dbus_message_iter_append_basic (&iter, DBUS_TYPE_BOOLEAN, &(dbSet));
   if(first_arg_type != LOG_TYPE_INVALID)
   {
-    va_start (var_args, first_arg_type);
     type = first_arg_type;
     while (type != LOG_TYPE_INVALID)
     {
@@ -133,7 +210,6 @@ void log_EVENT_LogIdParam(    log_tEventId           id,
       }
       type = va_arg (var_args, int);
     }
-    va_end(var_args);
   }
   (void)com_GEN_BlockThreadCancelling();
   dbus_connection_send(
@@ -146,6 +222,425 @@ void log_EVENT_LogIdParam(    log_tEventId           id,
   dbus_message_unref(message);
 }
 
+//-- Function: AppendArg --------------------------------------------------------
+///
+///  Append one captured parameter to a diagnostic signal
+//------------------------------------------------------------------------------
+static void AppendArg(DBusMessageIter * iter, const tLogArg * arg)
+{
+  dbus_message_iter_append_basic (iter, arg->type, &arg->value);
+}
+
+//-- Function: CaptureArgs ------------------------------------------------------
+///
+///  Copy the variable parameters of an event into a queue slot. Parameters
+///  beyond LOG_ASYNC_MAX_ARGS are stored in slot->moreArgs.
+///
+///  \return true on success; false if memory for the parameters is missing
+//------------------------------------------------------------------------------
+static bool CaptureArgs(tLogSlot * slot, int first_arg_type, va_list var_args)
+{
+  int type = first_arg_type;
+  unsigned int moreSize = 0;
+
+  slot->argc = 0;
+  slot->moreArgs = NULL;
+  while (type != LOG_TYPE_INVALID)
+  {
+    tLogArg * arg;
+    if(slot->argc < LOG_ASYNC_MAX_ARGS)
+    {
+      arg = &slot->args[slot->argc];
+    }
+    else
+    {
+      unsigned int more = slot->argc - LOG_ASYNC_MAX_ARGS;
+      if(more == moreSize)
+      {
+        tLogArg * moreArgs;
+        moreSize = (moreSize == 0) ? LOG_ASYNC_MAX_ARGS : moreSize * 2;
+        moreArgs = realloc(slot->moreArgs, moreSize * sizeof(tLogArg));
+        if(moreArgs == NULL)
+        {
+          free(slot->moreArgs);
+          slot->moreArgs = NULL;
+          return false;
+        }
+        slot->moreArgs = moreArgs;
+      }
+      arg = &slot->moreArgs[more];
+    }
+    arg->type = type;
+    if(type == LOG_TYPE_INT32)
+    {
+      arg->value.i32 = *va_arg(var_args, int32_t*);
+    }
+    else if(type == LOG_TYPE_UINT16)
+    {
+      arg->value.u16 = *va_arg(var_args, uint16_t*);
+    }
+    else if(type == LOG_TYPE_UINT32)
+    {
+      arg->value.u32 = *va_arg(var_args, uint32_t*);
+    }
+    else if(type == LOG_TYPE_INT16)
+    {
+      arg->value.i16 = *va_arg(var_args, int16_t*);
+    }
+    else if(type == LOG_TYPE_BYTE)
+    {
+      arg->value.byte = *va_arg(var_args, uint8_t*);
+    }
+    else
+    {
+      // the synchronous path stops at an unknown type as well
+      break;
+    }
+    slot->argc++;
+    type = va_arg (var_args, int);
+  }
+  return true;
+}
+
+//-- Function: SendSlot ---------------------------------------------------------
+///
+///  Build the signal for a queued event and hand it to libdbus without flushing
+//------------------------------------------------------------------------------
+static void SendSlot(DBusConnection * bus, const tLogSlot * slot)
+{
+  char strId[16];
+  DBusMessage *message;
+  DBusMessageIter iter;
+  com_tComBool dbSet = slot->set ? TRUE : FALSE;
+  time_t sec = slot->stamp.tv_sec;
+  time_t usec = slot->stamp.tv_nsec / 1000;
+  unsigned int i;
+
+  sprintf(strId, LOG_ID_NAME_FORMAT, slot->id);
+  message = dbus_message_new_signal(LOG_PATH,LOG_INTERFACE, strId);
+  if(message == NULL)
+  {
+    return;
+  }
+  dbus_message_iter_init_append (message, &iter);
+  dbus_message_iter_append_basic (&iter, COM_TYPE_TIME_T, &sec);
+  dbus_message_iter_append_basic (&iter, COM_TYPE_TIME_T, &usec);
+  dbus_message_iter_append_basic (&iter, DBUS_TYPE_STRING, &(programName));
+  dbus_message_iter_append_basic (&iter, DBUS_TYPE_BOOLEAN, &(dbSet));
+  for(i = 0; i < slot->argc; i++)
+  {
+    AppendArg(&iter, (i < LOG_ASYNC_MAX_ARGS) ? &slot->args[i]
+                                              : &slot->moreArgs[i - LOG_ASYNC_MAX_ARGS]);
+  }
+  dbus_connection_send(bus, message, NULL);
+  dbus_message_unref(message);
+}
+
+//-- Function: AsyncSender ------------------------------------------------------
+///
+///  Background thread of the asynchronous mode. Sends everything that is
+///  queued and flushes the connection once per burst.
+//------------------------------------------------------------------------------
+static void * AsyncSender(void * user_data)
+{
+  tLogAsync * async = user_data;
+  DBusConnection * bus = (DBusConnection*)com_GEN_GetDBusVar(&diagnosticConnection,
+                                                             DBUSVAR_CONNECTION);
+
+  while(1)
+  {
+    unsigned long batch = 0;
+
+    for(;;)
+    {
+      unsigned long pos = async->tail;
+      tLogSlot * slot = &async->ring[pos & async->mask];
+      if(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != pos + 1)
+      {
+        break;
+      }
+      SendSlot(bus, slot);
+      free(slot->moreArgs);
+      slot->moreArgs = NULL;
+      __atomic_store_n(&slot->seq, pos + async->mask + 1, __ATOMIC_RELEASE);
+      __atomic_store_n(&async->tail, pos + 1, __ATOMIC_RELEASE);
+      batch++;
+    }
+
+    if(batch > 0)
+    {
+      dbus_connection_flush(bus);
+      __atomic_add_fetch(&async->sent, batch, __ATOMIC_RELAXED);
+      __atomic_add_fetch(&async->flushes, 1, __ATOMIC_RELAXED);
+      // look again before sleeping; producers may have queued more meanwhile
+      continue;
+    }
+
+    __atomic_store_n(&async->sleeping, 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if(__atomic_load_n(&async->ring[async->tail & async->mask].seq, __ATOMIC_ACQUIRE)
+       != async->tail + 1)
+    {
+      uint64_t count;
+      if(read(async->fdWake, &count, sizeof count) < 0 && errno != EINTR)
+      {
+        break;
+      }
+    }
+    __atomic_store_n(&async->sleeping, 0, __ATOMIC_RELAXED);
+  }
+  // producers waiting for a free slot (LOG_ASYNC_OVERFLOW_BLOCK) give up now
+  __atomic_store_n(&async->alive, 0, __ATOMIC_RELEASE);
+  return NULL;
+}
+
+//-- Function: LogIdParamAsync --------------------------------------------------
+///
+///  Queue an event for the sender thread
+///
+///  \return true if the event was queued or dropped by the overflow policy;
+///          false if it has to be sent synchronously because the sender
+///          thread is gone or the parameters couldn't be copied
+//------------------------------------------------------------------------------
+static bool LogIdParamAsync(tLogAsync * async, log_tEventId id, bool set,
+                            int first_arg_type, va_list var_args)
+{
+  tLogSlot event;
+  unsigned long pos;
+  unsigned long fill;
+  tLogSlot * slot;
+  bool waited = false;
+
+  if(!__atomic_load_n(&async->alive, __ATOMIC_ACQUIRE))
+  {
+    return false;
+  }
+
+  // take the timestamp before queueing so it reflects the order of the calls
+  clock_gettime(CLOCK_REALTIME, &event.stamp);
+  event.id = id;
+  event.set = set;
+  if(!CaptureArgs(&event, first_arg_type, var_args))
+  {
+    // keep the order: everything queued before goes out first
+    log_EVENT_Flush();
+    return false;
+  }
+
+  pos = __atomic_load_n(&async->head, __ATOMIC_RELAXED);
+  for(;;)
+  {
+    long diff;
+    slot = &async->ring[pos & async->mask];
+    diff = (long)(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) - pos);
+    if(diff == 0)
+    {
+      if(__atomic_compare_exchange_n(&async->head, &pos, pos + 1, true,
+                                     __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+      {
+        break;
+      }
+    }
+    else if(diff < 0)
+    {
+      if(async->overflow == LOG_ASYNC_OVERFLOW_DROP)
+      {
+        __atomic_add_fetch(&async->dropped, 1, __ATOMIC_RELAXED);
+        free(event.moreArgs);
+        return true;
+      }
+      if(!__atomic_load_n(&async->alive, __ATOMIC_ACQUIRE))
+      {
+        // the sender won't make room anymore
+        free(event.moreArgs);
+        return false;
+      }
+      if(!waited)
+      {
+        __atomic_add_fetch(&async->blocked, 1, __ATOMIC_RELAXED);
+        waited = true;
+      }
+      usleep(100);
+      pos = __atomic_load_n(&async->head, __ATOMIC_RELAXED);
+    }
+    else
+    {
+      pos = __atomic_load_n(&async->head, __ATOMIC_RELAXED);
+    }
+  }
+
+  slot->id    = event.id;
+  slot->set   = event.set;
+  slot->argc  = event.argc;
+  slot->stamp = event.stamp;
+  memcpy(slot->args, event.args,
+         ((event.argc < LOG_ASYNC_MAX_ARGS) ? event.argc : LOG_ASYNC_MAX_ARGS) * sizeof(tLogArg));
+  slot->moreArgs = event.moreArgs;
+  __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+
+  fill = pos + 1 - __atomic_load_n(&async->tail, __ATOMIC_RELAXED);
+  if(fill > __atomic_load_n(&async->highWater, __ATOMIC_RELAXED))
+  {
+    __atomic_store_n(&async->highWater, fill, __ATOMIC_RELAXED);
+  }
+  __atomic_add_fetch(&async->enqueued, 1, __ATOMIC_RELAXED);
+
+  // pairs with the fence in AsyncSender: either the sender sees the new slot
+  // before it sleeps or we see it sleeping and wake it up
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  if(__atomic_exchange_n(&async->sleeping, 0, __ATOMIC_RELAXED))
+  {
+    uint64_t one = 1;
+    if(write(async->fdWake, &one, sizeof one) < 0)
+    {
+      // nothing to do; the sender picks the event up with the next wakeup
+    }
+  }
+  return true;
+}
+
+void log_EVENT_LogIdParam(    log_tEventId           id,
+                                   bool          set,
+                                   int           first_arg_type, ...)
+{
+  tLogAsync * async = __atomic_load_n(&logAsync, __ATOMIC_ACQUIRE);
+  va_list var_args;
+
+  va_start (var_args, first_arg_type);
+  if(async != NULL)
+  {
+    va_list copy;
+    bool queued;
+    va_copy(copy, var_args);
+    queued = LogIdParamAsync(async, id, set, first_arg_type, copy);
+    va_end(copy);
+    if(queued)
+    {
+      va_end(var_args);
+      return;
+    }
+  }
+  LogIdParamSync(id, set, first_arg_type, var_args);
+  va_end(var_args);
+}
+
+int log_EVENT_SetAsync(       uint32_t           depth,
+                              log_tAsyncOverflow overflow)
+{
+  static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+  tLogAsync * async;
+  unsigned long size = 2;
+  unsigned long i;
+
+  if(libInitDone == false)
+  {
+    return -1;
+  }
+  pthread_mutex_lock(&mutex);
+  if(logAsync != NULL)
+  {
+    // the mode can only be switched on once; later calls just change the policy
+    logAsync->overflow = overflow;
+    pthread_mutex_unlock(&mutex);
+    return 0;
+  }
+
+  if(depth == 0)
+  {
+    depth = LOG_ASYNC_DEFAULT_DEPTH;
+  }
+  if(depth > LOG_ASYNC_MAX_DEPTH)
+  {
+    depth = LOG_ASYNC_MAX_DEPTH;
+  }
+  while(size < depth)
+  {
+    size <<= 1;
+  }
+
+  async = calloc(1, sizeof(tLogAsync));
+  if(async == NULL)
+  {
+    pthread_mutex_unlock(&mutex);
+    return -1;
+  }
+  async->ring = calloc(size, sizeof(tLogSlot));
+  async->fdWake = eventfd(0, EFD_CLOEXEC);
+  if(async->ring == NULL || async->fdWake < 0)
+  {
+    goto error;
+  }
+  for(i = 0; i < size; i++)
+  {
+    async->ring[i].seq = i;
+  }
+  async->mask = size - 1;
+  async->overflow = overflow;
+  async->alive = 1;
+
+  if(pthread_create(&async->thread, NULL, AsyncSender, async))
+  {
+    goto error;
+  }
+#ifdef HAVE_PTHREAD_SETNAME_NP
+  pthread_setname_np(async->thread, "diag_sender");
+#endif
+  __atomic_store_n(&logAsync, async, __ATOMIC_RELEASE);
+  atexit(log_EVENT_Flush);
+  pthread_mutex_unlock(&mutex);
+  return 0;
+
+error:
+  if(async->fdWake >= 0)
+  {
+    close(async->fdWake);
+  }
+  free(async->ring);
+  free(async);
+  pthread_mutex_unlock(&mutex);
+  return -1;
+}
+
+void log_EVENT_Flush(void)
+{
+  tLogAsync * async = __atomic_load_n(&logAsync, __ATOMIC_ACQUIRE);
+  unsigned long head;
+  int waited = 0;
+
+  if(async == NULL)
+  {
+    return;
+  }
+  head = __atomic_load_n(&async->head, __ATOMIC_RELAXED);
+  while(   ((long)(__atomic_load_n(&async->tail, __ATOMIC_ACQUIRE) - head) < 0)
+        && (waited < LOG_ASYNC_FLUSH_TIMEOUT)
+        && __atomic_load_n(&async->alive, __ATOMIC_ACQUIRE))
+  {
+    usleep(1000);
+    waited++;
+  }
+}
+
+int log_EVENT_GetAsyncStats(  log_tAsyncStats  * stats)
+{
+  tLogAsync * async = __atomic_load_n(&logAsync, __ATOMIC_ACQUIRE);
+
+  if(async == NULL || stats == NULL)
+  {
+    return -1;
+  }
+  stats->depth     = async->mask + 1;
+  stats->pending   = __atomic_load_n(&async->head, __ATOMIC_RELAXED)
+                   - __atomic_load_n(&async->tail, __ATOMIC_RELAXED);
+  stats->enqueued  = __atomic_load_n(&async->enqueued, __ATOMIC_RELAXED);
+  stats->sent      = __atomic_load_n(&async->sent, __ATOMIC_RELAXED);
+  stats->dropped   = __atomic_load_n(&async->dropped, __ATOMIC_RELAXED);
+  stats->blocked   = __atomic_load_n(&async->blocked, __ATOMIC_RELAXED);
+  stats->flushes   = __atomic_load_n(&async->flushes, __ATOMIC_RELAXED);
+  stats->highWater = __atomic_load_n(&async->highWater, __ATOMIC_RELAXED);
+  return 0;
+}
+
 /*void log_EVENT_LogDev(        int priority,
                               const char         format, ...);*/
 
@@ -209,6 +704,178 @@ int log_EVENT_DeregisterId(com_tSignalHandle  handle)
                                  (void(*)(void *user_data)) FreeEventHandler);
 }
 
+//-- Function: log_EVENT_LocalDispatch -----------------------------------------
+///
+///  Handler of the interface-wide subscription; looks up the handlers of the
+///  signal's ID and calls them
+//------------------------------------------------------------------------------
+static void log_EVENT_LocalDispatch(com_tConnection * con, com_tComMessage * msg, void * unused)
+{
+  const char * member = dbus_message_get_member(msg->msg);
+  log_tEventId id;
+  char * end;
+  tLocalEvent * event;
+
+  (void)unused;
+  if(   (member == NULL)
+     || (member[0] != 'I')
+     || (member[1] != 'D'))
+  {
+    return;
+  }
+  id = (log_tEventId)strtoul(member + 2, &end, 16);
+  if((end == member + 2) || (*end != '\0'))
+  {
+    return;
+  }
+
+  pthread_mutex_lock(&localMutex);
+  localDispatchDepth++;
+  event = (localById != NULL) ? g_hash_table_lookup(localById, GUINT_TO_POINTER(id)) : NULL;
+  while(event != NULL)
+  {
+    // handlers may deregister any entry; those stay allocated and keep their
+    // pNext until the dispatch is over, but aren't called anymore
+    if(!event->removed)
+    {
+      event->callback(con, msg, event->id, event->user_data);
+    }
+    event = event->pNext;
+  }
+  if(--localDispatchDepth == 0)
+  {
+    while(localFreeList != NULL)
+    {
+      event = localFreeList;
+      localFreeList = event->pFree;
+      free(event);
+    }
+  }
+  pthread_mutex_unlock(&localMutex);
+}
+
+//-- Function: _LocalSubscribe --------------------------------------------------
+///
+///  Add the interface-wide match rule once. Must not be called with localMutex
+///  held: adding the match rule is a method call and the receiver thread may
+///  be waiting for localMutex in the dispatcher.
+///
+///  \return 0 if subscribed; -1 on error
+//------------------------------------------------------------------------------
+static int _LocalSubscribe(void)
+{
+  pthread_mutex_lock(&localSubscribeMutex);
+  if(localSignal < 0)
+  {
+    localSignal = com_MSG_RegisterSignal(&diagnosticConnection,
+                                         LOG_INTERFACE,
+                                         NULL,
+                                         (com_tHandlerFunction)log_EVENT_LocalDispatch,
+                                         NULL);
+  }
+  pthread_mutex_unlock(&localSubscribeMutex);
+  return (localSignal < 0) ? -1 : 0;
+}
+
+com_tSignalHandle log_EVENT_RegisterForIdLocal(  log_tEventId           eventId,
+                                                 log_tEventHandler      callback,
+                                                 void                 * user_data)
+{
+  tLocalEvent * event;
+
+  if(_LocalSubscribe())
+  {
+    return -1;
+  }
+
+  event = malloc(sizeof(tLocalEvent));
+  if(event == NULL)
+  {
+    return -1;
+  }
+  event->id        = eventId;
+  event->callback  = callback;
+  event->user_data = user_data;
+  event->removed   = false;
+  event->pFree     = NULL;
+
+  pthread_mutex_lock(&localMutex);
+  if(localById == NULL)
+  {
+    localById = g_hash_table_new(g_direct_hash, g_direct_equal);
+    localByHandle = g_hash_table_new(g_direct_hash, g_direct_equal);
+  }
+  event->handle = localNextHandle++;
+  event->pNext = g_hash_table_lookup(localById, GUINT_TO_POINTER(eventId));
+  g_hash_table_insert(localById, GUINT_TO_POINTER(eventId), event);
+  g_hash_table_insert(localByHandle, GINT_TO_POINTER(event->handle), event);
+  pthread_mutex_unlock(&localMutex);
+
+  return event->handle;
+}
+
+int log_EVENT_DeregisterIdLocal(com_tSignalHandle  handle)
+{
+  tLocalEvent * event;
+  tLocalEvent * head;
+
+  pthread_mutex_lock(&localMutex);
+  event = (localByHandle != NULL) ? g_hash_table_lookup(localByHandle, GINT_TO_POINTER(handle)) : NULL;
+  if(event == NULL)
+  {
+    pthread_mutex_unlock(&localMutex);
+    return -1;
+  }
+  g_hash_table_remove(localByHandle, GINT_TO_POINTER(handle));
+
+  head = g_hash_table_lookup(localById, GUINT_TO_POINTER(event->id));
+  if(head == event)
+  {
+    if(event->pNext != NULL)
+    {
+      g_hash_table_insert(localById, GUINT_TO_POINTER(event->id), event->pNext);
+    }
+    else
+    {
+      g_hash_table_remove(localById, GUINT_TO_POINTER(event->id));
+    }
+  }
+  else
+  {
+    while(head->pNext != event)
+    {
+      head = head->pNext;
+    }
+    head->pNext = event->pNext;
+  }
+  if(localDispatchDepth > 0)
+  {
+    event->removed = true;
+    event->pFree = localFreeList;
+    localFreeList = event;
+    event = NULL;
+  }
+  pthread_mutex_unlock(&localMutex);
+
+  free(event);
+  return 0;
+}
+
+int log_EVENT_LocalBegin(void)
+{
+  if(_LocalSubscribe())
+  {
+    return -1;
+  }
+  pthread_mutex_lock(&localMutex);
+  return 0;
+}
+
+void log_EVENT_LocalCommit(void)
+{
+  pthread_mutex_unlock(&localMutex);
+}
+
 bool log_EVENT_GetState(     log_tEventId           eventId,
                              struct timeval   * timestamp,
                              int                first_arg_type, ...)
@@ -574,6 +1241,10 @@ int led_GetLedStatus(const char * led_name,
   sprintf(path, LED_DBUS_PATH "%s", led_name);
   DBusMessage * lastmsg;
   DBusMessageIter iter;
+  if(0 == led_GetLedStatusSnapshot(led_name, status))
+  {
+    return 0;
+  }
   ret = com_MSG_MethodCall(&diagnosticConnection,LED_DBUS_NAME,
                          path, LED_DBUS_GET_STATE,
                          COM_TYPE_INVALID,
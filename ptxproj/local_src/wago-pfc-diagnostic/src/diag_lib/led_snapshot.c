@@ -0,0 +1,404 @@
+//------------------------------------------------------------------------------
+/// Copyright (c) WAGO GmbH & Co. KG
+///
+/// PROPRIETARY RIGHTS are involved in the subject matter of this material.
+/// All manufacturing, reproduction, use and sales rights pertaining to this
+/// subject matter are governed by the license agreement. The recipient of this
+/// software implicitly accepts the terms of the license.
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+///
+///  \file     led_snapshot.c
+///
+///  \version  $Revision: 1 $
+///
+///  \brief    shared memory snapshot of all LED states
+///
+///            ledserverd publishes the state of every LED into a shared memory
+///            object protected by a sequence lock; readers copy it without any
+///            IPC and retry if they raced with an update. Readers ignore the
+///            snapshot once the writer process is gone, even if it could not
+///            invalidate it (SIGKILL, crash). Every run of the writer creates
+///            a new object; readers only map it if it belongs to root and
+///            nobody else may write it.
+///
+///  \author   <author> : WAGO GmbH & Co. KG
+//------------------------------------------------------------------------------
+#include "config.h"
+#include <diagnostic/diagnostic_API.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <errno.h>
+
+#define LED_SNAPSHOT_MAGIC       0x4C454453  // "LEDS"
+#define LED_SNAPSHOT_VERSION     2
+#define LED_SNAPSHOT_INFO_SIZE   256
+#define LED_SNAPSHOT_MAX_LEDS    256
+#define LED_SNAPSHOT_MAX_RETRY   1000        // reads racing with updates before giving up
+
+typedef struct {
+    char      name[16];
+    int32_t   state;
+    int64_t   tv_sec;
+    int64_t   tv_usec;
+    tLedVars  vars;
+    uint32_t  id;
+    char      info[LED_SNAPSHOT_INFO_SIZE];   // parameters as formatted by _GetIdCtrlInfo
+}tLedSnapshotEntry;
+
+typedef struct {
+    uint32_t  magic;
+    uint32_t  version;
+    uint32_t  entrySize;
+    uint32_t  ledCount;
+    uint32_t  valid;          // cleared when ledserverd stops
+    uint32_t  seq;            // odd while the writer updates the entries
+    int32_t   writerPid;      // readers check that the writer still exists
+    tLedSnapshotEntry leds[];
+}tLedSnapshot;
+
+// reader side
+static pthread_mutex_t   snapMapMutex = PTHREAD_MUTEX_INITIALIZER;
+static tLedSnapshot    * snapMap = NULL;
+static size_t            snapMapSize = 0;
+static dev_t             snapMapDev;
+static ino_t             snapMapIno;
+
+// writer side
+static tLedSnapshot    * snapWrite = NULL;
+static tLedSnapshotEntry * snapShadow = NULL;
+
+static size_t _SnapshotSize(uint32_t ledCount)
+{
+  return sizeof(tLedSnapshot) + ledCount * sizeof(tLedSnapshotEntry);
+}
+
+static void _StatusToEntry(tLedSnapshotEntry * entry, const tLedStatus * status)
+{
+  memset(entry, 0, sizeof(*entry));
+  strncpy(entry->name, status->name, sizeof(entry->name) - 1);
+  entry->state = status->state;
+  entry->tv_sec = status->timestamp.tv_sec;
+  entry->tv_usec = status->timestamp.tv_usec;
+  entry->vars = status->vars;
+  entry->id = status->info.id;
+  if(status->info.info != NULL)
+  {
+    strncpy(entry->info, status->info.info, sizeof(entry->info) - 1);
+  }
+}
+
+static void _EntryToStatus(tLedStatus * status, const tLedSnapshotEntry * entry)
+{
+  memset(status, 0, sizeof(*status));
+  memcpy(status->name, entry->name, sizeof(status->name));
+  status->name[sizeof(status->name) - 1] = 0;
+  status->state = entry->state;
+  status->timestamp.tv_sec = entry->tv_sec;
+  status->timestamp.tv_usec = entry->tv_usec;
+  status->vars = entry->vars;
+  status->info.id = entry->id;
+  status->info.info = (entry->info[0] != 0) ? strndup(entry->info, sizeof(entry->info)) : NULL;
+}
+
+//------------------------------------------------------------------------------
+// writer
+//------------------------------------------------------------------------------
+int led_SnapshotCreate(uint32_t ledCount)
+{
+  size_t size = _SnapshotSize(ledCount);
+  void * map;
+  int fd;
+
+  if(snapWrite != NULL || ledCount == 0 || ledCount > LED_SNAPSHOT_MAX_LEDS)
+  {
+    return -1;
+  }
+  snapShadow = calloc(ledCount, sizeof(tLedSnapshotEntry));
+  if(snapShadow == NULL)
+  {
+    return -1;
+  }
+  // never take over an existing object, somebody else may have created it;
+  // readers still mapping the one of a previous run keep it until they see
+  // it invalid and remap
+  (void)shm_unlink(LED_SNAPSHOT_SHM_NAME);
+  fd = shm_open(LED_SNAPSHOT_SHM_NAME, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+  if(fd < 0)
+  {
+    free(snapShadow);
+    snapShadow = NULL;
+    return -1;
+  }
+  if(ftruncate(fd, size))
+  {
+    close(fd);
+    free(snapShadow);
+    snapShadow = NULL;
+    return -1;
+  }
+  map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if(map == MAP_FAILED)
+  {
+    free(snapShadow);
+    snapShadow = NULL;
+    return -1;
+  }
+  snapWrite = map;
+
+  // odd sequence keeps readers out while the header is written
+  __atomic_store_n(&snapWrite->seq, 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  snapWrite->magic = LED_SNAPSHOT_MAGIC;
+  snapWrite->version = LED_SNAPSHOT_VERSION;
+  snapWrite->entrySize = sizeof(tLedSnapshotEntry);
+  snapWrite->ledCount = ledCount;
+  snapWrite->writerPid = getpid();
+  snapWrite->valid = 1;
+  __atomic_store_n(&snapWrite->seq, 2, __ATOMIC_RELEASE);
+  return 0;
+}
+
+int led_SnapshotPublish(const tLedStatus * status, uint32_t count)
+{
+  tLedSnapshotEntry entry;
+  uint32_t changed = 0;
+  uint32_t seq;
+  uint32_t i;
+
+  if(snapWrite == NULL || count > snapWrite->ledCount)
+  {
+    return -1;
+  }
+  // compare against the last published state first, readers must not retry
+  // for updates that change nothing
+  for(i = 0; i < count; i++)
+  {
+    _StatusToEntry(&entry, &status[i]);
+    if(memcmp(&entry, &snapShadow[i], sizeof(entry)))
+    {
+      memcpy(&snapShadow[i], &entry, sizeof(entry));
+      changed++;
+    }
+  }
+  if(changed == 0)
+  {
+    return 0;
+  }
+
+  seq = __atomic_load_n(&snapWrite->seq, __ATOMIC_RELAXED);
+  __atomic_store_n(&snapWrite->seq, seq + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  memcpy(snapWrite->leds, snapShadow, count * sizeof(tLedSnapshotEntry));
+  __atomic_store_n(&snapWrite->seq, seq + 2, __ATOMIC_RELEASE);
+  return 0;
+}
+
+void led_SnapshotInvalidate(void)
+{
+  // async-signal-safe, called from ledserverd's signal handler
+  if(snapWrite != NULL)
+  {
+    __atomic_store_n(&snapWrite->valid, 0, __ATOMIC_RELEASE);
+  }
+}
+
+//------------------------------------------------------------------------------
+// reader
+//------------------------------------------------------------------------------
+static int _WriterAlive(pid_t pid)
+{
+  // EPERM: the process exists but belongs to another user
+  return (pid > 0) && (!kill(pid, 0) || (errno == EPERM));
+}
+
+static int _SnapshotTrusted(const struct stat * st)
+{
+  // only ledserverd running as root may provide the LED states
+  return    S_ISREG(st->st_mode)
+         && (st->st_uid == 0)
+         && !(st->st_mode & (S_IWGRP | S_IWOTH));
+}
+
+//-- Function: _SnapshotMap ----------------------------------------------------
+///
+///  Get the mapping of the snapshot, map it on first use. With remap set the
+///  object is opened again and mapped if it was replaced by a new writer; the
+///  old mapping is left in place as other threads may still read it.
+///
+///  \return mapping or NULL, size of the mapping in size
+//------------------------------------------------------------------------------
+static tLedSnapshot * _SnapshotMap(int remap, size_t * size)
+{
+  tLedSnapshot * snap;
+
+  pthread_mutex_lock(&snapMapMutex);
+  if((snapMap == NULL) || remap)
+  {
+    int fd = shm_open(LED_SNAPSHOT_SHM_NAME, O_RDONLY | O_CLOEXEC, 0);
+    if(fd >= 0)
+    {
+      struct stat st;
+      if(   !fstat(fd, &st)
+         && _SnapshotTrusted(&st)
+         && ((size_t)st.st_size >= sizeof(tLedSnapshot))
+         && (   (snapMap == NULL)
+             || (st.st_dev != snapMapDev)
+             || (st.st_ino != snapMapIno)))
+      {
+        void * map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if(map != MAP_FAILED)
+        {
+          snapMap = map;
+          snapMapSize = st.st_size;
+          snapMapDev = st.st_dev;
+          snapMapIno = st.st_ino;
+        }
+      }
+      close(fd);
+    }
+  }
+  snap = snapMap;
+  *size = snapMapSize;
+  pthread_mutex_unlock(&snapMapMutex);
+  return snap;
+}
+
+//-- Function: _SnapshotCopy ---------------------------------------------------
+///
+///  Copy the entries matching name (all if NULL) under the sequence lock; at
+///  most maxEntries are copied
+///
+///  \return number of matching entries, may be more than maxEntries; -1 if
+///          the snapshot is not valid
+//------------------------------------------------------------------------------
+static int _SnapshotCopy(const tLedSnapshot * snap, size_t size, const char * name,
+                         tLedSnapshotEntry * entries, uint32_t maxEntries)
+{
+  int retry;
+
+  for(retry = 0; retry < LED_SNAPSHOT_MAX_RETRY; retry++)
+  {
+    uint32_t seq = __atomic_load_n(&snap->seq, __ATOMIC_ACQUIRE);
+    uint32_t ledCount;
+    uint32_t matched = 0;
+    uint32_t i;
+
+    if(seq & 1)
+    {
+      sched_yield();
+      continue;
+    }
+    if(   (snap->magic != LED_SNAPSHOT_MAGIC)
+       || (snap->version != LED_SNAPSHOT_VERSION)
+       || (snap->entrySize != sizeof(tLedSnapshotEntry))
+       || (!snap->valid)
+       || (!_WriterAlive(snap->writerPid)))
+    {
+      return -1;
+    }
+    ledCount = snap->ledCount;
+    if(_SnapshotSize(ledCount) > size)
+    {
+      return -1;
+    }
+    for(i = 0; i < ledCount; i++)
+    {
+      if(   (name == NULL)
+         || (!strncasecmp(snap->leds[i].name, name, sizeof(snap->leds[i].name))))
+      {
+        if(matched < maxEntries)
+        {
+          memcpy(&entries[matched], &snap->leds[i], sizeof(tLedSnapshotEntry));
+        }
+        matched++;
+      }
+    }
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if(__atomic_load_n(&snap->seq, __ATOMIC_RELAXED) == seq)
+    {
+      return (int)matched;
+    }
+  }
+  return -1;
+}
+
+//-- Function: _SnapshotRead ---------------------------------------------------
+///
+///  Copy the entries matching name from the snapshot; if the mapped one is
+///  not valid (anymore), a snapshot of a restarted writer is tried
+///
+///  \return see _SnapshotCopy, -1 if there is no valid snapshot
+//------------------------------------------------------------------------------
+static int _SnapshotRead(const char * name, tLedSnapshotEntry * entries, uint32_t maxEntries)
+{
+  int remap;
+
+  for(remap = 0; remap < 2; remap++)
+  {
+    size_t size;
+    tLedSnapshot * snap = _SnapshotMap(remap, &size);
+    int ret;
+
+    if(snap == NULL)
+    {
+      return -1;
+    }
+    ret = _SnapshotCopy(snap, size, name, entries, maxEntries);
+    if(ret >= 0)
+    {
+      return ret;
+    }
+  }
+  return -1;
+}
+
+int led_GetLedStatusSnapshot(const char * ledName, tLedStatus * status)
+{
+  tLedSnapshotEntry entry;
+
+  if(ledName == NULL || status == NULL || 1 > _SnapshotRead(ledName, &entry, 1))
+  {
+    return -1;
+  }
+  _EntryToStatus(status, &entry);
+  return 0;
+}
+
+int led_GetAllLedStatusSnapshot(tLedStatus * status, int maxLeds)
+{
+  tLedSnapshotEntry * entries;
+  int count;
+  int i;
+
+  if(status == NULL || maxLeds <= 0)
+  {
+    return -1;
+  }
+  if(maxLeds > LED_SNAPSHOT_MAX_LEDS)
+  {
+    maxLeds = LED_SNAPSHOT_MAX_LEDS;
+  }
+  entries = malloc(maxLeds * sizeof(tLedSnapshotEntry));
+  if(entries == NULL)
+  {
+    return -1;
+  }
+  count = _SnapshotRead(NULL, entries, maxLeds);
+  for(i = 0; (i < count) && (i < maxLeds); i++)
+  {
+    _EntryToStatus(&status[i], &entries[i]);
+  }
+  free(entries);
+  return count;
+}
+//---- End of source file ------------------------------------------------------
@@ -0,0 +1,601 @@
+/*
+ * diagnostic_catalog.c
+ *
+ * Compiles the event strings of a diagnostic XML document into a sorted
+ * binary catalog and looks them up via mmap and binary search.
+ *
+ * File layout (native byte order, only read on the machine that wrote it):
+ *
+ *   tDiagCatHeader
+ *   tDiagCatEntry[entryCount]   sorted by id
+ *   tDiagCatText[textCount]     language/string pairs in document order
+ *   char pool[poolSize]         '\0' separated strings, offset 0 is reserved
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <libxml/parser.h>
+#include <libxml/tree.h>
+#include <glib.h>
+
+#include "diagnostic_catalog.h"
+
+#define DIAGCAT_MAGIC    "DIAGCAT"
+#define DIAGCAT_VERSION  1
+
+// only these ID bits are compared by GetClass()/GetEvent()
+#define DIAGCAT_ID_MASK    0x3FFFFFFF
+#define DIAGCAT_CLASS_MASK 0x3FFF0000
+#define DIAGCAT_EVENT_MASK 0x0000FFFF
+
+typedef struct {
+    char     magic[8];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t textCount;
+    uint32_t poolSize;
+    // identification of the XML document the catalog was compiled from
+    int64_t  srcMtimeSec;
+    int64_t  srcMtimeNsec;
+    uint64_t srcSize;
+    uint64_t srcIno;
+}tDiagCatHeader;
+
+typedef struct {
+    uint32_t id;
+    uint32_t setFirst;
+    uint32_t rstFirst;
+    uint16_t setCount;
+    uint16_t rstCount;
+}tDiagCatEntry;
+
+typedef struct {
+    uint32_t lan;
+    uint32_t str;           /* 0: element without text */
+}tDiagCatText;
+
+struct stDiagCatalog {
+    void                 * base;
+    size_t                 size;
+    int                    mapped;
+    const tDiagCatHeader * header;
+    const tDiagCatEntry  * entries;
+    const tDiagCatText   * texts;
+    const char           * pool;
+};
+
+typedef struct {
+    GArray     * entries;
+    GArray     * texts;
+    GByteArray * pool;
+    GHashTable * poolIndex;   /* string -> offset + 1 */
+}tDiagCatBuilder;
+
+static uint32_t _PoolAdd(tDiagCatBuilder * b, const char * str)
+{
+  gpointer offset = g_hash_table_lookup(b->poolIndex, str);
+
+  if(offset == NULL)
+  {
+    uint32_t off = b->pool->len;
+    g_byte_array_append(b->pool, (const guint8 *)str, strlen(str) + 1);
+    g_hash_table_insert(b->poolIndex, g_strdup(str), GUINT_TO_POINTER(off + 1));
+    return off;
+  }
+  return GPOINTER_TO_UINT(offset) - 1;
+}
+
+static uint16_t _AddStrings(tDiagCatBuilder * b, xmlDocPtr doc, xmlNodePtr strings, uint32_t * first)
+{
+  xmlNodePtr node;
+  uint16_t count = 0;
+
+  *first = b->texts->len;
+  for(node = strings->xmlChildrenNode; node != NULL; node = node->next)
+  {
+    tDiagCatText text;
+    xmlChar * str;
+
+    if(node->type != XML_ELEMENT_NODE || count == UINT16_MAX)
+    {
+      continue;
+    }
+    str = xmlNodeListGetString(doc, node->xmlChildrenNode, 1);
+    text.lan = _PoolAdd(b, (const char *)node->name);
+    text.str = 0;
+    if(str != NULL)
+    {
+      text.str = _PoolAdd(b, (const char *)str);
+      xmlFree(str);
+    }
+    g_array_append_val(b->texts, text);
+    count++;
+  }
+  return count;
+}
+
+static void _AddEvent(tDiagCatBuilder * b, xmlDocPtr doc, xmlNodePtr event, uint32_t id)
+{
+  tDiagCatEntry entry;
+  xmlNodePtr node;
+  int haveSet = 0;
+  int haveRst = 0;
+
+  memset(&entry, 0, sizeof(entry));
+  entry.id = id;
+  // like GetStrings()/GetResetStrings() only the first element of each kind counts
+  for(node = event->xmlChildrenNode; node != NULL; node = node->next)
+  {
+    if(!haveSet && !xmlStrcmp(node->name, (const xmlChar *)"string"))
+    {
+      entry.setCount = _AddStrings(b, doc, node, &entry.setFirst);
+      haveSet = 1;
+    }
+    else if(!haveRst && !xmlStrcmp(node->name, (const xmlChar *)"rststr"))
+    {
+      entry.rstCount = _AddStrings(b, doc, node, &entry.rstFirst);
+      haveRst = 1;
+    }
+  }
+  g_array_append_val(b->entries, entry);
+}
+
+static int _CompareEntries(const void * a, const void * b)
+{
+  uint32_t idA = ((const tDiagCatEntry *)a)->id;
+  uint32_t idB = ((const tDiagCatEntry *)b)->id;
+
+  return (idA > idB) - (idA < idB);
+}
+
+/*
+ * Walks the document the same way _GoToEvent() does: only the first
+ * eventclass of a range and the first event of an ID within it are reachable.
+ */
+static int _ReadDoc(tDiagCatBuilder * b, const char * xmlPath)
+{
+  GHashTable * seenClasses;
+  GHashTable * seenIds;
+  xmlDocPtr doc;
+  xmlNodePtr root;
+  xmlNodePtr classNode;
+
+  doc = xmlParseFile(xmlPath);
+  if(doc == NULL)
+  {
+    return -1;
+  }
+  root = xmlDocGetRootElement(doc);
+  if(root == NULL || xmlStrcmp(root->name, (const xmlChar *)"diagnostic"))
+  {
+    xmlFreeDoc(doc);
+    return -1;
+  }
+
+  // keys are stored +1, 0 would be a NULL pointer
+  seenClasses = g_hash_table_new(g_direct_hash, g_direct_equal);
+  seenIds = g_hash_table_new(g_direct_hash, g_direct_equal);
+  for(classNode = root->xmlChildrenNode; classNode != NULL; classNode = classNode->next)
+  {
+    xmlChar * rangeStr;
+    uint32_t range;
+    xmlNodePtr eventNode;
+
+    if(xmlStrcmp(classNode->name, (const xmlChar *)"eventclass"))
+    {
+      continue;
+    }
+    rangeStr = xmlGetProp(classNode, (xmlChar*)"class_range");
+    if(rangeStr == NULL)
+    {
+      continue;
+    }
+    range = strtol((char*)rangeStr+1, NULL, 16) << 16;
+    xmlFree(rangeStr);
+    if(   (range & ~DIAGCAT_CLASS_MASK)
+       || g_hash_table_contains(seenClasses, GUINT_TO_POINTER(range + 1)))
+    {
+      continue;
+    }
+    g_hash_table_add(seenClasses, GUINT_TO_POINTER(range + 1));
+
+    for(eventNode = classNode->xmlChildrenNode; eventNode != NULL; eventNode = eventNode->next)
+    {
+      xmlChar * idStr;
+      uint32_t id;
+
+      if(xmlStrcmp(eventNode->name, (const xmlChar *)"event"))
+      {
+        continue;
+      }
+      idStr = xmlGetProp(eventNode, (xmlChar*)"id");
+      if(idStr == NULL)
+      {
+        continue;
+      }
+      id = strtol((char*)idStr+1, NULL, 16);
+      xmlFree(idStr);
+      if(id & ~DIAGCAT_EVENT_MASK)
+      {
+        continue;
+      }
+      id |= range;
+      if(!g_hash_table_contains(seenIds, GUINT_TO_POINTER(id + 1)))
+      {
+        g_hash_table_add(seenIds, GUINT_TO_POINTER(id + 1));
+        _AddEvent(b, doc, eventNode, id);
+      }
+    }
+  }
+  g_hash_table_destroy(seenIds);
+  g_hash_table_destroy(seenClasses);
+  xmlFreeDoc(doc);
+
+  g_array_sort(b->entries, _CompareEntries);
+  return 0;
+}
+
+static void _SetupCatalog(tDiagCatalog * cat)
+{
+  const uint8_t * base = cat->base;
+
+  cat->header  = (const tDiagCatHeader *)base;
+  cat->entries = (const tDiagCatEntry *)(base + sizeof(tDiagCatHeader));
+  cat->texts   = (const tDiagCatText *)(cat->entries + cat->header->entryCount);
+  cat->pool    = (const char *)(cat->texts + cat->header->textCount);
+}
+
+static size_t _CatalogSize(const tDiagCatHeader * header)
+{
+  return   sizeof(tDiagCatHeader)
+         + (size_t)header->entryCount * sizeof(tDiagCatEntry)
+         + (size_t)header->textCount * sizeof(tDiagCatText)
+         + header->poolSize;
+}
+
+static int _IsCurrent(const tDiagCatHeader * header, const struct stat * src)
+{
+  return    !memcmp(header->magic, DIAGCAT_MAGIC, sizeof(DIAGCAT_MAGIC))
+         && header->version == DIAGCAT_VERSION
+         && header->srcMtimeSec == (int64_t)src->st_mtim.tv_sec
+         && header->srcMtimeNsec == (int64_t)src->st_mtim.tv_nsec
+         && header->srcSize == (uint64_t)src->st_size
+         && header->srcIno == (uint64_t)src->st_ino;
+}
+
+static void _CatalogPath(char * path, size_t size, const char * xmlPath)
+{
+  const char * name = strrchr(xmlPath, '/');
+
+  name = (name != NULL) ? name + 1 : xmlPath;
+  snprintf(path, size, "%s/%s%s", DIAGCAT_CACHE_DIR, name, DIAGCAT_SUFFIX);
+}
+
+/*
+ * A catalog is trusted if only root or the calling user could have written
+ * it; anything else may be a forged catalog planted by another user.
+ */
+static int _IsTrusted(const struct stat * st)
+{
+  return    S_ISREG(st->st_mode)
+         && (st->st_uid == 0 || st->st_uid == geteuid())
+         && !(st->st_mode & (S_IWGRP | S_IWOTH));
+}
+
+static tDiagCatalog * _MapCatalog(const char * catPath, const struct stat * src)
+{
+  tDiagCatalog * cat;
+  struct stat st;
+  void * base;
+  int fd;
+
+  fd = open(catPath, O_RDONLY | O_CLOEXEC | O_NOFOLLOW);
+  if(fd < 0)
+  {
+    return NULL;
+  }
+  if(   fstat(fd, &st)
+     || !_IsTrusted(&st)
+     || (size_t)st.st_size < sizeof(tDiagCatHeader))
+  {
+    close(fd);
+    return NULL;
+  }
+  base = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(base == MAP_FAILED)
+  {
+    return NULL;
+  }
+  if(   !_IsCurrent(base, src)
+     || _CatalogSize(base) != (size_t)st.st_size
+     || ((const tDiagCatHeader *)base)->poolSize == 0
+     || ((const char *)base)[st.st_size - 1] != '\0')
+  {
+    munmap(base, st.st_size);
+    return NULL;
+  }
+
+  cat = malloc(sizeof(tDiagCatalog));
+  if(cat == NULL)
+  {
+    munmap(base, st.st_size);
+    return NULL;
+  }
+  cat->base = base;
+  cat->size = st.st_size;
+  cat->mapped = 1;
+  _SetupCatalog(cat);
+  return cat;
+}
+
+/*
+ * Writes via a temporary file and rename() so concurrent readers see either
+ * the old or the new catalog. Failing to write is not an error, the compiled
+ * catalog is used from memory then.
+ */
+static void _WriteCatalog(const char * catPath, const tDiagCatalog * cat)
+{
+  char tmpPath[PATH_MAX];
+  size_t written = 0;
+  int fd;
+
+  if(snprintf(tmpPath, sizeof(tmpPath), "%s.XXXXXX", catPath) >= (int)sizeof(tmpPath))
+  {
+    return;
+  }
+  if(mkdir(DIAGCAT_CACHE_DIR, 0755) && errno != EEXIST)
+  {
+    return;
+  }
+  fd = mkstemp(tmpPath);
+  if(fd < 0)
+  {
+    return;
+  }
+  while(written < cat->size)
+  {
+    ssize_t ret = write(fd, (const char *)cat->base + written, cat->size - written);
+    if(ret <= 0)
+    {
+      break;
+    }
+    written += ret;
+  }
+  fchmod(fd, 0644);
+  if(close(fd) || written != cat->size || rename(tmpPath, catPath))
+  {
+    unlink(tmpPath);
+  }
+}
+
+static tDiagCatalog * _CompileCatalog(const char * xmlPath, const char * catPath, const struct stat * src)
+{
+  tDiagCatBuilder b;
+  tDiagCatHeader header;
+  tDiagCatalog * cat = NULL;
+  uint8_t * base;
+
+  b.entries = g_array_new(FALSE, FALSE, sizeof(tDiagCatEntry));
+  b.texts = g_array_new(FALSE, FALSE, sizeof(tDiagCatText));
+  b.pool = g_byte_array_new();
+  b.poolIndex = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+  // offset 0 is reserved for "no text", so even "" gets a slot of its own
+  g_byte_array_append(b.pool, (const guint8 *)"", 1);
+
+  if(!_ReadDoc(&b, xmlPath))
+  {
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, DIAGCAT_MAGIC, sizeof(DIAGCAT_MAGIC));
+    header.version      = DIAGCAT_VERSION;
+    header.entryCount   = b.entries->len;
+    header.textCount    = b.texts->len;
+    header.poolSize     = b.pool->len;
+    header.srcMtimeSec  = src->st_mtim.tv_sec;
+    header.srcMtimeNsec = src->st_mtim.tv_nsec;
+    header.srcSize      = src->st_size;
+    header.srcIno       = src->st_ino;
+
+    cat = malloc(sizeof(tDiagCatalog));
+    base = malloc(_CatalogSize(&header));
+    if(cat != NULL && base != NULL)
+    {
+      uint8_t * p = base;
+      memcpy(p, &header, sizeof(header));
+      p += sizeof(header);
+      memcpy(p, b.entries->data, b.entries->len * sizeof(tDiagCatEntry));
+      p += b.entries->len * sizeof(tDiagCatEntry);
+      memcpy(p, b.texts->data, b.texts->len * sizeof(tDiagCatText));
+      p += b.texts->len * sizeof(tDiagCatText);
+      memcpy(p, b.pool->data, b.pool->len);
+
+      cat->base = base;
+      cat->size = _CatalogSize(&header);
+      cat->mapped = 0;
+      _SetupCatalog(cat);
+      _WriteCatalog(catPath, cat);
+    }
+    else
+    {
+      free(base);
+      free(cat);
+      cat = NULL;
+    }
+  }
+
+  g_hash_table_destroy(b.poolIndex);
+  g_byte_array_free(b.pool, TRUE);
+  g_array_free(b.texts, TRUE);
+  g_array_free(b.entries, TRUE);
+  return cat;
+}
+
+tDiagCatalog * DIAGCAT_Open(const char * xmlPath)
+{
+  char catPath[PATH_MAX];
+  struct stat src;
+  tDiagCatalog * cat;
+
+  if(xmlPath == NULL || stat(xmlPath, &src))
+  {
+    return NULL;
+  }
+  _CatalogPath(catPath, sizeof(catPath), xmlPath);
+  cat = _MapCatalog(catPath, &src);
+  if(cat == NULL)
+  {
+    cat = _CompileCatalog(xmlPath, catPath, &src);
+  }
+  return cat;
+}
+
+void DIAGCAT_Close(tDiagCatalog * cat)
+{
+  if(cat != NULL)
+  {
+    if(cat->mapped)
+    {
+      munmap(cat->base, cat->size);
+    }
+    else
+    {
+      free(cat->base);
+    }
+    free(cat);
+  }
+}
+
+static const tDiagCatEntry * _FindEntry(const tDiagCatalog * cat, uint32_t id)
+{
+  uint32_t lo = 0;
+  uint32_t hi = cat->header->entryCount;
+
+  id &= DIAGCAT_ID_MASK;
+  while(lo < hi)
+  {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if(cat->entries[mid].id < id)
+    {
+      lo = mid + 1;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+  if(lo < cat->header->entryCount && cat->entries[lo].id == id)
+  {
+    return &cat->entries[lo];
+  }
+  return NULL;
+}
+
+static const char * _PoolString(const tDiagCatalog * cat, uint32_t offset)
+{
+  return (offset < cat->header->poolSize) ? cat->pool + offset : NULL;
+}
+
+/*
+ * Mirrors GetStrOfLan(): the first text of the language wins, otherwise the
+ * last default language text seen before it.
+ */
+static const char * _GetStrOfLan(const tDiagCatalog * cat, uint32_t first, uint16_t count, const char * lan)
+{
+  const char * defStr = NULL;
+  uint32_t i;
+
+  if(lan == NULL)
+  {
+    lan = diagnostic_xml_default_lan;
+  }
+  if(   first > cat->header->textCount
+     || count > cat->header->textCount - first)
+  {
+    return NULL;
+  }
+  for(i = first; i < first + count; i++)
+  {
+    const tDiagCatText * text = &cat->texts[i];
+    const char * name = _PoolString(cat, text->lan);
+    const char * str = text->str ? _PoolString(cat, text->str) : NULL;
+
+    if(name == NULL)
+    {
+      continue;
+    }
+    if(!strcmp(name, lan))
+    {
+      return (str != NULL) ? str : defStr;
+    }
+    if(!strcmp(name, diagnostic_xml_default_lan))
+    {
+      defStr = str;
+    }
+  }
+  return defStr;
+}
+
+const char * DIAGCAT_GetStringOfId(tDiagCatalog * cat, uint32_t id, const char * lan)
+{
+  const tDiagCatEntry * entry;
+
+  if(cat == NULL || (entry = _FindEntry(cat, id)) == NULL || entry->setCount == 0)
+  {
+    return NULL;
+  }
+  return _GetStrOfLan(cat, entry->setFirst, entry->setCount, lan);
+}
+
+const char * DIAGCAT_GetResetStringOfId(tDiagCatalog * cat, uint32_t id, const char * lan)
+{
+  const tDiagCatEntry * entry;
+
+  if(cat == NULL || (entry = _FindEntry(cat, id)) == NULL || entry->rstCount == 0)
+  {
+    return NULL;
+  }
+  return _GetStrOfLan(cat, entry->rstFirst, entry->rstCount, lan);
+}
+
+void DIAGCAT_OpenStrings(tDiagStrings * strings, const char * xmlPath)
+{
+  strings->cat = DIAGCAT_Open(xmlPath);
+  strings->xml = NULL;
+  if(strings->cat == NULL)
+  {
+    strings->xml = ParseDoc((char *)xmlPath);
+  }
+}
+
+void DIAGCAT_CloseStrings(tDiagStrings * strings)
+{
+  DIAGCAT_Close(strings->cat);
+  FreeDiagXml(strings->xml);
+  strings->cat = NULL;
+  strings->xml = NULL;
+}
+
+const char * DIAGCAT_StringOfId(tDiagStrings * strings, uint32_t id, const char * lan)
+{
+  if(strings->cat != NULL)
+  {
+    return DIAGCAT_GetStringOfId(strings->cat, id, lan);
+  }
+  return (strings->xml != NULL) ? GetStringOfId(id, strings->xml, lan) : NULL;
+}
+
+const char * DIAGCAT_ResetStringOfId(tDiagStrings * strings, uint32_t id, const char * lan)
+{
+  if(strings->cat != NULL)
+  {
+    return DIAGCAT_GetResetStringOfId(strings->cat, id, lan);
+  }
+  return (strings->xml != NULL) ? GetResetStringOfId(id, strings->xml, lan) : NULL;
+}
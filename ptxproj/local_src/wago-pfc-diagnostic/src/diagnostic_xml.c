@@ -23,6 +23,8 @@
 
 const char diagnostic_xml_default_lan[] = "en";
 tLedFiles * pActualFile = NULL;
+// ID -> element of the list being (re)built; only valid while a file is read
+static GHashTable * pLedElementIndex = NULL;
 
 #define DIAG_ID_SAVE_PERS 0x80000000
 #define DIAG_ID_SAVE_NO   0x40000000
@@ -950,18 +952,25 @@ static int _ReadLedArguments( tLedStateClass state,
 
 static tLedEventList * _GetLedElement(tLedEventList ** pledList,uint32_t id)
 {
-  tLedEventList * pAct = *pledList;
   tLedEventList * res = NULL;
 
-  while(pAct != NULL)
+  if(pLedElementIndex != NULL)
+  {
+    res = g_hash_table_lookup(pLedElementIndex, GUINT_TO_POINTER(id));
+  }
+  else
   {
-    if(pAct->info.idInfo.id == id)
+    tLedEventList * pAct = *pledList;
+    while(pAct != NULL)
     {
-      break;
+      if(pAct->info.idInfo.id == id)
+      {
+        break;
+      }
+      pAct = pAct->pNext;
     }
-    pAct = pAct->pNext;
+    res = pAct;
   }
-  res = pAct;
 
   if(res == NULL)
   {
@@ -974,11 +983,49 @@ static tLedEventList * _GetLedElement(tLedEventList ** pledList,uint32_t id)
     res->pNext = *pledList;
     res->info.flags = LED_FLAG_EVENT_NEW;
     *pledList = res;
+    if(pLedElementIndex != NULL)
+    {
+      g_hash_table_insert(pLedElementIndex, GUINT_TO_POINTER(id), res);
+    }
   }
 
   return res;
 }
 
+static void _IndexLedList(tLedEventList * pAct)
+{
+  pLedElementIndex = g_hash_table_new(g_direct_hash, g_direct_equal);
+  while(pAct != NULL)
+  {
+    // keep the first element like the linear search did
+    if(NULL == g_hash_table_lookup(pLedElementIndex, GUINT_TO_POINTER(pAct->info.idInfo.id)))
+    {
+      g_hash_table_insert(pLedElementIndex, GUINT_TO_POINTER(pAct->info.idInfo.id), pAct);
+    }
+    pAct = pAct->pNext;
+  }
+}
+
+static void _DropLedListIndex(void)
+{
+  g_hash_table_destroy(pLedElementIndex);
+  pLedElementIndex = NULL;
+}
+
+void FreeLedEvent(tLedEventList * event)
+{
+  tLedAlias * alias = event->alias;
+  while(alias != NULL)
+  {
+    tLedAlias * next = alias->pNext;
+    free(alias->alias);
+    free(alias);
+    alias = next;
+  }
+  free(event->ledName);
+  free(event);
+}
+
 void InitLedInfo(tLedInfo * ledInfo)
 {
   ledInfo->defaultIdInfo.id =0;
@@ -1230,6 +1277,7 @@ int CreateLedEventList(tLedBehavior * ledBehavior, tLedFiles * ledFiles, tLedEve
   assert(ledEvents);
   tLedFiles * pAct = ledFiles;
 
+  _IndexLedList(*ledEvents);
   while(pAct)
   {
     if(!access(pAct->path,R_OK))
@@ -1246,7 +1294,7 @@ int CreateLedEventList(tLedBehavior * ledBehavior, tLedFiles * ledFiles, tLedEve
     }
     pAct = pAct->pNext;
   }
-
+  _DropLedListIndex();
 
   return 1;
 }
@@ -1260,6 +1308,7 @@ int UpdateLedEventList(tLedBehavior * ledBehavior, tLedFiles * ledFiles, tLedEve
   tLedFiles * pAct = ledFiles;
   int ret = 0;
 
+  _IndexLedList(*ledEvents);
   while(pAct)
   {
     struct stat buf;
@@ -1281,7 +1330,7 @@ int UpdateLedEventList(tLedBehavior * ledBehavior, tLedFiles * ledFiles, tLedEve
     }
     pAct = pAct->pNext;
   }
-
+  _DropLedListIndex();
 
   return ret;
 }
@@ -37,6 +37,12 @@
 #include <unistd.h>
 #include <sys/time.h>
 #include <sys/resource.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <poll.h>
+#include <limits.h>
+#include <errno.h>
+#include <pthread.h>
 #include <glib.h>
 #include "led_info_json.h"
 
@@ -50,6 +56,9 @@
 //------------------------------------------------------------------------------
 #define WAGO_DIAGNOSE_ID_INTERFACE      "wago.diagnose"
 #define LEDCONFIG_XML_DOCUMENT          "/tmp/led.xml"
+#define LED_FILES_POLL_INTERVAL         5    // s, only without inotify
+#define LED_FILES_SETTLE_TIME           200  // ms without further file events before reloading
+#define LED_SNAPSHOT_INFO_LEN           256
 
 
 
@@ -101,6 +110,16 @@ typedef struct {
 //------------------------------------------------------------------------------
 tLedEventList * ledEvents = NULL;
 
+// the LED data attached to the LEDs (ID info lists) is changed by the event
+// handlers and read by the D-Bus getters and the snapshot of the main loop;
+// all of them hold this lock. It also protects the snapshot buffers below.
+static pthread_mutex_t ledDataMutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+
+// shared memory snapshot of the LED states, see led_SnapshotPublish
+static tLedStatus    * snapshotStates = NULL;
+static char         (* snapshotInfo)[LED_SNAPSHOT_INFO_LEN] = NULL;
+static int             snapshotLeds = 0;
+
 
 
 static const tIdInfo defaultIdInfo = {
@@ -260,11 +279,13 @@ void GetAllLedHandler(com_tConnection * con, com_tComMessage * msg,tLedNames * n
   //TEST
   //noOfLeds = 1;
   //TEST
+  pthread_mutex_lock(&ledDataMutex);
   for(i=0;i<noOfLeds; i++)
   {
     GetLedInfo(i,  &ledInfo[i]);
     AddInfoToDbus(&iter,i,&(ledInfo[i]),&(listLength[i]));
   }
+  pthread_mutex_unlock(&ledDataMutex);
 
   dbus_connection_send(con->bus, reply, NULL);
   dbus_connection_flush(con->bus);
@@ -279,15 +300,133 @@ void GetLedHandler(com_tConnection * con, com_tComMessage * msg, int * ledNr)
   uint32_t length;
 
 
-  GetLedInfo(*ledNr,  &ledInfo);
   reply = dbus_message_new_method_return(msg->msg);
   dbus_message_iter_init_append (reply, &iter);
+  pthread_mutex_lock(&ledDataMutex);
+  GetLedInfo(*ledNr,  &ledInfo);
   AddInfoToDbus(&iter,*ledNr,&ledInfo,&length);
+  pthread_mutex_unlock(&ledDataMutex);
   dbus_connection_send(con->bus, reply, NULL);
   dbus_connection_flush(con->bus);
   dbus_message_unref(reply);
 }
 
+//-- Function: _IdInfoToString -------------------------------------------------
+///
+///  Format the ID parameters the way led_GetLedStatus builds them from the
+///  D-Bus reply (" <type> <value>" per parameter)
+//------------------------------------------------------------------------------
+static void _IdInfoToString(GList * info, char * buffer, size_t size)
+{
+  size_t len = 0;
+
+  buffer[0] = 0;
+  for(; info != NULL && len < size; info = info->next)
+  {
+    tIdAdditionalParam * param = info->data;
+    int ret;
+
+    switch(param->type)
+    {
+      case DBUS_TYPE_BYTE:
+        ret = snprintf(buffer + len, size - len, " %X %u", param->type, (uint32_t) param->value.byte);
+        break;
+      case DBUS_TYPE_INT16:
+        ret = snprintf(buffer + len, size - len, " %X %d", param->type, (int) (int16_t) param->value.word);
+        break;
+      case DBUS_TYPE_UINT16:
+        ret = snprintf(buffer + len, size - len, " %X %u", param->type, (uint32_t) param->value.word);
+        break;
+      case DBUS_TYPE_INT32:
+      case DBUS_TYPE_BOOLEAN:
+        ret = snprintf(buffer + len, size - len, " %X %d", param->type, (int) param->value.integer);
+        break;
+      case DBUS_TYPE_UINT32:
+        ret = snprintf(buffer + len, size - len, " %X %u", param->type, param->value.integer);
+        break;
+      default:
+        ret = 0;
+        break;
+    }
+    if(ret < 0)
+    {
+      break;
+    }
+    len += ret;
+  }
+  buffer[size - 1] = 0;
+}
+
+//-- Function: PublishLedSnapshot ----------------------------------------------
+///
+///  Copy the state of all LEDs into the shared memory snapshot read by
+///  led_GetLedStatus and getledstate. Unchanged states are not rewritten.
+//------------------------------------------------------------------------------
+static void PublishLedSnapshot(void)
+{
+  int i;
+
+  if(snapshotLeds == 0)
+  {
+    return;
+  }
+  pthread_mutex_lock(&ledDataMutex);
+  for(i = 0; i < snapshotLeds; i++)
+  {
+    tLedStatus * status = &snapshotStates[i];
+    tLedInfo ledInfo;
+    int c;
+
+    memset(&ledInfo, 0, sizeof(ledInfo));
+    memset(status, 0, sizeof(*status));
+    if(GetLedInfo(i, &ledInfo))
+    {
+      continue;
+    }
+    ledserver_LEDCTRL_GetLedName(i, status->name, sizeof(status->name));
+    for(c = 0; status->name[c] != 0; c++)
+    {
+      status->name[c] = toupper((int)status->name[c]);
+    }
+    status->state = ledInfo.state;
+    status->timestamp = ledInfo.setTime;
+    VarCopy((tLedVariables*)&status->vars, &ledInfo.vars, ledInfo.state);
+    status->info.id = ledInfo.idInfo.id;
+    _IdInfoToString(ledInfo.idInfo.info, snapshotInfo[i], sizeof(snapshotInfo[i]));
+    status->info.info = snapshotInfo[i];
+  }
+  led_SnapshotPublish(snapshotStates, snapshotLeds);
+  pthread_mutex_unlock(&ledDataMutex);
+}
+
+// sequences ending by themselves change the LED state without an event
+static void LedSequenceEndHandler(void)
+{
+  PublishLedSnapshot();
+}
+
+static void _InitLedSnapshot(void)
+{
+  int noOfLeds = (int) ledserver_LEDCTRL_GetLedCount();
+
+  snapshotStates = calloc(noOfLeds, sizeof(tLedStatus));
+  snapshotInfo = calloc(noOfLeds, sizeof(*snapshotInfo));
+  if(   (snapshotStates == NULL)
+     || (snapshotInfo == NULL)
+     || (led_SnapshotCreate(noOfLeds)))
+  {
+    syslog(LOG_WARNING, "no LED state snapshot, LED states are only available over D-Bus");
+    free(snapshotStates);
+    free(snapshotInfo);
+    snapshotStates = NULL;
+    snapshotInfo = NULL;
+    return;
+  }
+  snapshotLeds = noOfLeds;
+  PublishLedSnapshot();
+  ledserver_LEDCTRL_SetSequenceEndHandler(LedSequenceEndHandler);
+}
+
 uint32_t GetArgFromMessage(int argno, DBusMessage *message)
 {
   DBusMessageIter iter;
@@ -672,6 +811,7 @@ void IdHandler(com_tConnection * con, com_tComMessage * msg, log_tEventId id, tL
 
   }
 
+  pthread_mutex_lock(&ledDataMutex);
   if(set == TRUE)
   {
     tLedInfo ledInfo;
@@ -706,12 +846,16 @@ void IdHandler(com_tConnection * con, com_tComMessage * msg, log_tEventId id, tL
   }
   DBG("Clean ID Info");
   _CleanIdInfo(&idInfo);
+  PublishLedSnapshot();
+  pthread_mutex_unlock(&ledDataMutex);
 }
 #pragma GCC diagnostic warning "-Wunused-parameter"
 
 void SetDefaults(tLedDefaults * ledDefaults)
 {
   tLedNr ledNr;
+
+  pthread_mutex_lock(&ledDataMutex);
   while(ledDefaults != NULL)
   {
     tLedInfo ledInfo;
@@ -752,7 +896,7 @@ void SetDefaults(tLedDefaults * ledDefaults)
       SetDefaultState(ledNr,&ledInfo);
     }
   }
-
+  pthread_mutex_unlock(&ledDataMutex);
 }
 
 
@@ -798,6 +942,7 @@ void SigTerm(int sigNum, siginfo_t * info, void * ucontext)
     backtrace_symbols_fd(array, size, STDOUT_FILENO);
   }
   isShutdown=true;
+  led_SnapshotInvalidate();
   ledserver_LEDCTRL_Deinit();
   DBG("Generate Coredump");
   //set rlimit to create coredump
@@ -822,70 +967,350 @@ void SigHup(int sigNum)
   syslog(LOG_ERR,"Ignore Signal %d",sigNum);
 }
 
-//-- Function: mainloop ------------------------------------------------------------
+static bool _LedAliasEqual(const tLedAlias * a, const tLedAlias * b)
+{
+  while(a != NULL && b != NULL)
+  {
+    if(strcmp(a->alias, b->alias))
+    {
+      return false;
+    }
+    a = a->pNext;
+    b = b->pNext;
+  }
+  return a == b;
+}
+
+//-- Function: _LedVarsEqual ----------------------------------------------------
 ///
-/// The MainLoop Function
+///  Compare the LED variables two events with the same arguments are defined
+///  with. Variables taken from an argument are overwritten by every incoming
+///  event (see SetArgsFromMessage) and are not part of the definition.
 ///
+///  \return true if all variables not taken from an argument are the same
 //------------------------------------------------------------------------------
-void mainloop(tLedBehavior * ledBehavior, tLedFiles * ledFiles)
+static bool _LedVarsEqual(const tLedEventList * a, const tLedEventList * b)
 {
-  //mtrace();
-  while(1)
+  size_t szVar = 0;
+
+  switch(a->info.state)
   {
-    sleep(5);
-    if(   (UpdateLedEventList(ledBehavior,ledFiles,&ledEvents))
-       &&(ledEvents != NULL))
+    case LED_STATE_BLINK:
+      {
+        const tLedBlink * arg  = (const tLedBlink*) &(a->args);
+        const tLedBlink * varA = (const tLedBlink*) &(a->info.vars);
+        const tLedBlink * varB = (const tLedBlink*) &(b->info.vars);
+        return    ((arg->color1 != 0) || (varA->color1 == varB->color1))
+               && ((arg->color2 != 0) || (varA->color2 == varB->color2))
+               && ((arg->time1 != 0)  || (varA->time1 == varB->time1))
+               && ((arg->time2 != 0)  || (varA->time2 == varB->time2));
+      }
+    case LED_STATE_FLASH:
+      {
+        const tLedFlash * arg  = (const tLedFlash*) &(a->args);
+        const tLedFlash * varA = (const tLedFlash*) &(a->info.vars);
+        const tLedFlash * varB = (const tLedFlash*) &(b->info.vars);
+        return    ((arg->flashColor != 0)  || (varA->flashColor == varB->flashColor))
+               && ((arg->flashTime != 0)   || (varA->flashTime == varB->flashTime))
+               && ((arg->staticColor != 0) || (varA->staticColor == varB->staticColor));
+      }
+    case LED_STATE_CAN:
+      {
+        const tLedCan * arg  = (const tLedCan*) &(a->args);
+        const tLedCan * varA = (const tLedCan*) &(a->info.vars);
+        const tLedCan * varB = (const tLedCan*) &(b->info.vars);
+        return (arg->canCode != 0) || (varA->canCode == varB->canCode);
+      }
+    case LED_STATE_750_ERR:
+      {
+        const tLed750 * arg  = (const tLed750*) &(a->args);
+        const tLed750 * varA = (const tLed750*) &(a->info.vars);
+        const tLed750 * varB = (const tLed750*) &(b->info.vars);
+        return    ((arg->errorArg != 0)  || (varA->errorArg == varB->errorArg))
+               && ((arg->errorCode != 0) || (varA->errorCode == varB->errorCode));
+      }
+    default:
+      // no arguments for the other states
+      GetSizeOfState(a->info.state, &szVar);
+      return !memcmp(&a->info.vars, &b->info.vars, szVar);
+  }
+}
+
+//-- Function: _LedEventEqual ---------------------------------------------------
+///
+///  Compare the LED definition of two events with the same ID
+///
+///  \return true if an incoming event would be handled the same way
+//------------------------------------------------------------------------------
+static bool _LedEventEqual(const tLedEventList * a, const tLedEventList * b)
+{
+  const uint8_t mask = LED_FLAG_SET_TO_DEFAULT | LED_FLAG_DEFAULT_NOT_ADOPT;
+  size_t szVar = 0;
+
+  if(   (a->ledNr != b->ledNr)
+     || (a->info.state != b->info.state)
+     || ((a->info.flags & mask) != (b->info.flags & mask))
+     || (a->file != b->file)
+     || strcmp(a->ledName, b->ledName)
+     || !_LedAliasEqual(a->alias, b->alias))
+  {
+    return false;
+  }
+  GetSizeOfState(a->info.state, &szVar);
+  return    !memcmp(&a->args, &b->args, szVar)
+         && _LedVarsEqual(a, b);
+}
+
+//-- Function: ReloadLedEvents --------------------------------------------------
+///
+///  Parse all LED files into a new event list and apply only the difference to
+///  the running one: unchanged IDs keep their entry and registration, removed
+///  IDs are deregistered, new and changed IDs are (re)registered. The whole
+///  change is applied while the dispatching of diagnostic IDs is held back, so
+///  no event is handled with a half-applied configuration.
+//------------------------------------------------------------------------------
+static void ReloadLedEvents(tLedBehavior * ledBehavior, tLedFiles * ledFiles)
+{
+  tLedEventList * newEvents = NULL;
+  tLedEventList * result = NULL;
+  tLedEventList * removed = NULL;
+  tLedEventList * pAct;
+  GHashTable    * newById;
+  unsigned int registered = 0, changed = 0, dropped = 0;
+
+  CreateLedEventList(ledBehavior, ledFiles, &newEvents);
+
+  newById = g_hash_table_new(g_direct_hash, g_direct_equal);
+  for(pAct = newEvents; pAct != NULL; pAct = pAct->pNext)
+  {
+    g_hash_table_insert(newById, GUINT_TO_POINTER(pAct->info.idInfo.id), pAct);
+  }
+
+  if(log_EVENT_LocalBegin())
+  {
+    syslog(LOG_ERR, "LED configuration not reloaded: no diagnostic subscription");
+  }
+  else
+  {
+    // old entries: keep the unchanged ones, drop the others
+    pAct = ledEvents;
+    while(pAct != NULL)
     {
-      tLedEventList * pAct=ledEvents;
-      tLedEventList * pLast = NULL;
-      while(pAct != NULL)
+      tLedEventList * pNext = pAct->pNext;
+      tLedEventList * pNew = g_hash_table_lookup(newById, GUINT_TO_POINTER(pAct->info.idInfo.id));
+      if((pNew != NULL) && _LedEventEqual(pAct, pNew))
       {
-        tLedEventList * pDel = NULL;
-        if(pAct->file->flags & LED_FILE_FLAG_REREAD)
-        {
-          if(pAct->info.flags & LED_FLAG_EVENT_NEW)
-          {
-            pAct->handle = log_EVENT_RegisterForId(pAct->info.idInfo.id, (log_tEventHandler) IdHandler, pAct);
-            DBG2("Registered ID:0x%.8X", pAct->info.idInfo.id);
-            pAct->info.flags &= ~LED_FLAG_EVENT_NEW;
-          }
-          else if(!(pAct->info.flags & LED_FLAG_EVENT_MODIFIED))
-          {
-            log_EVENT_DeregisterId(pAct->handle);
-            DBG2("Deregistered ID:0x%.8X", pAct->info.idInfo.id);
-            pDel = pAct;
-          }
-          else
-          {
-            pAct->info.flags &= ~LED_FLAG_EVENT_MODIFIED;
-          }
-        }
-        pAct = pAct->pNext;
-        if(pDel != NULL)
+        // flag the new entry as taken over; it is freed below
+        pNew->handle = -1;
+        pAct->pNext = result;
+        result = pAct;
+      }
+      else
+      {
+        log_EVENT_DeregisterIdLocal(pAct->handle);
+        DBG2("Deregistered ID:0x%.8X", pAct->info.idInfo.id);
+        if(pNew == NULL)
         {
-          if(pLast == NULL)
-          {
-            ledEvents = pAct;
-          }
-          else
-          {
-            pLast->pNext = pAct;
-          }
-          free(pDel);
+          dropped++;
         }
         else
         {
-          if(pLast == NULL)
-          {
-            pLast = ledEvents;
-          }
-          else
-          {
-            pLast = pLast->pNext;
-          }
+          changed++;
         }
+        pAct->pNext = removed;
+        removed = pAct;
+      }
+      pAct = pNext;
+    }
+    // new entries: register what is new or changed
+    pAct = newEvents;
+    while(pAct != NULL)
+    {
+      tLedEventList * pNext = pAct->pNext;
+      if(pAct->handle == -1)
+      {
+        FreeLedEvent(pAct);
+      }
+      else
+      {
+        pAct->info.flags &= ~(LED_FLAG_EVENT_NEW | LED_FLAG_EVENT_MODIFIED);
+        pAct->handle = log_EVENT_RegisterForIdLocal(pAct->info.idInfo.id, (log_tEventHandler) IdHandler, pAct);
+        DBG2("Registered ID:0x%.8X", pAct->info.idInfo.id);
+        pAct->pNext = result;
+        result = pAct;
+        registered++;
+      }
+      pAct = pNext;
+    }
+    ledEvents = result;
+    log_EVENT_LocalCommit();
+
+    for(pAct = removed; pAct != NULL; pAct = removed)
+    {
+      removed = pAct->pNext;
+      FreeLedEvent(pAct);
+    }
+    syslog(LOG_INFO, "LED configuration reloaded: %u IDs added, %u changed, %u removed",
+           registered - changed, changed, dropped);
+    newEvents = NULL;
+  }
+
+  while(newEvents != NULL)
+  {
+    pAct = newEvents->pNext;
+    FreeLedEvent(newEvents);
+    newEvents = pAct;
+  }
+  g_hash_table_destroy(newById);
+}
+
+//-- Function: _LedFilesChanged -------------------------------------------------
+///
+///  Check whether a LED file was modified, created or removed since it was
+///  read last
+//------------------------------------------------------------------------------
+static bool _LedFilesChanged(tLedFiles * ledFiles)
+{
+  tLedFiles * pAct;
+  bool ret = false;
+
+  for(pAct = ledFiles; pAct != NULL; pAct = pAct->pNext)
+  {
+    struct stat buf;
+    if(stat(pAct->path, &buf))
+    {
+      // removed: forget the timestamp so the file counts as new when it returns
+      if(pAct->mtim.tv_sec != 0 || pAct->mtim.tv_nsec != 0)
+      {
+        pAct->mtim.tv_sec = 0;
+        pAct->mtim.tv_nsec = 0;
+        ret = true;
+      }
+    }
+    else if(   (pAct->mtim.tv_sec  != buf.st_mtim.tv_sec)
+            || (pAct->mtim.tv_nsec != buf.st_mtim.tv_nsec))
+    {
+      ret = true;
+    }
+  }
+  return ret;
+}
+
+//-- Function: _WatchLedFiles ---------------------------------------------------
+///
+///  Set up an inotify watch on the directories of the LED files. Directories
+///  are watched because files are usually replaced by rename.
+///
+///  \return inotify file descriptor; -1 on error
+//------------------------------------------------------------------------------
+static int _WatchLedFiles(tLedFiles * ledFiles)
+{
+  int fd = inotify_init1(IN_CLOEXEC);
+  tLedFiles * pAct;
+
+  if(fd < 0)
+  {
+    return -1;
+  }
+  for(pAct = ledFiles; pAct != NULL; pAct = pAct->pNext)
+  {
+    char dir[PATH_MAX];
+    char * slash;
+
+    strncpy(dir, pAct->path, sizeof(dir) - 1);
+    dir[sizeof(dir) - 1] = '\0';
+    slash = strrchr(dir, '/');
+    if(slash == NULL)
+    {
+      continue;
+    }
+    if(slash == dir)
+    {
+      slash++;
+    }
+    *slash = '\0';
+    if(0 > inotify_add_watch(fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM |
+                                      IN_CREATE | IN_DELETE))
+    {
+      syslog(LOG_ERR, "cannot watch %s: %s", dir, strerror(errno));
+      close(fd);
+      return -1;
+    }
+  }
+  return fd;
+}
+
+//-- Function: _DrainLedFileEvents ----------------------------------------------
+///
+///  Read pending inotify events
+///
+///  \return true if one of them concerns a LED file
+//------------------------------------------------------------------------------
+static bool _DrainLedFileEvents(int fd, tLedFiles * ledFiles)
+{
+  char buffer[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+  ssize_t len = read(fd, buffer, sizeof(buffer));
+  bool ret = false;
+  char * p;
+
+  for(p = buffer; len > 0 && p < buffer + len; )
+  {
+    const struct inotify_event * event = (const struct inotify_event *)p;
+    tLedFiles * pAct;
+
+    for(pAct = ledFiles; (event->len > 0) && (pAct != NULL); pAct = pAct->pNext)
+    {
+      const char * base = strrchr(pAct->path, '/');
+      base = (base != NULL) ? base + 1 : pAct->path;
+      if(!strcmp(base, event->name))
+      {
+        ret = true;
       }
     }
+    p += sizeof(struct inotify_event) + event->len;
+  }
+  return ret;
+}
+
+//-- Function: mainloop ------------------------------------------------------------
+///
+/// The MainLoop Function
+///
+//------------------------------------------------------------------------------
+void mainloop(tLedBehavior * ledBehavior, tLedFiles * ledFiles)
+{
+  int fd = _WatchLedFiles(ledFiles);
+
+  if(fd < 0)
+  {
+    syslog(LOG_WARNING, "no inotify, checking LED files every %d s", LED_FILES_POLL_INTERVAL);
+  }
+  //mtrace();
+  while(1)
+  {
+    if(fd < 0)
+    {
+      sleep(LED_FILES_POLL_INTERVAL);
+    }
+    else
+    {
+      struct pollfd pfd = { .fd = fd, .events = POLLIN, .revents = 0 };
+
+      if(   (0 >= poll(&pfd, 1, -1))
+         || (!_DrainLedFileEvents(fd, ledFiles)))
+      {
+        continue;
+      }
+      // writers often touch a file several times; wait until it settles
+      while(0 < poll(&pfd, 1, LED_FILES_SETTLE_TIME))
+      {
+        (void)_DrainLedFileEvents(fd, ledFiles);
+      }
+    }
+    if(_LedFilesChanged(ledFiles))
+    {
+      ReloadLedEvents(ledBehavior, ledFiles);
+    }
   }
 }
 
@@ -964,9 +1389,11 @@ static void _SetupLedDefaultsFromInfoList(tLEDInfo * info)
       }
       if(pAct != NULL)
       {
+        pthread_mutex_lock(&ledDataMutex);
         GetLedInfo(ledNr, &ledInfo);
         SetLedDefaultState(ledNr,&ledInfo,&(pAct->info));
         SetDefaultState(ledNr,&ledInfo);
+        pthread_mutex_unlock(&ledDataMutex);
       }
     }
   }
@@ -1065,7 +1492,7 @@ int main(void)
     tLedEventList * pAct=ledEvents;
     while(pAct != NULL)
     {
-      pAct->handle = log_EVENT_RegisterForId(pAct->info.idInfo.id, (log_tEventHandler) IdHandler, pAct);
+      pAct->handle = log_EVENT_RegisterForIdLocal(pAct->info.idInfo.id, (log_tEventHandler) IdHandler, pAct);
       DBG2("Registered ID:0x%.8X", pAct->info.idInfo.id);
       DBG2("flags1:0x%.2X", pAct->info.flags);
       pAct->info.flags &= ~LED_FLAG_EVENT_NEW;
@@ -1112,6 +1539,7 @@ int main(void)
     }
   }
   com_MSG_RegisterObject(&con, LED_DBUS_PATH_ALL, (com_tHandlerFunction) GetAllLedHandler, (void*) ledBehavior.names);
+  _InitLedSnapshot();
   cleanUpInfoLedList(ledInfoList);
   mainloop(&ledBehavior,ledFiles);
   closelog();
@@ -0,0 +1,168 @@
+//------------------------------------------------------------------------------
+/// Copyright (c) WAGO GmbH & Co. KG
+///
+/// PROPRIETARY RIGHTS are involved in the subject matter of this material.
+/// All manufacturing, reproduction, use and sales rights pertaining to this
+/// subject matter are governed by the license agreement. The recipient of this
+/// software implicitly accepts the terms of the license.
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+///
+///  \file     diagcatalogtest.c
+///
+///  \brief    checks building, lookup and invalidation of the binary ID
+///            catalog (DIAGCAT_*)
+///
+///            Built with DIAGCAT_CACHE_DIR pointing into the build directory.
+///            Returns 0 if all checks pass.
+///
+///  \author   WAGO GmbH & Co. KG
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "diagnostic_catalog.h"
+
+#define TEST_XML_NAME  "diagcatalogtest.xml"
+#define TEST_XML_PATH  DIAGCAT_CACHE_DIR "/" TEST_XML_NAME
+#define TEST_CAT_PATH  DIAGCAT_CACHE_DIR "/" TEST_XML_NAME DIAGCAT_SUFFIX
+
+static int failed = 0;
+
+#define CHECK_STR(actual, expected)                                            \
+  _CheckStr(__LINE__, #actual, (actual), (expected))
+
+static void _CheckStr(int line, const char * what, const char * actual, const char * expected)
+{
+  if(   (actual == NULL) != (expected == NULL)
+     || (actual != NULL && strcmp(actual, expected)))
+  {
+    fprintf(stderr, "line %d: %s: got \"%s\", expected \"%s\"\n", line, what,
+            actual ? actual : "(null)", expected ? expected : "(null)");
+    failed++;
+  }
+}
+
+static int _WriteXml(const char * setString)
+{
+  FILE * f = fopen(TEST_XML_PATH, "w");
+
+  if(f == NULL)
+  {
+    perror(TEST_XML_PATH);
+    return -1;
+  }
+  fprintf(f,
+          "<?xml version=\"1.0\" encoding=\"UTF8\" ?>\n"
+          "<diagnostic>\n"
+          "  <eventclass class_range=\"x0001\" name=\"test\">\n"
+          "    <event id=\"x0002\" name=\"first\">\n"
+          "      <string><en>%s</en><de>Erstes</de></string>\n"
+          "      <rststr><en>First reset</en></rststr>\n"
+          "    </event>\n"
+          "    <event id=\"x0010\" name=\"second\">\n"
+          "      <string><en>Second</en></string>\n"
+          "    </event>\n"
+          "  </eventclass>\n"
+          "</diagnostic>\n",
+          setString);
+  return fclose(f);
+}
+
+// replaces a string of the cached catalog in place, keeping its length
+static int _PatchCatalog(const char * from, const char * to)
+{
+  FILE * f = fopen(TEST_CAT_PATH, "r+");
+  char buffer[4096];
+  size_t len;
+  char * pos;
+
+  if(f == NULL)
+  {
+    perror(TEST_CAT_PATH);
+    return -1;
+  }
+  len = fread(buffer, 1, sizeof(buffer), f);
+  pos = memmem(buffer, len, from, strlen(from));
+  if(pos == NULL || strlen(from) != strlen(to))
+  {
+    fclose(f);
+    return -1;
+  }
+  fseek(f, pos - buffer, SEEK_SET);
+  fwrite(to, 1, strlen(to), f);
+  return fclose(f);
+}
+
+static void _Lookup(const char * first)
+{
+  tDiagCatalog * cat = DIAGCAT_Open(TEST_XML_PATH);
+
+  if(cat == NULL)
+  {
+    fprintf(stderr, "DIAGCAT_Open failed\n");
+    failed++;
+    return;
+  }
+  CHECK_STR(DIAGCAT_GetStringOfId(cat, 0x00010002, NULL), first);
+  CHECK_STR(DIAGCAT_GetStringOfId(cat, 0x00010002, "de"), "Erstes");
+  // untranslated language falls back to the default one
+  CHECK_STR(DIAGCAT_GetStringOfId(cat, 0x00010010, "de"), "Second");
+  CHECK_STR(DIAGCAT_GetResetStringOfId(cat, 0x00010002, NULL), "First reset");
+  CHECK_STR(DIAGCAT_GetResetStringOfId(cat, 0x00010010, NULL), NULL);
+  // the upper two bits of an ID are not part of it
+  CHECK_STR(DIAGCAT_GetStringOfId(cat, 0xC0010010, NULL), "Second");
+  CHECK_STR(DIAGCAT_GetStringOfId(cat, 0x00010003, NULL), NULL);
+  DIAGCAT_Close(cat);
+}
+
+int main(void)
+{
+  struct stat st;
+
+  if(mkdir(DIAGCAT_CACHE_DIR, 0755) && access(DIAGCAT_CACHE_DIR, W_OK))
+  {
+    perror(DIAGCAT_CACHE_DIR);
+    return 1;
+  }
+  unlink(TEST_CAT_PATH);
+  if(_WriteXml("First"))
+  {
+    return 1;
+  }
+
+  // build: the first open compiles the document and caches the catalog
+  _Lookup("First");
+  if(stat(TEST_CAT_PATH, &st) || (st.st_mode & (S_IWGRP | S_IWOTH)))
+  {
+    fprintf(stderr, "catalog not cached as %s\n", TEST_CAT_PATH);
+    failed++;
+  }
+
+  // lookup: the cached catalog is used as long as the document is unchanged
+  if(_PatchCatalog("First", "Fir5t"))
+  {
+    fprintf(stderr, "can't patch %s\n", TEST_CAT_PATH);
+    failed++;
+  }
+  _Lookup("Fir5t");
+
+  // a catalog others may write to is not trusted and gets recompiled
+  chmod(TEST_CAT_PATH, 0666);
+  _Lookup("First");
+
+  // invalidation: a changed document makes the cached catalog outdated
+  if(_WriteXml("Changed first"))
+  {
+    return 1;
+  }
+  _Lookup("Changed first");
+
+  unlink(TEST_CAT_PATH);
+  unlink(TEST_XML_PATH);
+  printf("%s\n", failed ? "FAILED" : "OK");
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,170 @@
+//------------------------------------------------------------------------------
+/// Copyright (c) WAGO GmbH & Co. KG
+///
+/// PROPRIETARY RIGHTS are involved in the subject matter of this material.
+/// All manufacturing, reproduction, use and sales rights pertaining to this
+/// subject matter are governed by the license agreement. The recipient of this
+/// software implicitly accepts the terms of the license.
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+///
+///  \file     diageventbench.c
+///
+///  \brief    compares per-ID match rules (log_EVENT_RegisterForId) with the
+///            single interface subscription (log_EVENT_RegisterForIdLocal)
+///
+///            usage: diageventbench [ids] [events]
+///
+///            Registers the given number of IDs (default 1000) in both modes,
+///            emits a burst of events for them and reports the receive rate
+///            and the CPU time the dbus-daemon spent on the burst.
+///
+///  \author   WAGO GmbH & Co. KG
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+#include <diagnostic/diagnostic_API.h>
+
+#define BENCH_ID_BASE   0x01FF0000
+#define BENCH_TIMEOUT_S 30
+
+static volatile unsigned long received = 0;
+
+static void _BenchHandler(com_tConnection * con, com_tComMessage * msg, log_tEventId id, void * user_data)
+{
+  (void)con;
+  (void)msg;
+  (void)id;
+  (void)user_data;
+  __atomic_add_fetch(&received, 1, __ATOMIC_RELAXED);
+}
+
+static long _GetDaemonTicks(com_tConnection * con)
+{
+  static uint32_t pid = 0;
+  const char * daemonName = "org.freedesktop.DBus";
+  char path[64];
+  char line[1024];
+  unsigned long utime, stime;
+  char * p;
+  FILE * fp;
+
+  if(pid == 0)
+  {
+    if(com_MSG_MethodCall(con, "org.freedesktop.DBus", "/org/freedesktop/DBus",
+                          "GetConnectionUnixProcessID",
+                          COM_TYPE_STRING, &daemonName,
+                          COM_TYPE_INVALID,
+                          COM_TYPE_UINT32, &pid,
+                          COM_TYPE_INVALID))
+    {
+      return -1;
+    }
+  }
+  sprintf(path, "/proc/%u/stat", pid);
+  fp = fopen(path, "r");
+  if(fp == NULL)
+  {
+    return -1;
+  }
+  p = fgets(line, sizeof(line), fp);
+  fclose(fp);
+  if(p == NULL || (p = strrchr(line, ')')) == NULL)
+  {
+    return -1;
+  }
+  // fields after the command name; utime and stime are fields 14 and 15
+  if(2 != sscanf(p + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu",
+                 &utime, &stime))
+  {
+    return -1;
+  }
+  return (long)(utime + stime);
+}
+
+static void _RunBurst(com_tConnection * con, const char * mode, int ids, int events)
+{
+  struct timespec start, end;
+  long ticksStart, ticksEnd;
+  unsigned long target = __atomic_load_n(&received, __ATOMIC_RELAXED) + events;
+  double seconds;
+  int i;
+
+  ticksStart = _GetDaemonTicks(con);
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for(i = 0; i < events; i++)
+  {
+    log_EVENT_LogId(BENCH_ID_BASE + (i % ids), (i / ids) % 2 == 0);
+  }
+  do
+  {
+    usleep(1000);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+  }while(   (__atomic_load_n(&received, __ATOMIC_RELAXED) < target)
+         && (end.tv_sec - start.tv_sec < BENCH_TIMEOUT_S));
+  ticksEnd = _GetDaemonTicks(con);
+
+  seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+  printf("%-10s %d ids: %d events in %.3f s = %.0f events/s",
+         mode, ids, events, seconds, events / seconds);
+  if(ticksStart >= 0 && ticksEnd >= 0)
+  {
+    printf(", dbus-daemon %.2f s cpu", (double)(ticksEnd - ticksStart) / sysconf(_SC_CLK_TCK));
+  }
+  if(__atomic_load_n(&received, __ATOMIC_RELAXED) < target)
+  {
+    printf(" (timeout, %lu missing)", target - __atomic_load_n(&received, __ATOMIC_RELAXED));
+  }
+  printf("\n");
+}
+
+int main(int argc, char * argv[])
+{
+  com_tConnection con;
+  int ids = argc > 1 ? atoi(argv[1]) : 1000;
+  int events = argc > 2 ? atoi(argv[2]) : 20000;
+  com_tSignalHandle * handles;
+  int i;
+
+  if(ids <= 0 || events <= 0)
+  {
+    fprintf(stderr, "usage: %s [ids] [events]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  handles = malloc(sizeof(com_tSignalHandle) * ids);
+  if(handles == NULL)
+  {
+    return EXIT_FAILURE;
+  }
+
+  com_GEN_Init(&con);
+  log_EVENT_Init("diageventbench");
+
+  for(i = 0; i < ids; i++)
+  {
+    handles[i] = log_EVENT_RegisterForId(BENCH_ID_BASE + i, _BenchHandler, NULL);
+  }
+  _RunBurst(&con, "per-id", ids, events);
+  for(i = 0; i < ids; i++)
+  {
+    log_EVENT_DeregisterId(handles[i]);
+  }
+
+  for(i = 0; i < ids; i++)
+  {
+    handles[i] = log_EVENT_RegisterForIdLocal(BENCH_ID_BASE + i, _BenchHandler, NULL);
+  }
+  _RunBurst(&con, "local", ids, events);
+  for(i = 0; i < ids; i++)
+  {
+    log_EVENT_DeregisterIdLocal(handles[i]);
+  }
+
+  free(handles);
+  return EXIT_SUCCESS;
+}
+//---- End of source file ------------------------------------------------------
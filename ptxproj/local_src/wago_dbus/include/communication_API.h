@@ -118,7 +118,29 @@ typedef enum{
 
 typedef struct stDbusWorker tDbusWorker;
 
+typedef struct stWorkerStats{
+    unsigned long depth;      // size of the worker queue
+    unsigned long pending;    // messages waiting right now
+    unsigned long enqueued;   // messages handed to the worker
+    unsigned long processed;  // messages the worker has finished
+    unsigned long rejected;   // messages refused because the queue was full
+    unsigned long wakeups;    // times the idle worker had to be woken up
+    unsigned long highWater;  // highest queue fill seen
+} com_tWorkerStats;
+
+typedef struct stSignalStats{
+    const char  * interface;  // interface of the signal handlers
+    const char  * member;     // member or NULL for the handlers of all members
+    unsigned long dispatched; // signals delivered to the handlers
+    unsigned long calls;      // handler invocations
+    unsigned long handlers;   // handlers registered right now
+} com_tSignalStats;
+
+typedef void(*com_tSignalStatsFunction)(const com_tSignalStats*, void*);
+
 typedef void(*com_tHandlerFunction)(com_tConnection*, com_tComMessage*, void*);
+// reply of an asynchronous method call: connection, reply, 0 or -1 on error, user data
+typedef void(*com_tReplyFunction)(com_tConnection*, com_tComMessage*, int, void*);
 
 //------------------------------------------------------------------------------
 // Global variables
@@ -269,6 +291,19 @@ void com_SERV_Surrender(void);
 //------------------------------------------------------------------------------
 tDbusWorker * com_SERV_CreateNewWorker(unsigned char priority,char * name);
 
+//-- Function: com_SERV_CreateNewWorkerWithDepth ---------------------------------------------
+///
+///  Create a new worker with a given queue depth. Messages arriving while the
+///  queue is full are answered with DBUS_ERROR_LIMITS_EXCEEDED.
+///
+/// \param priority set priority for worker (0 SCHED_OTHER; 1-99 FIFO)
+/// \param name     name of the worker will be prefixed with wdbw_ and postfixed with ranom chars
+/// \param depth    number of messages the worker can buffer (rounded up to a power of two; 0 for default)
+///
+///  \return a new tDBus worker instance or NULL if error
+//------------------------------------------------------------------------------
+tDbusWorker * com_SERV_CreateNewWorkerWithDepth(unsigned char priority,char * name, unsigned int depth);
+
 //-- Function: com_SERV_GetWorker ---------------------------------------------
 ///
 ///  get a existing worker with priority and maybe this name
@@ -288,6 +323,23 @@ tDbusWorker * com_SERV_GetWorker(unsigned char priority,char * name);
 ///  \return old prio if OK; -1 on error
 int com_SERV_SetListenerPriority(unsigned char priority);
 
+//-- Function: com_SERV_GetWorkerStats ---------------------------------------------
+///
+///  get the queue statistics of a worker
+///
+/// \param worker the worker instance
+/// \param stats  filled with the current counters
+///
+///  \return 0 if OK; -1 on error
+int com_SERV_GetWorkerStats(tDbusWorker * worker, com_tWorkerStats * stats);
+
+//-- Function: com_SERV_ResetWorkerStats ---------------------------------------------
+///
+///  reset the counters and the high water mark of a worker
+///
+/// \param worker the worker instance
+void com_SERV_ResetWorkerStats(tDbusWorker * worker);
+
 //-- Function: com_MSG_Signal ---------------------------------------------------
 ///
 ///  Send a Signal to a given interface
@@ -350,6 +402,44 @@ int com_MSG_MethodCallVaArgs(com_tConnection* con,
                               int          first_arg_type,
                               va_list      var_args);
 
+//-- Function: com_MSG_MethodCallAsync ---------------------------------------------------
+///
+///  Send a MethodCall to a given object without waiting for the reply
+///
+///  The callback is called once from the receiver thread when the reply, an
+///  error or the timeout of the connection arrives. On error its result is -1
+///  and the error of its connection is set; otherwise the reply arguments can
+///  be read with com_MSG_GetParams. On a context connection the callback is
+///  called before this function returns.
+///
+///  \param com_tConnection* pointer to a connection variable
+///  \param dest         the destination name
+///  \param path         object path
+///  \param name         the member-name
+///  \param callback     called with the reply
+///  \param user_data    passed to callback
+///  \param additional parameters, terminated by COM_TYPE_INVALID
+///
+///  \return 0 if the call was sent; -1 on error (callback is not called)
+//------------------------------------------------------------------------------
+int com_MSG_MethodCallAsync(com_tConnection   * con,
+                            const char        * destination,
+                            const char        * path,
+                            const char        * name,
+                            com_tReplyFunction  callback,
+                            void              * user_data,
+                            int                 first_arg_type,
+                            ...);
+
+int com_MSG_MethodCallAsyncVaArgs(com_tConnection   * con,
+                                  const char        * destination,
+                                  const char        * path,
+                                  const char        * name,
+                                  com_tReplyFunction  callback,
+                                  void              * user_data,
+                                  int                 first_arg_type,
+                                  va_list             var_args);
+
 //-- Function: com_MSG_RegisterSignal ---------------------------------------------------
 ///
 ///  Registers a Signal-Handler for a given interface
@@ -472,9 +562,12 @@ int com_MSG_ReturnError(com_tConnection * con,
 ///
 ///  Removes a Signal-Handler for a given interface
 ///
-///  \param interface    the interface
-///  \param name         the signal member
-///  \param callback     the callback-function
+///  The handler is not called for signals received afterwards. If it is
+///  running at the moment, MemoryFreeFunction is called by the receiver
+///  thread when it returned, otherwise before this function returns.
+///
+///  \param handle              the handle returned by the registration
+///  \param MemoryFreeFunction  frees the user_data of the handler, may be NULL
 ///
 ///  \return 0 on success; -1 on error
 //------------------------------------------------------------------------------
@@ -482,6 +575,41 @@ int com_MSG_DeregisterSignal(com_tConnection     * con,
                              com_tSignalHandle     handle,
                              void(*MemoryFreeFunction)(void *user_data));
 
+//-- Function: com_MSG_GetSignalStats ---------------------------------------------------
+///
+///  get the dispatch counters of the signal handlers of an interface member
+///
+///  \param interface    the interface
+///  \param member       the signal member; NULL for the handlers of all members
+///  \param stats        filled with the current counters
+///
+///  \return 0 if OK; -1 if no handler is registered for interface and member
+//------------------------------------------------------------------------------
+int com_MSG_GetSignalStats(const char       * interface,
+                           const char       * member,
+                           com_tSignalStats * stats);
+
+//-- Function: com_MSG_ForEachSignalStats ---------------------------------------------------
+///
+///  call func with the dispatch counters of every registered interface member
+///
+///  The signal table is locked while func runs, so func must not register or
+///  deregister signals. The strings in the stats are only valid during the call.
+///
+///  \param func         the function called for every member
+///  \param user_data    passed to func
+///
+///  \return number of members reported; -1 on error
+//------------------------------------------------------------------------------
+int com_MSG_ForEachSignalStats(com_tSignalStatsFunction func, void * user_data);
+
+//-- Function: com_MSG_ResetSignalStats ---------------------------------------------------
+///
+///  reset the dispatch counters of all signal handlers
+///
+//------------------------------------------------------------------------------
+void com_MSG_ResetSignalStats(void);
+
 //-- Function: com_MSG_DeregisterObject ---------------------------------------------------
 ///
 ///  Removes an Object-Handler for a given path
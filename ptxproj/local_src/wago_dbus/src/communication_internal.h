@@ -24,10 +24,16 @@
 #include <glib.h>
 
 
+struct stMemberList;
+struct stInterfaceList;
+
 typedef struct stCallbackList {
     com_tHandlerFunction        callback;
     com_tSignalHandle           handle;
     void                  * user_data;
+    struct stMemberList   * member;          // owner, for deregistration by handle
+    int                     refs;            // registration + dispatches in progress
+    void                 (* freeUserData)(void *user_data); // set on deregistration
     struct stCallbackList * pNext;
 }tCallbackList;
 
@@ -35,13 +41,20 @@ typedef struct stMemberList {
     char                * member;
     tCallbackList       * callbackList;
     bool                  registered;
+    struct stInterfaceList * iFace;          // owner
+    unsigned long         dispatched;        // signals delivered to this member
+    unsigned long         calls;             // handler invocations
+    struct stMemberList * pPrev;
     struct stMemberList * pNext;
 }tMemberList;
 
 typedef struct stInterfaceList {
     char                   * interface;
     tMemberList            * memberList;
+    GHashTable             * memberIndex;    // member name -> tMemberList
+    tMemberList            * anyMember;      // handlers for all members (member NULL)
     bool                     registered;
+    struct stInterfaceList * pPrev;
     struct stInterfaceList * pNext;
 }tInterfaceList;
 
@@ -51,9 +64,10 @@ typedef struct stObject {
     tDbusWorker	*   worker;
 }tObject;
 
-typedef struct {
+typedef struct stPendingConditions {
     pthread_cond_t  condition;
     pthread_mutex_t mutex;
+    struct stPendingConditions * pNext;   // free list of exited threads
 }tPendingConditions;
 
 typedef enum {
@@ -68,11 +82,14 @@ typedef enum {
 //------------------------------------------------------------------------------
 extern com_tConnection      busConnection;
 extern tInterfaceList     * rootSignalHandler;
+extern pthread_rwlock_t     signalTableLock;
 extern tReceiverState       receiverState;
 extern bool                 signalFilterRegistered;
 extern int                  objectReferenceCounter;
+extern int                  asyncCallCounter;
 
 
+void             FreeCallback(           tCallbackList  * del);
 tMemberList    * MSG_GetMember(          tInterfaceList * pInterface,
                                          const char     * member);
 tInterfaceList * MSG_GetInterface(       const char     * interface);
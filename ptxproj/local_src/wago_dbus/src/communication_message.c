@@ -38,7 +38,12 @@
 
 
 tInterfaceList  * rootSignalHandler = NULL;
+pthread_rwlock_t  signalTableLock = PTHREAD_RWLOCK_INITIALIZER;
 static int32_t    signalHandle = 0;
+// interface name -> tInterfaceList, keys are owned by the list elements
+static GHashTable * interfaceIndex = NULL;
+// signal handle -> tCallbackList
+static GHashTable * handleIndex = NULL;
 
 //int method_call_timeout= -1;
 
@@ -58,8 +63,11 @@ tCallbackList * NewCallback( com_tHandlerFunction callback, void *user_data)
   if(cbl != NULL)
   {
     cbl->pNext              = NULL;
+    cbl->member             = NULL;
     cbl->callback           = callback;
     cbl->user_data          = user_data;
+    cbl->refs               = 1;
+    cbl->freeUserData       = NULL;
   }
   return cbl;
 }
@@ -79,8 +87,12 @@ tMemberList * NewMember(const char * member)
   if(mbr != NULL)
   {
     mbr->pNext              = NULL;
+    mbr->pPrev              = NULL;
+    mbr->iFace              = NULL;
     mbr->callbackList       = NULL;
     mbr->registered         = false;
+    mbr->dispatched         = 0;
+    mbr->calls              = 0;
     if(member != NULL)
     {
       mbr->member           = malloc((sizeof(char) * strlen(member))+1);
@@ -110,8 +122,11 @@ tInterfaceList * NewInterface(const char * interface)
   if(iFace != NULL)
   {
     iFace->pNext            = NULL;
+    iFace->pPrev            = NULL;
     iFace->memberList       = NULL;
+    iFace->anyMember        = NULL;
     iFace->registered       = false;
+    iFace->memberIndex      = g_hash_table_new(g_str_hash, g_str_equal);
     iFace->interface        = malloc((sizeof(char) * strlen(interface))+1);
     strcpy(iFace->interface, interface);
   }
@@ -142,7 +157,9 @@ tObject * MSG_NewObject(com_tHandlerFunction callback, void * user_data)
 
 //-- Function: FreeCallback ----------------------------------------------------
 ///
-///  Frees the Memory of a CallbackHandler
+///  Drops a reference of a CallbackHandler. The last one frees its memory and
+///  the user data, so a deregistered handler is freed by the signal handler
+///  when it is still being called.
 ///
 ///  \param tCallbackList Callback-To be freed
 ///
@@ -150,20 +167,33 @@ tObject * MSG_NewObject(com_tHandlerFunction callback, void * user_data)
 //------------------------------------------------------------------------------
 void FreeCallback(tCallbackList * del)
 {
-  free(del);
+  if(__atomic_sub_fetch(&del->refs, 1, __ATOMIC_ACQ_REL) == 0)
+  {
+    if(del->freeUserData != NULL)
+    {
+      del->freeUserData(del->user_data);
+    }
+    free(del);
+  }
 }
 
-void DeleteCallbackFromList(tCallbackList ** root, tCallbackList * prev, tCallbackList * del)
+void DeleteCallbackFromList(tMemberList * member, tCallbackList * del)
 {
-  if(prev == NULL)
+  tCallbackList ** link = &member->callbackList;
+
+  // a member only holds the few handlers registered for it
+  while((*link != NULL) && (*link != del))
   {
-    *root = del->pNext;
+    link = &(*link)->pNext;
   }
-  else
+  if(*link != NULL)
   {
-    prev->pNext = del->pNext;
+    *link = del->pNext;
+  }
+  if(handleIndex != NULL)
+  {
+    g_hash_table_remove(handleIndex, GINT_TO_POINTER(del->handle));
   }
-  FreeCallback(del);
 }
 
 //-- Function: FreeMember ----------------------------------------------------
@@ -180,15 +210,27 @@ void FreeMember(tMemberList * del)
     free(del);
 }
 
-void DeleteMemberFromList(tMemberList ** root,tMemberList * prev, tMemberList * del)
+void DeleteMemberFromList(tInterfaceList * iFace, tMemberList * del)
 {
-  if(prev == NULL)
+  if(del->pPrev == NULL)
+  {
+    iFace->memberList = del->pNext;
+  }
+  else
+  {
+    del->pPrev->pNext = del->pNext;
+  }
+  if(del->pNext != NULL)
+  {
+    del->pNext->pPrev = del->pPrev;
+  }
+  if(del->member == NULL)
   {
-    *root = del->pNext;
+    iFace->anyMember = NULL;
   }
   else
   {
-    prev->pNext = del->pNext;
+    g_hash_table_remove(iFace->memberIndex, del->member);
   }
   FreeMember(del);
 }
@@ -203,20 +245,26 @@ void DeleteMemberFromList(tMemberList ** root,tMemberList * prev, tMemberList *
 //------------------------------------------------------------------------------
 void FreeInterface(tInterfaceList * del)
 {
+    g_hash_table_destroy(del->memberIndex);
     free(del->interface);
     free(del);
 }
 
-void DeleteInterfaceFromList(tInterfaceList ** root,tInterfaceList * prev, tInterfaceList * del)
+void DeleteInterfaceFromList(tInterfaceList * del)
 {
-  if(prev == NULL)
+  if(del->pPrev == NULL)
   {
-    *root = del->pNext;
+    rootSignalHandler = del->pNext;
   }
   else
   {
-    prev->pNext = del->pNext;
+    del->pPrev->pNext = del->pNext;
   }
+  if(del->pNext != NULL)
+  {
+    del->pNext->pPrev = del->pPrev;
+  }
+  g_hash_table_remove(interfaceIndex, del->interface);
   FreeInterface(del);
 }
 
@@ -251,6 +299,10 @@ com_tSignalHandle SetCallBack(tMemberList     * pMember,
   tCallbackList * list = pMember->callbackList;
   com_tSignalHandle ret = 0;
 
+  if(handleIndex == NULL)
+  {
+    handleIndex = g_hash_table_new(g_direct_hash, g_direct_equal);
+  }
   if(list == NULL)
   {
     pMember->callbackList = NewCallback(callback,user_data);
@@ -276,7 +328,14 @@ com_tSignalHandle SetCallBack(tMemberList     * pMember,
   }
   else
   {
+    if(list->member != NULL)
+    {
+      // already registered: the old handle is replaced by the new one
+      g_hash_table_remove(handleIndex, GINT_TO_POINTER(list->handle));
+    }
+    list->member = pMember;
     list->handle = signalHandle++;
+    g_hash_table_insert(handleIndex, GINT_TO_POINTER(list->handle), list);
     ret = list->handle;
   }
   return ret;
@@ -315,49 +374,28 @@ int CompareMember(const char *member1,const char *member2)
 
 //-- Function: MSG_GetMember ----------------------------------------------------
 ///
-///  Go throw a tMemberList and look for a given Member-String
+///  Look up a given Member-String in the member index of an interface
 ///
 ///  \param pInterface        Interface-Pointer
-///  \param memebr            the member-string
+///  \param memebr            the member-string; NULL for the handlers of all members
 ///
 ///  \return NULL if not found otherwise the tMember-Pointer
 ///
 //-----------------------------------------------------------------------------
 tMemberList * MSG_GetMember(tInterfaceList * pInterface, const char * member)
 {
-  tMemberList * list = pInterface->memberList;
-
   if(member == NULL)
   {
-    while(list != NULL)
-    {
-      if(list->member == NULL)
-      {
-        break;
-      }
-      list = list->pNext;
-    }
+    return pInterface->anyMember;
   }
-  else
-  {
-    while(list != NULL)
-    {
-      if(   (list->member != NULL)
-         && (!strcmp(member, list->member)))
-      {
-        break;
-      }
-      list = list->pNext;
-    }
-  }
-  return list;
+  return g_hash_table_lookup(pInterface->memberIndex, member);
 }
 
 
-//-- Function: MSG_GetMember ----------------------------------------------------
+//-- Function: GetMemberNew ----------------------------------------------------
 ///
-///  Go throw a tMemberList and look for a given Member-String if not found
-///  create a ne element at the end of the list
+///  Look up a given Member-String, if not found create a new element at the
+///  end of the member list of the interface
 ///
 ///  \param pInterface        Interface-Pointer
 ///  \param memebr            the member-string
@@ -367,23 +405,36 @@ tMemberList * MSG_GetMember(tInterfaceList * pInterface, const char * member)
 //-----------------------------------------------------------------------------
 tMemberList * GetMemberNew(tInterfaceList * pInterface, const char * member)
 {
-  tMemberList * list = pInterface->memberList;
+  tMemberList * list = MSG_GetMember(pInterface, member);
+
   if(list == NULL)
   {
-    pInterface->memberList = NewMember(member);
-    list = pInterface->memberList;
-  }
-  else
-  {
-    while(CompareMember(member, list->member))
+    list = NewMember(member);
+    if(list != NULL)
     {
-      if(list->pNext == NULL)
+      tMemberList * last = pInterface->memberList;
+      list->iFace = pInterface;
+      if(last == NULL)
       {
-        list->pNext      = NewMember(member);
-        list             = list->pNext;
-        break;
+        pInterface->memberList = list;
+      }
+      else
+      {
+        while(last->pNext != NULL)
+        {
+          last = last->pNext;
+        }
+        last->pNext = list;
+        list->pPrev = last;
+      }
+      if(member == NULL)
+      {
+        pInterface->anyMember = list;
+      }
+      else
+      {
+        g_hash_table_insert(pInterface->memberIndex, list->member, list);
       }
-      list = list->pNext;
     }
   }
   return list;
@@ -391,7 +442,7 @@ tMemberList * GetMemberNew(tInterfaceList * pInterface, const char * member)
 
 //-- Function: MSG_GetInterface ----------------------------------------------------
 ///
-///  Go throw a tInterfaceList and look for a given interface-String
+///  Look up a given interface-String in the interface index
 ///
 ///  \param inetrafce            the interface-string
 ///
@@ -400,22 +451,18 @@ tMemberList * GetMemberNew(tInterfaceList * pInterface, const char * member)
 //-----------------------------------------------------------------------------
 tInterfaceList * MSG_GetInterface(const char * interface)
 {
-  tInterfaceList * list = rootSignalHandler;
-  while(list != NULL)
+  if(   (interface == NULL)
+     || (interfaceIndex == NULL))
   {
-    if(!strcmp(interface, list->interface))
-    {
-      break;
-    }
-    list = list->pNext;
+    return NULL;
   }
-  return list;
+  return g_hash_table_lookup(interfaceIndex, interface);
 }
 
 //-- Function: GetInterfaceNew ----------------------------------------------------
 ///
-///  Go throw a tInterfaceList and look for a given Member-String if not found
-///  create a ne element at the end of the list
+///  Look up a given interface-String, if not found create a new element at
+///  the head of the interface list
 ///
 ///  \param interface            the interface-string
 ///
@@ -428,11 +475,20 @@ tInterfaceList * GetInterfaceNew(const char * interface)
 
   if(list == NULL)
   {
+    if(interfaceIndex == NULL)
+    {
+      interfaceIndex = g_hash_table_new(g_str_hash, g_str_equal);
+    }
     list = NewInterface(interface);
     if(list != NULL)
     {
       list->pNext = rootSignalHandler;
+      if(rootSignalHandler != NULL)
+      {
+        rootSignalHandler->pPrev = list;
+      }
       rootSignalHandler = list;
+      g_hash_table_insert(interfaceIndex, list->interface, list);
     }
   }
 
@@ -649,22 +705,14 @@ int _ConditionInit(pthread_cond_t * condition)
   return result;
 
 }
-typedef enum  {
-  PCS_UNINTIALIZED,
-  PCS_FREE,
-  PCS_USED
-}tPendingConditionState;
-typedef struct {
-    tPendingConditions cond;
-    tPendingConditionState state;
-}tPendingPool;
-pthread_mutex_t protectPendingCondition;
-static tPendingPool ppool[] = {
-                                { .state = PCS_UNINTIALIZED },
-                                { .state = PCS_UNINTIALIZED },
-                                { .state = PCS_UNINTIALIZED }
-};
-static const size_t szPendingPool= sizeof (ppool)/sizeof (tPendingPool);
+// Every thread keeps the pending condition of its last method call, so the
+// synchronous call path neither locks nor allocates after the first call.
+// Conditions of exited threads are kept in a free list for new threads and
+// are never destroyed.
+static pthread_once_t       pendingOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t        pendingKey;
+pthread_mutex_t             protectPendingCondition;
+static tPendingConditions * pendingFreeList = NULL;
 
 static int _InitPendingCondition(tPendingConditions * cond)
 {
@@ -685,51 +733,58 @@ static int _InitPendingCondition(tPendingConditions * cond)
     return result;
 }
 
-tPendingConditions * _getPendingCondition(void)
+static void _pushPendingCondition(tPendingConditions * cond)
 {
-  tPendingConditions * cond = NULL;
+  pthread_mutex_lock(&protectPendingCondition);
+  cond->pNext = pendingFreeList;
+  pendingFreeList = cond;
+  pthread_mutex_unlock(&protectPendingCondition);
+}
 
+static void _pendingThreadExit(void * cond)
+{
+  _pushPendingCondition(cond);
+}
 
-  size_t i;
-  static int once = 0;
-  if(!once)
+static void _pendingPoolInit(void)
+{
+  _MutexInit(&protectPendingCondition);
+  pthread_key_create(&pendingKey, _pendingThreadExit);
+}
+
+tPendingConditions * _getPendingCondition(void)
+{
+  tPendingConditions * cond;
+
+  pthread_once(&pendingOnce, _pendingPoolInit);
+  cond = pthread_getspecific(pendingKey);
+  if(cond != NULL)
   {
-    _MutexInit(&protectPendingCondition);
-    once=1;
+    pthread_setspecific(pendingKey, NULL);
+    return cond;
   }
 
   pthread_mutex_lock(&protectPendingCondition);
-
-  for(i = 0; i < szPendingPool; i++)
+  cond = pendingFreeList;
+  if(cond != NULL)
   {
-    if(ppool[i].state == PCS_UNINTIALIZED)
-    {
-
-      if(_InitPendingCondition(&(ppool[i].cond)))
-      {
-        //errorhandling??
-        break;
-      }
-      ppool[i].state=PCS_FREE;
-    }
-    if(ppool[i].state == PCS_FREE)
-    {
-      ppool[i].state=PCS_USED;
-      cond = &(ppool[i].cond);
-      break;
-    }
+    pendingFreeList = cond->pNext;
   }
+  pthread_mutex_unlock(&protectPendingCondition);
+
   if(cond == NULL)
   {
     cond = malloc(sizeof (tPendingConditions));
-    memset(cond,0,sizeof (tPendingConditions));
-    if(_InitPendingCondition(cond))
+    if(cond != NULL)
     {
-      free(cond);
-      cond=NULL;
+      memset(cond,0,sizeof (tPendingConditions));
+      if(_InitPendingCondition(cond))
+      {
+        free(cond);
+        cond=NULL;
+      }
     }
   }
-  pthread_mutex_unlock(&protectPendingCondition);
   return cond;
 }
 
@@ -740,25 +795,11 @@ void _releasePendingCondition(tPendingConditions * cond)
   {
     return;
   }
-  size_t i;
-  int heapMutex=1;
-  pthread_mutex_lock(&protectPendingCondition);
-  for(i = 0; i < szPendingPool; i++)
-  {
-    if(cond == &(ppool[i].cond))
-    {
-      heapMutex=0;
-      ppool[i].state=PCS_FREE;
-      break;
-    }
-  }
-  if(heapMutex)
+  if(   (pthread_getspecific(pendingKey) != NULL)
+     || (pthread_setspecific(pendingKey, cond) != 0))
   {
-    pthread_mutex_destroy(&cond->mutex);
-    pthread_cond_destroy(&cond->condition);
-    free(cond);
+    _pushPendingCondition(cond);
   }
-  pthread_mutex_unlock(&protectPendingCondition);
 }
 
 /*TODO: Break down to several methods for not using the goto's*/
@@ -793,6 +834,12 @@ int com_MSG_MethodCallVaArgs(com_tConnection* con,
 
     dbus_bool_t returns;
     cond = _getPendingCondition();
+    if(cond == NULL)
+    {
+      ret = -ENOMEM;
+      SERV_UnblockServer();
+      goto EndOfFunction;
+    }
 
     returns = dbus_connection_send_with_reply(con->bus,message,&pending_return, con->method_call_timeout);
     if( (!returns) || (pending_return == NULL) )
@@ -944,6 +991,182 @@ int com_MSG_MethodCall(com_tConnection* con,
   return ret;
 }
 
+typedef struct {
+    com_tReplyFunction   callback;
+    void               * user_data;
+    DBusConnection     * bus;
+}tAsyncCall;
+
+//-- Function: _CallReplyFunction ----------------------------------------------
+///
+///  Hand a reply (or NULL) to the reply function of an asynchronous call
+///
+//------------------------------------------------------------------------------
+static void _CallReplyFunction(tAsyncCall * call, DBusMessage * reply)
+{
+  com_tConnection con;
+  com_tComMessage msg;
+  int result = 0;
+
+  memset(&con, 0, sizeof con);
+  con.bus = call->bus;
+  con.type = COM_CONNECTION_PROXY;
+  con.method_call_timeout = -1;
+  dbus_error_init(&con.error);
+  if(reply == NULL)
+  {
+    dbus_set_error(&con.error, DBUS_ERROR_NO_MEMORY, NULL);
+    result = -1;
+  }
+  else if(DBUS_MESSAGE_TYPE_ERROR == dbus_message_get_type(reply))
+  {
+    dbus_set_error_from_message(&con.error, reply);
+    result = -1;
+  }
+  msg.msg = reply;
+  call->callback(&con, &msg, result, call->user_data);
+  dbus_error_free(&con.error);
+}
+
+//-- Function: AsyncReplyNotify ------------------------------------------------
+///
+///  Pending call notification of an asynchronous method call, runs in the
+///  receiver thread
+///
+//------------------------------------------------------------------------------
+static void AsyncReplyNotify(DBusPendingCall *pending, tAsyncCall * call)
+{
+  DBusMessage * reply = dbus_pending_call_steal_reply(pending);
+
+  _CallReplyFunction(call, reply);
+  if(reply != NULL)
+  {
+    dbus_message_unref(reply);
+  }
+  // the receiver thread is left running, the next (de)registration stops it
+  // if nothing else needs it
+  __atomic_sub_fetch(&asyncCallCounter, 1, __ATOMIC_RELEASE);
+}
+
+//-- Function: com_MSG_MethodCallAsyncVaArgs -----------------------------------
+///
+///  see communication_API.h
+///
+//------------------------------------------------------------------------------
+int com_MSG_MethodCallAsyncVaArgs(com_tConnection   * con,
+                                  const char        * destination,
+                                  const char        * path,
+                                  const char        * name,
+                                  com_tReplyFunction  callback,
+                                  void              * user_data,
+                                  int                 first_arg_type,
+                                  va_list             var_args)
+{
+  DBusMessage * message;
+  DBusPendingCall * pending_return = NULL;
+  tAsyncCall * call;
+  dbus_bool_t returns;
+  dbus_bool_t notifySet = FALSE;
+
+  dbus_error_free(&con->error);
+  if(callback == NULL)
+  {
+    errno = EINVAL;
+    return -1;
+  }
+  message = dbus_message_new_method_call(destination, path, NULL, name);
+  call = malloc(sizeof(tAsyncCall));
+  if(   (message == NULL)
+     || (call == NULL)
+     || (FALSE == dbus_message_append_args_valist(message, first_arg_type, var_args)))
+  {
+    if(message != NULL)
+    {
+      dbus_message_unref(message);
+    }
+    free(call);
+    errno = ENOMEM;
+    return -1;
+  }
+  call->callback  = callback;
+  call->user_data = user_data;
+  call->bus       = con->bus;
+
+  if(con->type == COM_CONNECTION_CONTEXT)
+  {
+    // handled in this thread, so the reply is already there
+    DBusMessage * reply = DIRECT_HandleContextMessage(con, message);
+    _CallReplyFunction(call, reply);
+    if(reply != NULL)
+    {
+      dbus_message_unref(reply);
+    }
+    dbus_message_unref(message);
+    free(call);
+    return 0;
+  }
+
+  // the reply is dispatched by the receiver thread, keep it running
+  __atomic_add_fetch(&asyncCallCounter, 1, __ATOMIC_ACQ_REL);
+  SERV_RecallServerThread();
+
+  // the receiver must not dispatch the reply before the notify is set
+  SERV_BlockServer();
+  returns = dbus_connection_send_with_reply(con->bus, message, &pending_return,
+                                            con->method_call_timeout);
+  if(   returns
+     && (pending_return != NULL))
+  {
+    notifySet = dbus_pending_call_set_notify(pending_return,
+                                             (DBusPendingCallNotifyFunction) AsyncReplyNotify,
+                                             call, free);
+  }
+  SERV_UnblockServer();
+  dbus_message_unref(message);
+
+  if(!notifySet)
+  {
+    if(pending_return != NULL)
+    {
+      dbus_pending_call_cancel(pending_return);
+      dbus_pending_call_unref(pending_return);
+    }
+    free(call);
+    __atomic_sub_fetch(&asyncCallCounter, 1, __ATOMIC_RELEASE);
+    errno = ECOMM;
+    return -1;
+  }
+  // the connection keeps its own reference until the call completes
+  dbus_pending_call_unref(pending_return);
+  dbus_connection_flush(con->bus);
+  return 0;
+}
+
+//-- Function: com_MSG_MethodCallAsync -----------------------------------------
+///
+///  see communication_API.h
+///
+//------------------------------------------------------------------------------
+int com_MSG_MethodCallAsync(com_tConnection   * con,
+                            const char        * destination,
+                            const char        * path,
+                            const char        * name,
+                            com_tReplyFunction  callback,
+                            void              * user_data,
+                            int                 first_arg_type,
+                            ...)
+{
+  va_list var_args;
+  int ret;
+  va_start (var_args, first_arg_type);
+  (void)com_GEN_BlockThreadCancelling();
+  ret = com_MSG_MethodCallAsyncVaArgs(con, destination, path, name, callback,
+                                      user_data, first_arg_type, var_args);
+  (void)com_GEN_UnblockThreadCancelling();
+  va_end (var_args);
+  return ret;
+}
+
 //-- Function: com_MSG_RegisterSignal ---------------------------------------------------
 ///
 ///  Registers a Signal-Handler for a given interface
@@ -963,6 +1186,9 @@ com_tSignalHandle com_MSG_RegisterSignal(com_tConnection *con,
   tInterfaceList * pInterface;
   tMemberList    * pMember;
   com_tSignalHandle ret =0;
+  bool needMatch = false;
+
+  pthread_rwlock_wrlock(&signalTableLock);
   pInterface = GetInterfaceNew(interface);
   if(pInterface == NULL)
   {
@@ -978,11 +1204,16 @@ com_tSignalHandle com_MSG_RegisterSignal(com_tConnection *con,
   {
     ret = SetCallBack(pMember, callback, user_data);
   }
+  if(ret >= 0)
+  {
+    needMatch =    (pInterface->registered == false)
+                || (pMember->registered == false);
+  }
+  pthread_rwlock_unlock(&signalTableLock);
 
   if(ret >= 0)
   {
-    if(   (pInterface->registered == false)
-       || (pMember->registered == false))
+    if(needMatch)
     {
       RegisterMatch( con, pInterface, pMember);
     }
@@ -1320,71 +1551,157 @@ int com_MSG_DeregisterSignal(com_tConnection     * con,
                              int               handle,
                              void(*MemoryFreeFunction)(void *user_data))
 {
-  tInterfaceList * iFace;
-  tInterfaceList * iFacePrev;
+  tCallbackList  * cbList = NULL;
+  bool             removeInterface = false;
+  char removeMatch[4096] = "\0";
+  const char * pRemoveMatch = removeMatch;
+
   dbus_error_free(&con->error);
-  iFace = rootSignalHandler;
-  iFacePrev = NULL;
-  while(iFace != NULL)
+  pthread_rwlock_wrlock(&signalTableLock);
+  if(handleIndex != NULL)
   {
-    tMemberList    * member = iFace->memberList;
-    tMemberList    * memberPrev = NULL;
-    while(member != NULL)
-    {
-      tCallbackList  * cbList = member->callbackList;
-      tCallbackList  * cbListPrev = NULL;
+    cbList = g_hash_table_lookup(handleIndex, GINT_TO_POINTER(handle));
+  }
+  if(cbList != NULL)
+  {
+    tMemberList    * member = cbList->member;
+    tInterfaceList * iFace  = member->iFace;
 
-      while(cbList != NULL)
+    cbList->freeUserData = MemoryFreeFunction;
+    if(member->member != NULL)
+    {
+      sprintf(removeMatch, "member='%s',",member->member);
+    }
+    sprintf(removeMatch, "%stype='signal',interface='%s'", removeMatch, iFace->interface);
+    DeleteCallbackFromList(member, cbList);
+    if(member->callbackList == NULL)
+    {
+      DeleteMemberFromList(iFace, member);
+      if(iFace->memberList == NULL)
       {
-        if(cbList->handle == handle)
-        {
-          char removeMatch[4096] = "\0";
-          const char * pRemoveMatch = removeMatch;
-          if(MemoryFreeFunction != NULL)
-          {
-            MemoryFreeFunction(cbList->user_data);
-          }
-          if(member->member != NULL)
-          {
-            sprintf(removeMatch, "member='%s',",member->member);
-          }
-          sprintf(removeMatch, "%stype='signal',interface='%s'", removeMatch, iFace->interface);
-          DeleteCallbackFromList(&member->callbackList, cbListPrev, cbList);
-          if(member->callbackList == NULL)
-          {
-            DeleteMemberFromList(&iFace->memberList, memberPrev, member);
-            if(iFace->memberList == NULL)
-            {
-              DeleteInterfaceFromList(&rootSignalHandler, iFacePrev, iFace);
-              //dbus_bus_remove_match(con->bus,removeMatch,&con->error);
-              com_MSG_MethodCall(con, DBUS_SERVICE_DBUS, DBUS_PATH_DBUS, "RemoveMatch",
-                                 DBUS_TYPE_STRING, &pRemoveMatch,
-                                 COM_TYPE_INVALID,COM_TYPE_INVALID);
-            }
-          }
-          SERV_RecallServerThread();
-
-          if(dbus_error_is_set  ( &con->error ))
-          {
-            return -1;
-          }
-          //return or goto ... both is bad
-          goto loopOut;
-        }
-        cbListPrev = cbList;
-        cbList = cbList->pNext;
+        DeleteInterfaceFromList(iFace);
+        removeInterface = true;
       }
-      memberPrev = member;
-      member = member->pNext;
     }
-    iFacePrev = iFace;
-    iFace = iFace->pNext;
   }
-loopOut:
+  pthread_rwlock_unlock(&signalTableLock);
+
+  if(cbList == NULL)
+  {
+    return 0;
+  }
+  // a signal handler may still call the handler it took under the table
+  // lock; then it frees the handler and user_data when its call returns
+  FreeCallback(cbList);
+  if(removeInterface)
+  {
+    //dbus_bus_remove_match(con->bus,removeMatch,&con->error);
+    com_MSG_MethodCall(con, DBUS_SERVICE_DBUS, DBUS_PATH_DBUS, "RemoveMatch",
+                       DBUS_TYPE_STRING, &pRemoveMatch,
+                       COM_TYPE_INVALID,COM_TYPE_INVALID);
+  }
+  SERV_RecallServerThread();
+
+  if(dbus_error_is_set  ( &con->error ))
+  {
+    return -1;
+  }
   return 0;
 }
+
 #endif
 
+//-- Function: com_MSG_GetSignalStats ---------------------------------------------------
+///
+///  see communication_API.h
+///
+//------------------------------------------------------------------------------
+static void _FillSignalStats(tMemberList * member, com_tSignalStats * stats)
+{
+  tCallbackList * cbl;
+
+  stats->interface  = member->iFace->interface;
+  stats->member     = member->member;
+  stats->dispatched = __atomic_load_n(&member->dispatched, __ATOMIC_RELAXED);
+  stats->calls      = __atomic_load_n(&member->calls, __ATOMIC_RELAXED);
+  stats->handlers   = 0;
+  for(cbl = member->callbackList; cbl != NULL; cbl = cbl->pNext)
+  {
+    stats->handlers++;
+  }
+}
+
+int com_MSG_GetSignalStats(const char       * interface,
+                           const char       * member,
+                           com_tSignalStats * stats)
+{
+  tInterfaceList * iFace;
+  tMemberList    * mbr = NULL;
+
+  if(stats == NULL)
+  {
+    return -1;
+  }
+  pthread_rwlock_rdlock(&signalTableLock);
+  iFace = MSG_GetInterface(interface);
+  if(iFace != NULL)
+  {
+    mbr = MSG_GetMember(iFace, member);
+  }
+  if(mbr != NULL)
+  {
+    _FillSignalStats(mbr, stats);
+    // the names of the table are only valid under the lock
+    stats->interface = interface;
+    stats->member    = member;
+  }
+  pthread_rwlock_unlock(&signalTableLock);
+  return (mbr != NULL) ? 0 : -1;
+}
+
+int com_MSG_ForEachSignalStats(com_tSignalStatsFunction func, void * user_data)
+{
+  tInterfaceList * iFace;
+  int count = 0;
+
+  if(func == NULL)
+  {
+    return -1;
+  }
+  pthread_rwlock_rdlock(&signalTableLock);
+  for(iFace = rootSignalHandler; iFace != NULL; iFace = iFace->pNext)
+  {
+    tMemberList * mbr;
+    for(mbr = iFace->memberList; mbr != NULL; mbr = mbr->pNext)
+    {
+      com_tSignalStats stats;
+      _FillSignalStats(mbr, &stats);
+      func(&stats, user_data);
+      count++;
+    }
+  }
+  pthread_rwlock_unlock(&signalTableLock);
+  return count;
+}
+
+void com_MSG_ResetSignalStats(void)
+{
+  tInterfaceList * iFace;
+
+  pthread_rwlock_rdlock(&signalTableLock);
+  for(iFace = rootSignalHandler; iFace != NULL; iFace = iFace->pNext)
+  {
+    tMemberList * mbr;
+    for(mbr = iFace->memberList; mbr != NULL; mbr = mbr->pNext)
+    {
+      __atomic_store_n(&mbr->dispatched, 0, __ATOMIC_RELAXED);
+      __atomic_store_n(&mbr->calls, 0, __ATOMIC_RELAXED);
+    }
+  }
+  pthread_rwlock_unlock(&signalTableLock);
+}
+
+
 //-- Function: com_MSG_DeregisterObject ---------------------------------------------------
 ///
 ///  Removes an Object-Handler for a given path
@@ -31,8 +31,7 @@
 #include <dbus/dbus-glib-lowlevel.h>
 #include <errno.h>
 #include <pthread.h>
-#include <mqueue.h>
-#include <poll.h>
+#include <sys/eventfd.h>
 
 #include "communication_API.h"
 #include "communication_internal.h"
@@ -43,11 +42,39 @@
 #define WORKER_NAME_LEN(name) (strlen(WORKER_PREFIX)+strlen(name)+strlen(ID_TEMPLATE)+1)
 
 
+#define WORKER_DEFAULT_DEPTH 64
+#define WORKER_MAX_DEPTH     (64 * 1024)
+
+typedef struct stWorkerMsgQ {
+	tObject * object;
+	DBusConnection * DBusCon;
+	DBusMessage     * DBusMsg;
+}tWorkerMsgQ;
+
+// one slot of the worker ring; seq tells producers and the consumer whose
+// turn it is (bounded MPMC scheme, used here with a single consumer)
+typedef struct stWorkerSlot {
+	unsigned long seq;
+	tWorkerMsgQ   msg;
+}tWorkerSlot;
+
 struct stDbusWorker{
 	pthread_t id;
 	char * name;
 	unsigned int priority;
-	mqd_t  fdq;
+	// in-process ring, filled by the receiver thread, drained by the worker
+	tWorkerSlot * ring;
+	unsigned long mask;
+	unsigned long head;     // next slot to claim for producers
+	unsigned long tail;     // next slot to read, worker thread only
+	int           fdWake;   // eventfd the worker sleeps on when idle
+	int           sleeping; // set by the worker before it blocks on fdWake
+	// backpressure statistics
+	unsigned long enqueued;
+	unsigned long processed;
+	unsigned long rejected;
+	unsigned long wakeups;
+	unsigned long highWater;
 };
 
 typedef struct stWorkerList tWorkerList;
@@ -58,19 +85,13 @@ struct stWorkerList {
 };
 
 
-
-typedef struct stWorkerMsgQ {
-	tObject * object;
-	DBusConnection * DBusCon;
-	DBusMessage     * DBusMsg;
-}tWorkerMsgQ;
-
 tReceiverState  receiverState = REC_STATE_STOP;
 tWorkerList * pWorkerRoot=NULL;
 
 bool                     signalFilterRegistered = false;
 bool                     receiverUp = false;
 int                      objectReferenceCounter = 0;
+int                      asyncCallCounter = 0;
 static pthread_t         threadReceiver;
 static int               receiverThreadPriority = 49;
 static GMainLoop       * loop =  NULL;
@@ -193,44 +214,69 @@ static void * ReceiveServer(void * user_data)
 
 }
 
-//-- Function: CallSignalHandler -----------------------------------------------
+#define SIGNAL_HANDLER_STACK 16  // handlers per signal copied without allocating
+
+typedef struct {
+    tCallbackList        * handler;   // referenced until the call returned
+}tSignalCall;
+
+//-- Function: CollectSignalHandler --------------------------------------------
 ///
-///  Call a user-defined Signal-handler
+///  Copy and reference the handlers of a member and count the dispatch, called
+///  with the signal table locked
 ///
+///  \param calls   array to be extended; reallocated if it is not the stack one
+///  \param count   number of handlers already in the array
+///  \param size    capacity of the array
 ///
-///  \return DBUS_HANDLER_RESULT_NOT_YET_HANDLED if no handler was called
-///          DBUS_HANDLER_RESULT_HANDLED if a handler was called
+///  \return new number of handlers in the array
 //------------------------------------------------------------------------------
-static DBusHandlerResult CallSignalHandler(tMemberList * mbr, DBusMessage * message)
+static size_t CollectSignalHandler(tMemberList * mbr,
+                                   tSignalCall ** calls,
+                                   size_t         count,
+                                   size_t       * size,
+                                   tSignalCall  * stackCalls)
 {
-  if(   (mbr == NULL)
-     || (mbr->callbackList == NULL))
+  tCallbackList * cbl;
+  size_t first = count;
+
+  if(mbr == NULL)
   {
-    return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+    return count;
   }
-  else
+  for(cbl = mbr->callbackList; cbl != NULL; cbl = cbl->pNext)
   {
-    tCallbackList * cbl = mbr->callbackList;
-    com_tConnection con;
-    con.bus = busConnection.bus;
-    dbus_error_init(&con.error);
-    while(cbl != NULL)
+    if(count == *size)
     {
-      com_tComMessage msg = {
-                         .msg = message
-      };
-      cbl->callback(&con, &msg, cbl->user_data);
-      dbus_error_free(&con.error);
-      cbl = cbl->pNext;
+      tSignalCall * grown = g_new(tSignalCall, *size * 2);
+      memcpy(grown, *calls, count * sizeof(tSignalCall));
+      if(*calls != stackCalls)
+      {
+        g_free(*calls);
+      }
+      *calls = grown;
+      *size *= 2;
     }
-    return DBUS_HANDLER_RESULT_HANDLED;
+    __atomic_add_fetch(&cbl->refs, 1, __ATOMIC_RELAXED);
+    (*calls)[count].handler = cbl;
+    count++;
+  }
+  if(count != first)
+  {
+    __atomic_add_fetch(&mbr->dispatched, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&mbr->calls, count - first, __ATOMIC_RELAXED);
   }
+  return count;
 }
 
 //-- Function: SignalHandler -----------------------------------------------
 ///
 ///  Dbus-Signal handler for calling the user defined handler
 ///
+///  The handlers are looked up in the interface and member indexes and copied
+///  under the signal table lock, then called without it, so they may register
+///  or deregister signals themselves. A handler deregistered meanwhile is kept
+///  until its call returned.
 ///
 ///  \return DBUS_HANDLER_RESULT_NOT_YET_HANDLED if no handler was called
 ///          DBUS_HANDLER_RESULT_HANDLED if a handler was called
@@ -244,22 +290,49 @@ static DBusHandlerResult com_SERV_SignalHandler (DBusConnection *connection,
   //check if message is a signal
   if(DBUS_MESSAGE_TYPE_SIGNAL == dbus_message_get_type(message))
   {
+    tSignalCall   stackCalls[SIGNAL_HANDLER_STACK];
+    tSignalCall * calls = stackCalls;
+    size_t        size  = SIGNAL_HANDLER_STACK;
+    size_t        count = 0;
+    size_t        i;
+
+    pthread_rwlock_rdlock(&signalTableLock);
     if(rootSignalHandler != NULL)
     {
       tInterfaceList * iFace = MSG_GetInterface(dbus_message_get_interface(message));
 
       if(iFace != NULL)
       {
-        tMemberList * mbr = MSG_GetMember(iFace, NULL);;
-        ret =  CallSignalHandler(mbr, message);
-        mbr = MSG_GetMember(iFace, dbus_message_get_member(message));
-        if(   (CallSignalHandler(mbr, message) == DBUS_HANDLER_RESULT_HANDLED)
-           || (ret                             == DBUS_HANDLER_RESULT_HANDLED))
+        const char * member = dbus_message_get_member(message);
+        count = CollectSignalHandler(MSG_GetMember(iFace, NULL), &calls, count, &size, stackCalls);
+        if(member != NULL)
         {
-          ret = DBUS_HANDLER_RESULT_HANDLED;
+          count = CollectSignalHandler(MSG_GetMember(iFace, member), &calls, count, &size, stackCalls);
         }
       }
     }
+    pthread_rwlock_unlock(&signalTableLock);
+
+    if(count > 0)
+    {
+      com_tConnection con;
+      con.bus = busConnection.bus;
+      dbus_error_init(&con.error);
+      for(i = 0; i < count; i++)
+      {
+        com_tComMessage msg = {
+                           .msg = message
+        };
+        calls[i].handler->callback(&con, &msg, calls[i].handler->user_data);
+        dbus_error_free(&con.error);
+        FreeCallback(calls[i].handler);
+      }
+      ret = DBUS_HANDLER_RESULT_HANDLED;
+    }
+    if(calls != stackCalls)
+    {
+      g_free(calls);
+    }
   }
 
   return ret;
@@ -457,7 +530,8 @@ void SERV_RecallServerThread(void)
   {
     SERV_UnblockServer();
     if(   (signalFilterRegistered == FALSE)
-       && (objectReferenceCounter == 0))
+       && (objectReferenceCounter == 0)
+       && (__atomic_load_n(&asyncCallCounter, __ATOMIC_ACQUIRE) == 0))
     {
       SERV_StopServerThread();
       receiverState = REC_STATE_STOP;
@@ -546,18 +620,125 @@ void com_SERV_Surrender(void)
   SERV_RecallServerThread();
 }
 
+//-- Function: WorkerPush -----------------------------------------------------
+///
+///  Put a message into the ring of a worker. Safe for concurrent producers.
+///
+///  \return 0 if the message was queued; -1 if the ring is full
+//------------------------------------------------------------------------------
+static int WorkerPush(tDbusWorker * worker, const tWorkerMsgQ * entry)
+{
+	unsigned long pos = __atomic_load_n(&worker->head, __ATOMIC_RELAXED);
+	tWorkerSlot * slot;
+	unsigned long fill;
+
+	for(;;)
+	{
+		long diff;
+		slot = &worker->ring[pos & worker->mask];
+		diff = (long)(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) - pos);
+		if(diff == 0)
+		{
+			if(__atomic_compare_exchange_n(&worker->head, &pos, pos + 1, true,
+			                               __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+			{
+				break;
+			}
+		}
+		else if(diff < 0)
+		{
+			return -1;
+		}
+		else
+		{
+			pos = __atomic_load_n(&worker->head, __ATOMIC_RELAXED);
+		}
+	}
+
+	slot->msg = *entry;
+	__atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+
+	fill = pos + 1 - __atomic_load_n(&worker->tail, __ATOMIC_RELAXED);
+	if(fill > __atomic_load_n(&worker->highWater, __ATOMIC_RELAXED))
+	{
+		__atomic_store_n(&worker->highWater, fill, __ATOMIC_RELAXED);
+	}
+	__atomic_add_fetch(&worker->enqueued, 1, __ATOMIC_RELAXED);
+	return 0;
+}
+
+//-- Function: WorkerPop ------------------------------------------------------
+///
+///  Take the next message from the ring. Only called by the worker thread.
+///
+///  \return true if a message was taken; false if the ring is empty
+//------------------------------------------------------------------------------
+static bool WorkerPop(tDbusWorker * worker, tWorkerMsgQ * entry)
+{
+	unsigned long pos = worker->tail;
+	tWorkerSlot * slot = &worker->ring[pos & worker->mask];
+
+	if(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != pos + 1)
+	{
+		return false;
+	}
+	*entry = slot->msg;
+	__atomic_store_n(&slot->seq, pos + worker->mask + 1, __ATOMIC_RELEASE);
+	__atomic_store_n(&worker->tail, pos + 1, __ATOMIC_RELAXED);
+	return true;
+}
+
+//-- Function: WorkerReject ---------------------------------------------------
+///
+///  Answer a method call that did not fit into the worker ring, so the caller
+///  gets an error right away instead of running into its timeout
+//------------------------------------------------------------------------------
+static void WorkerReject(DBusConnection * con, DBusMessage * msg)
+{
+	if(   (dbus_message_get_type(msg) == DBUS_MESSAGE_TYPE_METHOD_CALL)
+	   && (!dbus_message_get_no_reply(msg)))
+	{
+		DBusMessage * reply = dbus_message_new_error(msg, DBUS_ERROR_LIMITS_EXCEEDED,
+		                                             "worker queue is full");
+		if(reply != NULL)
+		{
+			dbus_connection_send(con, reply, NULL);
+			dbus_message_unref(reply);
+		}
+	}
+}
+
 void SERV_AppentToWorkingQueue(tObject * object,
 								DBusConnection * con,
 								DBusMessage * msg)
 {
+	tDbusWorker * worker = object->worker;
 	tWorkerMsgQ stMessage;
 
 	stMessage.DBusCon = con;
 	stMessage.DBusMsg = msg;
 	stMessage.object = object;
 
-    mq_send(object->worker->fdq, (const char *)&stMessage,
-                    sizeof(tWorkerMsgQ), 0);
+	if(WorkerPush(worker, &stMessage))
+	{
+		__atomic_add_fetch(&worker->rejected, 1, __ATOMIC_RELAXED);
+		WorkerReject(con, msg);
+		dbus_message_unref(msg);
+		return;
+	}
+
+	// pairs with the store of sleeping in ObjectWorker: either the worker sees
+	// the new slot on its re-check or we see it sleeping and wake it up
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if(__atomic_exchange_n(&worker->sleeping, 0, __ATOMIC_RELAXED))
+	{
+		uint64_t one = 1;
+		__atomic_add_fetch(&worker->wakeups, 1, __ATOMIC_RELAXED);
+		if(write(worker->fdWake, &one, sizeof one) < 0)
+		{
+			perror("worker wakeup");
+		}
+	}
 }
 
 static void * ObjectWorker(void * user_data)
@@ -565,57 +746,103 @@ static void * ObjectWorker(void * user_data)
 	tDbusWorker * pThis = (tDbusWorker*) user_data;
 	while(1)
 	{
-		struct pollfd fdrec;
-		fdrec.fd = pThis->fdq;
-		fdrec.events = POLLIN;
-		fdrec.revents = 0;
-		// wait for message (forever) used because we opened fd in O_NONBLOCK mode
-		if(0 < poll(&fdrec, 1, -1))
+		tWorkerMsgQ stMessage;
+		if(!WorkerPop(pThis, &stMessage))
 		{
-		  tWorkerMsgQ stMessage;
-		  if(0 < mq_receive(pThis->fdq, (char *) &stMessage,
-							sizeof(tWorkerMsgQ),NULL))
+		  uint64_t count;
+		  // announce the sleep first and look again, so a message pushed in
+		  // between is not left in the ring until the next one arrives
+		  __atomic_store_n(&pThis->sleeping, 1, __ATOMIC_RELAXED);
+		  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+		  if(!WorkerPop(pThis, &stMessage))
 		  {
-		    com_tComMessage msg;
-		    memset(&msg, 0, sizeof msg);
-		    com_tConnection con;
-		    memset(&con, 0, sizeof con);
-
-		    con.type = COM_CONNECTION_PROXY;
-		    con.method_call_timeout = -1;
-			  con.bus = stMessage.DBusCon;
-			  dbus_error_init(&con.error);
-			  msg.msg = stMessage.DBusMsg;
-			  stMessage.object->callback(&con,&msg,stMessage.object->user_data);
-			  dbus_message_unref(stMessage.DBusMsg);
+		    // wait for message (forever); a stale wakeup just costs one loop
+		    if(read(pThis->fdWake, &count, sizeof count) < 0 && errno != EINTR)
+		    {
+		      perror("worker wait");
+		    }
+		    continue;
 		  }
+		  __atomic_store_n(&pThis->sleeping, 0, __ATOMIC_RELAXED);
 		}
+
+		com_tComMessage msg;
+		memset(&msg, 0, sizeof msg);
+		com_tConnection con;
+		memset(&con, 0, sizeof con);
+
+		con.type = COM_CONNECTION_PROXY;
+		con.method_call_timeout = -1;
+		con.bus = stMessage.DBusCon;
+		dbus_error_init(&con.error);
+		msg.msg = stMessage.DBusMsg;
+		stMessage.object->callback(&con,&msg,stMessage.object->user_data);
+		dbus_message_unref(stMessage.DBusMsg);
+		__atomic_add_fetch(&pThis->processed, 1, __ATOMIC_RELAXED);
 	}
 	pthread_exit(NULL);
 	return NULL;
 }
 
-static void SERV_OpenQueue(tDbusWorker*  worker, char * workername, long int msgsz, long int maxmsg)
+//-- Function: SERV_OpenQueue -------------------------------------------------
+///
+///  Allocate the ring of a worker. The depth is rounded up to a power of two.
+///
+///  \return 0 on success; -1 on error
+//------------------------------------------------------------------------------
+static int SERV_OpenQueue(tDbusWorker*  worker, unsigned int depth)
 {
-  //mqd_t ret = -1;
-  struct mq_attr mqAttr;
-  char * queueName = malloc(strlen("/")+strlen(workername)+1);
+  unsigned long size = 2;
+  unsigned long i;
 
-  sprintf(queueName,"/%s",workername);
-
-  mqAttr.mq_flags = 0;
-  mqAttr.mq_maxmsg = maxmsg;//create a good size for the message buffer
-  mqAttr.mq_msgsize = msgsz;
-  worker->fdq = mq_open(queueName, (O_RDWR|O_CREAT|O_EXCL|O_NONBLOCK), (S_IWUSR|S_IRUSR), &mqAttr );
-  if(worker->fdq < 0)
+  if(depth == 0)
+  {
+    depth = WORKER_DEFAULT_DEPTH;
+  }
+  if(depth > WORKER_MAX_DEPTH)
   {
-    mq_unlink(queueName);
-    worker->fdq = mq_open(queueName, (O_RDWR|O_CREAT|O_EXCL|O_NONBLOCK), (S_IWUSR|S_IRUSR), &mqAttr );
+    depth = WORKER_MAX_DEPTH;
+  }
+  while(size < depth)
+  {
+    size <<= 1;
   }
 
+  worker->ring = calloc(size, sizeof(tWorkerSlot));
+  if(worker->ring == NULL)
+  {
+    return -1;
+  }
+  for(i = 0; i < size; i++)
+  {
+    worker->ring[i].seq = i;
+  }
+  worker->mask = size - 1;
+  worker->head = 0;
+  worker->tail = 0;
+  worker->sleeping = 0;
+  worker->enqueued = 0;
+  worker->processed = 0;
+  worker->rejected = 0;
+  worker->wakeups = 0;
+  worker->highWater = 0;
+
+  worker->fdWake = eventfd(0, EFD_CLOEXEC);
+  if(worker->fdWake < 0)
+  {
+    free(worker->ring);
+    worker->ring = NULL;
+    return -1;
+  }
+  return 0;
 }
 
 tDbusWorker * com_SERV_CreateNewWorker(unsigned char priority,char * name)
+{
+	return com_SERV_CreateNewWorkerWithDepth(priority, name, WORKER_DEFAULT_DEPTH);
+}
+
+tDbusWorker * com_SERV_CreateNewWorkerWithDepth(unsigned char priority,char * name, unsigned int depth)
 {
 	pthread_attr_t attr;
 	struct sched_param scheduling_parameter;
@@ -670,7 +897,14 @@ tDbusWorker * com_SERV_CreateNewWorker(unsigned char priority,char * name)
 	remove(tmpFileName);
 	free(tmpFileName);
 
-	SERV_OpenQueue(newWorker, newWorker->name, sizeof(tWorkerMsgQ), 10);
+	if(SERV_OpenQueue(newWorker, depth))
+	{
+		perror("worker queue");
+		pthread_attr_destroy(&attr);
+		free(newWorker->name);
+		free(newWorker);
+		return NULL;
+	}
 
 	if(pthread_create(&newWorker->id, &attr,(void * )ObjectWorker,newWorker))
 	{
@@ -726,6 +960,37 @@ tDbusWorker * com_SERV_GetWorker(unsigned char priority,char * name)
 	return pAct->worker;
 }
 
+int com_SERV_GetWorkerStats(tDbusWorker * worker, com_tWorkerStats * stats)
+{
+	unsigned long tail;
+
+	if(worker == NULL || stats == NULL)
+	{
+		return -1;
+	}
+	tail = __atomic_load_n(&worker->tail, __ATOMIC_RELAXED);
+	stats->depth     = worker->mask + 1;
+	stats->pending   = __atomic_load_n(&worker->head, __ATOMIC_RELAXED) - tail;
+	stats->enqueued  = __atomic_load_n(&worker->enqueued, __ATOMIC_RELAXED);
+	stats->processed = __atomic_load_n(&worker->processed, __ATOMIC_RELAXED);
+	stats->rejected  = __atomic_load_n(&worker->rejected, __ATOMIC_RELAXED);
+	stats->wakeups   = __atomic_load_n(&worker->wakeups, __ATOMIC_RELAXED);
+	stats->highWater = __atomic_load_n(&worker->highWater, __ATOMIC_RELAXED);
+	return 0;
+}
+
+void com_SERV_ResetWorkerStats(tDbusWorker * worker)
+{
+	if(worker != NULL)
+	{
+		__atomic_store_n(&worker->enqueued, 0, __ATOMIC_RELAXED);
+		__atomic_store_n(&worker->processed, 0, __ATOMIC_RELAXED);
+		__atomic_store_n(&worker->rejected, 0, __ATOMIC_RELAXED);
+		__atomic_store_n(&worker->wakeups, 0, __ATOMIC_RELAXED);
+		__atomic_store_n(&worker->highWater, 0, __ATOMIC_RELAXED);
+	}
+}
+
 int com_SERV_SetListenerPriority(unsigned char priority)
 {
 	int oldPriority = -1;
@@ -0,0 +1,173 @@
+//------------------------------------------------------------------------------
+/// Copyright (c) WAGO GmbH & Co. KG
+///
+/// PROPRIETARY RIGHTS are involved in the subject matter of this material.
+/// All manufacturing, reproduction, use and sales rights pertaining to this
+/// subject matter are governed by the license agreement. The recipient of this
+/// software implicitly accepts the terms of the license.
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+///
+///  \file     worker_benchmark.c
+///
+///  \version  $Revision: 1 $
+///
+///  \brief    measures method calls per second through object workers of
+///            different priorities
+///
+///            usage: worker_benchmark [calls per client] [clients] [depth]
+///
+///            A server process registers one object per worker priority, then
+///            several client processes call it concurrently. The worker queue
+///            statistics are printed by the server when it is stopped.
+///
+///  \author   <author> : WAGO GmbH & Co. KG
+//------------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include <communication_API.h>
+
+#define BENCH_NAME "test.bench"
+
+static const unsigned char priorities[] = { 0, 10, 50 };
+#define PRIORITY_COUNT (sizeof(priorities) / sizeof(priorities[0]))
+
+static volatile sig_atomic_t stop = 0;
+
+static void onStop(int sig)
+{
+  (void)sig;
+  stop = 1;
+}
+
+static void pingpong(com_tConnection * con, com_tComMessage * msg, void * data)
+{
+  (void)data;
+  com_MSG_Return(con,msg,COM_TYPE_INVALID);
+}
+
+static void server(unsigned int depth)
+{
+  com_tConnection con;
+  tDbusWorker * worker[PRIORITY_COUNT];
+  size_t i;
+
+  signal(SIGTERM, onStop);
+  com_GEN_Init(&con);
+  com_MSG_RegisterName(&con, BENCH_NAME);
+  for(i = 0; i < PRIORITY_COUNT; i++)
+  {
+    char path[32];
+    worker[i] = com_SERV_CreateNewWorkerWithDepth(priorities[i], "bench", depth);
+    if(worker[i] == NULL)
+    {
+      fprintf(stderr, "cannot create worker with priority %u\n", priorities[i]);
+      exit(1);
+    }
+    sprintf(path, "/test/bench/prio%u", priorities[i]);
+    com_MSG_RegisterObjectForWorker(&con, path, pingpong, NULL, worker[i]);
+  }
+  while(!stop)
+  {
+    sleep(1);
+  }
+  for(i = 0; i < PRIORITY_COUNT; i++)
+  {
+    com_tWorkerStats stats;
+    if(!com_SERV_GetWorkerStats(worker[i], &stats))
+    {
+      printf("prio %2u: depth %lu processed %lu rejected %lu wakeups %lu high water %lu\n",
+             priorities[i], stats.depth, stats.processed, stats.rejected,
+             stats.wakeups, stats.highWater);
+    }
+  }
+  com_GEN_Close(&con);
+  exit(0);
+}
+
+static void client(const char * path, int calls)
+{
+  com_tConnection con;
+  int errors = 0;
+  int i;
+
+  com_GEN_Init(&con);
+  for(i = 0; i < calls; i++)
+  {
+    if(com_MSG_MethodCall(&con, BENCH_NAME, path, "PING",
+                          COM_TYPE_INVALID, COM_TYPE_INVALID))
+    {
+      errors++;
+    }
+  }
+  com_GEN_Close(&con);
+  exit(errors ? 1 : 0);
+}
+
+int main(int argc, char * argv[])
+{
+  int calls = argc > 1 ? atoi(argv[1]) : 10000;
+  int clients = argc > 2 ? atoi(argv[2]) : 4;
+  unsigned int depth = argc > 3 ? (unsigned int)atoi(argv[3]) : 0;
+  pid_t serverPid;
+  size_t i;
+
+  if(calls <= 0 || clients <= 0)
+  {
+    fprintf(stderr, "usage: %s [calls per client] [clients] [depth]\n", argv[0]);
+    return 1;
+  }
+
+  serverPid = fork();
+  if(serverPid == 0)
+  {
+    server(depth);
+  }
+  // give the server time to register its name and objects
+  sleep(1);
+
+  for(i = 0; i < PRIORITY_COUNT; i++)
+  {
+    char path[32];
+    struct timespec start, end;
+    double seconds;
+    int failed = 0;
+    int c;
+
+    sprintf(path, "/test/bench/prio%u", priorities[i]);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for(c = 0; c < clients; c++)
+    {
+      if(fork() == 0)
+      {
+        client(path, calls);
+      }
+    }
+    for(c = 0; c < clients; c++)
+    {
+      int status;
+      if(wait(&status) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+      {
+        failed++;
+      }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("prio %2u: %d clients x %d calls in %.3f s = %.0f calls/s%s\n",
+           priorities[i], clients, calls, seconds,
+           (double)clients * calls / seconds,
+           failed ? " (with errors)" : "");
+  }
+
+  kill(serverPid, SIGTERM);
+  waitpid(serverPid, NULL, 0);
+  return 0;
+}
+
+//---- End of source file ------------------------------------------------------